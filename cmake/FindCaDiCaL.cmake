@@ -16,6 +16,29 @@
 find_path(CaDiCaL_INCLUDE_DIR NAMES cadical.hpp)
 find_library(CaDiCaL_LIBRARIES NAMES cadical)
 
+# The CDCL(T) integration of CaDiCaL uses the external propagator interface
+# (IPASIR-UP), which is only available since CaDiCaL 1.9.
+if(CaDiCaL_INCLUDE_DIR AND CaDiCaL_LIBRARIES)
+  include(CheckCXXSourceCompiles)
+  set(CMAKE_REQUIRED_INCLUDES ${CaDiCaL_INCLUDE_DIR})
+  check_cxx_source_compiles(
+    "
+    #include <cadical.hpp>
+    using Connect =
+        decltype(&CaDiCaL::Solver::connect_external_propagator);
+    using Observe = decltype(&CaDiCaL::Solver::add_observed_var);
+    int main() { return sizeof(CaDiCaL::ExternalPropagator*) == 0; }
+    "
+    CaDiCaL_HAS_EXTERNAL_PROPAGATOR)
+  unset(CMAKE_REQUIRED_INCLUDES)
+  if(NOT CaDiCaL_HAS_EXTERNAL_PROPAGATOR)
+    message(FATAL_ERROR
+      "CaDiCaL in ${CaDiCaL_INCLUDE_DIR} is too old, CaDiCaL 1.9 or later is "
+      "required for its external propagator interface. "
+      "Use contrib/get-cadical to download a compatible version.")
+  endif()
+endif()
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(CaDiCaL
   DEFAULT_MSG
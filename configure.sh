@@ -40,6 +40,7 @@ The following flags enable optional features (disable with --no-<option name>).
   --statistics             include statistics
   --assertions             turn on assertions
   --tracing                include tracing code
+  --thread-safe-nodes      allow sharing a NodeManager between threads
   --dumping                include dumping code
   --muzzle                 complete silence (no non-result output)
   --coverage               support for gcov coverage testing
@@ -145,6 +146,7 @@ shared=default
 static_binary=default
 statistics=default
 symfpu=default
+thread_safe_nodes=default
 tracing=default
 tsan=default
 ubsan=default
@@ -279,6 +281,9 @@ do
     --symfpu) symfpu=ON;;
     --no-symfpu) symfpu=OFF;;
 
+    --thread-safe-nodes) thread_safe_nodes=ON;;
+    --no-thread-safe-nodes) thread_safe_nodes=OFF;;
+
     --tracing) tracing=ON;;
     --no-tracing) tracing=OFF;;
 
@@ -420,6 +425,8 @@ cmake_opts=""
   && cmake_opts="$cmake_opts -DENABLE_STATIC_BINARY=$static_binary"
 [ $statistics != default ] \
   && cmake_opts="$cmake_opts -DENABLE_STATISTICS=$statistics"
+[ $thread_safe_nodes != default ] \
+  && cmake_opts="$cmake_opts -DENABLE_THREAD_SAFE_NODES=$thread_safe_nodes"
 [ $tracing != default ] \
   && cmake_opts="$cmake_opts -DENABLE_TRACING=$tracing"
 [ $unit_testing != default ] \
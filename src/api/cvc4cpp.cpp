@@ -863,16 +863,16 @@ class CVC4ApiRecoverableExceptionStream
   catch (const CVC4::Exception& e) { throw CVC4ApiException(e.getMessage()); } \
   catch (const std::invalid_argument& e) { throw CVC4ApiException(e.what()); }
 
-#define CVC4_API_SOLVER_CHECK_SORT(sort) \
-  CVC4_API_CHECK(this == sort.d_solver)  \
+#define CVC4_API_SOLVER_CHECK_SORT(sort)         \
+  CVC4_API_CHECK(sharesTermsWith(sort.d_solver)) \
       << "Given sort is not associated with this solver";
 
-#define CVC4_API_SOLVER_CHECK_TERM(term) \
-  CVC4_API_CHECK(this == term.d_solver)  \
+#define CVC4_API_SOLVER_CHECK_TERM(term)         \
+  CVC4_API_CHECK(sharesTermsWith(term.d_solver)) \
       << "Given term is not associated with this solver";
 
-#define CVC4_API_SOLVER_CHECK_OP(op)  \
-  CVC4_API_CHECK(this == op.d_solver) \
+#define CVC4_API_SOLVER_CHECK_OP(op)           \
+  CVC4_API_CHECK(sharesTermsWith(op.d_solver)) \
       << "Given operator is not associated with this solver";
 
 }  // namespace
@@ -984,6 +984,11 @@ Sort::~Sort()
 /* Helpers                                                                    */
 /* -------------------------------------------------------------------------- */
 
+bool Solver::sharesTermsWith(const Solver* s) const
+{
+  return s == this || (s != nullptr && s->d_exprMgr == d_exprMgr);
+}
+
 /* Split out to avoid nested API calls (problematic with API tracing).        */
 /* .......................................................................... */
 
@@ -3237,6 +3242,15 @@ Solver::Solver(Options* opts)
   d_rng.reset(new Random(o[options::seed]));
 }
 
+Solver::Solver(std::shared_ptr<ExprManager> exprMgr,
+               std::unique_ptr<SmtEngine> smtEngine)
+    : d_exprMgr(exprMgr), d_smtEngine(std::move(smtEngine))
+{
+  d_smtEngine->setSolver(this);
+  Options& o = d_smtEngine->getOptions();
+  d_rng.reset(new Random(o[options::seed]));
+}
+
 Solver::~Solver() {}
 
 /* Helpers                                                                    */
@@ -3379,7 +3393,7 @@ Term Solver::mkTermHelper(Kind kind, const std::vector<Term>& children) const
         !children[i].isNull(), "child term", children[i], i)
         << "non-null term";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == children[i].d_solver, "child term", children[i], i)
+        sharesTermsWith(children[i].d_solver), "child term", children[i], i)
         << "a child term associated to this solver object";
   }
 
@@ -3478,10 +3492,11 @@ std::vector<Sort> Solver::mkDatatypeSortsInternal(
   std::vector<CVC4::DType> datatypes;
   for (size_t i = 0, ndts = dtypedecls.size(); i < ndts; ++i)
   {
-    CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(this == dtypedecls[i].d_solver,
-                                         "datatype declaration",
-                                         dtypedecls[i],
-                                         i)
+    CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
+        sharesTermsWith(dtypedecls[i].d_solver),
+        "datatype declaration",
+        dtypedecls[i],
+        i)
         << "a datatype declaration associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(dtypedecls[i].getNumConstructors() > 0,
                                          "datatype declaration",
@@ -3669,7 +3684,7 @@ Sort Solver::mkDatatypeSort(DatatypeDecl dtypedecl) const
 {
   NodeManagerScope scope(getNodeManager());
   CVC4_API_SOLVER_TRY_CATCH_BEGIN;
-  CVC4_API_CHECK(this == dtypedecl.d_solver)
+  CVC4_API_CHECK(sharesTermsWith(dtypedecl.d_solver))
       << "Given datatype declaration is not associated with this solver";
   CVC4_API_ARG_CHECK_EXPECTED(dtypedecl.getNumConstructors() > 0, dtypedecl)
       << "a datatype declaration with at least one constructor";
@@ -3729,7 +3744,7 @@ Sort Solver::mkFunctionSort(const std::vector<Sort>& sorts, Sort codomain) const
         !sorts[i].isNull(), "parameter sort", sorts[i], i)
         << "non-null sort";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == sorts[i].d_solver, "parameter sort", sorts[i], i)
+        sharesTermsWith(sorts[i].d_solver), "parameter sort", sorts[i], i)
         << "sort associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         sorts[i].isFirstClass(), "parameter sort", sorts[i], i)
@@ -3771,7 +3786,7 @@ Sort Solver::mkPredicateSort(const std::vector<Sort>& sorts) const
         !sorts[i].isNull(), "parameter sort", sorts[i], i)
         << "non-null sort";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == sorts[i].d_solver, "parameter sort", sorts[i], i)
+        sharesTermsWith(sorts[i].d_solver), "parameter sort", sorts[i], i)
         << "sort associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         sorts[i].isFirstClass(), "parameter sort", sorts[i], i)
@@ -3797,7 +3812,7 @@ Sort Solver::mkRecordSort(
         !p.second.isNull(), "parameter sort", p.second, i)
         << "non-null sort";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == p.second.d_solver, "parameter sort", p.second, i)
+        sharesTermsWith(p.second.d_solver), "parameter sort", p.second, i)
         << "sort associated to this solver object";
     i += 1;
     f.emplace_back(p.first, *p.second.d_type);
@@ -3877,7 +3892,7 @@ Sort Solver::mkTupleSort(const std::vector<Sort>& sorts) const
         !sorts[i].isNull(), "parameter sort", sorts[i], i)
         << "non-null sort";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == sorts[i].d_solver, "parameter sort", sorts[i], i)
+        sharesTermsWith(sorts[i].d_solver), "parameter sort", sorts[i], i)
         << "sort associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         !sorts[i].isFunctionLike(), "parameter sort", sorts[i], i)
@@ -4054,7 +4069,7 @@ Term Solver::mkEmptySet(Sort s) const
   CVC4_API_SOLVER_TRY_CATCH_BEGIN;
   CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || s.isSet(), s)
       << "null sort or set sort";
-  CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || this == s.d_solver, s)
+  CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || sharesTermsWith(s.d_solver), s)
       << "set sort associated to this solver object";
 
   return mkValHelper<CVC4::EmptySet>(CVC4::EmptySet(*s.d_type));
@@ -4068,7 +4083,7 @@ Term Solver::mkEmptyBag(Sort s) const
   CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || s.isBag(), s)
       << "null sort or bag sort";
 
-  CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || this == s.d_solver, s)
+  CVC4_API_ARG_CHECK_EXPECTED(s.isNull() || sharesTermsWith(s.d_solver), s)
       << "bag sort associated to this solver object";
 
   return mkValHelper<CVC4::EmptyBag>(CVC4::EmptyBag(*s.d_type));
@@ -4495,7 +4510,7 @@ Term Solver::mkTermHelper(const Op& op, const std::vector<Term>& children) const
         !children[i].isNull(), "child term", children[i], i)
         << "non-null term";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == children[i].d_solver, "child term", children[i], i)
+        sharesTermsWith(children[i].d_solver), "child term", children[i], i)
         << "child term associated to this solver object";
   }
 
@@ -4524,10 +4539,10 @@ Term Solver::mkTuple(const std::vector<Sort>& sorts,
   for (size_t i = 0, size = sorts.size(); i < size; i++)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == terms[i].d_solver, "child term", terms[i], i)
+        sharesTermsWith(terms[i].d_solver), "child term", terms[i], i)
         << "child term associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == sorts[i].d_solver, "child sort", sorts[i], i)
+        sharesTermsWith(sorts[i].d_solver), "child sort", sorts[i], i)
         << "child sort associated to this solver object";
     args.push_back(*(ensureTermSort(terms[i], sorts[i])).d_node);
   }
@@ -4916,7 +4931,7 @@ Sort Solver::declareDatatype(
   DatatypeDecl dtdecl(this, symbol);
   for (size_t i = 0, size = ctors.size(); i < size; i++)
   {
-    CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(this == ctors[i].d_solver,
+    CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(sharesTermsWith(ctors[i].d_solver),
                                          "datatype constructor declaration",
                                          ctors[i],
                                          i)
@@ -4938,7 +4953,7 @@ Term Solver::declareFun(const std::string& symbol,
   for (size_t i = 0, size = sorts.size(); i < size; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == sorts[i].d_solver, "parameter sort", sorts[i], i)
+        sharesTermsWith(sorts[i].d_solver), "parameter sort", sorts[i], i)
         << "parameter sort associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         sorts[i].isFirstClass(), "parameter sort", sorts[i], i)
@@ -4988,7 +5003,10 @@ Term Solver::defineFun(const std::string& symbol,
   for (size_t i = 0, size = bound_vars.size(); i < size; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == bound_vars[i].d_solver, "bound variable", bound_vars[i], i)
+        sharesTermsWith(bound_vars[i].d_solver),
+        "bound variable",
+        bound_vars[i],
+        i)
         << "bound variable associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         bound_vars[i].d_node->getKind() == CVC4::Kind::BOUND_VARIABLE,
@@ -5035,7 +5053,10 @@ Term Solver::defineFun(Term fun,
     for (size_t i = 0; i < size; ++i)
     {
       CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-          this == bound_vars[i].d_solver, "bound variable", bound_vars[i], i)
+          sharesTermsWith(bound_vars[i].d_solver),
+          "bound variable",
+          bound_vars[i],
+          i)
           << "bound variable associated to this solver object";
       CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
           bound_vars[i].d_node->getKind() == CVC4::Kind::BOUND_VARIABLE,
@@ -5095,7 +5116,10 @@ Term Solver::defineFunRec(const std::string& symbol,
   for (size_t i = 0, size = bound_vars.size(); i < size; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == bound_vars[i].d_solver, "bound variable", bound_vars[i], i)
+        sharesTermsWith(bound_vars[i].d_solver),
+        "bound variable",
+        bound_vars[i],
+        i)
         << "bound variable associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         bound_vars[i].d_node->getKind() == CVC4::Kind::BOUND_VARIABLE,
@@ -5152,7 +5176,10 @@ Term Solver::defineFunRec(Term fun,
     for (size_t i = 0; i < size; ++i)
     {
       CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-          this == bound_vars[i].d_solver, "bound variable", bound_vars[i], i)
+          sharesTermsWith(bound_vars[i].d_solver),
+          "bound variable",
+          bound_vars[i],
+          i)
           << "bound variable associated to this solver object";
       CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
           bound_vars[i].d_node->getKind() == CVC4::Kind::BOUND_VARIABLE,
@@ -5214,7 +5241,7 @@ void Solver::defineFunsRec(const std::vector<Term>& funs,
     const Term& term = terms[j];
 
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == fun.d_solver, "function", fun, j)
+        sharesTermsWith(fun.d_solver), "function", fun, j)
         << "function associated to this solver object";
     CVC4_API_SOLVER_CHECK_TERM(term);
 
@@ -5229,7 +5256,7 @@ void Solver::defineFunsRec(const std::vector<Term>& funs,
         for (size_t k = 0, nbvars = bvars.size(); k < nbvars; ++k)
         {
           CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-              this == bvars[k].d_solver, "bound variable", bvars[k], k)
+              sharesTermsWith(bvars[k].d_solver), "bound variable", bvars[k], k)
               << "bound variable associated to this solver object";
           CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
               bvars[k].d_node->getKind() == CVC4::Kind::BOUND_VARIABLE,
@@ -5400,7 +5427,7 @@ std::vector<Term> Solver::getValue(const std::vector<Term>& terms) const
   for (size_t i = 0, n = terms.size(); i < n; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == terms[i].d_solver, "term", terms[i], i)
+        sharesTermsWith(terms[i].d_solver), "term", terms[i], i)
         << "term associated to this solver object";
     /* Can not use emplace_back here since constructor is private. */
     res.push_back(getValueHelper(terms[i]));
@@ -5583,7 +5610,7 @@ void Solver::blockModelValues(const std::vector<Term>& terms) const
         !terms[i].isNull(), "term", terms[i], i)
         << "a non-null term";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == terms[i].d_solver, "term", terms[i], i)
+        sharesTermsWith(terms[i].d_solver), "term", terms[i], i)
         << "a term associated to this solver object";
   }
   CVC4::ExprManagerScope exmgrs(*(d_exprMgr.get()));
@@ -5599,6 +5626,19 @@ void Solver::printInstantiations(std::ostream& out) const
   CVC4_API_SOLVER_TRY_CATCH_END;
 }
 
+std::string Solver::getStatisticsJSON() const
+{
+  CVC4_API_SOLVER_TRY_CATCH_BEGIN;
+  CVC4::ExprManagerScope exmgrs(*(d_exprMgr.get()));
+  std::stringstream ss;
+  ss << "{";
+  bool first = true;
+  d_smtEngine->flushStatisticsJSON(ss, first);
+  ss << std::endl << "}";
+  return ss.str();
+  CVC4_API_SOLVER_TRY_CATCH_END;
+}
+
 /**
  *  ( push <numeral> )
  */
@@ -5627,6 +5667,14 @@ void Solver::resetAssertions(void) const
   CVC4_API_SOLVER_TRY_CATCH_END;
 }
 
+std::unique_ptr<Solver> Solver::clone() const
+{
+  CVC4_API_SOLVER_TRY_CATCH_BEGIN;
+  NodeManagerScope scope(getNodeManager());
+  return std::unique_ptr<Solver>(new Solver(d_exprMgr, d_smtEngine->clone()));
+  CVC4_API_SOLVER_TRY_CATCH_END;
+}
+
 /**
  *  ( set-info <attribute> )
  */
@@ -5737,7 +5785,10 @@ Grammar Solver::mkSygusGrammar(const std::vector<Term>& boundVars,
   for (size_t i = 0, n = boundVars.size(); i < n; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == boundVars[i].d_solver, "bound variable", boundVars[i], i)
+        sharesTermsWith(boundVars[i].d_solver),
+        "bound variable",
+        boundVars[i],
+        i)
         << "bound variable associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         !boundVars[i].isNull(), "bound variable", boundVars[i], i)
@@ -5753,7 +5804,7 @@ Grammar Solver::mkSygusGrammar(const std::vector<Term>& boundVars,
   for (size_t i = 0, n = ntSymbols.size(); i < n; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == ntSymbols[i].d_solver, "non-terminal", ntSymbols[i], i)
+        sharesTermsWith(ntSymbols[i].d_solver), "non-terminal", ntSymbols[i], i)
         << "term associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         !ntSymbols[i].isNull(), "non-terminal", ntSymbols[i], i)
@@ -5813,7 +5864,10 @@ Term Solver::synthFunHelper(const std::string& symbol,
   for (size_t i = 0, n = boundVars.size(); i < n; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == boundVars[i].d_solver, "bound variable", boundVars[i], i)
+        sharesTermsWith(boundVars[i].d_solver),
+        "bound variable",
+        boundVars[i],
+        i)
         << "bound variable associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         !boundVars[i].isNull(), "bound variable", boundVars[i], i)
@@ -5952,7 +6006,7 @@ std::vector<Term> Solver::getSynthSolutions(
   for (size_t i = 0, n = terms.size(); i < n; ++i)
   {
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
-        this == terms[i].d_solver, "parameter term", terms[i], i)
+        sharesTermsWith(terms[i].d_solver), "parameter term", terms[i], i)
         << "parameter term associated to this solver object";
     CVC4_API_ARG_AT_INDEX_CHECK_EXPECTED(
         !terms[i].isNull(), "parameter term", terms[i], i)
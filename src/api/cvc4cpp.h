@@ -3341,6 +3341,15 @@ class CVC4_PUBLIC Solver
    */
   void printInstantiations(std::ostream& out) const;
 
+  /**
+   * Get the statistics of this solver as a JSON object, which maps the name
+   * of each statistic to its value. Counters are numbers, timers are numbers
+   * of seconds, and histograms are objects that map values to counts.
+   * The object is empty if CVC4 was built without statistics.
+   * @return the statistics as a JSON object
+   */
+  std::string getStatisticsJSON() const;
+
   /**
    * Push (a) level(s) to the assertion stack.
    * SMT-LIB: ( push <numeral> )
@@ -3354,6 +3363,15 @@ class CVC4_PUBLIC Solver
    */
   void resetAssertions() const;
 
+  /**
+   * Make a clone of this solver, which starts from the assertions of this
+   * solver after preprocessing, together with the lemmas learned so far, and
+   * is independent of this solver afterwards. The clone shares the terms and
+   * sorts of this solver, and must be destroyed before it.
+   * @return the clone
+   */
+  std::unique_ptr<Solver> clone() const;
+
   /**
    * Set info.
    * SMT-LIB: ( set-info <attribute> )
@@ -3522,6 +3540,11 @@ class CVC4_PUBLIC Solver
   Options& getOptions(void);
 
  private:
+  /* Constructor of a clone with the given SMT engine. */
+  Solver(std::shared_ptr<ExprManager> exprMgr,
+         std::unique_ptr<SmtEngine> smtEngine);
+  /* Is s this solver or a clone that shares its terms? */
+  bool sharesTermsWith(const Solver* s) const;
   /* Helper to convert a vector of internal types to sorts. */
   std::vector<Type> sortVectorToTypes(const std::vector<Sort>& vector) const;
   /* Helper to convert a vector of sorts to internal types. */
@@ -3606,8 +3629,8 @@ class CVC4_PUBLIC Solver
   /** check whether string s is a valid decimal integer */
   bool isValidInteger(const std::string& s) const;
 
-  /* The expression manager of this solver. */
-  std::unique_ptr<ExprManager> d_exprMgr;
+  /* The expression manager of this solver, shared with its clones. */
+  std::shared_ptr<ExprManager> d_exprMgr;
   /* The SMT engine of this solver. */
   std::unique_ptr<SmtEngine> d_smtEngine;
   /* The random number generator of this solver. */
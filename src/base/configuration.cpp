@@ -84,6 +84,11 @@ bool Configuration::isUbsanBuild() { return IS_UBSAN_BUILD; }
 
 bool Configuration::isTsanBuild() { return IS_TSAN_BUILD; }
 
+bool Configuration::isThreadSafeNodesBuild()
+{
+  return IS_THREAD_SAFE_NODES_BUILD;
+}
+
 bool Configuration::isCompetitionBuild() {
   return IS_COMPETITION_BUILD;
 }
@@ -67,6 +67,8 @@ public:
 
   static bool isTsanBuild();
 
+  static bool isThreadSafeNodesBuild();
+
   static bool isCompetitionBuild();
 
   static bool isStaticBuild();
@@ -78,6 +78,12 @@ namespace CVC4 {
 #  define IS_PROFILING_BUILD false
 #endif /* CVC4_PROFILING */
 
+#ifdef CVC4_THREAD_SAFE_NODES
+#  define IS_THREAD_SAFE_NODES_BUILD true
+#else /* CVC4_THREAD_SAFE_NODES */
+#  define IS_THREAD_SAFE_NODES_BUILD false
+#endif /* CVC4_THREAD_SAFE_NODES */
+
 #ifdef CVC4_COMPETITION_MODE
 #  define IS_COMPETITION_BUILD true
 #else /* CVC4_COMPETITION_MODE */
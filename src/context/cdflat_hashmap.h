@@ -0,0 +1,254 @@
+/*********************                                                        */
+/*! \file cdflat_hashmap.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Context-dependent hash map with a flat open-addressing table
+ **
+ ** Context-dependent hash map whose entries are stored in a single array, in
+ ** insertion order, and indexed by an open-addressing table with linear
+ ** probing. Instead of saving and restoring a ContextObj per element, the map
+ ** records its changes on the UndoTrail of its Context, so that a pop of the
+ ** context only truncates the entry array and clears the slots of the removed
+ ** entries.
+ **
+ ** Since changes are undone in the reverse order in which they were made, the
+ ** entry that is removed is always the last inserted one, and no entry that
+ ** remains in the map was placed in the probe sequence through its slot. The
+ ** slot can therefore simply be cleared, without tombstones.
+ **
+ ** Unlike CDHashMap, this map does not support insertAtContextLevelZero() or
+ ** clear(), and it stores keys and data in a std::vector, so references to
+ ** entries are invalidated by insertions.
+ **
+ ** See also:
+ **  CDFlatHashSet : A context-dependent hash set on the same table.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__CONTEXT__CDFLAT_HASHMAP_H
+#define CVC4__CONTEXT__CDFLAT_HASHMAP_H
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "context/context.h"
+#include "context/undo_trail.h"
+
+namespace CVC4 {
+namespace context {
+
+template <class Key, class Data, class HashFcn = std::hash<Key>>
+class CDFlatHashMap : public UndoTrailClient
+{
+ public:
+  typedef std::pair<Key, Data> value_type;
+  typedef typename std::vector<value_type>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  CDFlatHashMap(Context* context)
+      : d_context(context),
+        d_trail(context->getUndoTrail()),
+        d_slots(s_minSlots, 0),
+        d_shift(64 - s_minSlotsLog)
+  {
+  }
+
+  ~CDFlatHashMap() { d_trail.forget(this); }
+
+  CDFlatHashMap(const CDFlatHashMap&) = delete;
+  CDFlatHashMap& operator=(const CDFlatHashMap&) = delete;
+
+  /** Get the number of entries */
+  size_t size() const { return d_entries.size(); }
+
+  /** Is the map empty? */
+  bool empty() const { return d_entries.empty(); }
+
+  /** Get the number of entries with key k, i.e. 0 or 1 */
+  size_t count(const Key& k) const { return contains(k) ? 1 : 0; }
+
+  /** Does the map contain k? */
+  bool contains(const Key& k) const { return d_slots[findSlot(k)] != 0; }
+
+  /** Get the entry of k, or end() */
+  const_iterator find(const Key& k) const
+  {
+    uint32_t index = d_slots[findSlot(k)];
+    return index == 0 ? end() : d_entries.begin() + (index - 1);
+  }
+
+  /** Iterate over the entries, in insertion order */
+  const_iterator begin() const { return d_entries.begin(); }
+  const_iterator end() const { return d_entries.end(); }
+
+  /**
+   * Map k to d. Returns true if k was not in the map, otherwise its data is
+   * overwritten, and restored when the context is popped below the current
+   * level.
+   */
+  bool insert(const Key& k, const Data& d)
+  {
+    size_t slot = findSlot(k);
+    if (d_slots[slot] == 0)
+    {
+      insertAt(slot, k, d);
+      return true;
+    }
+    size_t i = d_slots[slot] - 1;
+    int32_t level = d_context->getLevel();
+    if (d_levels[i] < level)
+    {
+      // first change of the entry at this level, save the old data
+      d_changes.push_back(Change{static_cast<uint32_t>(i), d_levels[i]});
+      d_savedData.push_back(d_entries[i].second);
+      d_levels[i] = level;
+      d_trail.record(this);
+    }
+    d_entries[i].second = d;
+    return false;
+  }
+
+  /**
+   * Map k to d if k is not in the map yet. Returns true if it was inserted,
+   * as CDInsertHashMap::insert_safe().
+   */
+  bool insertIfAbsent(const Key& k, const Data& d)
+  {
+    size_t slot = findSlot(k);
+    if (d_slots[slot] != 0)
+    {
+      return false;
+    }
+    insertAt(slot, k, d);
+    return true;
+  }
+
+  void undo(size_t n) override
+  {
+    for (; n > 0; --n)
+    {
+      Assert(!d_changes.empty());
+      Change c = d_changes.back();
+      d_changes.pop_back();
+      if (c.d_oldLevel < 0)
+      {
+        // undo the insertion of the last entry
+        Assert(c.d_index + 1 == d_entries.size());
+        d_slots[findSlot(d_entries.back().first)] = 0;
+        d_entries.pop_back();
+        d_levels.pop_back();
+      }
+      else
+      {
+        d_entries[c.d_index].second = std::move(d_savedData.back());
+        d_savedData.pop_back();
+        d_levels[c.d_index] = c.d_oldLevel;
+      }
+    }
+  }
+
+ private:
+  /** A change of an entry, recorded in the order of the trail */
+  struct Change
+  {
+    /** The index of the entry */
+    uint32_t d_index;
+    /**
+     * The level of the entry before the change, whose data is on top of
+     * d_savedData, or -1 if the entry was inserted
+     */
+    int32_t d_oldLevel;
+  };
+
+  static constexpr size_t s_minSlotsLog = 4;
+  static constexpr size_t s_minSlots = size_t(1) << s_minSlotsLog;
+
+  /** Get the slot of k, or the empty slot where k would be inserted */
+  size_t findSlot(const Key& k) const
+  {
+    size_t mask = d_slots.size() - 1;
+    size_t slot = hashToSlot(d_hash(k));
+    while (d_slots[slot] != 0 && !(d_entries[d_slots[slot] - 1].first == k))
+    {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  /** Fibonacci hashing, spreads the hash values over the slots */
+  size_t hashToSlot(size_t h) const
+  {
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(h) * UINT64_C(0x9E3779B97F4A7C15)) >> d_shift);
+  }
+
+  /** Insert a new entry in the empty slot for k */
+  void insertAt(size_t slot, const Key& k, const Data& d)
+  {
+    int32_t level = d_context->getLevel();
+    d_entries.emplace_back(k, d);
+    d_levels.push_back(level);
+    d_slots[slot] = static_cast<uint32_t>(d_entries.size());
+    if (d_trail.isRecording())
+    {
+      d_changes.push_back(
+          Change{static_cast<uint32_t>(d_entries.size() - 1), -1});
+      d_trail.record(this);
+    }
+    // keep the load factor below 1/2
+    if (2 * d_entries.size() > d_slots.size())
+    {
+      grow();
+    }
+  }
+
+  /** Double the number of slots and reinsert the entries in order */
+  void grow()
+  {
+    d_slots.assign(2 * d_slots.size(), 0);
+    --d_shift;
+    size_t mask = d_slots.size() - 1;
+    for (size_t i = 0, size = d_entries.size(); i < size; ++i)
+    {
+      size_t slot = hashToSlot(d_hash(d_entries[i].first));
+      while (d_slots[slot] != 0)
+      {
+        slot = (slot + 1) & mask;
+      }
+      d_slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+  }
+
+  /** The context */
+  Context* d_context;
+  /** The undo trail of the context */
+  UndoTrail& d_trail;
+  /** The hash function */
+  HashFcn d_hash;
+  /** The entries, in insertion order */
+  std::vector<value_type> d_entries;
+  /** The level of the last change of each entry */
+  std::vector<int32_t> d_levels;
+  /** The index plus one of the entry in each slot, or 0 if it is empty */
+  std::vector<uint32_t> d_slots;
+  /** 64 minus the binary logarithm of the number of slots */
+  size_t d_shift;
+  /** The changes that can be undone */
+  std::vector<Change> d_changes;
+  /** The data saved by the changes that overwrote an entry */
+  std::vector<Data> d_savedData;
+}; /* class CDFlatHashMap */
+
+}  // namespace context
+}  // namespace CVC4
+
+#endif /* CVC4__CONTEXT__CDFLAT_HASHMAP_H */
@@ -0,0 +1,111 @@
+/*********************                                                        */
+/*! \file cdflat_hashset.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Context-dependent hash set with a flat open-addressing table
+ **
+ ** Context-dependent hash set on the table of CDFlatHashMap, whose insertions
+ ** are undone through the UndoTrail of its Context.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__CONTEXT__CDFLAT_HASHSET_H
+#define CVC4__CONTEXT__CDFLAT_HASHSET_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+#include "context/cdflat_hashmap.h"
+
+namespace CVC4 {
+namespace context {
+
+template <class V, class HashFcn = std::hash<V>>
+class CDFlatHashSet
+{
+  struct Empty
+  {
+  };
+  typedef CDFlatHashMap<V, Empty, HashFcn> Map;
+
+ public:
+  /** Iterates over the elements, in insertion order */
+  class const_iterator
+  {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef V value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const V* pointer;
+    typedef const V& reference;
+
+    const_iterator(typename Map::const_iterator it) : d_it(it) {}
+    const V& operator*() const { return d_it->first; }
+    const V* operator->() const { return &d_it->first; }
+    const_iterator& operator++()
+    {
+      ++d_it;
+      return *this;
+    }
+    const_iterator operator++(int)
+    {
+      const_iterator tmp = *this;
+      ++d_it;
+      return tmp;
+    }
+    bool operator==(const const_iterator& other) const
+    {
+      return d_it == other.d_it;
+    }
+    bool operator!=(const const_iterator& other) const
+    {
+      return d_it != other.d_it;
+    }
+
+   private:
+    typename Map::const_iterator d_it;
+  };
+  typedef const_iterator iterator;
+
+  CDFlatHashSet(Context* context) : d_map(context) {}
+
+  /** Get the number of elements */
+  size_t size() const { return d_map.size(); }
+
+  /** Is the set empty? */
+  bool empty() const { return d_map.empty(); }
+
+  /** Get the number of occurrences of v, i.e. 0 or 1 */
+  size_t count(const V& v) const { return d_map.count(v); }
+
+  /** Does the set contain v? */
+  bool contains(const V& v) const { return d_map.contains(v); }
+
+  /** Get the position of v, or end() */
+  const_iterator find(const V& v) const { return d_map.find(v); }
+
+  const_iterator begin() const { return d_map.begin(); }
+  const_iterator end() const { return d_map.end(); }
+
+  /**
+   * Insert v, returns true if it was not in the set. The insertion is undone
+   * when the context is popped below the current level.
+   */
+  bool insert(const V& v) { return d_map.insertIfAbsent(v, Empty()); }
+
+ private:
+  /** The map whose keys are the elements */
+  Map d_map;
+}; /* class CDFlatHashSet */
+
+}  // namespace context
+}  // namespace CVC4
+
+#endif /* CVC4__CONTEXT__CDFLAT_HASHSET_H */
@@ -69,6 +69,9 @@ void Context::push() {
 
   // Create a new top Scope
   d_scopeList.push_back(new(d_pCMM) Scope(this, d_pCMM, getLevel()+1));
+
+  // Mark the start of the changes of the new Scope on the trail
+  d_undoTrail.push();
 }
 
 
@@ -84,6 +87,9 @@ void Context::pop() {
     pCNO = next;
   }
 
+  // Undo the changes recorded on the trail in the top Scope
+  d_undoTrail.pop();
+
   // Grab the top Scope
   Scope* pScope = d_scopeList.back();
 
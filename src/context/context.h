@@ -28,6 +28,7 @@
 #include "base/check.h"
 #include "base/output.h"
 #include "context/context_mm.h"
+#include "context/undo_trail.h"
 
 
 namespace CVC4 {
@@ -89,6 +90,12 @@ class Context {
    */
   ContextNotifyObj* d_pCNOpost;
 
+  /**
+   * The trail on which the containers that are not ContextObj, such as
+   * CDFlatHashMap, record their changes.
+   */
+  UndoTrail d_undoTrail;
+
   friend std::ostream& operator<<(std::ostream&, const Context&);
 
   // disable copy, assignment
@@ -170,6 +177,11 @@ public:
    */
   ContextMemoryManager* getCMM() { return d_pCMM; }
 
+  /**
+   * Return the UndoTrail associated with the context.
+   */
+  UndoTrail& getUndoTrail() { return d_undoTrail; }
+
   /**
    * Save the current state, create a new Scope
    */
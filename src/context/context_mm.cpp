@@ -15,11 +15,16 @@
  **/
 
 
+#include <algorithm>
 #include <cstdlib>
 #include <vector>
 #include <deque>
 #include <new>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif /* __linux__ */
+
 #ifdef CVC4_VALGRIND
 #include <valgrind/memcheck.h>
 #endif /* CVC4_VALGRIND */
@@ -31,8 +36,128 @@
 namespace CVC4 {
 namespace context {
 
+ContextMemoryConfig::ContextMemoryConfig()
+    : d_maxChunkSizeBytes(16384),
+      d_maxFreeBytes(100 * 16384),
+      d_hugePages(false)
+{
+}
+
+ContextMemoryStatistics::ContextMemoryStatistics()
+    : d_chunksAllocated(0),
+      d_chunksRecycled(0),
+      d_chunksReleased(0),
+      d_chunkBytes(0),
+      d_peakChunkBytes(0)
+{
+}
+
 #ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
 
+ContextMemoryManager::Chunk ContextMemoryManager::allocateChunk(size_t size)
+{
+  Chunk chunk{nullptr, size, false};
+  if (d_config.d_hugePages)
+  {
+    chunk.d_data = allocateFromArena(size);
+    chunk.d_arena = chunk.d_data != nullptr;
+  }
+  if (chunk.d_data == nullptr)
+  {
+    chunk.d_data = (char*)malloc(size);
+    if (chunk.d_data == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+  }
+  ++d_stats.d_chunksAllocated;
+  d_stats.d_chunkBytes += size;
+  d_stats.d_peakChunkBytes =
+      std::max(d_stats.d_peakChunkBytes, d_stats.d_chunkBytes);
+
+#ifdef CVC4_VALGRIND
+  VALGRIND_MAKE_MEM_NOACCESS(chunk.d_data, size);
+#endif /* CVC4_VALGRIND */
+  return chunk;
+}
+
+char* ContextMemoryManager::allocateFromArena(size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (static_cast<size_t>(d_arenaEnd - d_arenaNext) < size)
+  {
+    // Map a new block, with one extra huge page so that it can be aligned.
+    // The rest of the current block is not used.
+    size_t blockSize = std::max(arenaBlockSizeBytes, size);
+    blockSize = (blockSize + hugePageSizeBytes - 1) & ~(hugePageSizeBytes - 1);
+    size_t mapSize = blockSize + hugePageSizeBytes;
+    void* block = mmap(nullptr,
+                       mapSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (block == MAP_FAILED)
+    {
+      Debug("context") << "ContextMemoryManager: could not map a block of "
+                       << mapSize << " bytes for the arena" << std::endl;
+      return nullptr;
+    }
+    d_arenaBlocks.emplace_back(static_cast<char*>(block), mapSize);
+    uintptr_t start = reinterpret_cast<uintptr_t>(block);
+    start = (start + hugePageSizeBytes - 1) & ~(hugePageSizeBytes - 1);
+    d_arenaNext = reinterpret_cast<char*>(start);
+    d_arenaEnd = d_arenaNext + blockSize;
+    // this is only a hint, the block is used with normal pages otherwise
+    madvise(d_arenaNext, blockSize, MADV_HUGEPAGE);
+  }
+  char* res = d_arenaNext;
+  d_arenaNext += size;
+  return res;
+#else
+  return nullptr;
+#endif
+}
+
+size_t ContextMemoryManager::getNewChunkSize() const
+{
+  if (d_config.d_maxChunkSizeBytes <= chunkSizeBytes)
+  {
+    return chunkSizeBytes;
+  }
+  // Grow with the memory used by the current region so far, or by the
+  // earlier regions at this level, so that a region needs few chunks.
+  size_t level = d_nextFreeStack.size();
+  size_t size = d_regionBytes;
+  if (level < d_highWaterMarks.size() && d_highWaterMarks[level] > size)
+  {
+    size = std::max(size, d_highWaterMarks[level] - d_regionBytes);
+  }
+  // round up to a multiple of the minimal chunk size
+  size = (size + chunkSizeBytes - 1) / chunkSizeBytes * chunkSizeBytes;
+  return std::min(std::max(size, size_t(chunkSizeBytes)),
+                  d_config.d_maxChunkSizeBytes);
+}
+
+void ContextMemoryManager::releaseFreeChunks()
+{
+  // Delete the oldest excess free chunks, chunks of the arena are kept
+  std::deque<Chunk>::iterator it = d_freeChunks.begin();
+  while (d_freeBytes > d_config.d_maxFreeBytes && it != d_freeChunks.end())
+  {
+    if (it->d_arena)
+    {
+      ++it;
+      continue;
+    }
+    d_freeBytes -= it->d_size;
+    d_stats.d_chunkBytes -= it->d_size;
+    ++d_stats.d_chunksReleased;
+    free(it->d_data);
+    it = d_freeChunks.erase(it);
+  }
+}
+
 void ContextMemoryManager::newChunk() {
 
   // Increment index to chunk list
@@ -42,40 +167,40 @@ void ContextMemoryManager::newChunk() {
 
   // Create new chunk if no free chunk available
   if(d_freeChunks.empty()) {
-    d_chunkList.push_back((char*)malloc(chunkSizeBytes));
-    if(d_chunkList.back() == NULL) {
-      throw std::bad_alloc();
-    }
-
-#ifdef CVC4_VALGRIND
-    VALGRIND_MAKE_MEM_NOACCESS(d_chunkList.back(), chunkSizeBytes);
-#endif /* CVC4_VALGRIND */
+    d_chunkList.push_back(allocateChunk(getNewChunkSize()));
   }
   // If there is a free chunk, use that
   else {
     d_chunkList.push_back(d_freeChunks.back());
     d_freeChunks.pop_back();
+    if (!d_chunkList.back().d_arena)
+    {
+      d_freeBytes -= d_chunkList.back().d_size;
+    }
+    ++d_stats.d_chunksRecycled;
   }
   // Set up the current chunk pointers
-  d_nextFree = d_chunkList.back();
-  d_endChunk = d_nextFree + chunkSizeBytes;
+  d_nextFree = d_chunkList.back().d_data;
+  d_endChunk = d_nextFree + d_chunkList.back().d_size;
 }
 
 
-ContextMemoryManager::ContextMemoryManager() : d_indexChunkList(0) {
-  // Create initial chunk
-  d_chunkList.push_back((char*)malloc(chunkSizeBytes));
-  d_nextFree = d_chunkList.back();
-  if(d_nextFree == NULL) {
-    throw std::bad_alloc();
-  }
-  d_endChunk = d_nextFree + chunkSizeBytes;
-
+ContextMemoryManager::ContextMemoryManager()
+    : d_freeBytes(0),
+      d_indexChunkList(0),
+      d_regionBytes(0),
+      d_arenaNext(nullptr),
+      d_arenaEnd(nullptr)
+{
 #ifdef CVC4_VALGRIND
   VALGRIND_CREATE_MEMPOOL(this, 0, false);
-  VALGRIND_MAKE_MEM_NOACCESS(d_nextFree, chunkSizeBytes);
   d_allocations.push_back(std::vector<char*>());
 #endif /* CVC4_VALGRIND */
+
+  // Create initial chunk
+  d_chunkList.push_back(allocateChunk(chunkSizeBytes));
+  d_nextFree = d_chunkList.back().d_data;
+  d_endChunk = d_nextFree + chunkSizeBytes;
 }
 
 
@@ -86,13 +211,26 @@ ContextMemoryManager::~ContextMemoryManager() {
 
   // Delete all chunks
   while(!d_chunkList.empty()) {
-    free(d_chunkList.back());
+    if (!d_chunkList.back().d_arena)
+    {
+      free(d_chunkList.back().d_data);
+    }
     d_chunkList.pop_back();
   }
   while(!d_freeChunks.empty()) {
-    free(d_freeChunks.back());
+    if (!d_freeChunks.back().d_arena)
+    {
+      free(d_freeChunks.back().d_data);
+    }
     d_freeChunks.pop_back();
   }
+  // Unmap the arena
+#ifdef __linux__
+  for (const std::pair<char*, size_t>& block : d_arenaBlocks)
+  {
+    munmap(block.first, block.second);
+  }
+#endif /* __linux__ */
 }
 
 
@@ -108,6 +246,7 @@ void* ContextMemoryManager::newData(size_t size) {
     AlwaysAssert(d_nextFree <= d_endChunk)
         << "Request is bigger than memory chunk size";
   }
+  d_regionBytes += size;
   Debug("context") << "ContextMemoryManager::newData(" << size
                    << ") returning " << res << " at level "
                    << d_chunkList.size() << std::endl;
@@ -130,6 +269,8 @@ void ContextMemoryManager::push() {
   d_nextFreeStack.push_back(d_nextFree);
   d_endChunkStack.push_back(d_endChunk);
   d_indexChunkListStack.push_back(d_indexChunkList);
+  d_regionBytesStack.push_back(d_regionBytes);
+  d_regionBytes = 0;
 }
 
 
@@ -144,17 +285,32 @@ void ContextMemoryManager::pop() {
 
   Assert(d_nextFreeStack.size() > 0 && d_endChunkStack.size() > 0);
 
+  // Record the memory used by the region at this level
+  size_t level = d_nextFreeStack.size();
+  if (d_highWaterMarks.size() <= level)
+  {
+    d_highWaterMarks.resize(level + 1, 0);
+  }
+  d_highWaterMarks[level] = std::max(d_highWaterMarks[level], d_regionBytes);
+
   // Restore state from stack
   d_nextFree = d_nextFreeStack.back();
   d_nextFreeStack.pop_back();
   d_endChunk = d_endChunkStack.back();
   d_endChunkStack.pop_back();
+  d_regionBytes = d_regionBytesStack.back();
+  d_regionBytesStack.pop_back();
 
   // Free all the new chunks since the last push
   while(d_indexChunkList > d_indexChunkListStack.back()) {
-    d_freeChunks.push_back(d_chunkList.back());
+    const Chunk& chunk = d_chunkList.back();
+    d_freeChunks.push_back(chunk);
+    if (!chunk.d_arena)
+    {
+      d_freeBytes += chunk.d_size;
+    }
 #ifdef CVC4_VALGRIND
-    VALGRIND_MAKE_MEM_NOACCESS(d_chunkList.back(), chunkSizeBytes);
+    VALGRIND_MAKE_MEM_NOACCESS(chunk.d_data, chunk.d_size);
 #endif /* CVC4_VALGRIND */
     d_chunkList.pop_back();
     --d_indexChunkList;
@@ -162,10 +318,25 @@ void ContextMemoryManager::pop() {
   d_indexChunkListStack.pop_back();
 
   // Delete excess free chunks
-  while(d_freeChunks.size() > maxFreeChunks) {
-    free(d_freeChunks.front());
-    d_freeChunks.pop_front();
+  releaseFreeChunks();
+}
+
+void ContextMemoryManager::setConfig(const ContextMemoryConfig& config)
+{
+  d_config = config;
+  d_config.d_maxChunkSizeBytes =
+      std::max(d_config.d_maxChunkSizeBytes, size_t(chunkSizeBytes));
+  releaseFreeChunks();
+}
+
+size_t ContextMemoryManager::getHighWaterMark(size_t level) const
+{
+  size_t res = level < d_highWaterMarks.size() ? d_highWaterMarks[level] : 0;
+  if (level == d_nextFreeStack.size())
+  {
+    res = std::max(res, d_regionBytes);
   }
+  return res;
 }
 
 #endif /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
@@ -20,13 +20,58 @@
 #ifndef CVC4__CONTEXT__CONTEXT_MM_H
 #define CVC4__CONTEXT__CONTEXT_MM_H
 
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace CVC4 {
 namespace context {
 
+/**
+ * Configuration of the chunks of a ContextMemoryManager. The default
+ * configuration allocates chunks of fixed size from the heap.
+ */
+struct ContextMemoryConfig
+{
+  ContextMemoryConfig();
+  /**
+   * The maximal size of a chunk in bytes. If it is larger than the minimal
+   * chunk size, new chunks grow with the memory used by the region, or used
+   * before by the regions at the same level.
+   */
+  size_t d_maxChunkSizeBytes;
+  /**
+   * The maximal number of bytes in free chunks that are kept for reuse by
+   * later regions.
+   */
+  size_t d_maxFreeBytes;
+  /**
+   * Allocate chunks from an arena that is backed by transparent huge pages,
+   * if supported. The memory of the arena is kept until the memory manager
+   * is destroyed.
+   */
+  bool d_hugePages;
+}; /* struct ContextMemoryConfig */
+
+/** Statistics on the chunks of a ContextMemoryManager */
+struct ContextMemoryStatistics
+{
+  ContextMemoryStatistics();
+  /** Number of chunks that were allocated */
+  uint64_t d_chunksAllocated;
+  /** Number of chunks that were reused from the free chunks */
+  uint64_t d_chunksRecycled;
+  /** Number of free chunks that were released */
+  uint64_t d_chunksReleased;
+  /** Number of bytes in the chunks that are in use or free */
+  uint64_t d_chunkBytes;
+  /** The maximal value of d_chunkBytes */
+  uint64_t d_peakChunkBytes;
+}; /* struct ContextMemoryStatistics */
+
 #ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
 
 /**
@@ -38,29 +83,53 @@ namespace context {
  * stack, and a new current region is created.  A subsequent call to pop
  * releases the new region and restores the top region from the stack.
  *
+ * The size of the chunks, the number of free chunks that are kept and
+ * whether chunks come from a huge-page backed arena are configured by a
+ * ContextMemoryConfig.
  */
 class ContextMemoryManager {
 
   /**
-   * Memory in regions is allocated in chunks.  This is the chunk size
+   * Memory in regions is allocated in chunks.  This is the minimal chunk
+   * size, chunks can grow up to the maximal size of the configuration.
    */
   static const unsigned chunkSizeBytes = 16384;
 
   /**
-   * A list of free chunks is maintained.  This is the maximum number of
-   * free chunks.
+   * The size of the huge pages the blocks of the arena are aligned to
    */
-  static const unsigned maxFreeChunks = 100;
+  static const size_t hugePageSizeBytes = size_t(2) << 20;
+
+  /**
+   * The minimal size of a block of the arena
+   */
+  static const size_t arenaBlockSizeBytes = size_t(8) << 20;
+
+  /** A chunk of memory */
+  struct Chunk
+  {
+    /** The memory of the chunk */
+    char* d_data;
+    /** The size of the chunk in bytes */
+    size_t d_size;
+    /** Was the chunk allocated from the arena? */
+    bool d_arena;
+  };
 
   /**
    * List of all chunks that are currently active
    */
-  std::vector<char*> d_chunkList;
+  std::vector<Chunk> d_chunkList;
 
   /**
    * Queue of free chunks (for best cache performance, LIFO order is used)
    */
-  std::deque<char*> d_freeChunks;
+  std::deque<Chunk> d_freeChunks;
+
+  /**
+   * Number of bytes in the free chunks that are not from the arena
+   */
+  size_t d_freeBytes;
 
   /**
    * Pointer to the beginning of available memory in the current chunk in
@@ -97,6 +166,40 @@ class ContextMemoryManager {
    */
   std::vector<unsigned> d_indexChunkListStack;
 
+  /**
+   * Number of bytes allocated by newData in the current region
+   */
+  size_t d_regionBytes;
+
+  /**
+   * Part of the stack of saved regions.  This vector stores the saved value
+   * of d_regionBytes
+   */
+  std::vector<size_t> d_regionBytesStack;
+
+  /**
+   * The maximal number of bytes allocated in a region at each level, over
+   * the regions that were popped
+   */
+  std::vector<size_t> d_highWaterMarks;
+
+  /**
+   * The blocks of the arena, as the mapped memory and its size
+   */
+  std::vector<std::pair<char*, size_t>> d_arenaBlocks;
+
+  /**
+   * The available memory of the current block of the arena
+   */
+  char* d_arenaNext;
+  char* d_arenaEnd;
+
+  /** The configuration */
+  ContextMemoryConfig d_config;
+
+  /** The statistics */
+  ContextMemoryStatistics d_stats;
+
   /**
    * Private method to grab a new chunk for the current region.  Uses chunk
    * from d_freeChunks if available.  Creates a new one otherwise.  Sets the
@@ -104,6 +207,28 @@ class ContextMemoryManager {
    */
   void newChunk();
 
+  /**
+   * Allocate a chunk of the given size, from the arena if huge pages are
+   * enabled, otherwise from the heap
+   */
+  Chunk allocateChunk(size_t size);
+
+  /**
+   * Allocate size bytes from the arena, returns nullptr if the arena could
+   * not be extended
+   */
+  char* allocateFromArena(size_t size);
+
+  /**
+   * Get the size of the next new chunk of the current region
+   */
+  size_t getNewChunkSize() const;
+
+  /**
+   * Release free chunks that exceed the configured number of free bytes
+   */
+  void releaseFreeChunks();
+
 #ifdef CVC4_VALGRIND
   /**
    * Vector of allocations for each level. Used for accurately marking
@@ -146,6 +271,22 @@ class ContextMemoryManager {
    */
   void pop();
 
+  /**
+   * Set the configuration, which applies to the chunks allocated from now on
+   */
+  void setConfig(const ContextMemoryConfig& config);
+
+  /**
+   * Get the statistics on the chunks
+   */
+  const ContextMemoryStatistics& getStatistics() const { return d_stats; }
+
+  /**
+   * Get the maximal number of bytes allocated in a region at the given
+   * level, where level 0 is the region before the first push
+   */
+  size_t getHighWaterMark(size_t level) const;
+
 };/* class ContextMemoryManager */
 
 #else /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
@@ -196,8 +337,15 @@ class ContextMemoryManager
     d_allocations.pop_back();
   }
 
+  void setConfig(const ContextMemoryConfig& config) {}
+
+  const ContextMemoryStatistics& getStatistics() const { return d_stats; }
+
+  size_t getHighWaterMark(size_t level) const { return 0; }
+
  private:
   std::vector<std::vector<char*>> d_allocations;
+  ContextMemoryStatistics d_stats;
 }; /* ContextMemoryManager */
 
 #endif /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
@@ -0,0 +1,133 @@
+/*********************                                                        */
+/*! \file undo_trail.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A trail of changes to context-dependent containers
+ **
+ ** Each Context owns an UndoTrail, on which the containers built on it
+ ** (CDFlatHashMap and CDFlatHashSet) record their changes. A pop of the
+ ** context truncates the trail to its size at the matching push and hands
+ ** each run of consecutive changes back to the container that made them,
+ ** instead of restoring a saved ContextObj per modified element.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__CONTEXT__UNDO_TRAIL_H
+#define CVC4__CONTEXT__UNDO_TRAIL_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+
+namespace CVC4 {
+namespace context {
+
+/** A container that records its changes on an UndoTrail */
+class UndoTrailClient
+{
+  friend class UndoTrail;
+
+ public:
+  UndoTrailClient() : d_numRuns(0) {}
+  virtual ~UndoTrailClient() {}
+  /** Undo the last n changes this client recorded, in reverse order */
+  virtual void undo(size_t n) = 0;
+
+ private:
+  /** The number of runs of changes of this client on the trail */
+  size_t d_numRuns;
+}; /* class UndoTrailClient */
+
+/**
+ * The changes made since the last push of a Context, as runs of consecutive
+ * changes by the same client. Clients only record changes above level 0,
+ * which can be undone.
+ */
+class UndoTrail
+{
+ public:
+  UndoTrail() {}
+
+  UndoTrail(const UndoTrail&) = delete;
+  UndoTrail& operator=(const UndoTrail&) = delete;
+
+  /** Are changes recorded, i.e. is the context above level 0? */
+  bool isRecording() const { return !d_limits.empty(); }
+
+  /** Record a change made by client */
+  void record(UndoTrailClient* client)
+  {
+    Assert(isRecording());
+    if (d_entries.size() > d_limits.back() && d_entries.back().first == client)
+    {
+      ++d_entries.back().second;
+    }
+    else
+    {
+      d_entries.emplace_back(client, 1);
+      ++client->d_numRuns;
+    }
+  }
+
+  /**
+   * Forget the changes of client, which is being destroyed. The trail is
+   * scanned from the back until all runs of client are found, which is cheap
+   * for short-lived clients.
+   */
+  void forget(UndoTrailClient* client)
+  {
+    for (size_t i = d_entries.size(); client->d_numRuns > 0;)
+    {
+      Assert(i > 0);
+      --i;
+      if (d_entries[i].first == client)
+      {
+        d_entries[i].first = nullptr;
+        --client->d_numRuns;
+      }
+    }
+  }
+
+  /** Called by the context on a push */
+  void push() { d_limits.push_back(d_entries.size()); }
+
+  /** Called by the context on a pop, undoes the changes since the push */
+  void pop()
+  {
+    Assert(isRecording());
+    size_t limit = d_limits.back();
+    d_limits.pop_back();
+    while (d_entries.size() > limit)
+    {
+      std::pair<UndoTrailClient*, size_t> e = d_entries.back();
+      d_entries.pop_back();
+      if (e.first != nullptr)
+      {
+        --e.first->d_numRuns;
+        e.first->undo(e.second);
+      }
+    }
+  }
+
+  /** Get the number of runs of changes on the trail */
+  size_t size() const { return d_entries.size(); }
+
+ private:
+  /** The runs of changes, as the client and the number of changes */
+  std::vector<std::pair<UndoTrailClient*, size_t>> d_entries;
+  /** The size of d_entries at each push */
+  std::vector<size_t> d_limits;
+}; /* class UndoTrail */
+
+}  // namespace context
+}  // namespace CVC4
+
+#endif /* CVC4__CONTEXT__UNDO_TRAIL_H */
@@ -17,6 +17,7 @@
 
 #include "decision/decision_attributes.h"
 #include "decision/justification_heuristic.h"
+#include "decision/watched_justification_heuristic.h"
 #include "expr/node.h"
 #include "options/decision_options.h"
 #include "options/smt_options.h"
@@ -56,6 +57,12 @@ void DecisionEngine::init()
     d_enabledITEStrategy.reset(new decision::JustificationHeuristic(
         this, d_userContext, d_satContext));
   }
+  else if (options::decisionMode()
+           == options::DecisionMode::JUSTIFICATION_WATCHED)
+  {
+    d_enabledITEStrategy.reset(new decision::WatchedJustificationHeuristic(
+        this, d_userContext, d_satContext));
+  }
 }
 
 void DecisionEngine::shutdown()
@@ -154,6 +154,10 @@ class DecisionEngine {
   SatValue getSatValue(TNode n) {
     return getSatValue(getSatLiteral(n));
   }
+  /** Get the SAT context level at which l was assigned, or -1 */
+  int32_t getAssignmentLevel(SatLiteral l) {
+    return d_satSolver->getAssignmentLevel(l.getSatVariable());
+  }
   Node getNode(SatLiteral l) {
     return d_cnfStream->getNode(l);
   }
@@ -0,0 +1,530 @@
+/*********************                                                        */
+/*! \file watched_justification_heuristic.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Incremental justification heuristic for decision making
+ **
+ ** Incremental justification heuristic for decision making.
+ **/
+#include "decision/watched_justification_heuristic.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "decision/decision_engine.h"
+#include "expr/kind.h"
+#include "smt/smt_statistics_registry.h"
+
+using namespace CVC4::prop;
+
+namespace CVC4 {
+namespace decision {
+
+namespace {
+
+/**
+ * Computes the desired values of the children of an EQUAL or XOR node with
+ * the desired value desiredVal, given the known values of the children.
+ */
+void computeXorIffDesiredValues(Kind k,
+                                SatValue desiredVal,
+                                SatValue& desiredVal1,
+                                SatValue& desiredVal2)
+{
+  Assert(k == kind::EQUAL || k == kind::XOR);
+  bool shouldInvert = (desiredVal == SAT_VALUE_TRUE && k == kind::EQUAL)
+                      || (desiredVal == SAT_VALUE_FALSE && k == kind::XOR);
+  if (desiredVal1 == SAT_VALUE_UNKNOWN && desiredVal2 == SAT_VALUE_UNKNOWN)
+  {
+    desiredVal1 = SAT_VALUE_FALSE;
+  }
+  if (desiredVal2 == SAT_VALUE_UNKNOWN)
+  {
+    desiredVal2 = shouldInvert ? invertValue(desiredVal1) : desiredVal1;
+  }
+  else if (desiredVal1 == SAT_VALUE_UNKNOWN)
+  {
+    desiredVal1 = shouldInvert ? invertValue(desiredVal2) : desiredVal2;
+  }
+}
+
+}  // namespace
+
+WatchedJustificationHeuristic::WatchedJustificationHeuristic(
+    DecisionEngine* de, context::UserContext* uc, context::Context* c)
+    : ITEDecisionStrategy(de, c),
+      context::ContextNotifyObj(c),
+      d_satContext(c),
+      d_assertions(uc),
+      d_skolemAssertions(uc),
+      d_skolemCache(uc),
+      d_helpfulness("decision::wjh::helpfulness", 0),
+      d_resumes("decision::wjh::resumes", 0),
+      d_retained("decision::wjh::retainedJustifications", 0),
+      d_timestat("decision::wjh::time")
+{
+  smtStatisticsRegistry()->registerStat(&d_helpfulness);
+  smtStatisticsRegistry()->registerStat(&d_resumes);
+  smtStatisticsRegistry()->registerStat(&d_retained);
+  smtStatisticsRegistry()->registerStat(&d_timestat);
+  Trace("decision") << "Watched justification heuristic enabled" << std::endl;
+}
+
+WatchedJustificationHeuristic::~WatchedJustificationHeuristic()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_helpfulness);
+  smtStatisticsRegistry()->unregisterStat(&d_resumes);
+  smtStatisticsRegistry()->unregisterStat(&d_retained);
+  smtStatisticsRegistry()->unregisterStat(&d_timestat);
+}
+
+SatLiteral WatchedJustificationHeuristic::getNext(bool& stopSearch)
+{
+  Trace("decision") << "WatchedJustificationHeuristic::getNext()" << std::endl;
+  TimerStat::CodeTimer codeTimer(d_timestat);
+
+  if (!d_stack.empty())
+  {
+    ++d_resumes;
+  }
+  SatLiteral lit = findNext();
+  if (lit != undefSatLiteral)
+  {
+    Trace("decision") << "wjh: splitting on " << lit << std::endl;
+    ++d_helpfulness;
+    return lit;
+  }
+
+  Trace("decision") << "wjh: Nothing to split on " << std::endl;
+  // SAT solver can stop...
+  stopSearch = true;
+  d_decisionEngine->setResult(SAT_VALUE_TRUE);
+  return undefSatLiteral;
+}
+
+void WatchedJustificationHeuristic::addAssertion(TNode assertion)
+{
+  // as in the justification heuristic, this includes the assertions generated
+  // by term removal, so that all Boolean term variables are assigned
+  trimJustifiedPrefix();
+  d_assertions.push_back(assertion);
+}
+
+void WatchedJustificationHeuristic::addSkolemDefinition(TNode lem,
+                                                        TNode skolem)
+{
+  Trace("decision::wjh") << " wjh-ite: " << skolem << " maps to " << lem
+                         << std::endl;
+  d_skolemAssertions[skolem] = lem;
+}
+
+void WatchedJustificationHeuristic::contextNotifyPop()
+{
+  int32_t level = d_satContext->getLevel();
+  Trace("decision::wjh") << "wjh: pop to level " << level << std::endl;
+  size_t keep = static_cast<size_t>(level) + 1;
+  for (size_t l = keep, size = d_justifiedAtLevel.size(); l < size; ++l)
+  {
+    for (const Node& n : d_justifiedAtLevel[l])
+    {
+      d_justified.erase(n);
+    }
+  }
+  if (d_justifiedAtLevel.size() > keep)
+  {
+    d_justifiedAtLevel.resize(keep);
+  }
+  d_retained += d_justified.size();
+
+  while (!d_justifiedPrefix.empty() && d_justifiedPrefix.back().second > level)
+  {
+    d_justifiedPrefix.pop_back();
+  }
+
+  if (!d_relevantSkolemDefs.empty())
+  {
+    for (auto it = d_relevantSkolems.begin(); it != d_relevantSkolems.end();)
+    {
+      it = it->second > level ? d_relevantSkolems.erase(it) : std::next(it);
+    }
+    d_relevantSkolemDefs.erase(
+        std::remove_if(d_relevantSkolemDefs.begin(),
+                       d_relevantSkolemDefs.end(),
+                       [this](const std::pair<Node, Node>& d) {
+                         return d_relevantSkolems.find(d.first)
+                                == d_relevantSkolems.end();
+                       }),
+        d_relevantSkolemDefs.end());
+  }
+
+  // the path to the last decision may depend on undone assignments
+  d_stack.clear();
+}
+
+SatLiteral WatchedJustificationHeuristic::findNext()
+{
+  while (true)
+  {
+    if (d_stack.empty())
+    {
+      TNode root = getNextRoot();
+      if (root.isNull())
+      {
+        return undefSatLiteral;
+      }
+      Debug("decision") << "---" << std::endl << root << std::endl;
+      pushFrame(root, SAT_VALUE_TRUE);
+    }
+    SatLiteral lit = processTop();
+    if (lit != undefSatLiteral)
+    {
+      return lit;
+    }
+  }
+}
+
+TNode WatchedJustificationHeuristic::getNextRoot()
+{
+  trimJustifiedPrefix();
+  size_t start = d_justifiedPrefix.empty() ? 0 : d_justifiedPrefix.back().first;
+  int32_t level =
+      d_justifiedPrefix.empty() ? 0 : d_justifiedPrefix.back().second;
+  size_t i = start;
+  Justification j;
+  while (i < d_assertions.size() && getJustification(d_assertions[i], j))
+  {
+    level = std::max(level, j.d_level);
+    ++i;
+  }
+  if (i > start)
+  {
+    d_justifiedPrefix.emplace_back(i, level);
+  }
+  if (i < d_assertions.size())
+  {
+    return d_assertions[i];
+  }
+  for (const std::pair<Node, Node>& d : d_relevantSkolemDefs)
+  {
+    // skip definitions that were removed by a user pop
+    if (d_skolemAssertions.find(d.first) != d_skolemAssertions.end()
+        && !getJustification(d.second, j))
+    {
+      return d.second;
+    }
+  }
+  return TNode::null();
+}
+
+void WatchedJustificationHeuristic::trimJustifiedPrefix()
+{
+  // assertions that were removed by a user pop are no longer justified, this
+  // must be checked before new assertions are added
+  while (!d_justifiedPrefix.empty()
+         && d_justifiedPrefix.back().first > d_assertions.size())
+  {
+    d_justifiedPrefix.pop_back();
+  }
+}
+
+SatLiteral WatchedJustificationHeuristic::processTop()
+{
+  Frame& f = d_stack.back();
+  TNode n = f.d_node;
+  Trace("decision::wjh") << "processTop(" << n << ", " << f.d_desired << ")"
+                         << std::endl;
+  Justification j;
+  if (getJustification(n, j))
+  {
+    d_stack.pop_back();
+    return undefSatLiteral;
+  }
+
+  if (isAtom(n))
+  {
+    Assert(d_decisionEngine->hasSatLiteral(n));
+    SatLiteral lit = d_decisionEngine->getSatLiteral(n);
+    SatValue value = d_decisionEngine->getSatValue(lit);
+    if (value == SAT_VALUE_UNKNOWN)
+    {
+      Trace("decision-node")
+          << "[decision-node] requesting split on " << lit << ", node: " << n
+          << ", polarity: "
+          << (f.d_desired == SAT_VALUE_TRUE ? "true" : "false") << std::endl;
+      return f.d_desired == SAT_VALUE_TRUE ? lit : ~lit;
+    }
+    int32_t level = d_decisionEngine->getAssignmentLevel(lit);
+    popJustified(value, level);
+    notifyAtomJustified(n, level);
+    return undefSatLiteral;
+  }
+
+  Kind k = n.getKind();
+  switch (k)
+  {
+    case kind::AND:
+    case kind::OR:
+    case kind::IMPLIES:
+    {
+      // the value of a child that determines the value of n, where the first
+      // child of an implication is negated
+      SatValue ctrl = k == kind::AND ? SAT_VALUE_FALSE : SAT_VALUE_TRUE;
+      size_t nchildren = n.getNumChildren();
+      // advance the watch over the children with a non-controlling value
+      for (; f.d_watch < nchildren; ++f.d_watch)
+      {
+        if (!getJustification(n[f.d_watch], j))
+        {
+          break;
+        }
+        bool negated = k == kind::IMPLIES && f.d_watch == 0;
+        if ((negated ? invertValue(j.d_value) : j.d_value) == ctrl)
+        {
+          popJustified(ctrl, j.d_level);
+          return undefSatLiteral;
+        }
+        f.d_level = std::max(f.d_level, j.d_level);
+      }
+      if (f.d_watch == nchildren)
+      {
+        popJustified(invertValue(ctrl), f.d_level);
+        return undefSatLiteral;
+      }
+      size_t next = f.d_watch;
+      SatValue desired = invertValue(ctrl);
+      if (f.d_desired == ctrl)
+      {
+        // one child with the controlling value suffices, pick one that does
+        // not have the other value in the SAT solver
+        for (size_t i = f.d_watch; i < nchildren; ++i)
+        {
+          bool negated = k == kind::IMPLIES && i == 0;
+          if (getJustification(n[i], j))
+          {
+            if ((negated ? invertValue(j.d_value) : j.d_value) == ctrl)
+            {
+              popJustified(ctrl, j.d_level);
+              return undefSatLiteral;
+            }
+            continue;
+          }
+          SatValue value = tryGetSatValue(n[i]);
+          if ((negated ? invertValue(value) : value) != invertValue(ctrl))
+          {
+            next = i;
+            desired = ctrl;
+            break;
+          }
+        }
+      }
+      bool negated = k == kind::IMPLIES && next == 0;
+      pushFrame(n[next], negated ? invertValue(desired) : desired);
+      break;
+    }
+
+    case kind::XOR:
+    case kind::EQUAL:
+    {
+      Justification j0, j1;
+      bool has0 = getJustification(n[0], j0);
+      bool has1 = getJustification(n[1], j1);
+      if (has0 && has1)
+      {
+        bool equal = j0.d_value == j1.d_value;
+        popJustified(equal == (k == kind::EQUAL) ? SAT_VALUE_TRUE
+                                                 : SAT_VALUE_FALSE,
+                     std::max(j0.d_level, j1.d_level));
+        return undefSatLiteral;
+      }
+      SatValue desired0 = has0 ? j0.d_value : tryGetSatValue(n[0]);
+      SatValue desired1 = has1 ? j1.d_value : tryGetSatValue(n[1]);
+      computeXorIffDesiredValues(k, f.d_desired, desired0, desired1);
+      if (has0)
+      {
+        pushFrame(n[1], desired1);
+      }
+      else
+      {
+        pushFrame(n[0], desired0);
+      }
+      break;
+    }
+
+    case kind::ITE:
+    {
+      Justification jc, jb;
+      if (getJustification(n[0], jc))
+      {
+        TNode branch = n[jc.d_value == SAT_VALUE_TRUE ? 1 : 2];
+        if (getJustification(branch, jb))
+        {
+          popJustified(jb.d_value, std::max(jc.d_level, jb.d_level));
+          return undefSatLiteral;
+        }
+        pushFrame(branch, f.d_desired);
+        break;
+      }
+      Justification j1, j2;
+      if (getJustification(n[1], j1) && getJustification(n[2], j2)
+          && j1.d_value == j2.d_value)
+      {
+        popJustified(j1.d_value, std::max(j1.d_level, j2.d_level));
+        return undefSatLiteral;
+      }
+      SatValue desired = f.d_desired;
+      SatValue condDesired = tryGetSatValue(n[0]);
+      if (condDesired == SAT_VALUE_UNKNOWN)
+      {
+        SatValue thenVal = tryGetSatValue(n[1]);
+        SatValue elseVal = tryGetSatValue(n[2]);
+        condDesired = SAT_VALUE_TRUE;
+        if (thenVal != desired && elseVal != invertValue(desired)
+            && (thenVal == invertValue(desired) || elseVal == desired))
+        {
+          condDesired = SAT_VALUE_FALSE;
+        }
+      }
+      pushFrame(n[0], condDesired);
+      break;
+    }
+
+    default: Unhandled() << "Unexpected Boolean operator " << k; break;
+  }
+  return undefSatLiteral;
+}
+
+void WatchedJustificationHeuristic::pushFrame(TNode n, SatValue desired)
+{
+  while (n.getKind() == kind::NOT)
+  {
+    desired = invertValue(desired);
+    n = n[0];
+  }
+  d_stack.emplace_back(n, desired);
+}
+
+void WatchedJustificationHeuristic::popJustified(SatValue value,
+                                                 int32_t level)
+{
+  Assert(level >= 0 && level <= d_satContext->getLevel());
+  Node n = d_stack.back().d_node;
+  d_stack.pop_back();
+  Trace("decision::wjh") << "wjh: justified " << n << " with " << value
+                         << " at level " << level << std::endl;
+  Assert(d_justified.find(n) == d_justified.end());
+  d_justified[n] = Justification{value, level};
+  if (d_justifiedAtLevel.size() <= static_cast<size_t>(level))
+  {
+    d_justifiedAtLevel.resize(level + 1);
+  }
+  d_justifiedAtLevel[level].push_back(n);
+}
+
+bool WatchedJustificationHeuristic::getJustification(TNode n,
+                                                     Justification& j) const
+{
+  bool negated = false;
+  while (n.getKind() == kind::NOT)
+  {
+    negated = !negated;
+    n = n[0];
+  }
+  if (n.getKind() == kind::CONST_BOOLEAN)
+  {
+    j.d_value = n.getConst<bool>() ? SAT_VALUE_TRUE : SAT_VALUE_FALSE;
+    j.d_level = 0;
+  }
+  else
+  {
+    auto it = d_justified.find(n);
+    if (it == d_justified.end())
+    {
+      return false;
+    }
+    j = it->second;
+  }
+  if (negated)
+  {
+    j.d_value = invertValue(j.d_value);
+  }
+  return true;
+}
+
+bool WatchedJustificationHeuristic::isAtom(TNode n)
+{
+  Kind k = n.getKind();
+  return k == kind::BOOLEAN_TERM_VARIABLE
+         || (theory::kindToTheoryId(k) != theory::THEORY_BOOL
+             && (k != kind::EQUAL || !n[0].getType().isBoolean()));
+}
+
+SatValue WatchedJustificationHeuristic::tryGetSatValue(TNode n) const
+{
+  return d_decisionEngine->hasSatLiteral(n) ? d_decisionEngine->getSatValue(n)
+                                            : SAT_VALUE_UNKNOWN;
+}
+
+void WatchedJustificationHeuristic::notifyAtomJustified(TNode atom,
+                                                        int32_t level)
+{
+  if (d_skolemAssertions.empty())
+  {
+    return;
+  }
+  for (const std::pair<TNode, TNode>& s : getSkolems(atom))
+  {
+    auto it = d_relevantSkolems.find(s.first);
+    if (it == d_relevantSkolems.end())
+    {
+      Trace("decision::wjh::skolems")
+          << "wjh: " << s.first << " is relevant" << std::endl;
+      d_relevantSkolems[s.first] = level;
+      d_relevantSkolemDefs.emplace_back(s.first, s.second);
+    }
+    else if (it->second > level)
+    {
+      it->second = level;
+    }
+  }
+}
+
+const WatchedJustificationHeuristic::SkolemList&
+WatchedJustificationHeuristic::getSkolems(TNode n)
+{
+  SkolemCache::const_iterator it = d_skolemCache.find(n);
+  if (it == d_skolemCache.end())
+  {
+    d_visitedComputeSkolems.clear();
+    SkolemList l;
+    computeSkolems(n, l);
+    d_skolemCache.insert(n, l);
+    it = d_skolemCache.find(n);
+  }
+  return (*it).second;
+}
+
+void WatchedJustificationHeuristic::computeSkolems(TNode n, SkolemList& l)
+{
+  d_visitedComputeSkolems.insert(n);
+  for (const TNode& c : n)
+  {
+    SkolemMap::const_iterator it = d_skolemAssertions.find(c);
+    if (it != d_skolemAssertions.end())
+    {
+      l.push_back(std::make_pair(c, (*it).second));
+      Assert(c.getNumChildren() == 0);
+    }
+    if (d_visitedComputeSkolems.find(c) == d_visitedComputeSkolems.end())
+    {
+      computeSkolems(c, l);
+    }
+  }
+}
+
+}  // namespace decision
+}  // namespace CVC4
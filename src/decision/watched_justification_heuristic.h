@@ -0,0 +1,193 @@
+/*********************                                                        */
+/*! \file watched_justification_heuristic.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Incremental justification heuristic for decision making
+ **
+ ** A variant of the justification heuristic that maintains the justification
+ ** state of the Boolean structure of the assertions incrementally, across
+ ** decisions and backtracks, instead of re-walking the assertions on each
+ ** decision.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__DECISION__WATCHED_JUSTIFICATION_HEURISTIC_H
+#define CVC4__DECISION__WATCHED_JUSTIFICATION_HEURISTIC_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "context/cdhashmap.h"
+#include "context/cdlist.h"
+#include "context/context.h"
+#include "decision/decision_strategy.h"
+#include "expr/node.h"
+#include "prop/sat_solver_types.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace decision {
+
+/**
+ * A justification heuristic with incremental justification state.
+ *
+ * A node is justified with a value once its value follows from the
+ * assignment of the SAT literals of the atoms it depends on. Each
+ * justification is recorded together with the SAT context level of the
+ * deepest assignment it depends on, which may be far below the level at
+ * which it was found. On a pop of the SAT context, only the justifications
+ * above the new level are undone, so that the justified parts of the
+ * assertions are not walked again after backtracking.
+ *
+ * The unjustified nodes on the path from the current assertion to the last
+ * decision are kept on a stack. The frame of each AND, OR and IMPLIES node
+ * watches the first child that is not justified with a non-controlling
+ * value, and consecutive calls to getNext resume from the top of the stack
+ * until the SAT context is popped.
+ *
+ * Skolem definitions from term formula removal become relevant when an atom
+ * containing the skolem is justified, and are justified after the input
+ * assertions. The weight options of the justification heuristic do not
+ * apply to this heuristic.
+ */
+class WatchedJustificationHeuristic : public ITEDecisionStrategy,
+                                      public context::ContextNotifyObj
+{
+ public:
+  WatchedJustificationHeuristic(DecisionEngine* de,
+                                context::UserContext* uc,
+                                context::Context* c);
+
+  ~WatchedJustificationHeuristic();
+
+  prop::SatLiteral getNext(bool& stopSearch) override;
+
+  /**
+   * Notify this class that assertion is an (input) assertion, not corresponding
+   * to a skolem definition.
+   */
+  void addAssertion(TNode assertion) override;
+  /**
+   * Notify this class  that lem is the skolem definition for skolem, which is
+   * a part of the current assertions.
+   */
+  void addSkolemDefinition(TNode lem, TNode skolem) override;
+
+ protected:
+  /** Undo the justifications above the new level of the SAT context */
+  void contextNotifyPop() override;
+
+ private:
+  /** The justification of a node */
+  struct Justification
+  {
+    /** The value the node is justified with */
+    prop::SatValue d_value;
+    /** The SAT context level at which the justification became valid */
+    int32_t d_level;
+  };
+
+  /** An unjustified node on the path to the current decision */
+  struct Frame
+  {
+    Frame(TNode node, prop::SatValue desired)
+        : d_node(node), d_desired(desired), d_watch(0), d_level(0)
+    {
+    }
+    /** The node, which is not a negation */
+    TNode d_node;
+    /** The value we want to justify the node with */
+    prop::SatValue d_desired;
+    /**
+     * For AND, OR and IMPLIES, the child this frame watches. The children
+     * before it are justified with a non-controlling value.
+     */
+    size_t d_watch;
+    /** The maximal justification level of the children before d_watch */
+    int32_t d_level;
+  };
+
+  typedef std::vector<std::pair<TNode, TNode>> SkolemList;
+  typedef context::CDHashMap<TNode, SkolemList, TNodeHashFunction> SkolemCache;
+  typedef context::CDHashMap<TNode, TNode, TNodeHashFunction> SkolemMap;
+
+  /** Get the next decision, or undefSatLiteral if all roots are justified */
+  prop::SatLiteral findNext();
+  /**
+   * Processes the frame on top of the stack, which either pops it, pushes
+   * the frame of a child, or returns a decision.
+   */
+  prop::SatLiteral processTop();
+  /** Get the first root that is not justified, or the null node */
+  TNode getNextRoot();
+  /** Drop the justified prefix of the assertions removed by a user pop */
+  void trimJustifiedPrefix();
+
+  /** Push a frame for node n with the desired value */
+  void pushFrame(TNode n, prop::SatValue desired);
+  /** Justify the node of the top frame and pop it */
+  void popJustified(prop::SatValue value, int32_t level);
+  /** Get the justification of n, returns false if n is not justified */
+  bool getJustification(TNode n, Justification& j) const;
+
+  /** Is n an atom for this heuristic? */
+  static bool isAtom(TNode n);
+  /** Get the value of the SAT literal of n, if there is one */
+  prop::SatValue tryGetSatValue(TNode n) const;
+
+  /** Make the skolem definitions of the skolems in atom relevant */
+  void notifyAtomJustified(TNode atom, int32_t level);
+  /** Get the skolems introduced by term removal in n with their definition */
+  const SkolemList& getSkolems(TNode n);
+  /** Compute all term-removal skolems in n recursively */
+  void computeSkolems(TNode n, SkolemList& l);
+
+  /** The SAT context */
+  context::Context* d_satContext;
+
+  /** The input assertions that need to be justified */
+  context::CDList<Node> d_assertions;
+  /** Map from skolems introduced by term removal to their definition */
+  SkolemMap d_skolemAssertions;
+  /** Cache for the skolems of atoms */
+  SkolemCache d_skolemCache;
+  /** Visited set of computeSkolems */
+  std::unordered_set<TNode, TNodeHashFunction> d_visitedComputeSkolems;
+
+  /** The justified nodes, which are not negations */
+  std::unordered_map<Node, Justification, NodeHashFunction> d_justified;
+  /** The nodes justified at each SAT context level */
+  std::vector<std::vector<Node>> d_justifiedAtLevel;
+  /**
+   * The number of leading assertions that are justified, with the level of
+   * the deepest of their justifications, at the points where it increased.
+   */
+  std::vector<std::pair<size_t, int32_t>> d_justifiedPrefix;
+  /** The level at which each relevant skolem definition became relevant */
+  std::unordered_map<Node, int32_t, NodeHashFunction> d_relevantSkolems;
+  /** The relevant skolem definitions, in order */
+  std::vector<std::pair<Node, Node>> d_relevantSkolemDefs;
+  /** The path to the current decision */
+  std::vector<Frame> d_stack;
+
+  /** Number of decisions made */
+  IntStat d_helpfulness;
+  /** Number of calls to getNext that resumed from the previous decision */
+  IntStat d_resumes;
+  /** Number of justifications that were kept when backtracking */
+  IntStat d_retained;
+  /** Time spent in getNext */
+  TimerStat d_timestat;
+}; /* class WatchedJustificationHeuristic */
+
+}  // namespace decision
+}  // namespace CVC4
+
+#endif /* CVC4__DECISION__WATCHED_JUSTIFICATION_HEURISTIC_H */
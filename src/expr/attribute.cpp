@@ -26,9 +26,15 @@ namespace CVC4 {
 namespace expr {
 namespace attr {
 
-AttributeManager::AttributeManager() :
-  d_inGarbageCollection(false)
-{}
+AttributeManager::AttributeManager()
+    : d_inGarbageCollection(false),
+      d_ints("uint64"),
+      d_tnodes("tnode"),
+      d_nodes("node"),
+      d_types("type"),
+      d_strings("string")
+{
+}
 
 bool AttributeManager::inGarbageCollection() const {
   return d_inGarbageCollection;
@@ -45,11 +51,11 @@ void AttributeManager::debugHook(int debugFlag) {
 void AttributeManager::deleteAllAttributes(NodeValue* nv) {
   Assert(!inGarbageCollection());
   d_bools.erase(nv);
-  deleteFromTable(d_ints, nv);
-  deleteFromTable(d_tnodes, nv);
-  deleteFromTable(d_nodes, nv);
-  deleteFromTable(d_types, nv);
-  deleteFromTable(d_strings, nv);
+  d_ints.erase(nv);
+  d_tnodes.erase(nv);
+  d_nodes.erase(nv);
+  d_types.erase(nv);
+  d_strings.erase(nv);
 }
 
 void AttributeManager::deleteAllAttributes() {
@@ -75,7 +81,6 @@ void AttributeManager::deleteAttributes(const AttrIdVec& atids) {
     Assert(((*it).first) <= LastAttrTable);
     AttrTableId tableId = (AttrTableId) ((*it).first);
     std::vector< uint64_t>& ids = (*it).second;
-    std::sort(ids.begin(), ids.end());
 
     switch(tableId) {
     case AttrTableBool:
@@ -114,6 +119,24 @@ void AttributeManager::deleteAttributes(const AttrIdVec& atids) {
   }
 }
 
+void AttributeManager::registerStatistics(StatisticsRegistry* sr)
+{
+  d_ints.registerStatistics(sr);
+  d_tnodes.registerStatistics(sr);
+  d_nodes.registerStatistics(sr);
+  d_types.registerStatistics(sr);
+  d_strings.registerStatistics(sr);
+}
+
+void AttributeManager::unregisterStatistics(StatisticsRegistry* sr)
+{
+  d_ints.unregisterStatistics(sr);
+  d_tnodes.unregisterStatistics(sr);
+  d_nodes.unregisterStatistics(sr);
+  d_types.unregisterStatistics(sr);
+  d_strings.unregisterStatistics(sr);
+}
+
 }/* CVC4::expr::attr namespace */
 }/* CVC4::expr namespace */
 }/* CVC4 namespace */
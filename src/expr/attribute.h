@@ -82,18 +82,12 @@ namespace attr {
  */
 class AttributeManager {
 
-  template <class T>
-  void deleteFromTable(AttrHash<T>& table, NodeValue* nv);
-
   template <class T>
   void deleteAllFromTable(AttrHash<T>& table);
 
   template <class T>
   void deleteAttributesFromTable(AttrHash<T>& table, const std::vector<uint64_t>& ids);
 
-  template <class T>
-  void reconstructTable(AttrHash<T>& table);
-
   /**
    * getTable<> is a helper template that gets the right table from an
    * AttributeManager given its type.
@@ -195,6 +189,12 @@ public:
    */
   bool inGarbageCollection() const ;
 
+  /** Register the statistics of the attribute tables with sr. */
+  void registerStatistics(StatisticsRegistry* sr);
+
+  /** Unregister the statistics of the attribute tables from sr. */
+  void unregisterStatistics(StatisticsRegistry* sr);
+
   /**
    * Determines the AttrTableId of an attribute.
    *
@@ -466,19 +466,7 @@ AttributeManager::setAttribute(NodeValue* nv,
 
   table_type& ah =
       getTable<value_type, AttrKind::context_dependent>::get(*this);
-  ah[std::make_pair(AttrKind::getId(), nv)] = mapping::convert(value);
-}
-
-/** Search for the NodeValue in all attribute tables and remove it. */
-template <class T>
-inline void AttributeManager::deleteFromTable(AttrHash<T>& table,
-                                              NodeValue* nv) {
-  // This cannot use nv as anything other than a pointer!
-  const uint64_t last = attr::LastAttributeId<T, false>::getId();
-  for (uint64_t id = 0; id < last; ++id)
-  {
-    table.erase(std::make_pair(id, nv));
-  }
+  ah.set(std::make_pair(AttrKind::getId(), nv), mapping::convert(value));
 }
 
 /** Remove all attributes from the table. */
@@ -502,57 +490,27 @@ AttributeUniqueId AttributeManager::getAttributeId(const AttrKind& attr){
 template <class T>
 void AttributeManager::deleteAttributesFromTable(AttrHash<T>& table, const std::vector<uint64_t>& ids){
   d_inGarbageCollection = true;
-  typedef AttrHash<T> hash_t;
-
-  typename hash_t::iterator it = table.begin();
-  typename hash_t::iterator tmp;
-  typename hash_t::iterator it_end = table.end();
-
-  std::vector<uint64_t>::const_iterator begin_ids = ids.begin();
-  std::vector<uint64_t>::const_iterator end_ids = ids.end();
-
-  size_t initialSize = table.size();
-  while (it != it_end){
-    uint64_t id = (*it).first.first;
-
-    if(std::binary_search(begin_ids, end_ids, id)){
-      tmp = it;
-      ++it;
-      table.erase(tmp);
-    }else{
-      ++it;
-    }
-  }
-  d_inGarbageCollection = false;
-  static const size_t ReconstructShrinkRatio = 8;
-  if(initialSize/ReconstructShrinkRatio > table.size()){
-    reconstructTable(table);
+  for (uint64_t id : ids)
+  {
+    table.clearAttribute(id);
   }
-}
-
-template <class T>
-void AttributeManager::reconstructTable(AttrHash<T>& table){
-  d_inGarbageCollection = true;
-  typedef AttrHash<T> hash_t;
-  hash_t cpy;
-  cpy.insert(table.begin(), table.end());
-  cpy.swap(table);
   d_inGarbageCollection = false;
 }
 
-
 }/* CVC4::expr::attr namespace */
 }/* CVC4::expr namespace */
 
 template <class AttrKind>
 inline typename AttrKind::value_type
 NodeManager::getAttribute(expr::NodeValue* nv, const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(nv, AttrKind());
 }
 
 template <class AttrKind>
 inline bool NodeManager::hasAttribute(expr::NodeValue* nv,
                                       const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->hasAttribute(nv, AttrKind());
 }
 
@@ -560,6 +518,7 @@ template <class AttrKind>
 inline bool
 NodeManager::getAttribute(expr::NodeValue* nv, const AttrKind&,
                           typename AttrKind::value_type& ret) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(nv, AttrKind(), ret);
 }
 
@@ -567,18 +526,21 @@ template <class AttrKind>
 inline void
 NodeManager::setAttribute(expr::NodeValue* nv, const AttrKind&,
                           const typename AttrKind::value_type& value) {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   d_attrManager->setAttribute(nv, AttrKind(), value);
 }
 
 template <class AttrKind>
 inline typename AttrKind::value_type
 NodeManager::getAttribute(TNode n, const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(n.d_nv, AttrKind());
 }
 
 template <class AttrKind>
 inline bool
 NodeManager::hasAttribute(TNode n, const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->hasAttribute(n.d_nv, AttrKind());
 }
 
@@ -586,6 +548,7 @@ template <class AttrKind>
 inline bool
 NodeManager::getAttribute(TNode n, const AttrKind&,
                           typename AttrKind::value_type& ret) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(n.d_nv, AttrKind(), ret);
 }
 
@@ -593,18 +556,21 @@ template <class AttrKind>
 inline void
 NodeManager::setAttribute(TNode n, const AttrKind&,
                           const typename AttrKind::value_type& value) {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   d_attrManager->setAttribute(n.d_nv, AttrKind(), value);
 }
 
 template <class AttrKind>
 inline typename AttrKind::value_type
 NodeManager::getAttribute(TypeNode n, const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(n.d_nv, AttrKind());
 }
 
 template <class AttrKind>
 inline bool
 NodeManager::hasAttribute(TypeNode n, const AttrKind&) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->hasAttribute(n.d_nv, AttrKind());
 }
 
@@ -612,6 +578,7 @@ template <class AttrKind>
 inline bool
 NodeManager::getAttribute(TypeNode n, const AttrKind&,
                           typename AttrKind::value_type& ret) const {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   return d_attrManager->getAttribute(n.d_nv, AttrKind(), ret);
 }
 
@@ -619,6 +586,7 @@ template <class AttrKind>
 inline void
 NodeManager::setAttribute(TypeNode n, const AttrKind&,
                           const typename AttrKind::value_type& value) {
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   d_attrManager->setAttribute(n.d_nv, AttrKind(), value);
 }
 
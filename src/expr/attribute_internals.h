@@ -23,7 +23,12 @@
 #ifndef CVC4__EXPR__ATTRIBUTE_INTERNALS_H
 #define CVC4__EXPR__ATTRIBUTE_INTERNALS_H
 
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "util/statistics_registry.h"
 
 namespace CVC4 {
 namespace expr {
@@ -32,17 +37,6 @@ namespace expr {
 
 namespace attr {
 
-/**
- * A hash function for attribute table keys.  Attribute table keys are
- * pairs, (unique-attribute-id, Node).
- */
-struct AttrHashFunction {
-  enum { LARGE_PRIME = 32452843ul };
-  std::size_t operator()(const std::pair<uint64_t, NodeValue*>& p) const {
-    return p.first * LARGE_PRIME + p.second->getId();
-  }
-};/* struct AttrHashFunction */
-
 /**
  * A hash function for boolean-valued attribute table keys; here we
  * don't have to store a pair as the key, because we use a known bit
@@ -146,15 +140,305 @@ inline uint64_t GetBitSet(uint64_t bit)
 }
 
 /**
- * An "AttrHash<value_type>"---the hash table underlying
- * attributes---is simply a mapping of pair<unique-attribute-id, Node>
- * to value_type using our specialized hash function for these pairs.
+ * An open-addressing hash table that maps NodeValues to values of type V.
+ * It stores the entries of a single attribute (see AttrHash).
+ *
+ * Collisions are resolved by linear probing, and entries are erased by
+ * shifting the following entries of their probe sequence backwards, so that
+ * the table never contains tombstones. Values are released only once the
+ * table is consistent again, since releasing a Node may trigger garbage
+ * collection, which in turn erases entries from attribute tables.
+ */
+template <class V>
+class AttrTable
+{
+ public:
+  typedef std::pair<NodeValue*, V> Slot;
+
+  AttrTable() : d_size(0), d_mask(0), d_shift(64) {}
+
+  /** Returns the slot of nv, or nullptr if nv has no entry. */
+  const Slot* find(NodeValue* nv) const
+  {
+    if (d_size == 0)
+    {
+      return nullptr;
+    }
+    for (size_t i = home(nv);; i = (i + 1) & d_mask)
+    {
+      const Slot& slot = d_slots[i];
+      if (slot.first == nv)
+      {
+        return &slot;
+      }
+      if (slot.first == nullptr)
+      {
+        return nullptr;
+      }
+    }
+  }
+
+  /**
+   * Set the value of nv to v. Returns true if nv did not have an entry
+   * before.
+   */
+  bool set(NodeValue* nv, const V& v)
+  {
+    if ((d_size + 1) * 4 > d_slots.size() * 3)
+    {
+      grow();
+    }
+    size_t i = home(nv);
+    while (d_slots[i].first != nullptr && d_slots[i].first != nv)
+    {
+      i = (i + 1) & d_mask;
+    }
+    // the previous value is released at the end of the scope
+    V old(v);
+    std::swap(old, d_slots[i].second);
+    if (d_slots[i].first == nullptr)
+    {
+      d_slots[i].first = nv;
+      ++d_size;
+      return true;
+    }
+    return false;
+  }
+
+  /** Erase the entry of nv. Returns true if nv had an entry. */
+  bool erase(NodeValue* nv)
+  {
+    if (d_size == 0)
+    {
+      return false;
+    }
+    size_t i = home(nv);
+    while (d_slots[i].first != nv)
+    {
+      if (d_slots[i].first == nullptr)
+      {
+        return false;
+      }
+      i = (i + 1) & d_mask;
+    }
+    // the erased value is released at the end of the scope
+    V old;
+    std::swap(old, d_slots[i].second);
+    d_slots[i].first = nullptr;
+    --d_size;
+    // move entries that can no longer be reached from their home slot
+    size_t hole = i;
+    for (size_t j = (i + 1) & d_mask; d_slots[j].first != nullptr;
+         j = (j + 1) & d_mask)
+    {
+      size_t h = home(d_slots[j].first);
+      if (((j - h) & d_mask) >= ((j - hole) & d_mask))
+      {
+        std::swap(d_slots[hole], d_slots[j]);
+        hole = j;
+      }
+    }
+    return true;
+  }
+
+  /** Erase all entries and release the memory of the table. */
+  void clear()
+  {
+    // the erased values are released at the end of the scope
+    std::vector<Slot> old;
+    old.swap(d_slots);
+    d_size = 0;
+    d_mask = 0;
+    d_shift = 64;
+  }
+
+  size_t size() const { return d_size; }
+
+  /** Apply f to the NodeValue and value of each entry. */
+  template <class F>
+  void forEach(F f) const
+  {
+    for (const Slot& slot : d_slots)
+    {
+      if (slot.first != nullptr)
+      {
+        f(slot.first, slot.second);
+      }
+    }
+  }
+
+ private:
+  /** The home slot of nv, using Fibonacci hashing of the node id. */
+  size_t home(const NodeValue* nv) const
+  {
+    return static_cast<size_t>((nv->getId() * 0x9e3779b97f4a7c15ULL)
+                               >> d_shift);
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old(d_slots.size() == 0 ? 16 : 2 * d_slots.size());
+    old.swap(d_slots);
+    d_mask = d_slots.size() - 1;
+    d_shift = 64;
+    for (size_t n = d_slots.size(); n > 1; n >>= 1)
+    {
+      --d_shift;
+    }
+    for (Slot& slot : old)
+    {
+      if (slot.first != nullptr)
+      {
+        size_t i = home(slot.first);
+        while (d_slots[i].first != nullptr)
+        {
+          i = (i + 1) & d_mask;
+        }
+        d_slots[i].first = slot.first;
+        std::swap(d_slots[i].second, slot.second);
+      }
+    }
+  }
+
+  /** The slots, the size is zero or a power of two */
+  std::vector<Slot> d_slots;
+  /** The number of entries */
+  size_t d_size;
+  /** d_slots.size() - 1 */
+  size_t d_mask;
+  /** 64 - log2(d_slots.size()) */
+  unsigned d_shift;
+};/* class AttrTable<> */
+
+/**
+ * An "AttrHash<value_type>"---the table underlying attributes---is a
+ * mapping of pair<unique-attribute-id, Node> to value_type. It keeps a
+ * separate AttrTable for each attribute id, such that lookups only probe the
+ * entries of one attribute and all entries of an attribute can be dropped at
+ * once.
  */
 template <class value_type>
-class AttrHash :
-    public std::unordered_map<std::pair<uint64_t, NodeValue*>,
-                               value_type,
-                               AttrHashFunction> {
+class AttrHash
+{
+ public:
+  typedef typename AttrTable<value_type>::Slot Slot;
+  /** Points to the (NodeValue, value) pair of an entry */
+  typedef const Slot* const_iterator;
+
+  /**
+   * Construct the table. The statistics are named
+   * expr::AttributeManager::<name>::*.
+   */
+  explicit AttrHash(const std::string& name)
+      : d_hits("expr::AttributeManager::" + name + "::hits"),
+        d_misses("expr::AttributeManager::" + name + "::misses"),
+        d_size(0),
+        d_sizeStat("expr::AttributeManager::" + name + "::size", d_size)
+  {
+  }
+
+  /** Find an entry. Returns something == end() if not found. */
+  const_iterator find(const std::pair<uint64_t, NodeValue*>& k) const
+  {
+    const Slot* res = nullptr;
+    if (k.first < d_tables.size())
+    {
+      res = d_tables[k.first].find(k.second);
+    }
+    if (res == nullptr)
+    {
+      ++d_misses;
+    }
+    else
+    {
+      ++d_hits;
+    }
+    return res;
+  }
+
+  /** The "off the end" const_iterator */
+  const_iterator end() const { return nullptr; }
+
+  /** Set the value of an entry, inserting it if necessary. */
+  void set(const std::pair<uint64_t, NodeValue*>& k, const value_type& v)
+  {
+    if (k.first >= d_tables.size())
+    {
+      d_tables.resize(k.first + 1);
+    }
+    if (d_tables[k.first].set(k.second, v))
+    {
+      ++d_size;
+    }
+  }
+
+  /** Delete the entries of all attributes of the given node. */
+  void erase(NodeValue* nv)
+  {
+    for (AttrTable<value_type>& t : d_tables)
+    {
+      if (t.size() > 0 && t.erase(nv))
+      {
+        --d_size;
+      }
+    }
+  }
+
+  /** Delete all entries of the attribute with the given id. */
+  void clearAttribute(uint64_t id)
+  {
+    if (id < d_tables.size())
+    {
+      d_size -= d_tables[id].size();
+      d_tables[id].clear();
+    }
+  }
+
+  /** Delete all entries. */
+  void clear()
+  {
+    for (AttrTable<value_type>& t : d_tables)
+    {
+      t.clear();
+    }
+    d_size = 0;
+  }
+
+  /** Is the table empty? */
+  bool empty() const { return d_size == 0; }
+
+  /** The number of entries in the table. */
+  size_t size() const { return d_size; }
+
+  /** Register the statistics of this table with sr. */
+  void registerStatistics(StatisticsRegistry* sr)
+  {
+    sr->registerStat(&d_hits);
+    sr->registerStat(&d_misses);
+    sr->registerStat(&d_sizeStat);
+  }
+
+  /** Unregister the statistics of this table from sr. */
+  void unregisterStatistics(StatisticsRegistry* sr)
+  {
+    sr->unregisterStat(&d_hits);
+    sr->unregisterStat(&d_misses);
+    sr->unregisterStat(&d_sizeStat);
+  }
+
+ private:
+  /** The tables, indexed by attribute id */
+  std::vector<AttrTable<value_type>> d_tables;
+  /**
+   * The number of successful lookups. Lookups are frequent, and made from
+   * several threads if nodes are thread safe.
+   */
+  mutable CounterStat d_hits;
+  /** The number of unsuccessful lookups */
+  mutable CounterStat d_misses;
+  /** The number of entries in all tables */
+  uint64_t d_size;
+  ReferenceStat<uint64_t> d_sizeStat;
 };/* class AttrHash<> */
 
 /**
@@ -338,6 +622,11 @@ public:
     return BitAccessor(word, k.first);
   }
 
+  /** Set the flag k to b. */
+  void set(const std::pair<uint64_t, NodeValue*>& k, bool b) {
+    (*this)[k] = b;
+  }
+
   /**
    * Delete all flags from the given node.
    */
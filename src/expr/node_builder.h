@@ -850,24 +850,34 @@ void NodeBuilder<nchild_thresh>::decrRefCounts() {
 
 template <unsigned nchild_thresh>
 TypeNode NodeBuilder<nchild_thresh>::constructTypeNode() {
-  return TypeNode(constructNV());
+  expr::NodeValue* nv = constructNV();
+  TypeNode tn(nv);
+  d_nm->unpinNodeValue(nv);
+  return tn;
 }
 
 template <unsigned nchild_thresh>
 TypeNode NodeBuilder<nchild_thresh>::constructTypeNode() const {
-  return TypeNode(constructNV());
+  expr::NodeValue* nv = constructNV();
+  TypeNode tn(nv);
+  d_nm->unpinNodeValue(nv);
+  return tn;
 }
 
 template <unsigned nchild_thresh>
 Node NodeBuilder<nchild_thresh>::constructNode() {
-  Node n = Node(constructNV());
+  expr::NodeValue* nv = constructNV();
+  Node n = Node(nv);
+  d_nm->unpinNodeValue(nv);
   maybeCheckType(n);
   return n;
 }
 
 template <unsigned nchild_thresh>
 Node NodeBuilder<nchild_thresh>::constructNode() const {
-  Node n = Node(constructNV());
+  expr::NodeValue* nv = constructNV();
+  Node n = Node(nv);
+  d_nm->unpinNodeValue(nv);
   maybeCheckType(n);
   return n;
 }
@@ -876,14 +886,18 @@ template <unsigned nchild_thresh>
 Node* NodeBuilder<nchild_thresh>::constructNodePtr() {
   // maybeCheckType() can throw an exception. Make sure to call the destructor
   // on the exception branch.
-  std::unique_ptr<Node> np(new Node(constructNV()));
+  expr::NodeValue* nv = constructNV();
+  std::unique_ptr<Node> np(new Node(nv));
+  d_nm->unpinNodeValue(nv);
   maybeCheckType(*np.get());
   return np.release();
 }
 
 template <unsigned nchild_thresh>
 Node* NodeBuilder<nchild_thresh>::constructNodePtr() const {
-  std::unique_ptr<Node> np(new Node(constructNV()));
+  expr::NodeValue* nv = constructNV();
+  std::unique_ptr<Node> np(new Node(nv));
+  d_nm->unpinNodeValue(nv);
   maybeCheckType(*np.get());
   return np.release();
 }
@@ -933,17 +947,14 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
            "no children permitted";
 
     // we have to copy the inline NodeValue out
-    expr::NodeValue* nv = (expr::NodeValue*)
-      std::malloc(sizeof(expr::NodeValue));
-    if(nv == NULL) {
-      throw std::bad_alloc();
-    }
+    expr::NodeValue* nv = d_nm->d_nvAllocator.allocate(0);
     // there are no children, so we don't have to worry about
     // reference counts in this case.
     nv->d_nchildren = 0;
     nv->d_kind = d_nv->d_kind;
-    nv->d_id = d_nm->next_id++;// FIXME multithreading
+    nv->d_id = d_nm->next_id++;
     nv->d_rc = 0;
+    d_nm->pinNodeValue(nv);
     setUsed();
     if(Debug.isOn("gc")) {
       Debug("gc") << "creating node value " << nv
@@ -1011,15 +1022,11 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
        * reference count. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_inlineNv.d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv =
+          d_nm->d_nvAllocator.allocate(d_inlineNv.d_nchildren);
       nv->d_nchildren = d_inlineNv.d_nchildren;
       nv->d_kind = d_inlineNv.d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_inlineNv.d_children,
@@ -1030,7 +1037,7 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
       setUsed();
 
       //poolNv = nv;
-      d_nm->poolInsert(nv);
+      nv = d_nm->poolInsert(nv);
       if(Debug.isOn("gc")) {
         Debug("gc") << "creating node value " << nv
                     << " [" << nv->d_id << "]: ";
@@ -1064,22 +1071,40 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
       /* Subcase (b) The Node under construction is NOT already in the
        * NodeManager's pool. */
 
-      /* 2(b). The heap-allocated d_nv is "cropped" to the correct
-       * size (based on the number of children it _actually_ has).
-       * d_nv is repointed to d_inlineNv so that destruction of the
-       * NodeBuilder doesn't cause any problems, and the (old) value
-       * it had is placed into the NodeManager's pool and returned in
-       * a Node wrapper. */
-
-      crop();
-      expr::NodeValue* nv = d_nv;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      /* 2(b). If the NodeValue is small enough to be allocated by the
+       * NodeManager's slab allocator, it is moved there (taking over
+       * the child reference counts) and the heap-allocated d_nv is
+       * freed.  Otherwise, the heap-allocated d_nv is "cropped" to the
+       * correct size (based on the number of children it _actually_
+       * has).  d_nv is repointed to d_inlineNv so that destruction of
+       * the NodeBuilder doesn't cause any problems, and the new value
+       * is placed into the NodeManager's pool and returned in a Node
+       * wrapper. */
+
+      expr::NodeValue* nv;
+      if (d_nv->d_nchildren <= expr::NodeValueAllocator::MAX_SLAB_CHILDREN)
+      {
+        nv = d_nm->d_nvAllocator.allocate(d_nv->d_nchildren);
+        nv->d_nchildren = d_nv->d_nchildren;
+        nv->d_kind = d_nv->d_kind;
+        nv->d_rc = 0;
+        std::copy(d_nv->d_children,
+                  d_nv->d_children + d_nv->d_nchildren,
+                  nv->d_children);
+        free(d_nv);
+      }
+      else
+      {
+        crop();
+        nv = d_nv;
+      }
+      nv->d_id = d_nm->next_id++;
       d_nv = &d_inlineNv;
       d_nvMaxChildren = nchild_thresh;
       setUsed();
 
       //poolNv = nv;
-      d_nm->poolInsert(nv);
+      nv = d_nm->poolInsert(nv);
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
@@ -1113,17 +1138,14 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
            "no children permitted";
 
     // we have to copy the inline NodeValue out
-    expr::NodeValue* nv = (expr::NodeValue*)
-      std::malloc(sizeof(expr::NodeValue));
-    if(nv == NULL) {
-      throw std::bad_alloc();
-    }
+    expr::NodeValue* nv = d_nm->d_nvAllocator.allocate(0);
     // there are no children, so we don't have to worry about
     // reference counts in this case.
     nv->d_nchildren = 0;
     nv->d_kind = d_nv->d_kind;
-    nv->d_id = d_nm->next_id++;// FIXME multithreading
+    nv->d_id = d_nm->next_id++;
     nv->d_rc = 0;
+    d_nm->pinNodeValue(nv);
     Debug("gc") << "creating node value " << nv
                 << " [" << nv->d_id << "]: " << *nv << "\n";
     return nv;
@@ -1188,15 +1210,11 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
        * count. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_inlineNv.d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv =
+          d_nm->d_nvAllocator.allocate(d_inlineNv.d_nchildren);
       nv->d_nchildren = d_inlineNv.d_nchildren;
       nv->d_kind = d_inlineNv.d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_inlineNv.d_children,
@@ -1210,7 +1228,7 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
       }
 
       //poolNv = nv;
-      d_nm->poolInsert(nv);
+      nv = d_nm->poolInsert(nv);
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
@@ -1242,15 +1260,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
        * decremented to match at NodeBuilder destruction time. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_nv->d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv = d_nm->d_nvAllocator.allocate(d_nv->d_nchildren);
       nv->d_nchildren = d_nv->d_nchildren;
       nv->d_kind = d_nv->d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_nv->d_children,
@@ -1264,7 +1277,7 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
       }
 
       //poolNv = nv;
-      d_nm->poolInsert(nv);
+      nv = d_nm->poolInsert(nv);
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
@@ -49,10 +49,16 @@ namespace {
  * to false on destruction. This can be used to make sure a flag gets toggled
  * in a function even on exceptional exit (e.g., see reclaimZombies()).
  */
+#ifdef CVC4_THREAD_SAFE_NODES
+using ReclaimFlag = std::atomic<bool>;
+#else
+using ReclaimFlag = bool;
+#endif
+
 struct ScopedBool {
-  bool& d_value;
+  ReclaimFlag& d_value;
 
-  ScopedBool(bool& value) :
+  ScopedBool(ReclaimFlag& value) :
     d_value(value) {
 
     Debug("gc") << ">> setting ScopedBool\n";
@@ -105,6 +111,8 @@ NodeManager::NodeManager(ExprManager* exprManager)
       d_abstractValueCount(0),
       d_skolemCounter(0)
 {
+  d_nvAllocator.registerStatistics(d_statisticsRegistry);
+  d_attrManager->registerStatistics(d_statisticsRegistry);
   init();
 }
 
@@ -178,7 +186,7 @@ void NodeManager::init() {
   // call `NodeValue::inc()` which uses `NodeManager::curentNM()`
   NodeManagerScope nms(this);
 
-  poolInsert( &expr::NodeValue::null() );
+  d_nodeValuePool.insert(&expr::NodeValue::null());
 
   for(unsigned i = 0; i < unsigned(kind::LAST_KIND); ++i) {
     Kind k = Kind(i);
@@ -204,6 +212,7 @@ NodeManager::~NodeManager() {
     ScopedBool dontGC(d_inReclaimZombies);
     // hopefully by this point all SmtEngines have been deleted
     // already, along with all their attributes
+    std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
     d_attrManager->deleteAllAttributes();
   }
 
@@ -249,19 +258,16 @@ NodeManager::~NodeManager() {
 
   if(Debug.isOn("gc:leaks")) {
     Debug("gc:leaks") << "still in pool:" << endl;
-    for(NodeValuePool::const_iterator i = d_nodeValuePool.begin(),
-          iend = d_nodeValuePool.end();
-        i != iend;
-        ++i) {
-      Debug("gc:leaks") << "  " << *i
-                        << " id=" << (*i)->d_id
-                        << " rc=" << (*i)->d_rc
-                        << " " << **i << endl;
-    }
+    d_nodeValuePool.forEach([](NodeValue* nv) {
+      Debug("gc:leaks") << "  " << nv << " id=" << nv->d_id
+                        << " rc=" << nv->d_rc << " " << *nv << endl;
+    });
     Debug("gc:leaks") << ":end:" << endl;
   }
 
   // defensive coding, in case destruction-order issues pop up (they often do)
+  d_nvAllocator.unregisterStatistics(d_statisticsRegistry);
+  d_attrManager->unregisterStatistics(d_statisticsRegistry);
   delete d_statisticsRegistry;
   d_statisticsRegistry = NULL;
   delete d_attrManager;
@@ -284,14 +290,20 @@ const DType& NodeManager::getDTypeForIndex(size_t index) const
 }
 
 void NodeManager::reclaimZombies() {
-  // FIXME multithreading
   Assert(!d_attrManager->inGarbageCollection());
 
-  Debug("gc") << "reclaiming " << d_zombies.size() << " zombie(s)!\n";
-
+#ifdef CVC4_THREAD_SAFE_NODES
+  // only one thread reclaims zombies at a time, others keep going
+  bool expected = false;
+  if (!d_inReclaimZombies.compare_exchange_strong(expected, true))
+  {
+    return;
+  }
+#else
   // during reclamation, reclaimZombies() is never supposed to be called
   Assert(!d_inReclaimZombies)
       << "NodeManager::reclaimZombies() not re-entrant!";
+#endif
 
   // whether exit is normal or exceptional, the Reclaim dtor is called
   // and ensures that d_inReclaimZombies is set back to false.
@@ -311,12 +323,20 @@ void NodeManager::reclaimZombies() {
   // iterator, causing a crash.  So we need to copy the set away.
 
   vector<NodeValue*> zombies;
-  zombies.reserve(d_zombies.size());
-  remove_copy_if(d_zombies.begin(),
-                 d_zombies.end(),
-                 back_inserter(zombies),
-                 NodeValueReferenceCountNonZero());
-  d_zombies.clear();
+  {
+    std::lock_guard<expr::PoolMutex> guard(d_zombiesMutex);
+    Debug("gc") << "reclaiming " << d_zombies.size() << " zombie(s)!\n";
+    zombies.reserve(d_zombies.size());
+    remove_copy_if(d_zombies.begin(),
+                   d_zombies.end(),
+                   back_inserter(zombies),
+                   NodeValueReferenceCountNonZero());
+    d_zombies.clear();
+  }
+
+  // the memory of the reclaimed NodeValues is released in one batch at the end
+  vector<NodeValue*> reclaimed;
+  reclaimed.reserve(zombies.size());
 
 #ifdef _LIBCPP_VERSION
   NodeValue* last = NULL;
@@ -335,59 +355,86 @@ void NodeManager::reclaimZombies() {
 #endif
 
     // collect ONLY IF still zero
-    if(nv->d_rc == 0) {
-      if(Debug.isOn("gc")) {
-        Debug("gc") << "deleting node value " << nv
-                    << " [" << nv->d_id << "]: ";
-        nv->printAst(Debug("gc"));
-        Debug("gc") << endl;
-      }
+    if (!removeIfDead(nv))
+    {
+      continue;
+    }
+    kind::MetaKind mk = nv->getMetaKind();
+    if(Debug.isOn("gc")) {
+      Debug("gc") << "deleting node value " << nv
+                  << " [" << nv->d_id << "]: ";
+      nv->printAst(Debug("gc"));
+      Debug("gc") << endl;
+    }
 
-      // remove from the pool
-      kind::MetaKind mk = nv->getMetaKind();
-      if(mk != kind::metakind::VARIABLE && mk != kind::metakind::NULLARY_OPERATOR) {
-        poolRemove(nv);
+    // whether exit is normal or exceptional, the NVReclaim dtor is
+    // called and ensures that d_nodeUnderDeletion is set back to
+    // NULL.
+    NVReclaim rc(d_nodeUnderDeletion);
+    d_nodeUnderDeletion = nv;
+
+    { // notify listeners of deleted node
+      TNode n;
+      n.d_nv = nv;
+      nv->d_rc = 1; // so that TNode doesn't assert-fail
+      for (NodeManagerListener* listener : d_listeners)
+      {
+        listener->nmNotifyDeleteNode(n);
       }
-
-      // whether exit is normal or exceptional, the NVReclaim dtor is
-      // called and ensures that d_nodeUnderDeletion is set back to
-      // NULL.
-      NVReclaim rc(d_nodeUnderDeletion);
-      d_nodeUnderDeletion = nv;
-
+      // this would mean that one of the listeners stowed away
+      // a reference to this node!
+      Assert(nv->d_rc == 1);
+    }
+    nv->d_rc = 0;
+    {
       // remove attributes
-      { // notify listeners of deleted node
-        TNode n;
-        n.d_nv = nv;
-        nv->d_rc = 1; // so that TNode doesn't assert-fail
-        for (NodeManagerListener* listener : d_listeners)
-        {
-          listener->nmNotifyDeleteNode(n);
-        }
-        // this would mean that one of the listeners stowed away
-        // a reference to this node!
-        Assert(nv->d_rc == 1);
-      }
-      nv->d_rc = 0;
+      std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
       d_attrManager->deleteAllAttributes(nv);
+    }
 
-      // decr ref counts of children
-      nv->decrRefCounts();
-      if(mk == kind::metakind::CONSTANT) {
-        // Destroy (call the destructor for) the C++ type representing
-        // the constant in this NodeValue.  This is needed for
-        // e.g. CVC4::Rational, since it has a gmp internal
-        // representation that mallocs memory and should be cleaned
-        // up.  (This won't delete a pointer value if used as a
-        // constant, but then, you should probably use a smart-pointer
-        // type for a constant payload.)
-        kind::metakind::deleteNodeValueConstant(nv);
-      }
-      free(nv);
+    // decr ref counts of children
+    nv->decrRefCounts();
+    if(mk == kind::metakind::CONSTANT) {
+      // Destroy (call the destructor for) the C++ type representing
+      // the constant in this NodeValue.  This is needed for
+      // e.g. CVC4::Rational, since it has a gmp internal
+      // representation that mallocs memory and should be cleaned
+      // up.  (This won't delete a pointer value if used as a
+      // constant, but then, you should probably use a smart-pointer
+      // type for a constant payload.)
+      kind::metakind::deleteNodeValueConstant(nv);
     }
+    reclaimed.push_back(nv);
   }
+  d_nvAllocator.deallocateBatch(reclaimed);
 }/* NodeManager::reclaimZombies() */
 
+bool NodeManager::removeIfDead(NodeValue* nv)
+{
+  // Holding the zombie lock, no other thread can bring the reference count
+  // of nv to zero and zombify it again; holding the shard lock (in
+  // eraseIfDead()), no other thread can find nv in the pool and pin it.
+  std::lock_guard<expr::PoolMutex> guard(d_zombiesMutex);
+  kind::MetaKind mk = nv->getMetaKind();
+  if (mk != kind::metakind::VARIABLE && mk != kind::metakind::NULLARY_OPERATOR)
+  {
+    if (!d_nodeValuePool.eraseIfDead(nv))
+    {
+      return false;
+    }
+  }
+  else if (nv->d_rc != 0)
+  {
+    return false;
+  }
+#ifdef CVC4_THREAD_SAFE_NODES
+  // nv may have been resurrected and zombified again since we copied the
+  // zombie set, in which case it must not be reclaimed twice
+  d_zombies.erase(nv);
+#endif
+  return true;
+}
+
 std::vector<NodeValue*> NodeManager::TopologicalSort(
     const std::vector<NodeValue*>& roots) {
   std::vector<NodeValue*> order;
@@ -833,7 +880,8 @@ void NodeManager::reclaimAllZombies(){
 /** Reclaim zombies while there are more than k nodes in the pool (if possible).*/
 void NodeManager::reclaimZombiesUntil(uint32_t k){
   if(safeToReclaimZombies()){
-    while(poolSize() >= k && !d_zombies.empty()){
+    while (poolSize() >= k && hasZombies())
+    {
       reclaimZombies();
     }
   }
@@ -843,6 +891,12 @@ size_t NodeManager::poolSize() const{
   return d_nodeValuePool.size();
 }
 
+bool NodeManager::hasZombies()
+{
+  std::lock_guard<expr::PoolMutex> guard(d_zombiesMutex);
+  return !d_zombies.empty();
+}
+
 TypeNode NodeManager::mkSort(uint32_t flags) {
   NodeBuilder<1> nb(this, kind::SORT_TYPE);
   Node sortTag = NodeBuilder<0>(this, kind::SORT_TAG);
@@ -1146,11 +1200,11 @@ Node NodeManager::mkAbstractValue(const TypeNode& type) {
 }
 
 bool NodeManager::safeToReclaimZombies() const{
-  // FIXME multithreading
   return !d_inReclaimZombies && !d_attrManager->inGarbageCollection();
 }
 
 void NodeManager::deleteAttributes(const std::vector<const expr::attr::AttributeUniqueId*>& ids){
+  std::lock_guard<expr::RecursivePoolMutex> guard(d_attrMutex);
   d_attrManager->deleteAttributes(ids);
 }
 
@@ -32,10 +32,16 @@
 #include <string>
 #include <unordered_set>
 
+#ifdef CVC4_THREAD_SAFE_NODES
+#include <atomic>
+#endif
+
 #include "base/check.h"
 #include "expr/kind.h"
 #include "expr/metakind.h"
 #include "expr/node_value.h"
+#include "expr/node_value_allocator.h"
+#include "expr/node_value_pool.h"
 #include "options/options.h"
 
 namespace CVC4 {
@@ -97,9 +103,6 @@ class NodeManager {
     bool operator()(expr::NodeValue* nv) { return nv->d_rc > 0; }
   };
 
-  typedef std::unordered_set<expr::NodeValue*,
-                             expr::NodeValuePoolHashFunction,
-                             expr::NodeValuePoolEq> NodeValuePool;
   typedef std::unordered_set<expr::NodeValue*,
                              expr::NodeValueIDHashFunction,
                              expr::NodeValueIDEquality> NodeValueIDSet;
@@ -113,9 +116,16 @@ class NodeManager {
   /** The bound variable manager */
   std::unique_ptr<BoundVarManager> d_bvManager;
 
-  NodeValuePool d_nodeValuePool;
+  /** Allocates the memory of all NodeValues of this NodeManager */
+  expr::NodeValueAllocator d_nvAllocator;
+
+  expr::NodeValuePool d_nodeValuePool;
 
+#ifdef CVC4_THREAD_SAFE_NODES
+  std::atomic<size_t> next_id;
+#else
   size_t next_id;
+#endif
 
   expr::attr::AttributeManager* d_attrManager;
 
@@ -136,9 +146,17 @@ class NodeManager {
    * True iff we are in reclaimZombies().  This avoids unnecessary
    * recursion; a NodeValue being deleted might zombify other
    * NodeValues, but these shouldn't trigger a (recursive) call to
-   * reclaimZombies().
+   * reclaimZombies(). In thread-safe builds, this also ensures that only one
+   * thread reclaims zombies at a time.
    */
+#ifdef CVC4_THREAD_SAFE_NODES
+  std::atomic<bool> d_inReclaimZombies;
+#else
   bool d_inReclaimZombies;
+#endif
+
+  /** Protects d_zombies */
+  expr::PoolMutex d_zombiesMutex;
 
   /**
    * The set of zombie nodes.  We may want to revisit this design, as
@@ -153,6 +171,17 @@ class NodeManager {
    */
   std::vector<expr::NodeValue*> d_maxedOut;
 
+  /** Protects d_maxedOut */
+  expr::PoolMutex d_maxedOutMutex;
+
+  /**
+   * Protects the attribute tables of d_attrManager. It is recursive, since
+   * setting or deleting an attribute may release the last reference to a
+   * node, which may reclaim zombies and hence delete their attributes in the
+   * same thread. It must not be acquired while holding d_zombiesMutex.
+   */
+  mutable expr::RecursivePoolMutex d_attrMutex;
+
   /**
    * A set of operator singletons (w.r.t.  to this NodeManager
    * instance) for operators.  Conceptually, Nodes with kind, say,
@@ -236,16 +265,37 @@ class NodeManager {
    * NULL, the caller should fully construct an equivalent one before
    * calling poolInsert().  NON-FULLY-CONSTRUCTED NODEVALUES are not
    * permitted in the pool!
+   *
+   * In thread-safe builds, the returned NodeValue is pinned and must be
+   * released with unpinNodeValue() once the caller holds a reference to it.
    */
   inline expr::NodeValue* poolLookup(expr::NodeValue* nv) const;
 
   /**
-   * Insert a NodeValue into the NodeManager's pool.
+   * Insert a NodeValue into the NodeManager's pool and return the pool's
+   * representative for it.
    *
    * It is an error to insert a NodeValue already in the pool.
-   * Enquire first with poolLookup().
+   * Enquire first with poolLookup(). In thread-safe builds, another thread
+   * may have inserted an equal NodeValue since the lookup; then nv is
+   * destroyed and the existing one is returned. As for poolLookup(), the
+   * returned NodeValue is pinned in thread-safe builds.
+   */
+  inline expr::NodeValue* poolInsert(expr::NodeValue* nv);
+
+  /**
+   * Pin a NodeValue that is not created through the pool (e.g., a variable),
+   * so that it can be handled like the result of poolLookup(). No-op unless
+   * this is a thread-safe build.
+   */
+  inline void pinNodeValue(expr::NodeValue* nv);
+
+  /**
+   * Release a pin acquired by poolLookup(), poolInsert() or pinNodeValue().
+   * The caller must hold another reference to nv. No-op unless this is a
+   * thread-safe build.
    */
-  inline void poolInsert(expr::NodeValue* nv);
+  inline void unpinNodeValue(expr::NodeValue* nv);
 
   /**
    * Remove a NodeValue from the NodeManager's pool.
@@ -278,6 +328,48 @@ class NodeManager {
                   << std::endl;
     }
 
+    size_t numZombies;
+    {
+      std::lock_guard<expr::PoolMutex> guard(d_zombiesMutex);
+      numZombies = addZombie(nv);
+    }
+    maybeReclaimZombies(numZombies);
+  }
+
+#ifdef CVC4_THREAD_SAFE_NODES
+  /**
+   * Decrement the reference count of nv, which is at most one unless it was
+   * concurrently pinned, and register nv as a zombie if it reaches zero. The
+   * decrement and the registration happen in one critical section of the
+   * zombie lock. Otherwise, another thread could revive nv, release it again
+   * and reclaim it before nv is registered, which would register a freed
+   * NodeValue.
+   */
+  inline void decAndMaybeMarkForDeletion(expr::NodeValue* nv)
+  {
+    size_t numZombies;
+    {
+      std::lock_guard<expr::PoolMutex> guard(d_zombiesMutex);
+      if (nv->d_rc.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      {
+        return;
+      }
+      // printing nv may read its attributes, which must not be done while
+      // holding the zombie lock, hence only its id is printed
+      Debug("gc") << "zombifying node value " << nv << " [" << nv->d_id
+                  << "]" << std::endl;
+      numZombies = addZombie(nv);
+    }
+    maybeReclaimZombies(numZombies);
+  }
+#endif
+
+  /**
+   * Add nv to the zombies, to be called while holding d_zombiesMutex.
+   * Returns the number of zombies.
+   */
+  inline size_t addZombie(expr::NodeValue* nv)
+  {
     // `d_zombies` uses the node id to hash and compare nodes. If `d_zombies`
     // already contains a node value with the same id as `nv`, but the pointers
     // are different, then the wrong `NodeManager` was in scope for one of the
@@ -287,13 +379,16 @@ class NodeManager {
     // `Expr` is deleted and the node reaches refcount zero in the `Expr`'s
     // destructor, then `markForDeletion()` will be called on n2.
     Assert(d_zombies.find(nv) == d_zombies.end() || *d_zombies.find(nv) == nv);
+    d_zombies.insert(nv);
+    return d_zombies.size();
+  }
 
-    d_zombies.insert(nv);  // FIXME multithreading
-
-    if(safeToReclaimZombies()) {
-      if(d_zombies.size() > 5000) {
-        reclaimZombies();
-      }
+  /** Reclaim the zombies if there are numZombies of them and it is safe */
+  inline void maybeReclaimZombies(size_t numZombies)
+  {
+    if (safeToReclaimZombies() && numZombies > 5000)
+    {
+      reclaimZombies();
     }
   }
 
@@ -307,6 +402,7 @@ class NodeManager {
       Debug("gc") << "marking node value " << nv
                   << " [" << nv->d_id << "]: as maxed out" << std::endl;
     }
+    std::lock_guard<expr::PoolMutex> guard(d_maxedOutMutex);
     d_maxedOut.push_back(nv);
   }
 
@@ -315,6 +411,15 @@ class NodeManager {
    */
   void reclaimZombies();
 
+  /**
+   * Remove nv from the pool if its reference count is (still) zero. Returns
+   * true if nv can be deleted.
+   */
+  bool removeIfDead(expr::NodeValue* nv);
+
+  /** Returns true if there are zombies. */
+  bool hasZombies();
+
   /**
    * It is safe to collect zombies.
    */
@@ -1246,25 +1351,53 @@ inline TypeNode NodeManager::mkTesterType(TypeNode domain) {
 }
 
 inline expr::NodeValue* NodeManager::poolLookup(expr::NodeValue* nv) const {
-  NodeValuePool::const_iterator find = d_nodeValuePool.find(nv);
-  if(find == d_nodeValuePool.end()) {
-    return NULL;
-  } else {
-    return *find;
-  }
+  return d_nodeValuePool.find(nv);
 }
 
-inline void NodeManager::poolInsert(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) == d_nodeValuePool.end())
-      << "NodeValue already in the pool!";
-  d_nodeValuePool.insert(nv);// FIXME multithreading
+inline expr::NodeValue* NodeManager::poolInsert(expr::NodeValue* nv) {
+#ifndef CVC4_THREAD_SAFE_NODES
+  Assert(!d_nodeValuePool.contains(nv)) << "NodeValue already in the pool!";
+#endif
+  expr::NodeValue* res = d_nodeValuePool.insert(nv);
+  if (res != nv)
+  {
+    // lost the race against another thread, destroy our copy
+    if (nv->getMetaKind() == kind::metakind::CONSTANT)
+    {
+      kind::metakind::deleteNodeValueConstant(nv);
+    }
+    else
+    {
+      nv->decrRefCounts();
+    }
+    d_nvAllocator.deallocate(nv);
+  }
+  return res;
 }
 
 inline void NodeManager::poolRemove(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) != d_nodeValuePool.end())
-      << "NodeValue is not in the pool!";
+  bool erased CVC4_UNUSED = d_nodeValuePool.erase(nv);
+  Assert(erased) << "NodeValue is not in the pool!";
+}
+
+inline void NodeManager::pinNodeValue(expr::NodeValue* nv)
+{
+#ifdef CVC4_THREAD_SAFE_NODES
+  nv->inc();
+#endif
+}
 
-  d_nodeValuePool.erase(nv);// FIXME multithreading
+inline void NodeManager::unpinNodeValue(expr::NodeValue* nv)
+{
+#ifdef CVC4_THREAD_SAFE_NODES
+  uint32_t rc = nv->d_rc.load(std::memory_order_relaxed);
+  while (rc < expr::NodeValue::MAX_RC
+         && !nv->d_rc.compare_exchange_weak(
+             rc, rc - 1, std::memory_order_release))
+  {
+  }
+  Assert(rc > 1 || rc == expr::NodeValue::MAX_RC);
+#endif
 }
 
 inline Expr NodeManager::toExpr(TNode n) {
@@ -1638,24 +1771,22 @@ NodeClass NodeManager::mkConstInternal(const T& val) {
 #endif
 
   if(nv != NULL) {
-    return NodeClass(nv);
+    NodeClass n(nv);
+    unpinNodeValue(nv);
+    return n;
   }
 
-  nv = (expr::NodeValue*)
-    std::malloc(sizeof(expr::NodeValue) + sizeof(T));
-  if(nv == NULL) {
-    throw std::bad_alloc();
-  }
+  nv = d_nvAllocator.allocateConstant(sizeof(T));
 
   nv->d_nchildren = 0;
   nv->d_kind = kind::metakind::ConstantMap<T>::kind;
-  nv->d_id = next_id++;// FIXME multithreading
+  nv->d_id = next_id++;
   nv->d_rc = 0;
 
   //OwningTheory::mkConst(val);
   new (&nv->d_children) T(val);
 
-  poolInsert(nv);
+  nv = poolInsert(nv);
   if(Debug.isOn("gc")) {
     Debug("gc") << "creating node value " << nv
                 << " [" << nv->d_id << "]: ";
@@ -1663,7 +1794,9 @@ NodeClass NodeManager::mkConstInternal(const T& val) {
     Debug("gc") << std::endl;
   }
 
-  return NodeClass(nv);
+  NodeClass n(nv);
+  unpinNodeValue(nv);
+  return n;
 }
 
 }/* CVC4 namespace */
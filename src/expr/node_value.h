@@ -29,6 +29,10 @@
 #include <iterator>
 #include <string>
 
+#ifdef CVC4_THREAD_SAFE_NODES
+#include <atomic>
+#endif
+
 #include "expr/kind.h"
 #include "options/language.h"
 
@@ -41,6 +45,8 @@ class NodeManager;
 
 namespace expr {
   class NodeValue;
+  class NodeValuePool;
+  class NodeValueAllocator;
 }
 
 namespace kind {
@@ -68,6 +74,8 @@ class NodeValue
   template <unsigned nchild_thresh>
   friend class ::CVC4::NodeBuilder;
   friend class ::CVC4::NodeManager;
+  friend class NodeValuePool;
+  friend class NodeValueAllocator;
 
   template <Kind k, bool pool>
   friend struct ::CVC4::kind::metakind::NodeValueConstCompare;
@@ -331,6 +339,20 @@ class NodeValue
   /** The ID (0 is reserved for the null value) */
   uint64_t d_id : NBITS_ID;
 
+#ifdef CVC4_THREAD_SAFE_NODES
+  /** Kind of the expression */
+  uint32_t d_kind : NBITS_KIND;
+
+  /** Number of children */
+  uint32_t d_nchildren : NBITS_NCHILDREN;
+
+  /**
+   * The expression's reference count.  @see cvc4::Node. In thread-safe
+   * builds, this is a separate atomic word (still saturating at MAX_RC); the
+   * header keeps its size of 128 bits.
+   */
+  std::atomic<uint32_t> d_rc;
+#else
   /** The expression's reference count.  @see cvc4::Node. */
   uint32_t d_rc : NBITS_REFCOUNT;
 
@@ -339,6 +361,7 @@ class NodeValue
 
   /** Number of children */
   uint32_t d_nchildren : NBITS_NCHILDREN;
+#endif
 
   /** Variable number of child nodes */
   NodeValue* d_children[0];
@@ -405,9 +428,9 @@ namespace expr {
 
 inline NodeValue::NodeValue(int) :
   d_id(0),
-  d_rc(MAX_RC),
   d_kind(kind::NULL_EXPR),
   d_nchildren(0) {
+  d_rc = MAX_RC;
 }
 
 inline void NodeValue::decrRefCounts() {
@@ -420,7 +443,23 @@ inline void NodeValue::inc() {
   Assert(!isBeingDeleted())
       << "NodeValue is currently being deleted "
          "and increment is being called on it. Don't Do That!";
-  // FIXME multithreading
+#ifdef CVC4_THREAD_SAFE_NODES
+  uint32_t rc = d_rc.load(std::memory_order_relaxed);
+  do
+  {
+    if (rc == MAX_RC)
+    {
+      return;
+    }
+  } while (!d_rc.compare_exchange_weak(rc, rc + 1, std::memory_order_relaxed));
+  if (__builtin_expect((rc == MAX_RC - 1), false)) {
+    Assert(NodeManager::currentNM() != NULL)
+        << "No current NodeManager on incrementing of NodeValue: "
+           "maybe a public CVC4 interface function is missing a "
+           "NodeManagerScope ?";
+    NodeManager::currentNM()->markRefCountMaxedOut(this);
+  }
+#else
   if (__builtin_expect((d_rc < MAX_RC - 1), true)) {
     ++d_rc;
   } else if (__builtin_expect((d_rc == MAX_RC - 1), false)) {
@@ -431,10 +470,30 @@ inline void NodeValue::inc() {
            "NodeManagerScope ?";
     NodeManager::currentNM()->markRefCountMaxedOut(this);
   }
+#endif
 }
 
 inline void NodeValue::dec() {
-  // FIXME multithreading
+#ifdef CVC4_THREAD_SAFE_NODES
+  uint32_t rc = d_rc.load(std::memory_order_relaxed);
+  while (rc > 1 && rc < MAX_RC)
+  {
+    if (d_rc.compare_exchange_weak(rc, rc - 1, std::memory_order_release))
+    {
+      return;
+    }
+  }
+  if (rc < MAX_RC)
+  {
+    // possibly the last reference, the NodeManager decrements under its
+    // zombie lock so that reaching zero and zombification are atomic
+    Assert(NodeManager::currentNM() != NULL)
+        << "No current NodeManager on destruction of NodeValue: "
+           "maybe a public CVC4 interface function is missing a "
+           "NodeManagerScope ?";
+    NodeManager::currentNM()->decAndMaybeMarkForDeletion(this);
+  }
+#else
   if(__builtin_expect( ( d_rc < MAX_RC ), true )) {
     --d_rc;
     if(__builtin_expect( ( d_rc == 0 ), false )) {
@@ -445,6 +504,7 @@ inline void NodeValue::dec() {
       NodeManager::currentNM()->markForDeletion(this);
     }
   }
+#endif
 }
 
 inline NodeValue::nv_iterator NodeValue::nv_begin() {
@@ -0,0 +1,119 @@
+/*********************                                                        */
+/*! \file node_value_allocator.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A slab allocator for NodeValues
+ **/
+
+#include "expr/node_value_allocator.h"
+
+#include "base/check.h"
+
+namespace CVC4 {
+namespace expr {
+
+static_assert(sizeof(NodeValue) >= sizeof(void*),
+              "a free slab block must be able to hold a pointer");
+
+NodeValueAllocator::Statistics::Statistics()
+    : d_slabBytesStat("expr::NodeValueAllocator::slabBytes", d_slabBytes),
+      d_slabNodesStat("expr::NodeValueAllocator::slabNodes", d_slabNodes),
+      d_heapNodesStat("expr::NodeValueAllocator::heapNodes", d_heapNodes),
+      d_batchFreesStat("expr::NodeValueAllocator::batchFrees", d_batchFrees)
+{
+}
+
+NodeValueAllocator::NodeValueAllocator() {}
+
+NodeValueAllocator::~NodeValueAllocator()
+{
+  for (void* slab : d_slabs)
+  {
+    std::free(slab);
+  }
+}
+
+NodeValueAllocator::FreeBlock* NodeValueAllocator::refill(SizeClass& sc,
+                                                          size_t size)
+{
+  Assert(sc.d_free == nullptr);
+  char* slab = static_cast<char*>(std::malloc(SLAB_SIZE));
+  if (slab == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  {
+    std::lock_guard<PoolMutex> guard(d_slabsMutex);
+    d_slabs.push_back(slab);
+  }
+  addStat(d_stats.d_slabBytes, SLAB_SIZE);
+
+  // thread the blocks in address order, so that consecutive allocations are
+  // adjacent in memory
+  size_t nblocks = SLAB_SIZE / size;
+  FreeBlock* head = nullptr;
+  for (size_t i = nblocks; i-- > 0;)
+  {
+    FreeBlock* b = reinterpret_cast<FreeBlock*>(slab + i * size);
+    b->d_next = head;
+    head = b;
+  }
+  sc.d_free = head;
+  return head;
+}
+
+void NodeValueAllocator::deallocateBatch(const std::vector<NodeValue*>& nvs)
+{
+  addStat(d_stats.d_batchFrees, 1);
+  size_t i = 0;
+  size_t n = nvs.size();
+  while (i < n)
+  {
+    NodeValue* nv = nvs[i];
+    if (isHeapAllocated(nv))
+    {
+      deallocateHeap(nv);
+      ++i;
+      continue;
+    }
+    uint32_t nchildren = nv->d_nchildren;
+    SizeClass& sc = d_classes[nchildren];
+    int64_t freed = 0;
+    {
+      std::lock_guard<PoolMutex> guard(sc.d_mutex);
+      // return the run of NodeValues of the same size class
+      do
+      {
+        push(sc, nvs[i]);
+        ++freed;
+        ++i;
+      } while (i < n && !isHeapAllocated(nvs[i])
+               && nvs[i]->d_nchildren == nchildren);
+    }
+    addStat(d_stats.d_slabNodes, -freed);
+  }
+}
+
+void NodeValueAllocator::registerStatistics(StatisticsRegistry* sr)
+{
+  sr->registerStat(&d_stats.d_slabBytesStat);
+  sr->registerStat(&d_stats.d_slabNodesStat);
+  sr->registerStat(&d_stats.d_heapNodesStat);
+  sr->registerStat(&d_stats.d_batchFreesStat);
+}
+
+void NodeValueAllocator::unregisterStatistics(StatisticsRegistry* sr)
+{
+  sr->unregisterStat(&d_stats.d_slabBytesStat);
+  sr->unregisterStat(&d_stats.d_slabNodesStat);
+  sr->unregisterStat(&d_stats.d_heapNodesStat);
+  sr->unregisterStat(&d_stats.d_batchFreesStat);
+}
+
+}  // namespace expr
+}  // namespace CVC4
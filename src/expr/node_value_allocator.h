@@ -0,0 +1,210 @@
+/*********************                                                        */
+/*! \file node_value_allocator.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A slab allocator for NodeValues
+ **
+ ** NodeValues with few children are allocated from slabs, with one size class
+ ** per number of children. This avoids a malloc()/free() per node and keeps
+ ** nodes that are created together close in memory. Constants (whose payload
+ ** size varies) and NodeValues with many children use malloc().
+ **/
+
+#include "cvc4_private.h"
+
+// circular dependency
+#include "expr/node_value.h"
+
+#ifndef CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+#define CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "expr/node_value_pool.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace expr {
+
+class NodeValueAllocator
+{
+ public:
+  /** NodeValues with at most this many children are allocated from slabs. */
+  static constexpr uint32_t MAX_SLAB_CHILDREN = 15;
+  /** The size of a slab in bytes. */
+  static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+  NodeValueAllocator();
+  ~NodeValueAllocator();
+
+  NodeValueAllocator(const NodeValueAllocator&) = delete;
+  NodeValueAllocator& operator=(const NodeValueAllocator&) = delete;
+
+  /**
+   * Allocate (uninitialized) memory for a non-constant NodeValue with
+   * nchildren children.
+   *
+   * @throws bad_alloc if the allocation fails
+   */
+  NodeValue* allocate(uint32_t nchildren)
+  {
+    if (nchildren > MAX_SLAB_CHILDREN)
+    {
+      return allocateHeap(sizeof(NodeValue) + sizeof(NodeValue*) * nchildren);
+    }
+    SizeClass& sc = d_classes[nchildren];
+    std::lock_guard<PoolMutex> guard(sc.d_mutex);
+    FreeBlock* b = sc.d_free;
+    if (__builtin_expect((b == nullptr), false))
+    {
+      b = refill(sc, blockSize(nchildren));
+    }
+    sc.d_free = b->d_next;
+    addStat(d_stats.d_slabNodes, 1);
+    return reinterpret_cast<NodeValue*>(b);
+  }
+
+  /**
+   * Allocate (uninitialized) memory for a constant NodeValue with a payload
+   * of the given size.
+   *
+   * @throws bad_alloc if the allocation fails
+   */
+  NodeValue* allocateConstant(size_t payloadSize)
+  {
+    return allocateHeap(sizeof(NodeValue) + payloadSize);
+  }
+
+  /**
+   * Free the memory of nv, which must have been allocated by this allocator.
+   * The size class is determined from the metakind and number of children of
+   * nv, which must not have changed since the allocation. Destroying the
+   * payload of constants is up to the caller.
+   */
+  void deallocate(NodeValue* nv)
+  {
+    if (isHeapAllocated(nv))
+    {
+      deallocateHeap(nv);
+      return;
+    }
+    SizeClass& sc = d_classes[nv->d_nchildren];
+    std::lock_guard<PoolMutex> guard(sc.d_mutex);
+    push(sc, nv);
+    addStat(d_stats.d_slabNodes, -1);
+  }
+
+  /**
+   * Free all NodeValues in nvs, as deallocate(). Consecutive NodeValues of the
+   * same size class are returned to it under a single lock acquisition.
+   */
+  void deallocateBatch(const std::vector<NodeValue*>& nvs);
+
+  /** Register the statistics of this allocator with sr. */
+  void registerStatistics(StatisticsRegistry* sr);
+  /** Unregister the statistics of this allocator from sr. */
+  void unregisterStatistics(StatisticsRegistry* sr);
+
+ private:
+  /** A free block, linked through its first word. */
+  struct FreeBlock
+  {
+    FreeBlock* d_next;
+  };
+
+  /** A size class, i.e. the blocks for NodeValues with a fixed arity. */
+  struct alignas(64) SizeClass
+  {
+    PoolMutex d_mutex;
+    FreeBlock* d_free = nullptr;
+  };
+
+  struct Statistics
+  {
+    /** The number of bytes reserved in slabs */
+    uint64_t d_slabBytes = 0;
+    /** The number of live NodeValues in slabs */
+    uint64_t d_slabNodes = 0;
+    /** The number of live NodeValues allocated with malloc() */
+    uint64_t d_heapNodes = 0;
+    /** The number of calls to deallocateBatch() */
+    uint64_t d_batchFrees = 0;
+    ReferenceStat<uint64_t> d_slabBytesStat;
+    ReferenceStat<uint64_t> d_slabNodesStat;
+    ReferenceStat<uint64_t> d_heapNodesStat;
+    ReferenceStat<uint64_t> d_batchFreesStat;
+    Statistics();
+  };
+
+  static constexpr size_t blockSize(uint32_t nchildren)
+  {
+    return sizeof(NodeValue) + sizeof(NodeValue*) * nchildren;
+  }
+
+  static bool isHeapAllocated(const NodeValue* nv)
+  {
+    return nv->d_nchildren > MAX_SLAB_CHILDREN
+           || nv->getMetaKind() == kind::metakind::CONSTANT;
+  }
+
+  static void push(SizeClass& sc, NodeValue* nv)
+  {
+    FreeBlock* b = reinterpret_cast<FreeBlock*>(nv);
+    b->d_next = sc.d_free;
+    sc.d_free = b;
+  }
+
+  /** Update a statistic, atomically if nodes may be shared between threads */
+  static void addStat(uint64_t& stat, int64_t delta)
+  {
+#ifdef CVC4_THREAD_SAFE_NODES
+    __atomic_fetch_add(&stat, delta, __ATOMIC_RELAXED);
+#else
+    stat += delta;
+#endif
+  }
+
+  NodeValue* allocateHeap(size_t size)
+  {
+    NodeValue* nv = static_cast<NodeValue*>(std::malloc(size));
+    if (nv == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    addStat(d_stats.d_heapNodes, 1);
+    return nv;
+  }
+
+  void deallocateHeap(NodeValue* nv)
+  {
+    std::free(nv);
+    addStat(d_stats.d_heapNodes, -1);
+  }
+
+  /**
+   * Carve a new slab into blocks of the given size, add them to the free list
+   * of sc and return the first free block. The lock of sc must be held.
+   */
+  FreeBlock* refill(SizeClass& sc, size_t size);
+
+  /** The size classes, indexed by number of children */
+  SizeClass d_classes[MAX_SLAB_CHILDREN + 1];
+  /** All slabs, freed on destruction */
+  std::vector<void*> d_slabs;
+  /** Protects d_slabs */
+  PoolMutex d_slabsMutex;
+  Statistics d_stats;
+}; /* class NodeValueAllocator */
+
+}  // namespace expr
+}  // namespace CVC4
+
+#endif /* CVC4__EXPR__NODE_VALUE_ALLOCATOR_H */
@@ -0,0 +1,201 @@
+/*********************                                                        */
+/*! \file node_value_pool.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief The hash-consing pool of the NodeManager
+ **
+ ** The pool of NodeValues of a NodeManager. In builds with
+ ** CVC4_THREAD_SAFE_NODES, the pool is split into shards that each have their
+ ** own lock, so that threads that share a NodeManager only contend when they
+ ** create nodes that hash to the same shard. Otherwise, the pool consists of a
+ ** single shard and locking is a no-op.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__EXPR__NODE_VALUE_POOL_H
+#define CVC4__EXPR__NODE_VALUE_POOL_H
+
+#include <mutex>
+#include <unordered_set>
+
+#include "expr/metakind.h"
+#include "expr/node_value.h"
+
+namespace CVC4 {
+namespace expr {
+
+#ifdef CVC4_THREAD_SAFE_NODES
+using PoolMutex = std::mutex;
+using RecursivePoolMutex = std::recursive_mutex;
+#else
+/** A mutex that does nothing, used when nodes are not shared by threads. */
+struct PoolMutex
+{
+  void lock() {}
+  void unlock() {}
+};
+using RecursivePoolMutex = PoolMutex;
+#endif
+
+/**
+ * A set of fully constructed NodeValues, hashed and compared structurally.
+ *
+ * In thread-safe builds, find() and insert() pin the NodeValue they return
+ * (i.e., increment its reference count while the shard is locked). This
+ * prevents a concurrent reclaimZombies() from deleting a NodeValue with
+ * reference count zero before the caller has taken its own reference. The
+ * caller is responsible for unpinning, see NodeManager::unpinNodeValue().
+ */
+class NodeValuePool
+{
+  using Set = std::unordered_set<NodeValue*,
+                                 NodeValuePoolHashFunction,
+                                 NodeValuePoolEq>;
+
+ public:
+#ifdef CVC4_THREAD_SAFE_NODES
+  static constexpr size_t NUM_SHARDS = 64;
+#else
+  static constexpr size_t NUM_SHARDS = 1;
+#endif
+
+  /**
+   * Returns the NodeValue in the pool that is equal to nv, or nullptr if
+   * there is none. nv does not have to be fully constructed (see
+   * NodeManager::poolLookup()).
+   */
+  NodeValue* find(NodeValue* nv) const
+  {
+    const Shard& s = getShard(nv);
+    std::lock_guard<PoolMutex> guard(s.d_mutex);
+    Set::const_iterator it = s.d_set.find(nv);
+    if (it == s.d_set.end())
+    {
+      return nullptr;
+    }
+    pin(*it);
+    return *it;
+  }
+
+  /**
+   * Insert nv into the pool. Returns nv, or the NodeValue equal to nv if one
+   * was inserted concurrently by another thread.
+   */
+  NodeValue* insert(NodeValue* nv)
+  {
+    Shard& s = getShard(nv);
+    std::lock_guard<PoolMutex> guard(s.d_mutex);
+    NodeValue* res = *s.d_set.insert(nv).first;
+    pin(res);
+    return res;
+  }
+
+  /** Remove nv from the pool. Returns true if nv was in the pool. */
+  bool erase(NodeValue* nv)
+  {
+    Shard& s = getShard(nv);
+    std::lock_guard<PoolMutex> guard(s.d_mutex);
+    return s.d_set.erase(nv) > 0;
+  }
+
+  /**
+   * Remove nv from the pool if its reference count is zero. Since nodes in
+   * the pool are only pinned while their shard is locked, nv cannot be
+   * resurrected once this returns true.
+   */
+  bool eraseIfDead(NodeValue* nv)
+  {
+    Shard& s = getShard(nv);
+    std::lock_guard<PoolMutex> guard(s.d_mutex);
+    if (nv->d_rc != 0)
+    {
+      return false;
+    }
+    s.d_set.erase(nv);
+    return true;
+  }
+
+  /** Returns true if nv is in the pool. */
+  bool contains(NodeValue* nv) const
+  {
+    const Shard& s = getShard(nv);
+    std::lock_guard<PoolMutex> guard(s.d_mutex);
+    return s.d_set.find(nv) != s.d_set.end();
+  }
+
+  /** The number of NodeValues in the pool. */
+  size_t size() const
+  {
+    size_t res = 0;
+    for (const Shard& s : d_shards)
+    {
+      std::lock_guard<PoolMutex> guard(s.d_mutex);
+      res += s.d_set.size();
+    }
+    return res;
+  }
+
+  /** Apply f to all NodeValues in the pool, not thread-safe. */
+  template <class F>
+  void forEach(F f) const
+  {
+    for (const Shard& s : d_shards)
+    {
+      for (NodeValue* nv : s.d_set)
+      {
+        f(nv);
+      }
+    }
+  }
+
+ private:
+  /** A shard, aligned to avoid false sharing between the locks. */
+  struct alignas(64) Shard
+  {
+    mutable PoolMutex d_mutex;
+    Set d_set;
+  };
+
+  const Shard& getShard(const NodeValue* nv) const
+  {
+    return d_shards[shardIndex(nv)];
+  }
+  Shard& getShard(const NodeValue* nv) { return d_shards[shardIndex(nv)]; }
+
+  static size_t shardIndex(const NodeValue* nv)
+  {
+#ifdef CVC4_THREAD_SAFE_NODES
+    // use the high bits of a multiplicative hash, the low bits of poolHash()
+    // select the bucket within the shard
+    uint64_t h = static_cast<uint64_t>(nv->poolHash()) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_t>(h >> 58);
+#else
+    return 0;
+#endif
+  }
+
+  static void pin(NodeValue* nv)
+  {
+#ifdef CVC4_THREAD_SAFE_NODES
+    nv->inc();
+#endif
+  }
+
+  Shard d_shards[NUM_SHARDS];
+}; /* class NodeValuePool */
+
+#ifdef CVC4_THREAD_SAFE_NODES
+static_assert(NodeValuePool::NUM_SHARDS == 64,
+              "shardIndex() assumes 64 shards");
+#endif
+
+}  // namespace expr
+}  // namespace CVC4
+
+#endif /* CVC4__EXPR__NODE_VALUE_POOL_H */
@@ -66,6 +66,15 @@ CommandExecutor::~CommandExecutor()
 
 void CommandExecutor::flushStatistics(std::ostream& out) const
 {
+  if (d_options.getStatsJson())
+  {
+    out << "{";
+    bool first = true;
+    d_smtEngine->flushStatisticsJSON(out, first);
+    d_stats.flushInformationJSON(out, first);
+    out << std::endl << "}" << std::endl;
+    return;
+  }
   // SmtEngine + node manager flush statistics is part of the call below
   d_smtEngine->flushStatistics(out);
   d_stats.flushInformation(out);
@@ -151,7 +160,15 @@ bool CommandExecutor::doCommandSingleton(Command* cmd)
     std::ostringstream ossCurStats;
     flushStatistics(ossCurStats);
     std::ostream& err = *d_options.getErr();
-    printStatsIncremental(err, d_lastStatistics, ossCurStats.str());
+    if (d_options.getStatsJson())
+    {
+      // print the full object, which consumers can compare
+      err << ossCurStats.str();
+    }
+    else
+    {
+      printStatsIncremental(err, d_lastStatistics, ossCurStats.str());
+    }
     d_lastStatistics = ossCurStats.str();
   }
 
@@ -321,7 +338,7 @@ void CommandExecutor::printStatsFilterZeros(std::ostream& out,
 
 void CommandExecutor::flushOutputStreams() {
   if(d_options.getStatistics()) {
-    if(d_options.getStatsHideZeros() == false) {
+    if(d_options.getStatsHideZeros() == false || d_options.getStatsJson()) {
       flushStatistics(*(d_options.getErr()));
     } else {
       std::ostringstream ossStats;
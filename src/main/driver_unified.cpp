@@ -21,6 +21,7 @@
 #include <iostream>
 #include <memory>
 #include <new>
+#include <sstream>
 
 #include "cvc4autoconfig.h"
 
@@ -30,6 +31,7 @@
 #include "main/command_executor.h"
 #include "main/interactive_shell.h"
 #include "main/main.h"
+#include "main/portfolio.h"
 #include "main/signal_handlers.h"
 #include "main/time_limit.h"
 #include "options/options.h"
@@ -182,6 +184,31 @@ int runCvc4(int argc, char* argv[], Options& opts) {
   // important even for muzzled builds (to get result output right)
   (*(opts.getOut())) << language::SetLanguage(opts.getOutputLanguage());
 
+  // In portfolio mode, each thread creates its own command executor
+  if (opts.getPortfolio() > 1)
+  {
+    std::stringstream input;
+    if (inputFromStdin)
+    {
+      input << cin.rdbuf();
+    }
+    else
+    {
+      std::ifstream in(filenameStr);
+      if (!in)
+      {
+        throw Exception("Couldn't open file: " + filenameStr);
+      }
+      input << in.rdbuf();
+    }
+    int returnValue =
+        runPortfolio(opts, filenameStr, input.str(), opts.getPortfolio());
+    delete pTotalTime;
+    pTotalTime = nullptr;
+    signal_handlers::cleanup();
+    return returnValue;
+  }
+
   // Create the command executor to execute the parsed commands
   pExecutor = new CommandExecutor(opts);
 
@@ -0,0 +1,411 @@
+/*********************                                                        */
+/*! \file portfolio.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Multi-threaded portfolio mode of the driver
+ **/
+
+#include "main/portfolio.h"
+
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "api/cvc4cpp.h"
+#include "base/output.h"
+#include "main/command_executor.h"
+#include "options/option_exception.h"
+#include "options/set_language.h"
+#include "parser/parser.h"
+#include "parser/parser_builder.h"
+#include "smt/command.h"
+#include "smt/smt_engine.h"
+#include "util/unsafe_interrupt_exception.h"
+
+namespace CVC4 {
+namespace main {
+
+std::vector<PortfolioStrategy> getDefaultPortfolioStrategies()
+{
+  return {
+      {},
+      {{"decision", "justification"}},
+      {{"sat-clause-db", "tiered"}, {"sat-restart", "glucose"}},
+      {{"simplification", "none"}},
+      {{"decision", "justification"},
+       {"sat-clause-db", "tiered"},
+       {"sat-restart", "glucose"}},
+      {{"restart-int-base", "100"}, {"random-freq", "0.02"}},
+  };
+}
+
+std::vector<PortfolioStrategy> parsePortfolioStrategies(const std::string& s)
+{
+  std::vector<PortfolioStrategy> table;
+  std::stringstream entries(s);
+  std::string entry;
+  while (std::getline(entries, entry, ';'))
+  {
+    PortfolioStrategy strategy;
+    std::stringstream pairs(entry);
+    std::string pair;
+    while (pairs >> pair)
+    {
+      size_t pos = pair.find('=');
+      if (pos == 0)
+      {
+        throw OptionException("malformed portfolio strategy entry `" + pair
+                              + "'");
+      }
+      if (pos == std::string::npos)
+      {
+        strategy.emplace_back(pair, "true");
+      }
+      else
+      {
+        strategy.emplace_back(pair.substr(0, pos), pair.substr(pos + 1));
+      }
+    }
+    table.push_back(strategy);
+  }
+  if (table.empty())
+  {
+    throw OptionException("portfolio strategy table is empty");
+  }
+  return table;
+}
+
+PortfolioStrategy getPortfolioStrategy(
+    const std::vector<PortfolioStrategy>& table, unsigned i)
+{
+  PortfolioStrategy strategy = table[i % table.size()];
+  unsigned round = i / table.size();
+  if (round > 0)
+  {
+    strategy.emplace_back("random-seed", std::to_string(round));
+  }
+  return strategy;
+}
+
+namespace {
+
+class Portfolio;
+
+/**
+ * A portfolio worker owns a complete solver stack (options, solver, symbol
+ * manager, parser) that lives in its own thread. All of the output of the
+ * worker is buffered until the portfolio has decided on a winner.
+ */
+class PortfolioWorker
+{
+ public:
+  PortfolioWorker(Portfolio& portfolio,
+                  unsigned id,
+                  const PortfolioStrategy& strategy)
+      : d_portfolio(portfolio),
+        d_id(id),
+        d_strategy(strategy),
+        d_smtEngine(nullptr),
+        d_status(false),
+        d_definitive(false)
+  {
+  }
+
+  /** Run the worker, to be called in the worker's thread. */
+  void run(const Options& baseOptions,
+           const std::string& filename,
+           const std::string& input);
+
+  /**
+   * Interrupt the worker, may be called from any thread. The worker stops
+   * after its current command, or during its current check-sat.
+   */
+  void interrupt()
+  {
+    std::lock_guard<std::mutex> guard(d_smtMutex);
+    if (d_smtEngine != nullptr)
+    {
+      d_smtEngine->interrupt();
+    }
+  }
+
+  unsigned getId() const { return d_id; }
+  const PortfolioStrategy& getStrategy() const { return d_strategy; }
+  /** The buffered output of the worker */
+  std::string getOutput() const { return d_out.str(); }
+  /** The buffered statistics of the worker (if --stats is enabled) */
+  std::string getStatistics() const { return d_stats.str(); }
+  /** True if all commands of the worker succeeded */
+  bool getStatus() const { return d_status; }
+
+ private:
+  /** Execute the input, returns true if all commands succeeded */
+  bool execute(CommandExecutor& executor,
+               Options& options,
+               const std::string& filename,
+               const std::string& input);
+
+  /** The portfolio this worker belongs to */
+  Portfolio& d_portfolio;
+  /** The index of this worker */
+  unsigned d_id;
+  /** The options that are set for this worker */
+  PortfolioStrategy d_strategy;
+  /** Protects d_smtEngine, which is accessed by interrupting threads */
+  std::mutex d_smtMutex;
+  /** The SmtEngine of this worker while it is running, or nullptr */
+  SmtEngine* d_smtEngine;
+  /** Buffer for the regular output */
+  std::stringstream d_out;
+  /** Buffer for the statistics */
+  std::stringstream d_stats;
+  /** True if all commands succeeded */
+  bool d_status;
+  /** True if no check-sat or query returned unknown */
+  bool d_definitive;
+};
+
+/**
+ * The shared state of a portfolio run. Workers notify the portfolio when they
+ * finish; the first worker that finishes with a definitive answer wins and
+ * all other workers are interrupted.
+ */
+class Portfolio
+{
+ public:
+  explicit Portfolio(unsigned numWorkers)
+      : d_winner(nullptr), d_fallback(nullptr), d_running(numWorkers)
+  {
+  }
+
+  /** Called by a worker that has finished executing the input. */
+  void notifyFinished(PortfolioWorker* worker, bool definitive)
+  {
+    std::lock_guard<std::mutex> guard(d_mutex);
+    d_running--;
+    if (d_winner == nullptr)
+    {
+      if (definitive)
+      {
+        d_winner = worker;
+      }
+      else if (d_fallback == nullptr)
+      {
+        d_fallback = worker;
+      }
+    }
+    d_cv.notify_all();
+  }
+
+  /** True if a winner has been determined. */
+  bool isDone()
+  {
+    std::lock_guard<std::mutex> guard(d_mutex);
+    return d_winner != nullptr;
+  }
+
+  /**
+   * Block until there is a winner or all workers have finished. Returns the
+   * winner, or the first worker that finished if none was definitive.
+   */
+  PortfolioWorker* waitForResult()
+  {
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_cv.wait(lock, [this] { return d_winner != nullptr || d_running == 0; });
+    return d_winner != nullptr ? d_winner : d_fallback;
+  }
+
+ private:
+  std::mutex d_mutex;
+  std::condition_variable d_cv;
+  /** The first worker that finished with a definitive answer */
+  PortfolioWorker* d_winner;
+  /** The first worker that finished without a definitive answer */
+  PortfolioWorker* d_fallback;
+  /** The number of workers still running */
+  unsigned d_running;
+};
+
+void PortfolioWorker::run(const Options& baseOptions,
+                          const std::string& filename,
+                          const std::string& input)
+{
+  Options options;
+  options.copyValues(baseOptions);
+  options.setOut(&d_out);
+  d_out << language::SetLanguage(options.getOutputLanguage());
+  try
+  {
+    CommandExecutor executor(options);
+    {
+      std::lock_guard<std::mutex> guard(d_smtMutex);
+      d_smtEngine = executor.getSmtEngine();
+    }
+    // Clears d_smtEngine before executor is destroyed, also if an exception
+    // is thrown, so that interrupt() never sees a deleted SmtEngine
+    struct SmtEngineReset
+    {
+      PortfolioWorker* d_worker;
+      ~SmtEngineReset()
+      {
+        std::lock_guard<std::mutex> guard(d_worker->d_smtMutex);
+        d_worker->d_smtEngine = nullptr;
+      }
+    } reset{this};
+    d_status = execute(executor, options, filename, input);
+    if (options.getStatistics())
+    {
+      executor.flushStatistics(d_stats);
+    }
+  }
+  catch (Exception& e)
+  {
+    d_out << "(error \"" << e << "\")" << std::endl;
+    d_status = false;
+    d_definitive = false;
+  }
+  d_portfolio.notifyFinished(this, d_status && d_definitive);
+}
+
+bool PortfolioWorker::execute(CommandExecutor& executor,
+                              Options& options,
+                              const std::string& filename,
+                              const std::string& input)
+{
+  api::Solver* solver = executor.getSolver();
+  for (const std::pair<std::string, std::string>& opt : d_strategy)
+  {
+    Trace("portfolio") << "portfolio[" << d_id << "]: set " << opt.first
+                       << " to " << opt.second << std::endl;
+    solver->setOption(opt.first, opt.second);
+  }
+
+  parser::ParserBuilder parserBuilder(
+      solver, executor.getSymbolManager(), filename, options);
+  parserBuilder.withStringInput(input);
+  std::unique_ptr<parser::Parser> parser(parserBuilder.build());
+
+  d_definitive = true;
+  bool status = true;
+  std::unique_ptr<Command> cmd;
+  while (status && !d_portfolio.isDone())
+  {
+    try
+    {
+      cmd.reset(parser->nextCommand());
+    }
+    catch (UnsafeInterruptException& e)
+    {
+      d_definitive = false;
+      break;
+    }
+    if (cmd == nullptr)
+    {
+      break;
+    }
+    status = executor.doCommand(cmd);
+    if (cmd->interrupted())
+    {
+      d_definitive = false;
+      break;
+    }
+    if (dynamic_cast<CheckSatCommand*>(cmd.get()) != nullptr
+        || dynamic_cast<CheckSatAssumingCommand*>(cmd.get()) != nullptr
+        || dynamic_cast<QueryCommand*>(cmd.get()) != nullptr)
+    {
+      api::Result res = executor.getResult();
+      if (res.isSatUnknown() || res.isEntailmentUnknown())
+      {
+        d_definitive = false;
+      }
+    }
+    if (dynamic_cast<QuitCommand*>(cmd.get()) != nullptr)
+    {
+      break;
+    }
+  }
+  return status;
+}
+
+}  // namespace
+
+int runPortfolio(Options& opts,
+                 const std::string& filename,
+                 const std::string& input,
+                 unsigned numThreads)
+{
+  if (opts.getInteractive())
+  {
+    throw OptionException("--portfolio doesn't work in interactive mode");
+  }
+  if (opts.getTearDownIncremental() > 0)
+  {
+    throw OptionException(
+        "--portfolio is incompatible with --tear-down-incremental");
+  }
+
+  std::vector<PortfolioStrategy> table =
+      opts.getPortfolioStrategies().empty()
+          ? getDefaultPortfolioStrategies()
+          : parsePortfolioStrategies(opts.getPortfolioStrategies());
+
+  Portfolio portfolio(numThreads);
+  std::vector<std::unique_ptr<PortfolioWorker>> workers;
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < numThreads; ++i)
+  {
+    workers.emplace_back(
+        new PortfolioWorker(portfolio, i, getPortfolioStrategy(table, i)));
+  }
+  for (unsigned i = 0; i < numThreads; ++i)
+  {
+    PortfolioWorker* w = workers[i].get();
+    threads.emplace_back([w, &opts, &filename, &input]() {
+      w->run(opts, filename, input);
+    });
+  }
+
+  PortfolioWorker* winner = portfolio.waitForResult();
+  // stop all other workers as soon as possible
+  for (std::unique_ptr<PortfolioWorker>& w : workers)
+  {
+    if (w.get() != winner)
+    {
+      w->interrupt();
+    }
+  }
+
+  *opts.getOut() << winner->getOutput() << std::flush;
+  if (opts.getStatistics())
+  {
+    std::ostream& err = *opts.getErr();
+    err << "portfolio::threads, " << numThreads << std::endl;
+    err << "portfolio::winner, " << winner->getId() << std::endl;
+    err << "portfolio::winner_strategy, \"";
+    for (const std::pair<std::string, std::string>& opt :
+         winner->getStrategy())
+    {
+      err << " " << opt.first << "=" << opt.second;
+    }
+    err << " \"" << std::endl;
+    err << winner->getStatistics();
+  }
+  int returnValue = winner->getStatus() ? 0 : 1;
+
+  for (std::thread& t : threads)
+  {
+    t.join();
+  }
+  return returnValue;
+}
+
+}  // namespace main
+}  // namespace CVC4
@@ -0,0 +1,71 @@
+/*********************                                                        */
+/*! \file portfolio.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Multi-threaded portfolio mode of the driver
+ **
+ ** Runs the same input on several differently configured solvers, each in its
+ ** own thread with its own NodeManager, and reports the output of the first
+ ** solver that finishes with a definitive answer.
+ **/
+
+#ifndef CVC4__MAIN__PORTFOLIO_H
+#define CVC4__MAIN__PORTFOLIO_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "options/options.h"
+
+namespace CVC4 {
+namespace main {
+
+/**
+ * A portfolio strategy is a list of (option, value) pairs that are set on the
+ * solver of a portfolio thread before the input is parsed.
+ */
+using PortfolioStrategy = std::vector<std::pair<std::string, std::string>>;
+
+/** The built-in strategy table used when --portfolio-strategies is not set. */
+std::vector<PortfolioStrategy> getDefaultPortfolioStrategies();
+
+/**
+ * Parse a strategy table of the form "opt=val opt=val;opt=val;...". Entries
+ * are separated by ';', pairs within an entry by whitespace. An option without
+ * a value is set to "true". Throws an OptionException on malformed input.
+ */
+std::vector<PortfolioStrategy> parsePortfolioStrategies(const std::string& s);
+
+/**
+ * Get the strategy for thread i given a strategy table. Threads beyond the
+ * table reuse its entries round-robin with a distinct SAT random seed so that
+ * no two threads run the same configuration.
+ */
+PortfolioStrategy getPortfolioStrategy(
+    const std::vector<PortfolioStrategy>& table, unsigned i);
+
+/**
+ * Solve the given input in portfolio mode with numThreads threads. The output
+ * of the winning thread is written to the output stream of opts.
+ *
+ * @param opts The options from the command line
+ * @param filename The name of the input, used by the parser for error messages
+ * @param input The complete input
+ * @param numThreads The number of portfolio threads
+ * @return the exit status of the driver (0 on success)
+ */
+int runPortfolio(Options& opts,
+                 const std::string& filename,
+                 const std::string& input,
+                 unsigned numThreads);
+
+}  // namespace main
+}  // namespace CVC4
+
+#endif /* CVC4__MAIN__PORTFOLIO_H */
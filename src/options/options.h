@@ -164,12 +164,15 @@ public:
   bool getLanguageHelp() const;
   bool getMemoryMap() const;
   bool getParseOnly() const;
+  unsigned getPortfolio() const;
+  const std::string& getPortfolioStrategies() const;
   bool getProduceModels() const;
   bool getSegvSpin() const;
   bool getSemanticChecks() const;
   bool getStatistics() const;
   bool getStatsEveryQuery() const;
   bool getStatsHideZeros() const;
+  bool getStatsJson() const;
   bool getStrictParsing() const;
   int getTearDownIncremental() const;
   unsigned long getCumulativeTimeLimit() const;
@@ -30,6 +30,7 @@
 #include "options/option_exception.h"
 #include "options/options.h"
 #include "options/printer_modes.h"
+#include "options/prop_options.h"
 #include "options/quantifiers_options.h"
 
 namespace CVC4 {
@@ -72,6 +73,9 @@ public:
   void checkBvSatSolver(std::string option, SatSolverMode m);
   void checkBitblastMode(std::string option, BitblastMode m);
 
+  // prop/options_handlers.h
+  void checkPropSatSolver(std::string option, PropSatSolverMode m);
+
   void setBitblastAig(std::string option, bool arg);
 
   // printer/options_handlers.h
@@ -112,6 +112,14 @@ bool Options::getParseOnly() const{
   return (*this)[options::parseOnly];
 }
 
+unsigned Options::getPortfolio() const{
+  return (*this)[options::portfolio];
+}
+
+const std::string& Options::getPortfolioStrategies() const{
+  return (*this)[options::portfolioStrategies];
+}
+
 bool Options::getProduceModels() const{
   return (*this)[options::produceModels];
 }
@@ -125,8 +133,9 @@ bool Options::getSemanticChecks() const{
 }
 
 bool Options::getStatistics() const{
-  // statsEveryQuery enables stats
-  return (*this)[options::statistics] || (*this)[options::statsEveryQuery];
+  // statsEveryQuery and statsJson enable stats
+  return (*this)[options::statistics] || (*this)[options::statsEveryQuery]
+         || (*this)[options::statsJson];
 }
 
 bool Options::getStatsEveryQuery() const{
@@ -137,6 +146,8 @@ bool Options::getStatsHideZeros() const{
   return (*this)[options::statsHideZeros];
 }
 
+bool Options::getStatsJson() const { return (*this)[options::statsJson]; }
+
 bool Options::getStrictParsing() const{
   return (*this)[options::strictParsing];
 }
@@ -11,7 +11,8 @@
  **
  ** \brief Wrapper for CaDiCaL SAT Solver.
  **
- ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors).
+ ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors and the
+ ** main CDCL(T) engine).
  **/
 
 #include "prop/cadical.h"
@@ -19,6 +20,8 @@
 #ifdef CVC4_USE_CADICAL
 
 #include "base/check.h"
+#include "context/context.h"
+#include "prop/theory_proxy.h"
 
 namespace CVC4 {
 namespace prop {
@@ -55,14 +58,510 @@ CadicalVar toCadicalVar(SatVariable var) { return var; }
 
 }  // namespace helper functions
 
+/**
+ * Connects the theories to CaDiCaL through its external propagator interface.
+ *
+ * The propagator mirrors the assignment of the variables of the CDCL(T)
+ * engine on its own trail, and pushes (pops) a SAT context level for each
+ * decision level that CaDiCaL opens (backtracks), as Minisat does. Assigned
+ * theory atoms are enqueued to the theories, which are checked with standard
+ * effort whenever CaDiCaL asks for propagations, and with full effort when it
+ * has found a model. Theory lemmas, conflicts and explanations of
+ * propagations that are already false are handed to CaDiCaL as external
+ * clauses.
+ */
+class CadicalPropagator : public CaDiCaL::ExternalPropagator
+{
+ public:
+  CadicalPropagator(prop::TheoryProxy* proxy,
+                    context::Context* context,
+                    CaDiCaL::Solver& solver,
+                    StatisticsRegistry* registry)
+      : d_proxy(proxy),
+        d_context(context),
+        d_solver(solver),
+        d_baseLevel(context->getLevel()),
+        d_newClausesHead(0),
+        d_propagationsHead(0),
+        d_reasonHead(0),
+        d_inReason(false),
+        d_checkPending(false),
+        d_newVars(false),
+        d_inSearch(false),
+        d_statistics(registry)
+  {
+  }
+
+  /* ExternalPropagator ------------------------------------------------- */
+
+  void notify_assignment(int lit, bool is_fixed) override
+  {
+    SatVariable var = std::abs(lit);
+    Assert(var < d_varInfo.size());
+    VarInfo& info = d_varInfo[var];
+    if (!info.d_active)
+    {
+      return;
+    }
+    int8_t assignment = lit > 0 ? 1 : -1;
+    if (info.d_assignment != 0)
+    {
+      // a literal of the trail became fixed at the root level
+      Assert(info.d_assignment == assignment);
+      info.d_fixed = info.d_fixed || is_fixed;
+      return;
+    }
+    info.d_assignment = assignment;
+    info.d_fixed = is_fixed;
+    info.d_trailIndex = d_trail.size();
+    info.d_level = d_context->getLevel();
+    d_trail.push_back(lit);
+    d_checkPending = true;
+    if (info.d_theoryAtom)
+    {
+      d_proxy->enqueueTheoryLiteral(toSatLiteral(lit));
+    }
+  }
+
+  void notify_new_decision_level() override
+  {
+    d_context->push();
+    d_trailLimits.push_back(d_trail.size());
+  }
+
+  void notify_backtrack(size_t level) override { backtrack(level); }
+
+  bool cb_check_found_model(const std::vector<int>& model) override
+  {
+    if (hasPendingClauses() || d_newVars)
+    {
+      d_newVars = false;
+      return false;
+    }
+    ++d_statistics.d_numFullChecks;
+    do
+    {
+      d_proxy->theoryCheck(theory::Theory::EFFORT_FULL);
+      SatClause propagations;
+      d_proxy->theoryPropagate(propagations);
+      for (const SatLiteral& lit : propagations)
+      {
+        if (value(lit) == SAT_VALUE_FALSE)
+        {
+          addExplanationClause(lit);
+        }
+        else if (value(lit) == SAT_VALUE_UNKNOWN)
+        {
+          d_propagations.push_back(lit);
+        }
+      }
+      // The model is rejected if the theories added lemmas or introduced new
+      // variables, CaDiCaL then continues the search with them.
+      if (hasPendingClauses() || d_newVars
+          || d_propagationsHead < d_propagations.size())
+      {
+        d_newVars = false;
+        return false;
+      }
+    } while (d_proxy->theoryNeedCheck());
+    return true;
+  }
+
+  int cb_decide() override
+  {
+    SatLiteral lit = d_proxy->getNextTheoryDecisionRequest();
+    while (lit != undefSatLiteral && value(lit) != SAT_VALUE_UNKNOWN)
+    {
+      lit = d_proxy->getNextTheoryDecisionRequest();
+    }
+    if (lit == undefSatLiteral)
+    {
+      // The decision engine cannot stop the search of CaDiCaL, which stops
+      // by itself once all variables are assigned.
+      bool stopSearch = false;
+      lit = d_proxy->getNextDecisionEngineRequest(stopSearch);
+    }
+    if (lit == undefSatLiteral || value(lit) != SAT_VALUE_UNKNOWN)
+    {
+      return 0;
+    }
+    return toCadicalLit(lit);
+  }
+
+  int cb_propagate() override
+  {
+    if (d_propagationsHead == d_propagations.size() && d_checkPending)
+    {
+      d_checkPending = false;
+      d_propagations.clear();
+      d_propagationsHead = 0;
+      d_proxy->theoryCheck(theory::Theory::EFFORT_STANDARD);
+      d_proxy->theoryPropagate(d_propagations);
+    }
+    while (d_propagationsHead < d_propagations.size())
+    {
+      SatLiteral lit = d_propagations[d_propagationsHead++];
+      SatValue val = value(lit);
+      if (val == SAT_VALUE_UNKNOWN)
+      {
+        ++d_statistics.d_numPropagations;
+        return toCadicalLit(lit);
+      }
+      if (val == SAT_VALUE_FALSE)
+      {
+        addExplanationClause(lit);
+      }
+    }
+    return 0;
+  }
+
+  int cb_add_reason_clause_lit(int propagated_lit) override
+  {
+    if (!d_inReason)
+    {
+      SatClause explanation;
+      d_proxy->explainPropagation(toSatLiteral(propagated_lit), explanation);
+      d_reason.clear();
+      for (const SatLiteral& lit : explanation)
+      {
+        d_reason.push_back(toCadicalLit(lit));
+      }
+      d_reasonHead = 0;
+      d_inReason = true;
+    }
+    if (d_reasonHead < d_reason.size())
+    {
+      return d_reason[d_reasonHead++];
+    }
+    d_inReason = false;
+    return 0;
+  }
+
+  bool cb_has_external_clause() override { return hasPendingClauses(); }
+
+  int cb_add_external_clause_lit() override
+  {
+    Assert(hasPendingClauses());
+    int lit = d_newClauses[d_newClausesHead++];
+    if (lit == 0)
+    {
+      ++d_statistics.d_numExternalClauses;
+    }
+    if (d_newClausesHead == d_newClauses.size())
+    {
+      d_newClauses.clear();
+      d_newClausesHead = 0;
+    }
+    return lit;
+  }
+
+  /* CadicalSolver ------------------------------------------------------- */
+
+  /**
+   * Adds a clause. During search, the clause is handed to CaDiCaL the next
+   * time it asks for external clauses, otherwise it is added directly.
+   */
+  void addClause(const std::vector<int>& clause)
+  {
+    if (d_inSearch)
+    {
+      d_newClauses.insert(d_newClauses.end(), clause.begin(), clause.end());
+      d_newClauses.push_back(0);
+      return;
+    }
+    for (int lit : clause)
+    {
+      d_solver.add(lit);
+    }
+    d_solver.add(0);
+  }
+
+  /** Notifies this propagator of a new variable of the solver */
+  void addNewVar(SatVariable var, bool isTheoryAtom, bool preRegister)
+  {
+    Assert(var == d_varInfo.size() || (var == 1 && d_varInfo.empty()));
+    if (d_varInfo.empty())
+    {
+      // CaDiCaL variables start with index 1
+      d_varInfo.emplace_back();
+    }
+    d_varInfo.emplace_back();
+    d_varInfo[var].d_theoryAtom = isTheoryAtom;
+    d_solver.add_observed_var(toCadicalVar(var));
+    d_newVars = true;
+    if (preRegister)
+    {
+      d_varsToRegister.emplace_back(var, d_trailLimits.size());
+    }
+  }
+
+  /** Called before the search of CaDiCaL starts */
+  void beginSearch()
+  {
+    Assert(d_trailLimits.empty());
+    // clauses that were produced after the last search was interrupted
+    for (int lit : d_newClauses)
+    {
+      d_solver.add(lit);
+    }
+    d_newClauses.clear();
+    d_newClausesHead = 0;
+    d_baseLevel = d_context->getLevel();
+    d_inSearch = true;
+  }
+
+  /** Called after the search of CaDiCaL stopped */
+  void endSearch() { d_inSearch = false; }
+
+  /** Backtracks to the given decision level */
+  void backtrack(size_t level)
+  {
+    if (level >= d_trailLimits.size())
+    {
+      return;
+    }
+    std::vector<int> fixed;
+    size_t limit = d_trailLimits[level];
+    while (d_trail.size() > limit)
+    {
+      int lit = d_trail.back();
+      d_trail.pop_back();
+      VarInfo& info = d_varInfo[std::abs(lit)];
+      if (info.d_fixed)
+      {
+        fixed.push_back(lit);
+      }
+      else
+      {
+        info.d_assignment = 0;
+      }
+    }
+    d_trailLimits.resize(level);
+    d_context->popto(d_baseLevel + level);
+    d_propagations.clear();
+    d_propagationsHead = 0;
+    // reregister the variables introduced above the level, as Minisat does
+    for (auto it = d_varsToRegister.rbegin();
+         it != d_varsToRegister.rend() && it->second > level;
+         ++it)
+    {
+      it->second = level;
+      d_proxy->variableNotify(it->first);
+    }
+    // literals fixed at the root level remain assigned
+    for (auto it = fixed.rbegin(); it != fixed.rend(); ++it)
+    {
+      VarInfo& info = d_varInfo[std::abs(*it)];
+      info.d_trailIndex = d_trail.size();
+      info.d_level = d_context->getLevel();
+      d_trail.push_back(*it);
+      if (info.d_theoryAtom)
+      {
+        d_proxy->enqueueTheoryLiteral(toSatLiteral(*it));
+      }
+    }
+    d_checkPending = true;
+  }
+
+  /** Pushes a user level */
+  void userPush()
+  {
+    d_userLimits.emplace_back(d_varInfo.size(), d_trail.size());
+    d_context->push();
+  }
+
+  /**
+   * Pops a user level. The variables introduced at the level are no longer
+   * observed, and the theory atoms that were fixed since the level was
+   * pushed are enqueued again in the restored SAT context.
+   */
+  void userPop()
+  {
+    Assert(d_trailLimits.empty());
+    Assert(!d_userLimits.empty());
+    d_context->pop();
+    auto [numVars, trailSize] = d_userLimits.back();
+    d_userLimits.pop_back();
+    for (size_t var = numVars, n = d_varInfo.size(); var < n; ++var)
+    {
+      VarInfo& info = d_varInfo[var];
+      if (info.d_active)
+      {
+        d_solver.remove_observed_var(toCadicalVar(var));
+        info.d_active = false;
+        info.d_assignment = 0;
+      }
+    }
+    std::vector<int> kept;
+    for (size_t i = trailSize, n = d_trail.size(); i < n; ++i)
+    {
+      if (static_cast<size_t>(std::abs(d_trail[i])) < numVars)
+      {
+        kept.push_back(d_trail[i]);
+      }
+    }
+    d_trail.resize(trailSize);
+    for (int lit : kept)
+    {
+      VarInfo& info = d_varInfo[std::abs(lit)];
+      info.d_trailIndex = d_trail.size();
+      info.d_level = d_context->getLevel();
+      d_trail.push_back(lit);
+      if (info.d_theoryAtom)
+      {
+        d_proxy->enqueueTheoryLiteral(toSatLiteral(lit));
+      }
+    }
+    d_varsToRegister.clear();
+    d_checkPending = true;
+  }
+
+  /** Get the current value of lit */
+  SatValue value(SatLiteral lit) const
+  {
+    SatVariable var = lit.getSatVariable();
+    Assert(var < d_varInfo.size());
+    int8_t assignment = d_varInfo[var].d_assignment;
+    if (assignment == 0)
+    {
+      return SAT_VALUE_UNKNOWN;
+    }
+    return (assignment > 0) != lit.isNegated() ? SAT_VALUE_TRUE
+                                               : SAT_VALUE_FALSE;
+  }
+
+  /** Get the SAT context level at which var was assigned, or -1 */
+  int32_t getAssignmentLevel(SatVariable var) const
+  {
+    Assert(var < d_varInfo.size());
+    const VarInfo& info = d_varInfo[var];
+    return info.d_assignment == 0 ? -1 : info.d_level;
+  }
+
+  /** Is expl true and assigned before the true literal lit? */
+  bool properExplanation(SatLiteral lit, SatLiteral expl) const
+  {
+    if (value(lit) != SAT_VALUE_TRUE || value(expl) != SAT_VALUE_TRUE)
+    {
+      return false;
+    }
+    return d_varInfo[expl.getSatVariable()].d_trailIndex
+           < d_varInfo[lit.getSatVariable()].d_trailIndex;
+  }
+
+ private:
+  struct VarInfo
+  {
+    /** 1 if true, -1 if false, 0 if unassigned */
+    int8_t d_assignment = 0;
+    /** Whether the assignment is fixed at the root level */
+    bool d_fixed = false;
+    /** Whether the variable is a theory atom */
+    bool d_theoryAtom = false;
+    /** Whether the variable belongs to a user level that was not popped */
+    bool d_active = true;
+    /** The position of the variable on the trail, if it is assigned */
+    size_t d_trailIndex = 0;
+    /** The SAT context level at which the variable was assigned */
+    int32_t d_level = 0;
+  };
+
+  static SatLiteral toSatLiteral(int lit)
+  {
+    return SatLiteral(std::abs(lit), lit < 0);
+  }
+
+  bool hasPendingClauses() const
+  {
+    return d_newClausesHead < d_newClauses.size();
+  }
+
+  /** Adds the explanation of the propagated literal lit as a clause */
+  void addExplanationClause(SatLiteral lit)
+  {
+    SatClause explanation;
+    d_proxy->explainPropagation(lit, explanation);
+    std::vector<int> clause;
+    for (const SatLiteral& l : explanation)
+    {
+      clause.push_back(toCadicalLit(l));
+    }
+    addClause(clause);
+  }
+
+  /** The theory proxy */
+  prop::TheoryProxy* d_proxy;
+  /** The SAT context */
+  context::Context* d_context;
+  /** The solver this propagator is connected to */
+  CaDiCaL::Solver& d_solver;
+  /** The SAT context level at which the current search started */
+  int d_baseLevel;
+  /** The information about each variable, indexed by variable */
+  std::vector<VarInfo> d_varInfo;
+  /** The assigned literals, in order of assignment */
+  std::vector<int> d_trail;
+  /** The size of the trail at the start of each decision level */
+  std::vector<size_t> d_trailLimits;
+  /** The number of variables and the size of the trail at each user push */
+  std::vector<std::pair<size_t, size_t>> d_userLimits;
+  /**
+   * The variables that must be reregistered with the theories when
+   * backtracking below the decision level they were introduced at.
+   */
+  std::vector<std::pair<SatVariable, size_t>> d_varsToRegister;
+  /** The clauses that were not handed to CaDiCaL yet, each ended by 0 */
+  std::vector<int> d_newClauses;
+  size_t d_newClausesHead;
+  /** The theory propagations that were not handed to CaDiCaL yet */
+  SatClause d_propagations;
+  size_t d_propagationsHead;
+  /** The reason clause that is handed to CaDiCaL */
+  std::vector<int> d_reason;
+  size_t d_reasonHead;
+  bool d_inReason;
+  /** Whether literals were assigned since the last theory check */
+  bool d_checkPending;
+  /** Whether variables were introduced since the last found model */
+  bool d_newVars;
+  /** Whether CaDiCaL is searching */
+  bool d_inSearch;
+
+  struct Statistics
+  {
+    StatisticsRegistry* d_registry;
+    IntStat d_numPropagations;
+    IntStat d_numExternalClauses;
+    IntStat d_numFullChecks;
+    Statistics(StatisticsRegistry* registry)
+        : d_registry(registry),
+          d_numPropagations("prop::cadical::theory_propagations", 0),
+          d_numExternalClauses("prop::cadical::external_clauses", 0),
+          d_numFullChecks("prop::cadical::full_checks", 0)
+    {
+      d_registry->registerStat(&d_numPropagations);
+      d_registry->registerStat(&d_numExternalClauses);
+      d_registry->registerStat(&d_numFullChecks);
+    }
+    ~Statistics()
+    {
+      d_registry->unregisterStat(&d_numPropagations);
+      d_registry->unregisterStat(&d_numExternalClauses);
+      d_registry->unregisterStat(&d_numFullChecks);
+    }
+  };
+
+  Statistics d_statistics;
+};
+
 CadicalSolver::CadicalSolver(StatisticsRegistry* registry,
-                             const std::string& name)
+                             const std::string& prefix)
     : d_solver(new CaDiCaL::Solver()),
       // Note: CaDiCaL variables start with index 1 rather than 0 since negated
       //       literals are represented as the negation of the index.
       d_nextVarIdx(1),
       d_inSatMode(false),
-      d_statistics(registry, name)
+      d_statistics(registry, prefix)
 {
 }
 
@@ -78,15 +577,39 @@ void CadicalSolver::init()
   d_solver->add(0);
 }
 
-CadicalSolver::~CadicalSolver() {}
+CadicalSolver::~CadicalSolver()
+{
+  if (d_propagator)
+  {
+    d_solver->disconnect_external_propagator();
+  }
+}
 
 ClauseId CadicalSolver::addClause(SatClause& clause, bool removable)
 {
+  // CaDiCaL has no removable clauses, removable lemmas are kept.
+  std::vector<CadicalLit> lits;
   for (const SatLiteral& lit : clause)
   {
-    d_solver->add(toCadicalLit(lit));
+    lits.push_back(toCadicalLit(lit));
+  }
+  // clauses of a user level only hold while its activation literal is assumed
+  if (!d_activationLits.empty())
+  {
+    lits.push_back(-toCadicalLit(d_activationLits.back()));
+  }
+  if (d_propagator)
+  {
+    d_propagator->addClause(lits);
+  }
+  else
+  {
+    for (CadicalLit lit : lits)
+    {
+      d_solver->add(lit);
+    }
+    d_solver->add(0);
   }
-  d_solver->add(0);
   ++d_statistics.d_numClauses;
   return ClauseIdError;
 }
@@ -103,7 +626,12 @@ SatVariable CadicalSolver::newVar(bool isTheoryAtom,
                                   bool canErase)
 {
   ++d_statistics.d_numVariables;
-  return d_nextVarIdx++;
+  SatVariable var = d_nextVarIdx++;
+  if (d_propagator)
+  {
+    d_propagator->addNewVar(var, isTheoryAtom, preRegister);
+  }
+  return var;
 }
 
 SatVariable CadicalSolver::trueVar() { return d_true; }
@@ -114,10 +642,7 @@ SatValue CadicalSolver::solve()
 {
   TimerStat::CodeTimer codeTimer(d_statistics.d_solveTime);
   d_assumptions.clear();
-  SatValue res = toSatValue(d_solver->solve());
-  d_inSatMode = (res == SAT_VALUE_TRUE);
-  ++d_statistics.d_numSatCalls;
-  return res;
+  return solveInternal();
 }
 
 SatValue CadicalSolver::solve(long unsigned int&)
@@ -134,7 +659,24 @@ SatValue CadicalSolver::solve(const std::vector<SatLiteral>& assumptions)
     d_solver->assume(toCadicalLit(lit));
     d_assumptions.push_back(lit);
   }
+  return solveInternal();
+}
+
+SatValue CadicalSolver::solveInternal()
+{
+  if (d_propagator)
+  {
+    d_propagator->beginSearch();
+  }
+  for (const SatLiteral& lit : d_activationLits)
+  {
+    d_solver->assume(toCadicalLit(lit));
+  }
   SatValue res = toSatValue(d_solver->solve());
+  if (d_propagator)
+  {
+    d_propagator->endSearch();
+  }
   d_inSatMode = (res == SAT_VALUE_TRUE);
   ++d_statistics.d_numSatCalls;
   return res;
@@ -161,6 +703,10 @@ void CadicalSolver::interrupt() { d_solver->terminate(); }
 
 SatValue CadicalSolver::value(SatLiteral l)
 {
+  if (d_propagator)
+  {
+    return d_propagator->value(l);
+  }
   Assert(d_inSatMode);
   return toSatValueLit(d_solver->val(toCadicalLit(l)));
 }
@@ -173,18 +719,93 @@ SatValue CadicalSolver::modelValue(SatLiteral l)
 
 unsigned CadicalSolver::getAssertionLevel() const
 {
-  Unreachable() << "CaDiCaL does not support assertion levels.";
+  return d_activationLits.size();
 }
 
 bool CadicalSolver::ok() const { return d_inSatMode; }
 
+void CadicalSolver::initialize(context::Context* context,
+                               prop::TheoryProxy* theoryProxy,
+                               CVC4::context::UserContext* userContext,
+                               ProofNodeManager* pnm)
+{
+  AlwaysAssert(pnm == nullptr) << "CaDiCaL does not support proofs.";
+  d_propagator.reset(new CadicalPropagator(
+      theoryProxy, context, *d_solver, d_statistics.d_registry));
+  d_solver->connect_external_propagator(d_propagator.get());
+  // the variables created by init()
+  for (SatVariable var = 1; var < d_nextVarIdx; ++var)
+  {
+    d_propagator->addNewVar(var, false, false);
+  }
+}
+
+void CadicalSolver::push()
+{
+  SatVariable act = newVar();
+  d_activationLits.push_back(SatLiteral(act));
+  if (d_propagator)
+  {
+    d_propagator->userPush();
+  }
+}
+
+void CadicalSolver::pop()
+{
+  Assert(!d_activationLits.empty());
+  SatLiteral act = d_activationLits.back();
+  d_activationLits.pop_back();
+  // the clauses of the popped level are disabled for good
+  d_solver->add(-toCadicalLit(act));
+  d_solver->add(0);
+  if (d_propagator)
+  {
+    d_propagator->userPop();
+  }
+}
+
+void CadicalSolver::resetTrail()
+{
+  if (d_propagator)
+  {
+    d_propagator->backtrack(0);
+  }
+}
+
+bool CadicalSolver::properExplanation(SatLiteral lit, SatLiteral expl) const
+{
+  return d_propagator && d_propagator->properExplanation(lit, expl);
+}
+
+int32_t CadicalSolver::getAssignmentLevel(SatVariable var) const
+{
+  return d_propagator ? d_propagator->getAssignmentLevel(var) : -1;
+}
+
+void CadicalSolver::requirePhase(SatLiteral lit)
+{
+  d_solver->phase(toCadicalLit(lit));
+}
+
+bool CadicalSolver::isDecision(SatVariable decn) const
+{
+  return d_solver->is_decision(toCadicalVar(decn));
+}
+
+std::shared_ptr<ProofNode> CadicalSolver::getProof()
+{
+  // setDefaults uses minisat whenever proofs are enabled, hence CaDiCaL is
+  // never initialized with a proof node manager
+  Unreachable() << "Proofs are not supported with CaDiCaL";
+}
+
 CadicalSolver::Statistics::Statistics(StatisticsRegistry* registry,
                                       const std::string& prefix)
     : d_registry(registry),
-      d_numSatCalls("theory::bv::" + prefix + "::cadical::calls_to_solve", 0),
-      d_numVariables("theory::bv::" + prefix + "::cadical::variables", 0),
-      d_numClauses("theory::bv::" + prefix + "::cadical::clauses", 0),
-      d_solveTime("theory::bv::" + prefix + "::cadical::solve_time")
+      d_numSatCalls(prefix + "::cadical::calls_to_solve", 0),
+      d_numVariables(prefix + "::cadical::variables", 0),
+      d_numClauses(prefix + "::cadical::clauses", 0),
+      d_solveTime(prefix + "::cadical::solve_time")
 {
   d_registry->registerStat(&d_numSatCalls);
   d_registry->registerStat(&d_numVariables);
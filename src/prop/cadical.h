@@ -11,7 +11,10 @@
  **
  ** \brief Wrapper for CaDiCaL SAT Solver.
  **
- ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors).
+ ** Implementation of the CaDiCaL SAT solver for CVC4. It is used for
+ ** bit-blasting, and as the SAT solver of the main CDCL(T) engine, where it
+ ** communicates with the theories through CaDiCaL's external propagator
+ ** interface (IPASIR-UP).
  **/
 
 #include "cvc4_private.h"
@@ -28,7 +31,9 @@
 namespace CVC4 {
 namespace prop {
 
-class CadicalSolver : public SatSolver
+class CadicalPropagator;
+
+class CadicalSolver : public CDCLTSatSolverInterface
 {
   friend class SatSolverFactory;
 
@@ -63,19 +68,63 @@ class CadicalSolver : public SatSolver
 
   bool ok() const override;
 
+  /* CDCLTSatSolverInterface ------------------------------------------- */
+
+  /**
+   * Connects the theories to this solver. This is only done if this solver is
+   * the SAT solver of the main CDCL(T) engine.
+   */
+  void initialize(context::Context* context,
+                  prop::TheoryProxy* theoryProxy,
+                  CVC4::context::UserContext* userContext,
+                  ProofNodeManager* pnm) override;
+
+  /**
+   * Pushes a user level. The clauses added at a user level are guarded by the
+   * activation literal of the level, which is assumed in solve() and asserted
+   * false when the level is popped.
+   */
+  void push() override;
+
+  void pop() override;
+
+  void resetTrail() override;
+
+  bool properExplanation(SatLiteral lit, SatLiteral expl) const override;
+
+  void requirePhase(SatLiteral lit) override;
+
+  bool isDecision(SatVariable decn) const override;
+
+  int32_t getAssignmentLevel(SatVariable var) const override;
+
+  std::shared_ptr<ProofNode> getProof() override;
+
  private:
   /**
    * Private to disallow creation outside of SatSolverFactory.
    * Function init() must be called after creation.
+   *
+   * The statistics are registered with the given prefix.
    */
-  CadicalSolver(StatisticsRegistry* registry, const std::string& name = "");
+  CadicalSolver(StatisticsRegistry* registry, const std::string& prefix);
   /**
    * Initialize SAT solver instance.
    * Note: Split out to not call virtual functions in constructor.
    */
   void init();
 
+  /** Solves under the current assumptions and activation literals */
+  SatValue solveInternal();
+
   std::unique_ptr<CaDiCaL::Solver> d_solver;
+  /**
+   * The propagator that connects the theories to d_solver, which is only set
+   * if this is the SAT solver of the main CDCL(T) engine.
+   */
+  std::unique_ptr<CadicalPropagator> d_propagator;
+  /** The activation literals of the pushed user levels */
+  std::vector<SatLiteral> d_activationLits;
   /**
    * Stores the current set of assumptions provided via solve() and is used to
    * query the solver if a given assumption is false.
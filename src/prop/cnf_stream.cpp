@@ -34,6 +34,7 @@
 #include "smt/smt_engine.h"
 #include "printer/printer.h"
 #include "smt/smt_engine_scope.h"
+#include "smt/smt_statistics_registry.h"
 #include "theory/theory.h"
 #include "theory/theory_engine.h"
 
@@ -46,7 +47,8 @@ CnfStream::CnfStream(SatSolver* satSolver,
                      OutputManager* outMgr,
                      ResourceManager* rm,
                      FormulaLitPolicy flpol,
-                     std::string name)
+                     std::string name,
+                     bool polarity)
     : d_satSolver(satSolver),
       d_outMgr(outMgr),
       d_booleanVariables(context),
@@ -58,10 +60,37 @@ CnfStream::CnfStream(SatSolver* satSolver,
       d_name(name),
       d_cnfProof(nullptr),
       d_removable(false),
+      d_polarity(polarity && flpol != FormulaLitPolicy::TRACK_AND_NOTIFY),
+      d_gatePolarity(context),
+      d_statistics(name),
       d_resourceManager(rm)
 {
 }
 
+CnfStream::Statistics::Statistics(const std::string& prefix)
+    : d_numClauses(prefix + "::cnf::clauses", 0),
+      d_numVariables(prefix + "::cnf::variables", 0),
+      d_numCompletions(prefix + "::cnf::completedDefinitions", 0),
+      d_registerStats(!prefix.empty())
+{
+  if (d_registerStats)
+  {
+    smtStatisticsRegistry()->registerStat(&d_numClauses);
+    smtStatisticsRegistry()->registerStat(&d_numVariables);
+    smtStatisticsRegistry()->registerStat(&d_numCompletions);
+  }
+}
+
+CnfStream::Statistics::~Statistics()
+{
+  if (d_registerStats)
+  {
+    smtStatisticsRegistry()->unregisterStat(&d_numClauses);
+    smtStatisticsRegistry()->unregisterStat(&d_numVariables);
+    smtStatisticsRegistry()->unregisterStat(&d_numCompletions);
+  }
+}
+
 bool CnfStream::assertClause(TNode node, SatClause& c)
 {
   Trace("cnf") << "Inserting into stream " << c << " node = " << node << "\n";
@@ -86,6 +115,7 @@ bool CnfStream::assertClause(TNode node, SatClause& c)
     }
   }
 
+  ++d_statistics.d_numClauses;
   ClauseId clauseId = d_satSolver->addClause(c, d_removable);
 
   if (d_cnfProof && clauseId != ClauseIdUndef)
@@ -151,6 +181,11 @@ void CnfStream::ensureLiteral(TNode n)
   Trace("cnf") << "ensureLiteral(" << n << ")\n";
   if (hasLiteral(n))
   {
+    if (d_polarity)
+    {
+      // the literal must be definitionally equal to n
+      toCNF(n, false, POL_BOTH);
+    }
     ensureMappingForLiteral(n);
     return;
   }
@@ -222,6 +257,7 @@ SatLiteral CnfStream::newLiteral(TNode node, bool isTheoryAtom, bool preRegister
     } else {
       Trace("cnf") << d_name << "::newLiteral: new var\n";
       lit = SatLiteral(d_satSolver->newVar(isTheoryAtom, preRegister, canEliminate));
+      ++d_statistics.d_numVariables;
     }
     d_nodeToLiteralMap.insert(node, lit);
     d_nodeToLiteralMap.insert(node.notNode(), ~lit);
@@ -324,9 +360,14 @@ SatLiteral CnfStream::getLiteral(TNode node) {
   return literal;
 }
 
-SatLiteral CnfStream::handleXor(TNode xorNode)
+SatLiteral CnfStream::getOrNewLiteral(TNode node)
 {
-  Assert(!hasLiteral(xorNode)) << "Atom already mapped!";
+  return hasLiteral(node) ? getLiteral(node) : newLiteral(node);
+}
+
+SatLiteral CnfStream::handleXor(TNode xorNode, Polarity pol)
+{
+  Assert(d_polarity || !hasLiteral(xorNode)) << "Atom already mapped!";
   Assert(xorNode.getKind() == kind::XOR) << "Expecting an XOR expression!";
   Assert(xorNode.getNumChildren() == 2) << "Expecting exactly 2 children!";
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
@@ -335,19 +376,25 @@ SatLiteral CnfStream::handleXor(TNode xorNode)
   SatLiteral a = toCNF(xorNode[0]);
   SatLiteral b = toCNF(xorNode[1]);
 
-  SatLiteral xorLit = newLiteral(xorNode);
+  SatLiteral xorLit = getOrNewLiteral(xorNode);
 
-  assertClause(xorNode.negate(), a, b, ~xorLit);
-  assertClause(xorNode.negate(), ~a, ~b, ~xorLit);
-  assertClause(xorNode, a, ~b, xorLit);
-  assertClause(xorNode, ~a, b, xorLit);
+  if (pol & POL_POS)
+  {
+    assertClause(xorNode.negate(), a, b, ~xorLit);
+    assertClause(xorNode.negate(), ~a, ~b, ~xorLit);
+  }
+  if (pol & POL_NEG)
+  {
+    assertClause(xorNode, a, ~b, xorLit);
+    assertClause(xorNode, ~a, b, xorLit);
+  }
 
   return xorLit;
 }
 
-SatLiteral CnfStream::handleOr(TNode orNode)
+SatLiteral CnfStream::handleOr(TNode orNode, Polarity pol)
 {
-  Assert(!hasLiteral(orNode)) << "Atom already mapped!";
+  Assert(d_polarity || !hasLiteral(orNode)) << "Atom already mapped!";
   Assert(orNode.getKind() == kind::OR) << "Expecting an OR expression!";
   Assert(orNode.getNumChildren() > 1) << "Expecting more then 1 child!";
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
@@ -361,32 +408,40 @@ SatLiteral CnfStream::handleOr(TNode orNode)
   TNode::const_iterator node_it_end = orNode.end();
   SatClause clause(n_children + 1);
   for(int i = 0; node_it != node_it_end; ++node_it, ++i) {
-    clause[i] = toCNF(*node_it);
+    clause[i] = toCNF(*node_it, false, pol);
   }
 
   // Get the literal for this node
-  SatLiteral orLit = newLiteral(orNode);
+  SatLiteral orLit = getOrNewLiteral(orNode);
 
   // lit <- (a_1 | a_2 | a_3 | ... | a_n)
   // lit | ~(a_1 | a_2 | a_3 | ... | a_n)
   // (lit | ~a_1) & (lit | ~a_2) & (lit & ~a_3) & ... & (lit & ~a_n)
-  for(unsigned i = 0; i < n_children; ++i) {
-    assertClause(orNode, orLit, ~clause[i]);
+  if (pol & POL_NEG)
+  {
+    for (unsigned i = 0; i < n_children; ++i)
+    {
+      assertClause(orNode, orLit, ~clause[i]);
+    }
   }
 
   // lit -> (a_1 | a_2 | a_3 | ... | a_n)
   // ~lit | a_1 | a_2 | a_3 | ... | a_n
-  clause[n_children] = ~orLit;
-  // This needs to go last, as the clause might get modified by the SAT solver
-  assertClause(orNode.negate(), clause);
+  if (pol & POL_POS)
+  {
+    clause[n_children] = ~orLit;
+    // This needs to go last, as the clause might get modified by the SAT
+    // solver
+    assertClause(orNode.negate(), clause);
+  }
 
   // Return the literal
   return orLit;
 }
 
-SatLiteral CnfStream::handleAnd(TNode andNode)
+SatLiteral CnfStream::handleAnd(TNode andNode, Polarity pol)
 {
-  Assert(!hasLiteral(andNode)) << "Atom already mapped!";
+  Assert(d_polarity || !hasLiteral(andNode)) << "Atom already mapped!";
   Assert(andNode.getKind() == kind::AND) << "Expecting an AND expression!";
   Assert(andNode.getNumChildren() > 1) << "Expecting more than 1 child!";
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
@@ -400,60 +455,74 @@ SatLiteral CnfStream::handleAnd(TNode andNode)
   TNode::const_iterator node_it_end = andNode.end();
   SatClause clause(n_children + 1);
   for(int i = 0; node_it != node_it_end; ++node_it, ++i) {
-    clause[i] = ~toCNF(*node_it);
+    clause[i] = ~toCNF(*node_it, false, pol);
   }
 
   // Get the literal for this node
-  SatLiteral andLit = newLiteral(andNode);
+  SatLiteral andLit = getOrNewLiteral(andNode);
 
   // lit -> (a_1 & a_2 & a_3 & ... & a_n)
   // ~lit | (a_1 & a_2 & a_3 & ... & a_n)
   // (~lit | a_1) & (~lit | a_2) & ... & (~lit | a_n)
-  for(unsigned i = 0; i < n_children; ++i) {
-    assertClause(andNode.negate(), ~andLit, ~clause[i]);
+  if (pol & POL_POS)
+  {
+    for (unsigned i = 0; i < n_children; ++i)
+    {
+      assertClause(andNode.negate(), ~andLit, ~clause[i]);
+    }
   }
 
   // lit <- (a_1 & a_2 & a_3 & ... a_n)
   // lit | ~(a_1 & a_2 & a_3 & ... & a_n)
   // lit | ~a_1 | ~a_2 | ~a_3 | ... | ~a_n
-  clause[n_children] = andLit;
-  // This needs to go last, as the clause might get modified by the SAT solver
-  assertClause(andNode, clause);
+  if (pol & POL_NEG)
+  {
+    clause[n_children] = andLit;
+    // This needs to go last, as the clause might get modified by the SAT
+    // solver
+    assertClause(andNode, clause);
+  }
 
   return andLit;
 }
 
-SatLiteral CnfStream::handleImplies(TNode impliesNode)
+SatLiteral CnfStream::handleImplies(TNode impliesNode, Polarity pol)
 {
-  Assert(!hasLiteral(impliesNode)) << "Atom already mapped!";
+  Assert(d_polarity || !hasLiteral(impliesNode)) << "Atom already mapped!";
   Assert(impliesNode.getKind() == kind::IMPLIES)
       << "Expecting an IMPLIES expression!";
   Assert(impliesNode.getNumChildren() == 2) << "Expecting exactly 2 children!";
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
   Trace("cnf") << "handleImplies(" << impliesNode << ")\n";
 
-  // Convert the children to cnf
-  SatLiteral a = toCNF(impliesNode[0]);
-  SatLiteral b = toCNF(impliesNode[1]);
+  // Convert the children to cnf, the antecedent in the opposite polarity
+  SatLiteral a = toCNF(impliesNode[0], false, flipPolarity(pol));
+  SatLiteral b = toCNF(impliesNode[1], false, pol);
 
-  SatLiteral impliesLit = newLiteral(impliesNode);
+  SatLiteral impliesLit = getOrNewLiteral(impliesNode);
 
   // lit -> (a->b)
   // ~lit | ~ a | b
-  assertClause(impliesNode.negate(), ~impliesLit, ~a, b);
+  if (pol & POL_POS)
+  {
+    assertClause(impliesNode.negate(), ~impliesLit, ~a, b);
+  }
 
   // (a->b) -> lit
   // ~(~a | b) | lit
   // (a | l) & (~b | l)
-  assertClause(impliesNode, a, impliesLit);
-  assertClause(impliesNode, ~b, impliesLit);
+  if (pol & POL_NEG)
+  {
+    assertClause(impliesNode, a, impliesLit);
+    assertClause(impliesNode, ~b, impliesLit);
+  }
 
   return impliesLit;
 }
 
-SatLiteral CnfStream::handleIff(TNode iffNode)
+SatLiteral CnfStream::handleIff(TNode iffNode, Polarity pol)
 {
-  Assert(!hasLiteral(iffNode)) << "Atom already mapped!";
+  Assert(d_polarity || !hasLiteral(iffNode)) << "Atom already mapped!";
   Assert(iffNode.getKind() == kind::EQUAL) << "Expecting an EQUAL expression!";
   Assert(iffNode.getNumChildren() == 2) << "Expecting exactly 2 children!";
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
@@ -464,28 +533,34 @@ SatLiteral CnfStream::handleIff(TNode iffNode)
   SatLiteral b = toCNF(iffNode[1]);
 
   // Get the now literal
-  SatLiteral iffLit = newLiteral(iffNode);
+  SatLiteral iffLit = getOrNewLiteral(iffNode);
 
   // lit -> ((a-> b) & (b->a))
   // ~lit | ((~a | b) & (~b | a))
   // (~a | b | ~lit) & (~b | a | ~lit)
-  assertClause(iffNode.negate(), ~a, b, ~iffLit);
-  assertClause(iffNode.negate(), a, ~b, ~iffLit);
+  if (pol & POL_POS)
+  {
+    assertClause(iffNode.negate(), ~a, b, ~iffLit);
+    assertClause(iffNode.negate(), a, ~b, ~iffLit);
+  }
 
   // (a<->b) -> lit
   // ~((a & b) | (~a & ~b)) | lit
   // (~(a & b)) & (~(~a & ~b)) | lit
   // ((~a | ~b) & (a | b)) | lit
   // (~a | ~b | lit) & (a | b | lit)
-  assertClause(iffNode, ~a, ~b, iffLit);
-  assertClause(iffNode, a, b, iffLit);
+  if (pol & POL_NEG)
+  {
+    assertClause(iffNode, ~a, ~b, iffLit);
+    assertClause(iffNode, a, b, iffLit);
+  }
 
   return iffLit;
 }
 
-SatLiteral CnfStream::handleIte(TNode iteNode)
+SatLiteral CnfStream::handleIte(TNode iteNode, Polarity pol)
 {
-  Assert(!hasLiteral(iteNode)) << "Atom already mapped!";
+  Assert(d_polarity || !hasLiteral(iteNode)) << "Atom already mapped!";
   Assert(iteNode.getKind() == kind::ITE);
   Assert(iteNode.getNumChildren() == 3);
   Assert(!d_removable) << "Removable clauses can not contain Boolean structure";
@@ -493,10 +568,10 @@ SatLiteral CnfStream::handleIte(TNode iteNode)
                << iteNode[2] << ")\n";
 
   SatLiteral condLit = toCNF(iteNode[0]);
-  SatLiteral thenLit = toCNF(iteNode[1]);
-  SatLiteral elseLit = toCNF(iteNode[2]);
+  SatLiteral thenLit = toCNF(iteNode[1], false, pol);
+  SatLiteral elseLit = toCNF(iteNode[2], false, pol);
 
-  SatLiteral iteLit = newLiteral(iteNode);
+  SatLiteral iteLit = getOrNewLiteral(iteNode);
 
   // If ITE is true then one of the branches is true and the condition
   // implies which one
@@ -504,9 +579,12 @@ SatLiteral CnfStream::handleIte(TNode iteNode)
   // lit -> (t | e) & (b -> t) & (!b -> e)
   // lit -> (t | e) & (!b | t) & (b | e)
   // (!lit | t | e) & (!lit | !b | t) & (!lit | b | e)
-  assertClause(iteNode.negate(), ~iteLit, thenLit, elseLit);
-  assertClause(iteNode.negate(), ~iteLit, ~condLit, thenLit);
-  assertClause(iteNode.negate(), ~iteLit, condLit, elseLit);
+  if (pol & POL_POS)
+  {
+    assertClause(iteNode.negate(), ~iteLit, thenLit, elseLit);
+    assertClause(iteNode.negate(), ~iteLit, ~condLit, thenLit);
+    assertClause(iteNode.negate(), ~iteLit, condLit, elseLit);
+  }
 
   // If ITE is false then one of the branches is false and the condition
   // implies which one
@@ -514,45 +592,106 @@ SatLiteral CnfStream::handleIte(TNode iteNode)
   // !lit -> (!t | !e) & (b -> !t) & (!b -> !e)
   // !lit -> (!t | !e) & (!b | !t) & (b | !e)
   // (lit | !t | !e) & (lit | !b | !t) & (lit | b | !e)
-  assertClause(iteNode, iteLit, ~thenLit, ~elseLit);
-  assertClause(iteNode, iteLit, ~condLit, ~thenLit);
-  assertClause(iteNode, iteLit, condLit, ~elseLit);
+  if (pol & POL_NEG)
+  {
+    assertClause(iteNode, iteLit, ~thenLit, ~elseLit);
+    assertClause(iteNode, iteLit, ~condLit, ~thenLit);
+    assertClause(iteNode, iteLit, condLit, ~elseLit);
+  }
 
   return iteLit;
 }
 
-SatLiteral CnfStream::toCNF(TNode node, bool negated)
+SatLiteral CnfStream::convertGate(TNode node, Polarity pol)
+{
+  SatLiteral nodeLit;
+  switch (node.getKind())
+  {
+    case kind::XOR: nodeLit = handleXor(node, pol); break;
+    case kind::ITE: nodeLit = handleIte(node, pol); break;
+    case kind::IMPLIES: nodeLit = handleImplies(node, pol); break;
+    case kind::OR: nodeLit = handleOr(node, pol); break;
+    case kind::AND: nodeLit = handleAnd(node, pol); break;
+    case kind::EQUAL:
+      if (node[0].getType().isBoolean())
+      {
+        nodeLit = handleIff(node, pol);
+        break;
+      }
+      CVC4_FALLTHROUGH;
+    default:
+    {
+      // Atoms are equal to their literal
+      return convertAtom(node);
+    }
+  }
+  if (d_polarity)
+  {
+    // Remember the polarities of gates that are not defined in both
+    NodeToPolarityMap::const_iterator it = d_gatePolarity.find(node);
+    if (it != d_gatePolarity.end())
+    {
+      d_gatePolarity.insert(node, static_cast<Polarity>((*it).second | pol));
+    }
+    else if (pol != POL_BOTH)
+    {
+      d_gatePolarity.insert(node, pol);
+    }
+  }
+  return nodeLit;
+}
+
+SatLiteral CnfStream::toCNF(TNode node, bool negated, Polarity pol)
 {
   Trace("cnf") << "toCNF(" << node
                << ", negated = " << (negated ? "true" : "false") << ")\n";
   SatLiteral nodeLit;
-  Node negatedNode = node.notNode();
+  // The polarity in which the non-negated node is used
+  Polarity npol = POL_BOTH;
+  if (d_polarity)
+  {
+    npol = negated ? flipPolarity(pol) : pol;
+    // Negations are not mapped independently of the negated node, go to the
+    // latter to check whether its definition is complete
+    if (node.getKind() == kind::NOT)
+    {
+      return toCNF(node[0], !negated, pol);
+    }
+  }
 
   // If the non-negated node has already been translated, get the translation
   if(hasLiteral(node)) {
     Trace("cnf") << "toCNF(): already translated\n";
     nodeLit = getLiteral(node);
+    if (d_polarity)
+    {
+      NodeToPolarityMap::const_iterator it = d_gatePolarity.find(node);
+      Polarity missing = static_cast<Polarity>(
+          it == d_gatePolarity.end() ? 0 : npol & ~(*it).second);
+      if (missing != 0)
+      {
+        Trace("cnf") << "toCNF(): completing definition\n";
+        ++d_statistics.d_numCompletions;
+        // The definition of the literal is permanent even if we are
+        // converting a removable clause, which may be a lemma that uses it
+        // in the polarity it was not defined in.
+        bool backupRemovable = d_removable;
+        d_removable = false;
+        convertGate(node, missing);
+        d_removable = backupRemovable;
+      }
+    }
     // Return the (maybe negated) literal
     return !negated ? nodeLit : ~nodeLit;
   }
   // Handle each Boolean operator case
-  switch (node.getKind())
+  if (node.getKind() == kind::NOT)
   {
-    case kind::NOT: nodeLit = ~toCNF(node[0]); break;
-    case kind::XOR: nodeLit = handleXor(node); break;
-    case kind::ITE: nodeLit = handleIte(node); break;
-    case kind::IMPLIES: nodeLit = handleImplies(node); break;
-    case kind::OR: nodeLit = handleOr(node); break;
-    case kind::AND: nodeLit = handleAnd(node); break;
-    case kind::EQUAL:
-      nodeLit =
-          node[0].getType().isBoolean() ? handleIff(node) : convertAtom(node);
-      break;
-    default:
-    {
-      nodeLit = convertAtom(node);
-    }
-    break;
+    nodeLit = ~toCNF(node[0]);
+  }
+  else
+  {
+    nodeLit = convertGate(node, npol);
   }
   // Return the (maybe negated) literal
   Trace("cnf") << "toCNF(): resulting literal: "
@@ -578,7 +717,7 @@ void CnfStream::convertAndAssertAnd(TNode node, bool negated)
     TNode::const_iterator disjunct = node.begin();
     for(int i = 0; i < nChildren; ++ disjunct, ++ i) {
       Assert(disjunct != node.end());
-      clause[i] = toCNF(*disjunct, true);
+      clause[i] = toCNF(*disjunct, true, POL_POS);
     }
     Assert(disjunct == node.end());
     assertClause(node.negate(), clause);
@@ -597,7 +736,7 @@ void CnfStream::convertAndAssertOr(TNode node, bool negated)
     TNode::const_iterator disjunct = node.begin();
     for(int i = 0; i < nChildren; ++ disjunct, ++ i) {
       Assert(disjunct != node.end());
-      clause[i] = toCNF(*disjunct, false);
+      clause[i] = toCNF(*disjunct, false, POL_POS);
     }
     Assert(disjunct == node.end());
     assertClause(node, clause);
@@ -685,8 +824,8 @@ void CnfStream::convertAndAssertImplies(TNode node, bool negated)
                << ", negated = " << (negated ? "true" : "false") << ")\n";
   if (!negated) {
     // p => q
-    SatLiteral p = toCNF(node[0], false);
-    SatLiteral q = toCNF(node[1], false);
+    SatLiteral p = toCNF(node[0], false, POL_NEG);
+    SatLiteral q = toCNF(node[1], false, POL_POS);
     // Construct the clause ~p || q
     SatClause clause(2);
     clause[0] = ~p;
@@ -706,8 +845,8 @@ void CnfStream::convertAndAssertIte(TNode node, bool negated)
                << ", negated = " << (negated ? "true" : "false") << ")\n";
   // ITE(p, q, r)
   SatLiteral p = toCNF(node[0], false);
-  SatLiteral q = toCNF(node[1], negated);
-  SatLiteral r = toCNF(node[2], negated);
+  SatLiteral q = toCNF(node[1], negated, POL_POS);
+  SatLiteral r = toCNF(node[2], negated, POL_POS);
   // Construct the clauses:
   // (p => q) and (!p => r)
   //
@@ -781,7 +920,7 @@ void CnfStream::convertAndAssert(TNode node, bool negated)
         nnode = node.negate();
       }
       // Atoms
-      assertClause(nnode, toCNF(node, negated));
+      assertClause(nnode, toCNF(node, negated, POL_POS));
   }
     break;
   }
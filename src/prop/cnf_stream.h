@@ -25,6 +25,7 @@
 #ifndef CVC4__PROP__CNF_STREAM_H
 #define CVC4__PROP__CNF_STREAM_H
 
+#include "context/cdhashmap.h"
 #include "context/cdhashset.h"
 #include "context/cdinsert_hashmap.h"
 #include "context/cdlist.h"
@@ -33,6 +34,7 @@
 #include "prop/proof_cnf_stream.h"
 #include "prop/registrar.h"
 #include "prop/theory_proxy.h"
+#include "util/statistics_registry.h"
 
 namespace CVC4 {
 
@@ -61,6 +63,11 @@ enum class FormulaLitPolicy : uint32_t
  * The general idea is to introduce a new literal that will be equivalent to
  * each subexpression in the constructed equi-satisfiable formula, then
  * substitute the new literal for the formula, and so on, recursively.
+ *
+ * With the polarity-aware encoding of Plaisted and Greenbaum, the literal of
+ * a subexpression only implies it, or is only implied by it, if the literal
+ * occurs only positively, or only negatively, in the clauses. The missing
+ * direction is added when the literal is later used in the other polarity.
  */
 class CnfStream {
   friend PropEngine;
@@ -89,7 +96,12 @@ class CnfStream {
    * @param flpol policy for literals corresponding to formulas (those that are
    * not-theory literals).
    * @param name string identifier to distinguish between different instances
-   * even for non-theory literals.
+   * even for non-theory literals. The statistics of named instances are
+   * registered with this name as prefix.
+   * @param polarity whether to define the literals of Boolean gates only in
+   * the polarities in which they are used (Plaisted-Greenbaum encoding). This
+   * is ignored if flpol is FormulaLitPolicy::TRACK_AND_NOTIFY, since the
+   * literals of notified formulas must be equivalent to them.
    */
   CnfStream(SatSolver* satSolver,
             Registrar* registrar,
@@ -97,7 +109,8 @@ class CnfStream {
             OutputManager* outMgr,
             ResourceManager* rm,
             FormulaLitPolicy flpol = FormulaLitPolicy::INTERNAL,
-            std::string name = "");
+            std::string name = "",
+            bool polarity = false);
   /**
    * Convert a given formula to CNF and assert it to the SAT solver.
    *
@@ -178,6 +191,29 @@ class CnfStream {
   void convertAndAssertImplies(TNode node, bool negated);
   void convertAndAssertIte(TNode node, bool negated);
 
+  /**
+   * Bit masks for the directions of the definition of the literal lit of a
+   * Boolean gate. The positive direction, lit -> gate, is needed if lit may
+   * be asserted true, i.e. if it occurs positively in a clause. The negative
+   * direction, gate -> lit, is needed if lit may be asserted false.
+   */
+  enum Polarity : uint8_t
+  {
+    POL_POS = 1,
+    POL_NEG = 2,
+    POL_BOTH = 3
+  };
+  /** Get the polarity of the negation of a literal of polarity pol */
+  static Polarity flipPolarity(Polarity pol)
+  {
+    return static_cast<Polarity>(((pol & POL_POS) << 1)
+                                 | ((pol & POL_NEG) >> 1));
+  }
+
+  /** Map from Boolean gates to the polarities of their definitions */
+  typedef context::CDHashMap<Node, Polarity, NodeHashFunction>
+      NodeToPolarityMap;
+
   /**
    * Transforms the node into CNF recursively and yields a literal
    * definitionally equal to it.
@@ -186,22 +222,39 @@ class CnfStream {
    * and literals to avoid redundant work and to retrieve formulas from literals
    * and vice-versa.
    *
+   * If d_polarity is true, the returned literal is only defined in the
+   * polarity pol, i.e. it implies the (maybe negated) formula if pol is
+   * POL_POS and is implied by it if pol is POL_NEG. If the formula already
+   * has a literal, the missing direction of its definition is added.
+   *
    * @param node the formula to transform
    * @param negated whether the literal is negated
+   * @param pol the polarity in which the returned literal is used
    * @return the literal representing the root of the formula
    */
-  SatLiteral toCNF(TNode node, bool negated = false);
+  SatLiteral toCNF(TNode node, bool negated = false, Polarity pol = POL_BOTH);
+
+  /**
+   * Converts the Boolean gate node in polarity pol by calling the clausifier
+   * of its kind, or converts it as an atom if it is not a Boolean gate.
+   */
+  SatLiteral convertGate(TNode node, Polarity pol);
 
   /** Specific clausifiers, based on the formula kinds, that clausify a formula,
    * by calling toCNF into each of the formula's children under the respective
-   * kind, and introduce a literal definitionally equal to it. */
+   * kind, and introduce a literal definitionally equal to it, or implying
+   * it (POL_POS) or implied by it (POL_NEG) according to pol. If the formula
+   * already has a literal, they only add the clauses of its definition. */
   SatLiteral handleNot(TNode node);
-  SatLiteral handleXor(TNode node);
-  SatLiteral handleImplies(TNode node);
-  SatLiteral handleIff(TNode node);
-  SatLiteral handleIte(TNode node);
-  SatLiteral handleAnd(TNode node);
-  SatLiteral handleOr(TNode node);
+  SatLiteral handleXor(TNode node, Polarity pol);
+  SatLiteral handleImplies(TNode node, Polarity pol);
+  SatLiteral handleIff(TNode node, Polarity pol);
+  SatLiteral handleIte(TNode node, Polarity pol);
+  SatLiteral handleAnd(TNode node, Polarity pol);
+  SatLiteral handleOr(TNode node, Polarity pol);
+
+  /** Get the literal of node, or a new literal for it if it has none */
+  SatLiteral getOrNewLiteral(TNode node);
 
   /** Stores the literal of the given node in d_literalToNodeMap.
    *
@@ -252,6 +305,37 @@ class CnfStream {
    */
   bool d_removable;
 
+  /**
+   * Whether the literals of Boolean gates are only defined in the polarities
+   * in which they are used.
+   */
+  const bool d_polarity;
+
+  /**
+   * The polarities in which the Boolean gates that are not defined in both
+   * polarities are defined. Nodes with a literal that are not in this map are
+   * atoms or Boolean gates that are defined in both polarities.
+   */
+  NodeToPolarityMap d_gatePolarity;
+
+  /** Statistics of the CNF conversion */
+  struct Statistics
+  {
+    Statistics(const std::string& prefix);
+    ~Statistics();
+    /** Number of clauses sent to the SAT solver */
+    IntStat d_numClauses;
+    /** Number of SAT variables introduced for nodes */
+    IntStat d_numVariables;
+    /**
+     * Number of definitions of Boolean gates completed with the polarity
+     * they were not defined in
+     */
+    IntStat d_numCompletions;
+    /** Whether the statistics are registered, only if the prefix is nonempty */
+    bool d_registerStats;
+  } d_statistics;
+
   /**
    * Asserts the given clause to the sat solver.
    * @param node the node giving rise to this clause
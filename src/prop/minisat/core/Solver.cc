@@ -125,6 +125,13 @@ static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby r
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 25, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 3, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static IntOption     opt_tier2_reduce_inc  (_cat, "tier2-inc",   "Number of conflicts between demotions of unused tier-2 clauses", 10000, IntRange(1, INT32_MAX));
+static IntOption     opt_local_reduce_inc  (_cat, "local-inc",   "Number of conflicts between reductions of the local learnt clauses", 15000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_restart_K         (_cat, "K",           "The constant used to force restart",            0.8,      DoubleRange(0, false, 1, false));
+static DoubleOption  opt_restart_R         (_cat, "R",           "The constant used to block restart",            1.4,      DoubleRange(1, false, 5, false));
+static IntOption     opt_size_lbd_queue    (_cat, "szLBDQueue",  "The size of moving average for LBD (restarts)", 50,       IntRange(10, INT32_MAX));
+static IntOption     opt_size_trail_queue  (_cat, "szTrailQueue", "The size of moving average for trail (block restarts)", 5000, IntRange(10, INT32_MAX));
+static IntOption     opt_restart_block_min (_cat, "blk-min",     "Number of conflicts before restarts may be blocked", 10000, IntRange(0, INT32_MAX));
 
 //=================================================================================================
 // Proof declarations
@@ -187,6 +194,19 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy,
       learntsize_adjust_start_confl(100),
       learntsize_adjust_inc(1.5)
 
+      // Parameters (tiered clause database and glucose restarts):
+      //
+      ,
+      tiered_clause_db(false),
+      lbd_core(2),
+      lbd_tier2(6),
+      tier2_reduce_inc(opt_tier2_reduce_inc),
+      local_reduce_inc(opt_local_reduce_inc),
+      glucose_restart(false),
+      restart_K(opt_restart_K),
+      restart_R(opt_restart_R),
+      restart_block_min(opt_restart_block_min)
+
       // Statistics: (formerly in 'SolverStats')
       //
       ,
@@ -201,7 +221,14 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy,
       clauses_literals(0),
       learnts_literals(0),
       max_literals(0),
-      tot_literals(0)
+      tot_literals(0),
+      learnts_core(0),
+      learnts_tier2(0),
+      learnts_local(0),
+      lbd_promotions(0),
+      tier2_demotions(0),
+      reduce_dbs(0),
+      blocked_restarts(0)
 
       ,
       ok(true),
@@ -213,7 +240,11 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy,
       simpDB_props(0),
       order_heap(VarOrderLt(activity)),
       progress_estimate(0),
-      remove_satisfied(!enableIncremental)
+      remove_satisfied(!enableIncremental),
+      lbd_stamp_counter(0),
+      sum_lbd(0),
+      next_tier2_reduce(0),
+      next_local_reduce(0)
 
       // Resource constraints:
       //
@@ -232,6 +263,9 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy,
     ProofManager::currentPM()->initSatProof(this);
   }
 
+  lbd_queue.initSize(opt_size_lbd_queue);
+  trail_queue.initSize(opt_size_trail_queue);
+
   // Create the constant variables
   varTrue = newVar(true, false, false);
   varFalse = newVar(false, false, false);
@@ -442,6 +476,8 @@ CRef Solver::reason(Var x) {
       ProofManager::getCnfProof()->popCurrentAssertion();
     }
     vardata[x] = VarData(real_reason, level(x), user_level(x), intro_level(x), trail_index(x));
+    ca[real_reason].lbd(computeLBD(explanation));
+    countTier(ca[real_reason].tier(), 1);
     clauses_removable.push(real_reason);
     attachClause(real_reason);
 
@@ -746,6 +782,7 @@ void Solver::removeClause(CRef cr) {
       Debug("minisat") << "\n";
     }
     detachClause(cr);
+    if (c.removable()) countTier(c.tier(), -1);
     // Don't leave pointers to free'd memory!
     if (locked(c))
     {
@@ -1016,7 +1053,11 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
           Clause& c = ca[confl];
           max_resolution_level = std::max(max_resolution_level, c.level());
 
-          if (c.removable()) claBumpActivity(c);
+          if (c.removable())
+          {
+            if (tiered_clause_db) updateLearntLBD(c);
+            claBumpActivity(c);
+          }
         }
 
         if (Trace.isOn("pf::sat"))
@@ -1188,6 +1229,28 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 }
 
 
+// Recompute the LBD of a learnt clause that takes part in conflict analysis. If the LBD improved
+// the clause may move to a better tier. Core clauses are never looked at again.
+void Solver::updateLearntLBD(Clause& c)
+{
+  Assert(c.removable());
+  if (c.tier() == Clause::TIER_CORE) return;
+  c.used(true);
+  unsigned lbd = computeLBD(c);
+  if (lbd < c.lbd())
+  {
+    c.lbd(lbd);
+    Clause::Tier t = tierOf(lbd);
+    if (t < c.tier())
+    {
+      countTier(c.tier(), -1);
+      countTier(t, 1);
+      c.tier(t);
+      lbd_promotions++;
+    }
+  }
+}
+
 // Check if 'p' can be removed. 'abstract_levels' is used to abort early if the algorithm is
 // visiting literals at levels that cannot be removed later.
 bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
@@ -1537,9 +1600,41 @@ struct reduceDB_lt {
     bool operator () (CRef x, CRef y) {
         return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); }
 };
+// In the tiered mode, only the non-binary local clauses are candidates for deletion. They are
+// sorted to the front by increasing activity, everything else is kept at the back.
+struct reduceDB_tiered_lt {
+    ClauseAllocator& ca;
+    reduceDB_tiered_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool candidate(const Clause& c) const { return c.tier() == Clause::TIER_LOCAL && c.size() > 2; }
+    bool operator () (CRef x, CRef y) {
+        Clause& cx = ca[x];
+        Clause& cy = ca[y];
+        return candidate(cx) && (!candidate(cy) || cx.activity() < cy.activity()); }
+};
 void Solver::reduceDB()
 {
     int     i, j;
+    reduce_dbs++;
+
+    if (tiered_clause_db){
+        reduceDB_tiered_lt lt(ca);
+        sort(clauses_removable, lt);
+        int candidates = 0;
+        while (candidates < clauses_removable.size() && lt.candidate(ca[clauses_removable[candidates]]))
+            candidates++;
+        // Delete the less active half of the local clauses that are not locked:
+        for (i = j = 0; i < clauses_removable.size(); i++){
+            Clause& c = ca[clauses_removable[i]];
+            if (i < candidates / 2 && !locked(c))
+                removeClause(clauses_removable[i]);
+            else
+                clauses_removable[j++] = clauses_removable[i];
+        }
+        clauses_removable.shrink(i - j);
+        checkGarbage();
+        return;
+    }
+
     double  extra_lim = cla_inc / clauses_removable.size();    // Remove any clause below this activity
 
     sort(clauses_removable, reduceDB_lt(ca));
@@ -1556,6 +1651,24 @@ void Solver::reduceDB()
     checkGarbage();
 }
 
+void Solver::reduceDBTier2()
+{
+    for (int i = 0; i < clauses_removable.size(); i++){
+        Clause& c = ca[clauses_removable[i]];
+        if (c.tier() != Clause::TIER_TIER2) continue;
+        if (c.used()){
+            c.used(false);
+        }else{
+            // Not used in a conflict since the last sweep, let the activity decide its fate
+            countTier(Clause::TIER_TIER2, -1);
+            countTier(Clause::TIER_LOCAL, 1);
+            c.tier(Clause::TIER_LOCAL);
+            claBumpActivity(c);
+            tier2_demotions++;
+        }
+    }
+}
+
 
 void Solver::removeSatisfied(vec<CRef>& cs)
 {
@@ -1690,6 +1803,20 @@ lbool Solver::search(int nof_conflicts)
             // Analyze the conflict
             learnt_clause.clear();
             int max_level = analyze(confl, learnt_clause, backtrack_level);
+            unsigned lbd = computeLBD(learnt_clause);
+
+            if (glucose_restart){
+                // Block the restart if the solver is close to a (partial) model
+                if (conflicts > (uint64_t)restart_block_min && lbd_queue.isvalid()
+                    && trail.size() > restart_R * trail_queue.getavgDouble()){
+                    lbd_queue.fastclear();
+                    blocked_restarts++;
+                }
+                trail_queue.push(trail.size());
+                lbd_queue.push(lbd);
+            }
+            sum_lbd += lbd;
+
             cancelUntil(backtrack_level);
 
             // Assert the conflict clause and the asserting literal
@@ -1708,6 +1835,9 @@ lbool Solver::search(int nof_conflicts)
                   ca.alloc(assertionLevelOnly() ? assertionLevel : max_level,
                            learnt_clause,
                            true);
+              ca[cr].lbd(lbd);
+              ca[cr].tier(tierOf(lbd));
+              countTier(ca[cr].tier(), 1);
               clauses_removable.push(cr);
               attachClause(cr);
               claBumpActivity(ca[cr]);
@@ -1775,10 +1905,12 @@ lbool Solver::search(int nof_conflicts)
           }
 
           if ((nof_conflicts >= 0 && conflictC >= nof_conflicts)
+              || (glucose_restart && restartDynamic())
               || !withinBudget(ResourceManager::Resource::SatConflictStep))
           {
             // Reached bound on number of conflicts:
             progress_estimate = progressEstimate();
+            lbd_queue.fastclear();
             cancelUntil(0);
             // [mdeters] notify theory engine of restarts for deferred
             // theory processing
@@ -1791,7 +1923,17 @@ lbool Solver::search(int nof_conflicts)
                 return l_False;
             }
 
-            if (clauses_removable.size()-nAssigns() >= max_learnts) {
+            if (tiered_clause_db) {
+                // Demote unused tier-2 clauses and reduce the local tier periodically:
+                if (conflicts >= next_tier2_reduce) {
+                    next_tier2_reduce = conflicts + tier2_reduce_inc;
+                    reduceDBTier2();
+                }
+                if (conflicts >= next_local_reduce) {
+                    next_local_reduce = conflicts + local_reduce_inc;
+                    reduceDB();
+                }
+            } else if (clauses_removable.size()-nAssigns() >= max_learnts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
             }
@@ -1894,6 +2036,8 @@ lbool Solver::solve_()
     solves++;
 
     max_learnts               = nClauses() * learntsize_factor;
+    next_tier2_reduce         = conflicts + tier2_reduce_inc;
+    next_local_reduce         = conflicts + local_reduce_inc;
     learntsize_adjust_confl   = learntsize_adjust_start_confl;
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
     lbool   status            = l_Undef;
@@ -1908,8 +2052,9 @@ lbool Solver::solve_()
     // Search:
     int curr_restarts = 0;
     while (status == l_Undef){
+        // With glucose restarts, search() decides on its own when to restart
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        status = search(glucose_restart ? -1 : rest_base * restart_first);
         if (!withinBudget(ResourceManager::Resource::SatConflictStep))
           break;  // FIXME add restart option?
         curr_restarts++;
@@ -2254,6 +2399,7 @@ CRef Solver::updateLemmas() {
         ProofManager::getCnfProof()->setClauseAssertion(id, cnf_assertion);
       }
       if (removable) {
+        countTier(ca[lemma_ref].tier(), 1);
         clauses_removable.push(lemma_ref);
       } else {
         clauses_persistent.push(lemma_ref);
@@ -2339,6 +2485,9 @@ void ClauseAllocator::reloc(CRef& cr,
   // Copy extra data-fields:
   // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
   to[cr].mark(c.mark());
+  to[cr].lbd(c.lbd());
+  to[cr].tier(c.tier());
+  to[cr].used(c.used());
   if (to[cr].removable())         to[cr].activity() = c.activity();
   else if (to[cr].has_extra()) to[cr].calcAbstraction();
 }
@@ -31,6 +31,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "proof/clause_id.h"
 #include "prop/minisat/core/SolverTypes.h"
 #include "prop/minisat/mtl/Alg.h"
+#include "prop/minisat/mtl/BoundedQueue.h"
 #include "prop/minisat/mtl/Heap.h"
 #include "prop/minisat/mtl/Vec.h"
 #include "prop/minisat/utils/Options.h"
@@ -257,6 +258,7 @@ public:
     int     nVars      ()      const;       // The current number of variables.
     int     nFreeVars  ()      const;
     bool    isDecision (Var x) const;       // is the given var a decision?
+    int     contextLevel(Var x) const;      // The SAT context level at which x was assigned, -1 if unassigned.
 
     // Debugging SMT explanations
     //
@@ -305,10 +307,27 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    // Tiered learnt clause management (LBD based):
+    //
+    bool      tiered_clause_db;   // Manage learnt clauses in core/tier2/local tiers by LBD.                                  (default false)
+    unsigned  lbd_core;           // Learnt clauses with LBD at most this value are kept in the core tier.                     (default 2)
+    unsigned  lbd_tier2;          // Learnt clauses with LBD at most this value are kept in tier 2 while in use.               (default 6)
+    int       tier2_reduce_inc;   // Number of conflicts between demotions of unused tier-2 clauses.                           (default 10000)
+    int       local_reduce_inc;   // Number of conflicts between reductions of the local tier.                                 (default 15000)
+
+    // Glucose-style dynamic restarts:
+    //
+    bool      glucose_restart;    // Use dynamic restarts based on the moving average of LBDs instead of the Luby sequence.    (default false)
+    double    restart_K;          // Restart if the recent LBD average times K exceeds the global LBD average.                 (default 0.8)
+    double    restart_R;          // Block restarts if the trail is R times larger than its recent average.                    (default 1.4)
+    int       restart_block_min;  // Number of conflicts before restarts may be blocked.                                       (default 10000)
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, resources_consumed;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t learnts_core, learnts_tier2, learnts_local;  // Current number of removable clauses in each tier.
+    uint64_t lbd_promotions, tier2_demotions, reduce_dbs, blocked_restarts;
 
 protected:
 
@@ -420,6 +439,14 @@ protected:
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
 
+    vec<uint64_t>       lbd_stamp;          // Per decision level, the last LBD computation that has seen the level.
+    uint64_t            lbd_stamp_counter;  // Identifies the current LBD computation.
+    bqueue<unsigned>    lbd_queue;          // LBDs of the most recent learnt clauses (for glucose restarts).
+    bqueue<unsigned>    trail_queue;        // Trail sizes at the most recent conflicts (for blocking restarts).
+    double              sum_lbd;            // Sum of the LBDs of all learnt clauses.
+    uint64_t            next_tier2_reduce;  // Number of conflicts at which unused tier-2 clauses are demoted next.
+    uint64_t            next_local_reduce;  // Number of conflicts at which the local tier is reduced next.
+
     // Resource contraints:
     //
     int64_t             conflict_budget;    // -1 means no budget.
@@ -446,6 +473,8 @@ protected:
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    void     reduceDBTier2    ();                                                      // Demote the tier-2 clauses that were not used since the last call.
+    bool     restartDynamic   ()      const;                                           // Glucose restart condition: recent learnt clauses are worse than average.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
 
@@ -457,6 +486,14 @@ protected:
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
 
+    // Literal block distance of learnt clauses:
+    //
+    template <class Lits>
+    unsigned         computeLBD       (const Lits& lits);      // Number of distinct decision levels among the (assigned) literals.
+    Clause::Tier     tierOf           (unsigned lbd) const;    // The tier a learnt clause with the given LBD belongs to.
+    void             countTier        (Clause::Tier t, int d); // Update the statistics on the tier sizes.
+    void             updateLearntLBD  (Clause& c);             // Recompute the LBD of a learnt clause used in conflict analysis, promoting it if it improved.
+
     // Operations on clauses:
     //
     void     attachClause     (CRef cr);               // Attach a clause to watcher lists.
@@ -580,6 +617,50 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[clauses_removable[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+template <class Lits>
+inline unsigned Solver::computeLBD(const Lits& lits)
+{
+  lbd_stamp_counter++;
+  unsigned nblevels = 0;
+  for (int i = 0; i < lits.size(); i++)
+  {
+    int l = level(var(lits[i]));
+    // Unassigned literals (e.g. in theory lemmas) do not contribute
+    if (l < 0) continue;
+    if (lbd_stamp.size() <= l) lbd_stamp.growTo(l + 1, 0);
+    if (lbd_stamp[l] != lbd_stamp_counter)
+    {
+      lbd_stamp[l] = lbd_stamp_counter;
+      nblevels++;
+    }
+  }
+  return nblevels;
+}
+
+inline Clause::Tier Solver::tierOf(unsigned lbd) const
+{
+  if (!tiered_clause_db) return Clause::TIER_LOCAL;
+  if (lbd <= lbd_core) return Clause::TIER_CORE;
+  if (lbd <= lbd_tier2) return Clause::TIER_TIER2;
+  return Clause::TIER_LOCAL;
+}
+
+inline void Solver::countTier(Clause::Tier t, int d)
+{
+  switch (t)
+  {
+    case Clause::TIER_CORE: learnts_core += d; break;
+    case Clause::TIER_TIER2: learnts_tier2 += d; break;
+    default: learnts_local += d; break;
+  }
+}
+
+inline bool Solver::restartDynamic() const
+{
+  return lbd_queue.isvalid()
+         && lbd_queue.getavgDouble() * restart_K > sum_lbd / conflicts;
+}
+
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
@@ -615,6 +696,7 @@ inline int      Solver::nClauses      ()      const   { return clauses_persisten
 inline int      Solver::nLearnts      ()      const   { return clauses_removable.size(); }
 inline int      Solver::nVars         ()      const   { return vardata.size(); }
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
+inline int      Solver::contextLevel  (Var x) const   { return value(x) == l_Undef ? -1 : d_context->getLevel() - decisionLevel() + level(x); }
 inline bool     Solver::properExplanation(Lit l, Lit expl) const { return value(l) == l_True && value(expl) == l_True && trail_index(var(expl)) < trail_index(var(l)); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; }
 inline void     Solver::freezePolarity(Var v, bool b) { polarity[v] = int(b) | 0x2; }
@@ -199,7 +199,10 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned size      : 27;
-        unsigned level     : 32; }                            header;
+        unsigned level     : 32;
+        unsigned lbd       : 29;
+        unsigned tier      : 2;
+        unsigned used      : 1; }                             header;
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
 
     friend class ClauseAllocator;
@@ -213,6 +216,9 @@ class Clause {
         header.reloced   = 0;
         header.size      = ps.size();
         header.level     = level;
+        header.lbd       = ps.size();
+        header.tier      = TIER_LOCAL;
+        header.used      = 0;
 
         for (int i = 0; i < ps.size(); i++) data[i].lit = ps[i];
 
@@ -225,6 +231,15 @@ class Clause {
     }
 
 public:
+    /**
+     * The tiers of the learnt clause database. Clauses with a literal block
+     * distance (LBD) of at most the core threshold are kept until the user
+     * context they live in is popped, tier-2 clauses are kept as long as they
+     * keep participating in conflicts, and local clauses are subject to the
+     * activity based reduction.
+     */
+    enum Tier { TIER_CORE = 0, TIER_TIER2 = 1, TIER_LOCAL = 2 };
+
     void calcAbstraction() {
         assert(header.has_extra);
         uint32_t abstraction = 0;
@@ -243,6 +258,13 @@ public:
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
+    unsigned     lbd         ()      const   { return header.lbd; }
+    void         lbd         (unsigned l)    { header.lbd = l; }
+    Tier         tier        ()      const   { return (Tier)header.tier; }
+    void         tier        (Tier t)        { header.tier = t; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool u)        { header.used = u; }
+
     bool         reloced     ()      const   { return header.reloced; }
     CRef         relocation  ()      const   { return data[0].rel; }
     void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
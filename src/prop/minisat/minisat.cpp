@@ -147,6 +147,14 @@ void MinisatSatSolver::setupOptions() {
   d_minisat->clause_decay = options::satClauseDecay();
   d_minisat->restart_first = options::satRestartFirst();
   d_minisat->restart_inc = options::satRestartInc();
+
+  // Learnt clause management and restart strategy
+  d_minisat->tiered_clause_db =
+      options::satClauseDbMode() == options::SatClauseDbMode::TIERED;
+  d_minisat->lbd_core = options::satLbdCore();
+  d_minisat->lbd_tier2 = options::satLbdTier2();
+  d_minisat->glucose_restart =
+      options::satRestartMode() == options::SatRestartMode::GLUCOSE;
 }
 
 ClauseId MinisatSatSolver::addClause(SatClause& clause, bool removable) {
@@ -211,7 +219,7 @@ SatValue MinisatSatSolver::modelValue(SatLiteral l){
 }
 
 bool MinisatSatSolver::properExplanation(SatLiteral lit, SatLiteral expl) const {
-  return true;
+  return d_minisat->properExplanation(toMinisatLit(lit), toMinisatLit(expl));
 }
 
 void MinisatSatSolver::requirePhase(SatLiteral lit) {
@@ -225,6 +233,11 @@ bool MinisatSatSolver::isDecision(SatVariable decn) const {
   return d_minisat->isDecision( decn );
 }
 
+int32_t MinisatSatSolver::getAssignmentLevel(SatVariable var) const
+{
+  return d_minisat->contextLevel(var);
+}
+
 SatProofManager* MinisatSatSolver::getProofManager()
 {
   return d_minisat->getProofManager();
@@ -263,7 +276,14 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
     d_statClausesLiterals("sat::clauses_literals"),
     d_statLearntsLiterals("sat::learnts_literals"),
     d_statMaxLiterals("sat::max_literals"),
-    d_statTotLiterals("sat::tot_literals")
+    d_statTotLiterals("sat::tot_literals"),
+    d_statLearntsCore("sat::learnts_core"),
+    d_statLearntsTier2("sat::learnts_tier2"),
+    d_statLearntsLocal("sat::learnts_local"),
+    d_statLbdPromotions("sat::lbd_promotions"),
+    d_statTier2Demotions("sat::tier2_demotions"),
+    d_statReduceDbs("sat::reduce_dbs"),
+    d_statBlockedRestarts("sat::blocked_restarts")
 {
   d_registry->registerStat(&d_statStarts);
   d_registry->registerStat(&d_statDecisions);
@@ -274,6 +294,13 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
   d_registry->registerStat(&d_statLearntsLiterals);
   d_registry->registerStat(&d_statMaxLiterals);
   d_registry->registerStat(&d_statTotLiterals);
+  d_registry->registerStat(&d_statLearntsCore);
+  d_registry->registerStat(&d_statLearntsTier2);
+  d_registry->registerStat(&d_statLearntsLocal);
+  d_registry->registerStat(&d_statLbdPromotions);
+  d_registry->registerStat(&d_statTier2Demotions);
+  d_registry->registerStat(&d_statReduceDbs);
+  d_registry->registerStat(&d_statBlockedRestarts);
 }
 
 MinisatSatSolver::Statistics::~Statistics() {
@@ -286,6 +313,13 @@ MinisatSatSolver::Statistics::~Statistics() {
   d_registry->unregisterStat(&d_statLearntsLiterals);
   d_registry->unregisterStat(&d_statMaxLiterals);
   d_registry->unregisterStat(&d_statTotLiterals);
+  d_registry->unregisterStat(&d_statLearntsCore);
+  d_registry->unregisterStat(&d_statLearntsTier2);
+  d_registry->unregisterStat(&d_statLearntsLocal);
+  d_registry->unregisterStat(&d_statLbdPromotions);
+  d_registry->unregisterStat(&d_statTier2Demotions);
+  d_registry->unregisterStat(&d_statReduceDbs);
+  d_registry->unregisterStat(&d_statBlockedRestarts);
 }
 
 void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* minisat){
@@ -298,6 +332,13 @@ void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* minisat){
   d_statLearntsLiterals.setData(minisat->learnts_literals);
   d_statMaxLiterals.setData(minisat->max_literals);
   d_statTotLiterals.setData(minisat->tot_literals);
+  d_statLearntsCore.setData(minisat->learnts_core);
+  d_statLearntsTier2.setData(minisat->learnts_tier2);
+  d_statLearntsLocal.setData(minisat->learnts_local);
+  d_statLbdPromotions.setData(minisat->lbd_promotions);
+  d_statTier2Demotions.setData(minisat->tier2_demotions);
+  d_statReduceDbs.setData(minisat->reduce_dbs);
+  d_statBlockedRestarts.setData(minisat->blocked_restarts);
 }
 
 } /* namespace CVC4::prop */
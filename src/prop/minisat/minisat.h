@@ -82,6 +82,8 @@ class MinisatSatSolver : public CDCLTSatSolverInterface
 
   bool isDecision(SatVariable decn) const override;
 
+  int32_t getAssignmentLevel(SatVariable var) const override;
+
   /** Retrieve a pointer to the unerlying solver. */
   Minisat::SimpSolver* getSolver() { return d_minisat; }
 
@@ -109,6 +111,10 @@ class MinisatSatSolver : public CDCLTSatSolverInterface
     ReferenceStat<uint64_t> d_statConflicts, d_statClausesLiterals;
     ReferenceStat<uint64_t> d_statLearntsLiterals,  d_statMaxLiterals;
     ReferenceStat<uint64_t> d_statTotLiterals;
+    ReferenceStat<uint64_t> d_statLearntsCore, d_statLearntsTier2;
+    ReferenceStat<uint64_t> d_statLearntsLocal, d_statLbdPromotions;
+    ReferenceStat<uint64_t> d_statTier2Demotions, d_statReduceDbs;
+    ReferenceStat<uint64_t> d_statBlockedRestarts;
   public:
     Statistics(StatisticsRegistry* registry);
     ~Statistics();
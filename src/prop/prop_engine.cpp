@@ -28,6 +28,7 @@
 #include "options/main_options.h"
 #include "options/options.h"
 #include "options/proof_options.h"
+#include "options/prop_options.h"
 #include "options/smt_options.h"
 #include "proof/proof_manager.h"
 #include "prop/cnf_stream.h"
@@ -75,6 +76,7 @@ PropEngine::PropEngine(TheoryEngine* te,
       d_context(satContext),
       d_theoryProxy(nullptr),
       d_satSolver(nullptr),
+      d_assertedFormulas(userContext),
       d_pnm(pnm),
       d_cnfStream(nullptr),
       d_pfCnfStream(nullptr),
@@ -88,7 +90,15 @@ PropEngine::PropEngine(TheoryEngine* te,
   d_decisionEngine.reset(new DecisionEngine(satContext, userContext, rm));
   d_decisionEngine->init();  // enable appropriate strategies
 
-  d_satSolver = SatSolverFactory::createCDCLTMinisat(smtStatisticsRegistry());
+  if (options::satSolver() == options::PropSatSolverMode::CADICAL)
+  {
+    d_satSolver =
+        SatSolverFactory::createCDCLTCadical(smtStatisticsRegistry());
+  }
+  else
+  {
+    d_satSolver = SatSolverFactory::createCDCLTMinisat(smtStatisticsRegistry());
+  }
 
   // CNF stream and theory proxy required pointers to each other, make the
   // theory proxy first
@@ -103,10 +113,12 @@ PropEngine::PropEngine(TheoryEngine* te,
                               userContext,
                               &d_outMgr,
                               rm,
-                              FormulaLitPolicy::TRACK);
+                              FormulaLitPolicy::TRACK,
+                              "prop",
+                              options::cnfPolarity());
 
   // connect theory proxy
-  d_theoryProxy->finishInit(d_cnfStream);
+  d_theoryProxy->finishInit(d_satSolver, d_cnfStream);
   // connect SAT solver
   d_satSolver->initialize(d_context, d_theoryProxy, userContext, pnm);
 
@@ -181,6 +193,7 @@ void PropEngine::assertFormula(TNode node) {
   Assert(!d_inCheckSat) << "Sat solver in solve()!";
   Debug("prop") << "assertFormula(" << node << ")" << endl;
   d_decisionEngine->addAssertion(node);
+  d_assertedFormulas.push_back(AssertedFormula(node, Node::null(), false));
   assertInternal(node, false, false, true);
 }
 
@@ -189,6 +202,7 @@ void PropEngine::assertSkolemDefinition(TNode node, TNode skolem)
   Assert(!d_inCheckSat) << "Sat solver in solve()!";
   Debug("prop") << "assertFormula(" << node << ")" << endl;
   d_decisionEngine->addSkolemDefinition(node, skolem);
+  d_assertedFormulas.push_back(AssertedFormula(node, skolem, false));
   assertInternal(node, false, false, true);
 }
 
@@ -277,16 +291,27 @@ void PropEngine::assertLemmasInternal(
   if (!removable)
   {
     // also add to the decision engine, where notice we don't need proofs
+    // lemmas are only kept for cloning if requested, since there may be many
+    bool recordLemmas = options::cloneLemmas();
     if (!trn.isNull())
     {
       // notify the theory proxy of the lemma
       d_decisionEngine->addAssertion(trn.getProven());
+      if (recordLemmas)
+      {
+        d_assertedFormulas.push_back(
+            AssertedFormula(trn.getProven(), Node::null(), true));
+      }
     }
     Assert(ppSkolems.size() == ppLemmas.size());
     for (size_t i = 0, lsize = ppLemmas.size(); i < lsize; ++i)
     {
       Node lem = ppLemmas[i].getProven();
       d_decisionEngine->addSkolemDefinition(lem, ppSkolems[i]);
+      if (recordLemmas)
+      {
+        d_assertedFormulas.push_back(AssertedFormula(lem, ppSkolems[i], true));
+      }
     }
   }
 }
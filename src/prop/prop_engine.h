@@ -24,6 +24,7 @@
 #include <sys/time.h>
 
 #include "base/modal_exception.h"
+#include "context/cdlist.h"
 #include "expr/node.h"
 #include "options/options.h"
 #include "proof/proof_manager.h"
@@ -63,6 +64,24 @@ class PropEngine;
 class PropEngine
 {
  public:
+  /**
+   * A formula that was asserted to the SAT solver and is kept for the rest of
+   * the current user context, see getAssertedFormulas().
+   */
+  struct AssertedFormula
+  {
+    AssertedFormula(Node formula, Node skolem, bool isLemma)
+        : d_formula(formula), d_skolem(skolem), d_isLemma(isLemma)
+    {
+    }
+    /** The formula */
+    Node d_formula;
+    /** The skolem it defines, if it is a skolem definition */
+    Node d_skolem;
+    /** Whether it is a (non-removable) lemma */
+    bool d_isLemma;
+  };
+
   /**
    * Create a PropEngine with a particular decision and theory engine.
    */
@@ -163,6 +182,18 @@ class PropEngine
    */
   void assertLemma(theory::TrustNode tlemma, theory::LemmaProperty p);
 
+  /**
+   * Get the preprocessed assertions, skolem definitions and, with
+   * --clone-lemmas, non-removable lemmas asserted in the current user
+   * context, in the order in which they were asserted. Asserting them to a
+   * fresh PropEngine gives a problem that is equisatisfiable with the
+   * assertions of this one.
+   */
+  const context::CDList<AssertedFormula>& getAssertedFormulas() const
+  {
+    return d_assertedFormulas;
+  }
+
   /**
    * If ever n is decided upon, it must be in the given phase.  This
    * occurs *globally*, i.e., even if the literal is untranslated by
@@ -369,6 +400,9 @@ class PropEngine
   /** List of all of the assertions that need to be made */
   std::vector<Node> d_assertionList;
 
+  /** The formulas asserted in the current user context */
+  context::CDList<AssertedFormula> d_assertedFormulas;
+
   /** A pointer to the proof node maneger to be used by this engine. */
   ProofNodeManager* d_pnm;
 
@@ -169,6 +169,13 @@ class CDCLTSatSolverInterface : public SatSolver
 
   virtual bool isDecision(SatVariable decn) const = 0;
 
+  /**
+   * Get the SAT context level at which var was assigned, or -1 if var is
+   * unassigned. The level may be over-approximated, but var remains assigned
+   * as long as the SAT context is not popped below it.
+   */
+  virtual int32_t getAssignmentLevel(SatVariable var) const = 0;
+
   virtual std::shared_ptr<ProofNode> getProof() = 0;
 
 }; /* class CDCLTSatSolverInterface */
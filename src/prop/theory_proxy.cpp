@@ -19,6 +19,7 @@
 #include "context/context.h"
 #include "decision/decision_engine.h"
 #include "options/decision_options.h"
+#include "options/prop_options.h"
 #include "options/smt_options.h"
 #include "proof/cnf_proof.h"
 #include "prop/cnf_stream.h"
@@ -38,11 +39,15 @@ TheoryProxy::TheoryProxy(PropEngine* propEngine,
                          context::UserContext* userContext,
                          ProofNodeManager* pnm)
     : d_propEngine(propEngine),
+      d_satSolver(nullptr),
       d_cnfStream(nullptr),
       d_decisionEngine(decisionEngine),
       d_theoryEngine(theoryEngine),
       d_queue(context),
-      d_tpp(*theoryEngine, userContext, pnm)
+      d_tpp(*theoryEngine, userContext, pnm),
+      d_cacheExplanations(options::theoryExplanationCache()
+                          && !options::proof() && !options::unsatCores()),
+      d_explanationCache(userContext)
 {
 }
 
@@ -50,7 +55,12 @@ TheoryProxy::~TheoryProxy() {
   /* nothing to do for now */
 }
 
-void TheoryProxy::finishInit(CnfStream* cnfStream) { d_cnfStream = cnfStream; }
+void TheoryProxy::finishInit(CDCLTSatSolverInterface* satSolver,
+                             CnfStream* cnfStream)
+{
+  d_satSolver = satSolver;
+  d_cnfStream = cnfStream;
+}
 
 void TheoryProxy::variableNotify(SatVariable var) {
   d_theoryEngine->preRegister(getNode(SatLiteral(var)));
@@ -69,13 +79,49 @@ void TheoryProxy::theoryPropagate(std::vector<SatLiteral>& output) {
   // Get the propagated literals
   std::vector<TNode> outputNodes;
   d_theoryEngine->getPropagatedLiterals(outputNodes);
+  if (outputNodes.empty())
+  {
+    return;
+  }
+  ++d_statistics.d_propagationRounds;
+  // a literal may be propagated by several theories in the same round
+  std::unordered_set<TNode, TNodeHashFunction> seen;
   for (unsigned i = 0, i_end = outputNodes.size(); i < i_end; ++ i) {
+    if (!seen.insert(outputNodes[i]).second)
+    {
+      ++d_statistics.d_duplicatePropagations;
+      continue;
+    }
     Debug("prop-explain") << "theoryPropagate() => " << outputNodes[i] << std::endl;
     output.push_back(d_cnfStream->getLiteral(outputNodes[i]));
   }
+  d_statistics.d_propagations += seen.size();
 }
 
 void TheoryProxy::explainPropagation(SatLiteral l, SatClause& explanation) {
+  ++d_statistics.d_explanations;
+  if (d_cacheExplanations)
+  {
+    ExplanationCache::const_iterator it = d_explanationCache.find(l);
+    if (it != d_explanationCache.end())
+    {
+      const SatClause& cached = (*it).second;
+      bool proper = true;
+      for (size_t i = 1, size = cached.size(); i < size && proper; ++i)
+      {
+        proper = d_satSolver->properExplanation(l, ~cached[i]);
+      }
+      if (proper)
+      {
+        Debug("prop-explain") << "explainPropagation(" << l << ") => cached"
+                              << std::endl;
+        ++d_statistics.d_explanationCacheHits;
+        explanation.insert(explanation.end(), cached.begin(), cached.end());
+        return;
+      }
+    }
+  }
+
   TNode lNode = d_cnfStream->getNode(l);
   Debug("prop-explain") << "explainPropagation(" << lNode << ")" << std::endl;
 
@@ -114,6 +160,10 @@ void TheoryProxy::explainPropagation(SatLiteral l, SatClause& explanation) {
     }
     Trace("sat-proof") << ss.str() << "\n";
   }
+  if (d_cacheExplanations)
+  {
+    d_explanationCache.insert(l, explanation);
+  }
 }
 
 void TheoryProxy::enqueueTheoryLiteral(const SatLiteral& l) {
@@ -209,5 +259,28 @@ void TheoryProxy::getSkolems(TNode node,
 
 void TheoryProxy::preRegister(Node n) { d_theoryEngine->preRegister(n); }
 
+TheoryProxy::Statistics::Statistics()
+    : d_propagationRounds("theory_proxy::propagationRounds", 0),
+      d_propagations("theory_proxy::propagations", 0),
+      d_duplicatePropagations("theory_proxy::duplicatePropagations", 0),
+      d_explanations("theory_proxy::explanations", 0),
+      d_explanationCacheHits("theory_proxy::explanationCacheHits", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_propagationRounds);
+  smtStatisticsRegistry()->registerStat(&d_propagations);
+  smtStatisticsRegistry()->registerStat(&d_duplicatePropagations);
+  smtStatisticsRegistry()->registerStat(&d_explanations);
+  smtStatisticsRegistry()->registerStat(&d_explanationCacheHits);
+}
+
+TheoryProxy::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_propagationRounds);
+  smtStatisticsRegistry()->unregisterStat(&d_propagations);
+  smtStatisticsRegistry()->unregisterStat(&d_duplicatePropagations);
+  smtStatisticsRegistry()->unregisterStat(&d_explanations);
+  smtStatisticsRegistry()->unregisterStat(&d_explanationCacheHits);
+}
+
 }/* CVC4::prop namespace */
 }/* CVC4 namespace */
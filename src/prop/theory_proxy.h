@@ -63,12 +63,22 @@ class TheoryProxy : public Registrar
   ~TheoryProxy();
 
   /** Finish initialize */
-  void finishInit(CnfStream* cnfStream);
+  void finishInit(CDCLTSatSolverInterface* satSolver, CnfStream* cnfStream);
 
   void theoryCheck(theory::Theory::Effort effort);
 
+  /**
+   * Get the explanation clause of the theory propagation l, whose first
+   * literal is l. If l was explained before in the current user context and
+   * the antecedents of the previous explanation properly explain l in the
+   * current assignment, the previous explanation clause is reused.
+   */
   void explainPropagation(SatLiteral l, SatClause& explanation);
 
+  /**
+   * Get all literals propagated by the theories since the last call, with
+   * duplicates removed.
+   */
   void theoryPropagate(SatClause& output);
 
   void enqueueTheoryLiteral(const SatLiteral& l);
@@ -136,6 +146,9 @@ class TheoryProxy : public Registrar
   /** The prop engine we are using. */
   PropEngine* d_propEngine;
 
+  /** The SAT solver we are using. */
+  CDCLTSatSolverInterface* d_satSolver;
+
   /** The CNF engine we are using. */
   CnfStream* d_cnfStream;
 
@@ -156,6 +169,40 @@ class TheoryProxy : public Registrar
 
   /** The theory preprocessor */
   theory::TheoryPreprocessor d_tpp;
+
+  /**
+   * Whether explanation clauses are cached, which is disabled if proofs or
+   * unsat cores are enabled since these record every explanation.
+   */
+  bool d_cacheExplanations;
+
+  typedef context::
+      CDHashMap<SatLiteral, SatClause, SatLiteralHashFunction>
+          ExplanationCache;
+  /**
+   * The last explanation clause of each propagated literal. Explanations are
+   * valid theory lemmas, so they remain valid after backtracking, but are
+   * only reused if their antecedents are assigned before the literal.
+   */
+  ExplanationCache d_explanationCache;
+
+  class Statistics
+  {
+   public:
+    /** Number of calls to theoryPropagate that returned literals */
+    IntStat d_propagationRounds;
+    /** Number of literals returned by theoryPropagate */
+    IntStat d_propagations;
+    /** Number of duplicate propagated literals that were dropped */
+    IntStat d_duplicatePropagations;
+    /** Number of calls to explainPropagation */
+    IntStat d_explanations;
+    /** Number of explanations taken from the cache */
+    IntStat d_explanationCacheHits;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
 }; /* class TheoryProxy */
 
 }/* CVC4::prop namespace */
@@ -0,0 +1,609 @@
+/*********************                                                        */
+/*! \file cube_and_conquer.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Cube-and-conquer solving of a single query
+ **/
+
+#include "smt/cube_and_conquer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "api/cvc4cpp.h"
+#include "expr/expr.h"
+#include "expr/expr_manager.h"
+#include "expr/node_manager.h"
+#include "expr/variable_type_map.h"
+#include "options/options.h"
+#include "options/smt_options.h"
+#include "prop/prop_engine.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/rewriter.h"
+#include "util/safe_print.h"
+
+namespace CVC4 {
+namespace smt {
+
+namespace {
+
+/** The number of most frequent atoms the cuber looks ahead on */
+const size_t kLookaheadCandidates = 8;
+
+/** Is n a Boolean connective, whose children the cuber descends into? */
+bool isConnective(TNode n)
+{
+  switch (n.getKind())
+  {
+    case kind::NOT:
+    case kind::AND:
+    case kind::OR:
+    case kind::IMPLIES:
+    case kind::XOR: return true;
+    case kind::ITE: return n.getType().isBoolean();
+    case kind::EQUAL: return n[0].getType().isBoolean();
+    default: return false;
+  }
+}
+
+/** Get the number of distinct subterms of n */
+size_t getDagSize(TNode n)
+{
+  std::unordered_set<TNode, TNodeHashFunction> visited;
+  std::vector<TNode> toVisit{n};
+  while (!toVisit.empty())
+  {
+    TNode cur = toVisit.back();
+    toVisit.pop_back();
+    if (visited.insert(cur).second)
+    {
+      toVisit.insert(toVisit.end(), cur.begin(), cur.end());
+    }
+  }
+  return visited.size();
+}
+
+}  // namespace
+
+/**
+ * A worker owns a solver with its own NodeManager, on which it solves cubes
+ * in its own thread.
+ */
+class CubeWorker
+{
+ public:
+  CubeWorker(const Options& options)
+  {
+    d_options.copyValues(options);
+    d_solver.reset(new api::Solver(&d_options));
+  }
+
+  /**
+   * Export the assertions and the cubes to the NodeManager of this worker.
+   * This is done in the main thread, before the worker is started, since the
+   * export reads the nodes of the solver that owns them.
+   */
+  void exportQuery(const std::vector<Node>& assertions,
+                   const std::vector<std::vector<Node>>& cubes)
+  {
+    ExprManager* em = d_solver->getExprManager();
+    ExprManagerMapCollection vmap;
+    for (const Node& a : assertions)
+    {
+      d_assertions.push_back(a.toExpr().exportTo(em, vmap));
+    }
+    for (const std::vector<Node>& cube : cubes)
+    {
+      d_cubes.emplace_back();
+      for (const Node& lit : cube)
+      {
+        d_cubes.back().push_back(lit.toExpr().exportTo(em, vmap));
+      }
+    }
+  }
+
+  /** Solve cubes until there are none left, to be called in a new thread */
+  void run(CubeAndConquer& cc, const LogicInfo& logic)
+  {
+    NodeManagerScope nms(d_solver->getNodeManager());
+    SmtEngine* smt = d_solver->getSmtEngine();
+    size_t i = d_cubes.size();
+    try
+    {
+      smt->setIsInternalSubsolver();
+      // the cubes are solved as check-sat-assuming queries
+      smt->setOption("incremental", "true");
+      smt->setOption("cube-workers", "0");
+      smt->setLogic(logic);
+      for (const Expr& a : d_assertions)
+      {
+        smt->assertFormula(Node::fromExpr(a));
+      }
+      while (cc.getNextCube(i))
+      {
+        std::vector<Node> assumptions;
+        for (const Expr& lit : d_cubes[i])
+        {
+          assumptions.push_back(Node::fromExpr(lit));
+        }
+        auto start = std::chrono::steady_clock::now();
+        Result r = smt->checkSat(assumptions);
+        std::chrono::nanoseconds time =
+            std::chrono::steady_clock::now() - start;
+        cc.notifyResult(i, r, time.count());
+        i = d_cubes.size();
+      }
+    }
+    catch (Exception& e)
+    {
+      Trace("cube-and-conquer") << "cube worker failed: " << e << std::endl;
+      notifyFailure(cc, i);
+    }
+    catch (std::exception& e)
+    {
+      // an exception escaping the thread would terminate the process
+      Trace("cube-and-conquer")
+          << "cube worker failed: " << e.what() << std::endl;
+      notifyFailure(cc, i);
+    }
+  }
+
+  /** Interrupt the solver of this worker, may be called from any thread */
+  void interrupt() { d_solver->getSmtEngine()->interrupt(); }
+
+ private:
+  /**
+   * Notify cc that this worker failed while solving cube i, or while setting
+   * up its solver if i is d_cubes.size(). In both cases the query is unknown,
+   * since the worker may have been the only one left to solve the cubes.
+   */
+  void notifyFailure(CubeAndConquer& cc, size_t i)
+  {
+    if (i < d_cubes.size())
+    {
+      cc.notifyResult(i, Result(Result::SAT_UNKNOWN, Result::OTHER), 0);
+    }
+    else
+    {
+      cc.notifyUnknown(Result::OTHER);
+    }
+  }
+
+  /** The options of the solver */
+  Options d_options;
+  /** The solver, which owns the NodeManager of this worker */
+  std::unique_ptr<api::Solver> d_solver;
+  /** The exported assertions */
+  std::vector<Expr> d_assertions;
+  /** The exported cubes */
+  std::vector<std::vector<Expr>> d_cubes;
+};
+
+void CubeResultsStat::record(size_t i,
+                             size_t numLiterals,
+                             Result::Sat result,
+                             uint64_t nanos)
+{
+  if (i >= d_entries.size())
+  {
+    d_entries.resize(i + 1);
+  }
+  Entry& e = d_entries[i];
+  e.d_numLiterals = numLiterals;
+  e.d_result = result;
+  e.d_nanos = nanos;
+  e.d_solved = true;
+}
+
+void CubeResultsStat::flushInformation(std::ostream& out) const
+{
+  out << "[";
+  bool first = true;
+  for (size_t i = 0, n = d_entries.size(); i < n; ++i)
+  {
+    const Entry& e = d_entries[i];
+    if (!e.d_solved)
+    {
+      continue;
+    }
+    if (!first)
+    {
+      out << ", ";
+    }
+    first = false;
+    out << "(" << i << " : literals " << e.d_numLiterals << ", result "
+        << e.d_result << ", time ";
+    // the operator for timespec is hidden by the ones of this namespace
+    CVC4::operator<<(out, toTimespec(e)) << ")";
+  }
+  out << "]";
+}
+
+void CubeResultsStat::safeFlushInformation(int fd) const
+{
+  safe_print(fd, "[");
+  bool first = true;
+  for (size_t i = 0, n = d_entries.size(); i < n; ++i)
+  {
+    const Entry& e = d_entries[i];
+    if (!e.d_solved)
+    {
+      continue;
+    }
+    if (!first)
+    {
+      safe_print(fd, ", ");
+    }
+    first = false;
+    safe_print(fd, "(");
+    safe_print<uint64_t>(fd, i);
+    safe_print(fd, " : literals ");
+    safe_print<uint64_t>(fd, e.d_numLiterals);
+    safe_print(fd, ", result ");
+    safe_print(fd,
+               e.d_result == Result::SAT
+                   ? "sat"
+                   : (e.d_result == Result::UNSAT ? "unsat" : "unknown"));
+    safe_print(fd, ", time ");
+    safe_print<timespec>(fd, toTimespec(e));
+    safe_print(fd, ")");
+  }
+  safe_print(fd, "]");
+}
+
+timespec CubeResultsStat::toTimespec(const Entry& e)
+{
+  timespec t;
+  t.tv_sec = e.d_nanos / 1000000000;
+  t.tv_nsec = e.d_nanos % 1000000000;
+  return t;
+}
+
+CubeAndConquer::CubeAndConquer(prop::PropEngine* propEngine,
+                               const LogicInfo& logic,
+                               const Options& options)
+    : d_propEngine(propEngine),
+      d_logic(logic),
+      d_options(options),
+      d_nextCube(0),
+      d_satCube(0),
+      d_numUnsatCubes(0),
+      d_unknown(false),
+      d_unknownReason(Result::UNKNOWN_REASON),
+      d_interrupted(false)
+{
+}
+
+CubeAndConquer::~CubeAndConquer() {}
+
+Result CubeAndConquer::solve(const std::vector<Node>& assertions,
+                             std::vector<Node>& satCube)
+{
+  {
+    std::lock_guard<std::mutex> guard(d_mutex);
+    d_interrupted = false;
+  }
+  {
+    TimerStat::CodeTimer cubeTimer(d_statistics.d_cubeTime);
+    makeCubes(assertions);
+  }
+  Trace("cube-and-conquer") << "cube-and-conquer: " << d_cubes.size()
+                            << " cubes" << std::endl;
+  d_statistics.d_numCubes += d_cubes.size();
+  if (d_cubes.empty())
+  {
+    return Result(Result::UNSAT);
+  }
+
+  size_t numWorkers =
+      std::min<size_t>(options::cubeWorkers(), d_cubes.size());
+  {
+    std::lock_guard<std::mutex> guard(d_mutex);
+    d_nextCube = 0;
+    d_satCube = d_cubes.size();
+    d_numUnsatCubes = 0;
+    d_unknown = false;
+    try
+    {
+      // the export reads the nodes of this solver, so it happens here
+      for (size_t i = 0; i < numWorkers; ++i)
+      {
+        d_workers.emplace_back(new CubeWorker(d_options));
+        d_workers.back()->exportQuery(assertions, d_cubes);
+      }
+    }
+    catch (ExportUnsupportedException& e)
+    {
+      d_workers.clear();
+      d_cubes.clear();
+      throw;
+    }
+  }
+
+  {
+    TimerStat::CodeTimer conquerTimer(d_statistics.d_conquerTime);
+    std::vector<std::thread> threads;
+    for (std::unique_ptr<CubeWorker>& w : d_workers)
+    {
+      CubeWorker* worker = w.get();
+      threads.emplace_back(
+          [this, worker]() { worker->run(*this, d_logic); });
+    }
+    for (std::thread& t : threads)
+    {
+      t.join();
+    }
+  }
+
+  Result res;
+  std::lock_guard<std::mutex> guard(d_mutex);
+  if (d_satCube < d_cubes.size())
+  {
+    satCube = d_cubes[d_satCube];
+    res = Result(Result::SAT);
+  }
+  else if (d_interrupted)
+  {
+    res = Result(Result::SAT_UNKNOWN, Result::INTERRUPTED);
+  }
+  else if (d_numUnsatCubes == d_cubes.size())
+  {
+    // only unsatisfiable if every cube was shown to be
+    res = Result(Result::UNSAT);
+  }
+  else
+  {
+    res = Result(Result::SAT_UNKNOWN,
+                 d_unknown ? d_unknownReason : Result::OTHER);
+  }
+  d_workers.clear();
+  d_cubes.clear();
+  return res;
+}
+
+void CubeAndConquer::interrupt()
+{
+  std::lock_guard<std::mutex> guard(d_mutex);
+  d_interrupted = true;
+  for (std::unique_ptr<CubeWorker>& w : d_workers)
+  {
+    w->interrupt();
+  }
+}
+
+void CubeAndConquer::makeCubes(const std::vector<Node>& assertions)
+{
+  NodeManager* nm = NodeManager::currentNM();
+  Node ff = nm->mkConst(false);
+  d_cubes.clear();
+
+  struct OpenCube
+  {
+    std::vector<Node> d_literals;
+    Node d_formula;
+    unsigned d_depth;
+  };
+  Node f = assertions.empty()
+               ? nm->mkConst(true)
+               : (assertions.size() == 1 ? assertions[0]
+                                         : nm->mkNode(kind::AND, assertions));
+  std::deque<OpenCube> open;
+  open.push_back({{}, theory::Rewriter::rewrite(f), 0});
+  // the number of open and finished cubes
+  size_t numLeaves = 1;
+  // cubes are split breadth-first, which keeps the tree balanced
+  while (!open.empty())
+  {
+    OpenCube c = open.front();
+    open.pop_front();
+    bool split = c.d_depth < options::cubeDepth()
+                 && numLeaves < options::cubeCount() && !d_interrupted;
+    Node atom = split ? pickSplitAtom(c.d_formula, c.d_literals) : Node::null();
+    if (c.d_formula == ff)
+    {
+      ++d_statistics.d_numRefutedCubes;
+      numLeaves--;
+      continue;
+    }
+    if (atom.isNull())
+    {
+      d_cubes.push_back(c.d_literals);
+      continue;
+    }
+    numLeaves++;
+    for (bool pol : {true, false})
+    {
+      OpenCube child{c.d_literals, Node::null(), c.d_depth + 1};
+      child.d_literals.push_back(pol ? atom : atom.notNode());
+      Node val = nm->mkConst(pol);
+      child.d_formula = theory::Rewriter::rewrite(
+          c.d_formula.substitute(TNode(atom), TNode(val)));
+      open.push_back(child);
+    }
+  }
+}
+
+Node CubeAndConquer::pickSplitAtom(Node& f, std::vector<Node>& cube)
+{
+  NodeManager* nm = NodeManager::currentNM();
+  Node tt = nm->mkConst(true);
+  Node ff = nm->mkConst(false);
+  while (!f.isConst())
+  {
+    // count the occurrences of the atoms of the SAT solver in f
+    std::unordered_map<TNode, size_t, TNodeHashFunction> occurrences;
+    std::unordered_set<TNode, TNodeHashFunction> visited;
+    std::vector<TNode> toVisit{f};
+    while (!toVisit.empty())
+    {
+      TNode cur = toVisit.back();
+      toVisit.pop_back();
+      if (!isConnective(cur))
+      {
+        if (!cur.isConst() && d_propEngine->isSatLiteral(cur))
+        {
+          occurrences[cur]++;
+        }
+        continue;
+      }
+      if (visited.insert(cur).second)
+      {
+        toVisit.insert(toVisit.end(), cur.begin(), cur.end());
+      }
+    }
+    std::vector<std::pair<size_t, TNode>> candidates;
+    for (const std::pair<const TNode, size_t>& p : occurrences)
+    {
+      candidates.emplace_back(p.second, p.first);
+    }
+    size_t numCandidates = std::min(candidates.size(), kLookaheadCandidates);
+    std::partial_sort(
+        candidates.begin(),
+        candidates.begin() + numCandidates,
+        candidates.end(),
+        [](const std::pair<size_t, TNode>& a,
+           const std::pair<size_t, TNode>& b) { return a.first > b.first; });
+
+    // look ahead on the most frequent atoms
+    size_t size = getDagSize(f);
+    Node best;
+    uint64_t bestScore = 0;
+    bool forced = false;
+    for (size_t i = 0; i < numCandidates; ++i)
+    {
+      TNode atom = candidates[i].second;
+      Node fTrue = theory::Rewriter::rewrite(f.substitute(atom, tt));
+      Node fFalse = theory::Rewriter::rewrite(f.substitute(atom, ff));
+      if (fTrue == ff || fFalse == ff)
+      {
+        if (fTrue == fFalse)
+        {
+          f = ff;
+          return Node::null();
+        }
+        // one branch is closed, the atom is forced
+        cube.push_back(fTrue == ff ? atom.notNode() : Node(atom));
+        f = fTrue == ff ? fFalse : fTrue;
+        forced = true;
+        break;
+      }
+      size_t sizeTrue = getDagSize(fTrue);
+      size_t sizeFalse = getDagSize(fFalse);
+      uint64_t score = (size > sizeTrue ? size - sizeTrue + 1 : 1)
+                       * (size > sizeFalse ? size - sizeFalse + 1 : 1);
+      if (score > bestScore)
+      {
+        best = atom;
+        bestScore = score;
+      }
+    }
+    if (!forced)
+    {
+      return best;
+    }
+  }
+  return Node::null();
+}
+
+bool CubeAndConquer::getNextCube(size_t& i)
+{
+  std::lock_guard<std::mutex> guard(d_mutex);
+  if (d_interrupted || d_satCube < d_cubes.size()
+      || d_nextCube >= d_cubes.size())
+  {
+    return false;
+  }
+  i = d_nextCube++;
+  return true;
+}
+
+void CubeAndConquer::notifyResult(size_t i, const Result& r, uint64_t nanos)
+{
+  std::lock_guard<std::mutex> guard(d_mutex);
+  Result::Sat sat = r.asSatisfiabilityResult().isSat();
+  d_statistics.d_cubeResults.record(i, d_cubes[i].size(), sat, nanos);
+  Trace("cube-and-conquer") << "cube " << i << ": " << sat << std::endl;
+  if (sat == Result::SAT)
+  {
+    ++d_statistics.d_numSatCubes;
+    if (d_satCube == d_cubes.size())
+    {
+      d_satCube = i;
+      // the other workers are no longer needed
+      for (std::unique_ptr<CubeWorker>& w : d_workers)
+      {
+        w->interrupt();
+      }
+    }
+  }
+  else if (sat == Result::UNSAT)
+  {
+    ++d_statistics.d_numUnsatCubes;
+    d_numUnsatCubes++;
+  }
+  else
+  {
+    ++d_statistics.d_numUnknownCubes;
+    setUnknown(r.whyUnknown());
+  }
+}
+
+void CubeAndConquer::notifyUnknown(Result::UnknownExplanation why)
+{
+  std::lock_guard<std::mutex> guard(d_mutex);
+  setUnknown(why);
+}
+
+void CubeAndConquer::setUnknown(Result::UnknownExplanation why)
+{
+  if (!d_unknown)
+  {
+    d_unknown = true;
+    d_unknownReason = why;
+  }
+}
+
+CubeAndConquer::Statistics::Statistics()
+    : d_numCubes("smt::CubeAndConquer::cubes", 0),
+      d_numRefutedCubes("smt::CubeAndConquer::refutedCubes", 0),
+      d_numSatCubes("smt::CubeAndConquer::satCubes", 0),
+      d_numUnsatCubes("smt::CubeAndConquer::unsatCubes", 0),
+      d_numUnknownCubes("smt::CubeAndConquer::unknownCubes", 0),
+      d_cubeTime("smt::CubeAndConquer::cubeTime"),
+      d_conquerTime("smt::CubeAndConquer::conquerTime"),
+      d_cubeResults("smt::CubeAndConquer::cubeResults")
+{
+  smtStatisticsRegistry()->registerStat(&d_numCubes);
+  smtStatisticsRegistry()->registerStat(&d_numRefutedCubes);
+  smtStatisticsRegistry()->registerStat(&d_numSatCubes);
+  smtStatisticsRegistry()->registerStat(&d_numUnsatCubes);
+  smtStatisticsRegistry()->registerStat(&d_numUnknownCubes);
+  smtStatisticsRegistry()->registerStat(&d_cubeTime);
+  smtStatisticsRegistry()->registerStat(&d_conquerTime);
+  smtStatisticsRegistry()->registerStat(&d_cubeResults);
+}
+
+CubeAndConquer::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_numCubes);
+  smtStatisticsRegistry()->unregisterStat(&d_numRefutedCubes);
+  smtStatisticsRegistry()->unregisterStat(&d_numSatCubes);
+  smtStatisticsRegistry()->unregisterStat(&d_numUnsatCubes);
+  smtStatisticsRegistry()->unregisterStat(&d_numUnknownCubes);
+  smtStatisticsRegistry()->unregisterStat(&d_cubeTime);
+  smtStatisticsRegistry()->unregisterStat(&d_conquerTime);
+  smtStatisticsRegistry()->unregisterStat(&d_cubeResults);
+}
+
+}  // namespace smt
+}  // namespace CVC4
@@ -0,0 +1,190 @@
+/*********************                                                        */
+/*! \file cube_and_conquer.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Cube-and-conquer solving of a single query
+ **
+ ** If --cube-workers=N is given, the preprocessed assertions of a query are
+ ** split by a lookahead cuber into cubes, i.e. conjunctions of literals of the
+ ** SAT solver. The cubes are solved as check-sat-assuming queries by N worker
+ ** solvers in parallel threads, each with its own NodeManager.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__SMT__CUBE_AND_CONQUER_H
+#define CVC4__SMT__CUBE_AND_CONQUER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "expr/node.h"
+#include "theory/logic_info.h"
+#include "util/result.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+
+class Options;
+
+namespace prop {
+class PropEngine;
+}
+
+namespace smt {
+
+class CubeWorker;
+
+/**
+ * A statistic that records the number of split literals, the result and the
+ * solving time of each cube of a cube-and-conquer run.
+ */
+class CubeResultsStat : public Stat
+{
+ public:
+  CubeResultsStat(const std::string& name) : Stat(name) {}
+
+  /** Records the result of cube i, which has the given number of literals */
+  void record(size_t i,
+              size_t numLiterals,
+              Result::Sat result,
+              uint64_t nanos);
+
+  void flushInformation(std::ostream& out) const override;
+
+  void safeFlushInformation(int fd) const override;
+
+ private:
+  struct Entry
+  {
+    size_t d_numLiterals = 0;
+    Result::Sat d_result = Result::SAT_UNKNOWN;
+    uint64_t d_nanos = 0;
+    bool d_solved = false;
+  };
+
+  static timespec toTimespec(const Entry& e);
+
+  /** The entries, indexed by cube */
+  std::vector<Entry> d_entries;
+}; /* class CubeResultsStat */
+
+/**
+ * Solves a set of preprocessed assertions in cube-and-conquer mode.
+ *
+ * The cuber builds a binary tree of depth at most --cube-depth and with at
+ * most --cube-count leaves. At each node it picks, among the most frequent
+ * atoms of the SAT solver that occur in the simplified assertions, the atom
+ * whose assignment to true and to false simplifies the assertions the most
+ * (measured in DAG size). Branches whose assertions rewrite to false are
+ * closed by the cuber, and atoms for which one branch closes are assigned
+ * without splitting.
+ *
+ * The assertions are exported to each worker once, the cubes are then handed
+ * out to the workers on demand. The query is satisfiable as soon as one cube
+ * is, and unsatisfiable once all cubes are shown to be. If a worker fails,
+ * e.g. because its solver cannot be set up, the result is unknown.
+ */
+class CubeAndConquer
+{
+  friend class CubeWorker;
+
+ public:
+  CubeAndConquer(prop::PropEngine* propEngine,
+                 const LogicInfo& logic,
+                 const Options& options);
+  ~CubeAndConquer();
+
+  /**
+   * Solve the conjunction of the given preprocessed assertions. If the result
+   * is SAT, satCube is set to the literals of a satisfiable cube.
+   *
+   * Throws an ExportUnsupportedException if the assertions cannot be
+   * exported to the workers.
+   */
+  Result solve(const std::vector<Node>& assertions,
+               std::vector<Node>& satCube);
+
+  /** Interrupt the workers, may be called from any thread */
+  void interrupt();
+
+ private:
+  /** Split the assertions into cubes */
+  void makeCubes(const std::vector<Node>& assertions);
+  /**
+   * Pick the atom to split formula f on. Atoms for which one branch is
+   * closed are added to cube and substituted in f, which is set to false if
+   * both branches of an atom are closed. Returns the null node if no atom
+   * can be split on.
+   */
+  Node pickSplitAtom(Node& f, std::vector<Node>& cube);
+
+  /** Called by worker threads to get the next cube to solve */
+  bool getNextCube(size_t& i);
+  /** Called by worker threads when cube i was solved */
+  void notifyResult(size_t i, const Result& r, uint64_t nanos);
+  /** Called by worker threads that failed before they took a cube */
+  void notifyUnknown(Result::UnknownExplanation why);
+  /** Record that the run is unknown for reason why, if it is not already */
+  void setUnknown(Result::UnknownExplanation why);
+
+  /** The prop engine, whose atoms are split on */
+  prop::PropEngine* d_propEngine;
+  /** The logic of the workers */
+  LogicInfo d_logic;
+  /** The options of the workers */
+  const Options& d_options;
+  /** The cubes of the current run */
+  std::vector<std::vector<Node>> d_cubes;
+
+  /** Protects the state of the current run below and d_workers */
+  std::mutex d_mutex;
+  /** The workers of the current run */
+  std::vector<std::unique_ptr<CubeWorker>> d_workers;
+  /** The index of the next cube to hand out */
+  size_t d_nextCube;
+  /** The index of a satisfiable cube, or d_cubes.size() */
+  size_t d_satCube;
+  /** The number of cubes that were shown to be unsatisfiable */
+  size_t d_numUnsatCubes;
+  /** Whether a cube was unknown, and the reason of the first one */
+  bool d_unknown;
+  Result::UnknownExplanation d_unknownReason;
+  /** Whether the run was interrupted, also read by the cuber */
+  std::atomic<bool> d_interrupted;
+
+  struct Statistics
+  {
+    /** Number of cubes handed to the workers */
+    IntStat d_numCubes;
+    /** Number of cubes closed by the cuber */
+    IntStat d_numRefutedCubes;
+    /** Number of cubes with each result */
+    IntStat d_numSatCubes;
+    IntStat d_numUnsatCubes;
+    IntStat d_numUnknownCubes;
+    /** Time spent in the cuber */
+    TimerStat d_cubeTime;
+    /** Time spent solving cubes */
+    TimerStat d_conquerTime;
+    /** Results of the individual cubes */
+    CubeResultsStat d_cubeResults;
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+}; /* class CubeAndConquer */
+
+}  // namespace smt
+}  // namespace CVC4
+
+#endif /* CVC4__SMT__CUBE_AND_CONQUER_H */
@@ -147,6 +147,11 @@ Node Preprocessor::simplify(const Node& node)
   return ns;
 }
 
+theory::TrustSubstitutionMap& Preprocessor::getTopLevelSubstitutions()
+{
+  return d_ppContext->getTopLevelSubstitutions();
+}
+
 void Preprocessor::setProofGenerator(PreprocessProofGenerator* pppg)
 {
   Assert(pppg != nullptr);
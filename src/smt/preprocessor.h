@@ -75,6 +75,11 @@ class Preprocessor
    * @return The simplified term.
    */
   Node simplify(const Node& n);
+  /**
+   * Get the top-level substitutions inferred by preprocessing in the current
+   * user context.
+   */
+  theory::TrustSubstitutionMap& getTopLevelSubstitutions();
   /**
    * Expand the definitions in a term or formula n.  No other
    * simplification or normalization is done.
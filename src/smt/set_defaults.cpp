@@ -381,6 +381,11 @@ void setDefaults(LogicInfo& logic, bool isInternalSubsolver)
     options::bitvectorToBool.set(true);
   }
 
+  if (options::cubeWorkers() > 0 && options::incrementalSolving())
+  {
+    throw OptionException("cube-workers not supported in incremental mode");
+  }
+
   // Disable options incompatible with unsat cores or output an error if enabled
   // explicitly
   if (options::unsatCores())
@@ -497,6 +502,36 @@ void setDefaults(LogicInfo& logic, bool isInternalSubsolver)
       options::globalNegate.set(false);
     }
 
+    if (options::cnfPolarity())
+    {
+      if (options::cnfPolarity.wasSetByUser())
+      {
+        throw OptionException("cnf-polarity not supported with unsat cores");
+      }
+      Notice() << "SmtEngine: turning off cnf-polarity to support unsat "
+                  "cores"
+               << std::endl;
+      options::cnfPolarity.set(false);
+    }
+
+    if (options::satSolver() != options::PropSatSolverMode::MINISAT)
+    {
+      if (options::satSolver.wasSetByUser())
+      {
+        throw OptionException("sat-solver=cadical not supported with unsat "
+                              "cores");
+      }
+      Notice() << "SmtEngine: using minisat as the SAT solver to support "
+                  "unsat cores"
+               << std::endl;
+      options::satSolver.set(options::PropSatSolverMode::MINISAT);
+    }
+
+    if (options::cubeWorkers() > 0)
+    {
+      throw OptionException("cube-workers not supported with unsat cores");
+    }
+
     if (options::bitvectorAig())
     {
       throw OptionException("bitblast-aig not supported with unsat cores");
@@ -525,6 +560,19 @@ void setDefaults(LogicInfo& logic, bool isInternalSubsolver)
     }
   }
 
+  // proofs of the SAT solver are only supported by minisat
+  if (options::proof()
+      && options::satSolver() != options::PropSatSolverMode::MINISAT)
+  {
+    if (options::satSolver.wasSetByUser())
+    {
+      throw OptionException("sat-solver=cadical not supported with proofs");
+    }
+    Notice() << "SmtEngine: using minisat as the SAT solver to support proofs"
+             << std::endl;
+    options::satSolver.set(options::PropSatSolverMode::MINISAT);
+  }
+
   if (options::cegqiBv() && logic.isQuantified())
   {
     if (options::boolToBitvector() != options::BoolToBVMode::OFF)
@@ -934,6 +982,27 @@ void setDefaults(LogicInfo& logic, bool isInternalSubsolver)
     }
   }
 
+  // parallel matching runs the passes of the code tree in parallel
+  if (options::ematchThreads() > 1)
+  {
+#ifndef CVC4_THREAD_SAFE_NODES
+    throw OptionException(
+        "ematch-threads requires a build configured with --thread-safe-nodes");
+#endif
+    if (options::ematchEngine() != options::EmatchEngineMode::CODE_TREE)
+    {
+      throw OptionException(
+          "ematch-threads requires --ematch-engine=code-tree");
+    }
+    // a parallel round runs the triggers of all trees, and the incremental
+    // mode would skip the terms of the triggers whose matches are not taken
+    if (options::ematchCodeTreeInc())
+    {
+      throw OptionException(
+          "ematch-threads cannot be combined with --ematch-code-tree-inc");
+    }
+  }
+
   // apply sygus options
   // if we are attempting to rewrite everything to SyGuS, use sygus()
   if (is_sygus)
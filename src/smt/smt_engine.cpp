@@ -33,6 +33,7 @@
 #include "options/theory_options.h"
 #include "printer/printer.h"
 #include "proof/proof_manager.h"
+#include "prop/prop_engine.h"
 #include "proof/unsat_core.h"
 #include "smt/abduction_solver.h"
 #include "smt/abstract_values.h"
@@ -53,6 +54,7 @@
 #include "smt/smt_engine_state.h"
 #include "smt/smt_engine_stats.h"
 #include "smt/smt_solver.h"
+#include "smt/subsolver_pool.h"
 #include "smt/sygus_solver.h"
 #include "smt/unsat_core_manager.h"
 #include "theory/quantifiers/instantiation_list.h"
@@ -97,6 +99,7 @@ SmtEngine::SmtEngine(NodeManager* nm, Options* optr)
       d_abductSolver(nullptr),
       d_interpolSolver(nullptr),
       d_quantElimSolver(nullptr),
+      d_subsolverPool(nullptr),
       d_logic(),
       d_originalOptions(),
       d_isInternalSubsolver(false),
@@ -136,7 +139,9 @@ SmtEngine::SmtEngine(NodeManager* nm, Options* optr)
   // listen to resource out
   d_resourceManager->registerListener(d_routListener.get());
   // make statistics
-  d_stats.reset(new SmtEngineStatistics());
+  d_stats.reset(
+      new SmtEngineStatistics(getContext()->getCMM()->getStatistics(),
+                              getUserContext()->getCMM()->getStatistics()));
   // reset the preprocessor
   d_pp.reset(new smt::Preprocessor(
       *this, getUserContext(), *d_absValues.get(), *d_stats));
@@ -148,6 +153,8 @@ SmtEngine::SmtEngine(NodeManager* nm, Options* optr)
       new SygusSolver(*d_smtSolver, *d_pp, getUserContext(), d_outMgr));
   // make the quantifier elimination solver
   d_quantElimSolver.reset(new QuantElimSolver(*d_smtSolver));
+  // make the pool of subsolvers
+  d_subsolverPool.reset(new SubsolverPool(*this));
 
   // The ProofManager is constructed before any other proof objects such as
   // SatProof and TheoryProofs. The TheoryProofEngine and the SatProof are
@@ -222,6 +229,17 @@ void SmtEngine::finishInit()
   // based on our heuristics.
   d_optm->finishInit(d_logic, d_isInternalSubsolver);
 
+  // set up the rewrite caches, which depend on the options
+  d_rewriter->finishInit();
+
+  // configure the memory of the contexts
+  context::ContextMemoryConfig cmc;
+  cmc.d_maxChunkSizeBytes = size_t(options::contextMaxChunkSize()) * 1024;
+  cmc.d_maxFreeBytes = size_t(options::contextMaxFreeMemory()) * 1024;
+  cmc.d_hugePages = options::contextHugePages();
+  getContext()->getCMM()->setConfig(cmc);
+  getUserContext()->getCMM()->setConfig(cmc);
+
   ProofNodeManager* pnm = nullptr;
   if (options::proof())
   {
@@ -317,6 +335,9 @@ SmtEngine::~SmtEngine()
   SmtScope smts(this);
 
   try {
+    // destroy the subsolvers first, they share our node manager
+    d_subsolverPool.reset(nullptr);
+
     shutdown();
 
     // global push/pop around everything, to ensure proper destruction
@@ -1753,6 +1774,74 @@ std::vector<Node> SmtEngine::getAssertions()
   return res;
 }
 
+std::unique_ptr<SmtEngine> SmtEngine::clone()
+{
+  SmtScope smts(this);
+  finishInit();
+  if (options::unsatCores() || options::proof())
+  {
+    throw ModalException(
+        "Cannot clone an SmtEngine when unsat cores or proofs are enabled.");
+  }
+  if (language::isInputLangSygus(options::inputLanguage()))
+  {
+    throw ModalException("Cannot clone an SmtEngine in sygus mode.");
+  }
+  d_state->doPendingPops();
+  Trace("smt") << "SMT clone()" << endl;
+  // ensure the prop engine has all the assertions
+  d_smtSolver->processAssertions(*d_asserts);
+
+  std::unique_ptr<SmtEngine> smte(new SmtEngine(d_nodeManager, &d_options));
+  if (d_isInternalSubsolver)
+  {
+    smte->setIsInternalSubsolver();
+  }
+  smte->setLogic(getLogicInfo());
+  smte->finishInit();
+  SmtScope cloneScope(smte.get());
+  for (const std::pair<const Node, DefinedFunction>& df : *d_definedFunctions)
+  {
+    smte->d_definedFunctions->insertAtContextLevelZero(df.first, df.second);
+  }
+  // Assert the formulas of our prop engine directly to the prop engine of
+  // the clone, which bypasses preprocessing.
+  std::vector<const prop::PropEngine::AssertedFormula*> afs;
+  std::vector<Node> formulas;
+  for (const prop::PropEngine::AssertedFormula& af :
+       getPropEngine()->getAssertedFormulas())
+  {
+    afs.push_back(&af);
+    formulas.push_back(af.d_formula);
+  }
+  prop::PropEngine* pe = smte->getPropEngine();
+  pe->notifyPreprocessedAssertions(formulas);
+  for (const prop::PropEngine::AssertedFormula* af : afs)
+  {
+    if (af->d_skolem.isNull())
+    {
+      pe->assertFormula(af->d_formula);
+    }
+    else
+    {
+      pe->assertSkolemDefinition(af->d_formula, af->d_skolem);
+    }
+  }
+  // The variables eliminated by preprocessing do not occur in the formulas
+  // above, their substitutions are asserted so that later assertions and
+  // models of the clone account for them.
+  size_t numSubs = 0;
+  for (const std::pair<const Node, Node>& s :
+       d_pp->getTopLevelSubstitutions().get())
+  {
+    smte->assertFormula(s.first.eqNode(s.second));
+    ++numSubs;
+  }
+  Trace("smt") << "SMT clone(): cloned " << formulas.size() << " formulas and "
+               << numSubs << " substitutions" << endl;
+  return smte;
+}
+
 void SmtEngine::push()
 {
   SmtScope smts(this);
@@ -1891,6 +1980,12 @@ void SmtEngine::safeFlushStatistics(int fd) const
   d_statisticsRegistry->safeFlushInformation(fd);
 }
 
+void SmtEngine::flushStatisticsJSON(std::ostream& out, bool& first) const
+{
+  d_nodeManager->getStatisticsRegistry()->flushInformationJSON(out, first);
+  d_statisticsRegistry->flushInformationJSON(out, first);
+}
+
 void SmtEngine::setUserAttribute(const std::string& attr,
                                  Node expr,
                                  const std::vector<Node>& expr_values,
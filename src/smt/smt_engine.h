@@ -100,6 +100,7 @@ class SygusSolver;
 class AbductionSolver;
 class InterpolationSolver;
 class QuantElimSolver;
+class SubsolverPool;
 /**
  * Representation of a defined function.  We keep these around in
  * SmtEngine to permit expanding definitions late (and lazily), to
@@ -698,6 +699,27 @@ class CVC4_PUBLIC SmtEngine
    */
   std::vector<Node> getAssertions();
 
+  /**
+   * Make a clone of this SmtEngine. The clone is independent of this
+   * SmtEngine but shares its NodeManager, and with it the rewrite caches that
+   * are attributes of the nodes. It has the options, logic and defined
+   * functions of this SmtEngine, and its SAT solver starts from the
+   * preprocessed assertions of this SmtEngine, the skolem definitions of
+   * preprocessing, the non-removable lemmas learned so far (with
+   * --clone-lemmas) and the substitutions inferred by preprocessing. The
+   * assertions are therefore not preprocessed again.
+   *
+   * Assertions, push and pop in this SmtEngine or in the clone do not affect
+   * the other one. The clone does not keep the original assertions, hence
+   * get-assertions and check-models of the clone only concern the assertions
+   * made to the clone, and reset-assertions on the clone discards the cloned
+   * assertions.
+   *
+   * @throw ModalException if unsat cores or proofs are enabled, or in sygus
+   * mode
+   */
+  std::unique_ptr<SmtEngine> clone();
+
   /**
    * Push a user-level context.
    * throw@ ModalException, LogicException, UnsafeInterruptException
@@ -825,6 +847,12 @@ class CVC4_PUBLIC SmtEngine
    */
   void safeFlushStatistics(int fd) const;
 
+  /**
+   * Flush statistics from this SmtEngine and the NodeManager it uses as
+   * members of a JSON object, see StatisticsBase::flushInformationJSON().
+   */
+  void flushStatisticsJSON(std::ostream& out, bool& first) const;
+
   /**
    * Set user attribute.
    * This function is called when an attribute is set by a user.
@@ -872,6 +900,9 @@ class CVC4_PUBLIC SmtEngine
   /** Get a pointer to the Rewriter owned by this SmtEngine. */
   theory::Rewriter* getRewriter() { return d_rewriter.get(); }
 
+  /** Get the pool of reusable subsolvers of this SmtEngine. */
+  smt::SubsolverPool* getSubsolverPool() { return d_subsolverPool.get(); }
+
   /** The type of our internal map of defined functions */
   using DefinedFunctionMap =
       context::CDHashMap<Node, smt::DefinedFunction, NodeHashFunction>;
@@ -1119,6 +1150,8 @@ class CVC4_PUBLIC SmtEngine
   std::unique_ptr<smt::InterpolationSolver> d_interpolSolver;
   /** The solver for quantifier elimination queries */
   std::unique_ptr<smt::QuantElimSolver> d_quantElimSolver;
+  /** The subsolvers kept for reuse by satisfiability checks */
+  std::unique_ptr<smt::SubsolverPool> d_subsolverPool;
   /**
    * The logic we're in. This logic may be an extension of the logic set by the
    * user.
@@ -19,7 +19,9 @@
 namespace CVC4 {
 namespace smt {
 
-SmtEngineStatistics::SmtEngineStatistics()
+SmtEngineStatistics::SmtEngineStatistics(
+    const context::ContextMemoryStatistics& cms,
+    const context::ContextMemoryStatistics& ucms)
     : d_definitionExpansionTime("smt::SmtEngine::definitionExpansionTime"),
       d_numConstantProps("smt::SmtEngine::numConstantProps", 0),
       d_cnfConversionTime("smt::SmtEngine::cnfConversionTime"),
@@ -30,7 +32,20 @@ SmtEngineStatistics::SmtEngineStatistics()
       d_solveTime("smt::SmtEngine::solveTime"),
       d_pushPopTime("smt::SmtEngine::pushPopTime"),
       d_processAssertionsTime("smt::SmtEngine::processAssertionsTime"),
-      d_simplifiedToFalse("smt::SmtEngine::simplifiedToFalse", 0)
+      d_simplifiedToFalse("smt::SmtEngine::simplifiedToFalse", 0),
+      d_contextChunksAllocated("smt::SmtEngine::contextChunksAllocated",
+                               cms.d_chunksAllocated),
+      d_contextChunksRecycled("smt::SmtEngine::contextChunksRecycled",
+                              cms.d_chunksRecycled),
+      d_contextPeakChunkBytes("smt::SmtEngine::contextPeakChunkBytes",
+                              cms.d_peakChunkBytes),
+      d_userContextChunksAllocated(
+          "smt::SmtEngine::userContextChunksAllocated",
+          ucms.d_chunksAllocated),
+      d_userContextChunksRecycled("smt::SmtEngine::userContextChunksRecycled",
+                                  ucms.d_chunksRecycled),
+      d_userContextPeakChunkBytes("smt::SmtEngine::userContextPeakChunkBytes",
+                                  ucms.d_peakChunkBytes)
 {
   smtStatisticsRegistry()->registerStat(&d_definitionExpansionTime);
   smtStatisticsRegistry()->registerStat(&d_numConstantProps);
@@ -43,6 +58,12 @@ SmtEngineStatistics::SmtEngineStatistics()
   smtStatisticsRegistry()->registerStat(&d_pushPopTime);
   smtStatisticsRegistry()->registerStat(&d_processAssertionsTime);
   smtStatisticsRegistry()->registerStat(&d_simplifiedToFalse);
+  smtStatisticsRegistry()->registerStat(&d_contextChunksAllocated);
+  smtStatisticsRegistry()->registerStat(&d_contextChunksRecycled);
+  smtStatisticsRegistry()->registerStat(&d_contextPeakChunkBytes);
+  smtStatisticsRegistry()->registerStat(&d_userContextChunksAllocated);
+  smtStatisticsRegistry()->registerStat(&d_userContextChunksRecycled);
+  smtStatisticsRegistry()->registerStat(&d_userContextPeakChunkBytes);
 }
 
 SmtEngineStatistics::~SmtEngineStatistics()
@@ -58,6 +79,12 @@ SmtEngineStatistics::~SmtEngineStatistics()
   smtStatisticsRegistry()->unregisterStat(&d_pushPopTime);
   smtStatisticsRegistry()->unregisterStat(&d_processAssertionsTime);
   smtStatisticsRegistry()->unregisterStat(&d_simplifiedToFalse);
+  smtStatisticsRegistry()->unregisterStat(&d_contextChunksAllocated);
+  smtStatisticsRegistry()->unregisterStat(&d_contextChunksRecycled);
+  smtStatisticsRegistry()->unregisterStat(&d_contextPeakChunkBytes);
+  smtStatisticsRegistry()->unregisterStat(&d_userContextChunksAllocated);
+  smtStatisticsRegistry()->unregisterStat(&d_userContextChunksRecycled);
+  smtStatisticsRegistry()->unregisterStat(&d_userContextPeakChunkBytes);
 }
 
 }  // namespace smt
@@ -17,6 +17,7 @@
 #ifndef CVC4__SMT__SMT_ENGINE_STATS_H
 #define CVC4__SMT__SMT_ENGINE_STATS_H
 
+#include "context/context_mm.h"
 #include "util/statistics_registry.h"
 
 namespace CVC4 {
@@ -24,7 +25,12 @@ namespace smt {
 
 struct SmtEngineStatistics
 {
-  SmtEngineStatistics();
+  /**
+   * Constructs the statistics, which refer to the chunk statistics of the
+   * memory managers of the SAT context (cms) and the user context (ucms).
+   */
+  SmtEngineStatistics(const context::ContextMemoryStatistics& cms,
+                      const context::ContextMemoryStatistics& ucms);
   ~SmtEngineStatistics();
   /** time spent in definition-expansion */
   TimerStat d_definitionExpansionTime;
@@ -49,6 +55,18 @@ struct SmtEngineStatistics
 
   /** Has something simplified to false? */
   IntStat d_simplifiedToFalse;
+  /** Number of chunks allocated for the SAT context */
+  ReferenceStat<uint64_t> d_contextChunksAllocated;
+  /** Number of chunks of the SAT context reused from its free chunks */
+  ReferenceStat<uint64_t> d_contextChunksRecycled;
+  /** Peak number of bytes in the chunks of the SAT context */
+  ReferenceStat<uint64_t> d_contextPeakChunkBytes;
+  /** Number of chunks allocated for the user context */
+  ReferenceStat<uint64_t> d_userContextChunksAllocated;
+  /** Number of chunks of the user context reused from its free chunks */
+  ReferenceStat<uint64_t> d_userContextChunksRecycled;
+  /** Peak number of bytes in the chunks of the user context */
+  ReferenceStat<uint64_t> d_userContextPeakChunkBytes;
 }; /* struct SmtEngineStatistics */
 
 }  // namespace smt
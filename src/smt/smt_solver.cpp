@@ -14,12 +14,15 @@
 
 #include "smt/smt_solver.h"
 
+#include "options/quantifiers_options.h"
 #include "options/smt_options.h"
 #include "prop/prop_engine.h"
 #include "smt/assertions.h"
+#include "smt/cube_and_conquer.h"
 #include "smt/preprocessor.h"
 #include "smt/smt_engine.h"
 #include "smt/smt_engine_state.h"
+#include "theory/quantifiers_engine.h"
 #include "theory/theory_engine.h"
 #include "theory/theory_traits.h"
 
@@ -79,6 +82,12 @@ void SmtSolver::finishInit(const LogicInfo& logicInfo)
   Trace("smt-debug") << "Finishing init for theory engine..." << std::endl;
   d_theoryEngine->finishInit();
   d_propEngine->finishInit();
+
+  if (options::cubeWorkers() > 0)
+  {
+    d_cubeAndConquer.reset(new CubeAndConquer(
+        d_propEngine.get(), logicInfo, d_smt.getOptions()));
+  }
 }
 
 void SmtSolver::resetAssertions()
@@ -99,6 +108,14 @@ void SmtSolver::resetAssertions()
   // finishInit again. In particular, TheoryEngine::finishInit does not
   // depend on knowing the associated PropEngine.
   d_propEngine->finishInit();
+
+  if (d_cubeAndConquer != nullptr)
+  {
+    // as above, unregister the statistics of the old object first
+    d_cubeAndConquer.reset(nullptr);
+    d_cubeAndConquer.reset(new CubeAndConquer(
+        d_propEngine.get(), d_smt.getLogicInfo(), d_smt.getOptions()));
+  }
 }
 
 void SmtSolver::interrupt()
@@ -111,6 +128,10 @@ void SmtSolver::interrupt()
   {
     d_theoryEngine->interrupt();
   }
+  if (d_cubeAndConquer != nullptr)
+  {
+    d_cubeAndConquer->interrupt();
+  }
 }
 
 void SmtSolver::shutdown()
@@ -160,9 +181,53 @@ Result SmtSolver::checkSatisfiability(Assertions& as,
 
   Chat() << "solving..." << endl;
   Trace("smt") << "SmtSolver::check(): running check" << endl;
-  Result result = d_propEngine->checkSat();
+  Result result;
+  bool solved = false;
+  if (d_cubeAndConquer != nullptr)
+  {
+    // the formulas of the prop engine include the assertions of a clone
+    std::vector<Node> assertions;
+    for (const PropEngine::AssertedFormula& af :
+         d_propEngine->getAssertedFormulas())
+    {
+      assertions.push_back(af.d_formula);
+    }
+    std::vector<Node> satCube;
+    try
+    {
+      result = d_cubeAndConquer->solve(assertions, satCube);
+      solved = true;
+    }
+    catch (ExportUnsupportedException& e)
+    {
+      Notice() << "SmtSolver: cannot use cube-and-conquer (" << e.getMessage()
+               << "), solving sequentially" << std::endl;
+    }
+    if (solved && result.asSatisfiabilityResult().isSat() == Result::SAT
+        && (options::produceModels() || options::produceAssignments()))
+    {
+      // The workers do not share their models. The model is computed by the
+      // prop engine, whose search is steered towards the satisfiable cube.
+      for (const Node& lit : satCube)
+      {
+        bool pol = lit.getKind() != kind::NOT;
+        d_propEngine->requirePhase(pol ? lit : lit[0], pol);
+      }
+      solved = false;
+    }
+  }
+  if (!solved)
+  {
+    result = d_propEngine->checkSat();
+  }
 
   d_rm->endCall();
+  // the instantiation profile is also written if the check ran out of time
+  theory::QuantifiersEngine* qe = d_theoryEngine->getQuantifiersEngine();
+  if (qe != nullptr && !options::instProfile().empty())
+  {
+    qe->writeInstProfile();
+  }
   Trace("limit") << "SmtSolver::check(): cumulative millis "
                  << d_rm->getTimeUsage() << ", resources "
                  << d_rm->getResourceUsage() << endl;
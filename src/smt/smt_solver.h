@@ -41,6 +41,7 @@ class QuantifiersEngine;
 namespace smt {
 
 class Assertions;
+class CubeAndConquer;
 class SmtEngineState;
 class Preprocessor;
 struct SmtEngineStatistics;
@@ -148,6 +149,8 @@ class SmtSolver
   std::unique_ptr<TheoryEngine> d_theoryEngine;
   /** The propositional engine */
   std::unique_ptr<prop::PropEngine> d_propEngine;
+  /** The cube-and-conquer solver, if --cube-workers is enabled */
+  std::unique_ptr<CubeAndConquer> d_cubeAndConquer;
 };
 
 }  // namespace smt
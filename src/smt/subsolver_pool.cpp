@@ -0,0 +1,224 @@
+/*********************                                                        */
+/*! \file subsolver_pool.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the pool of reusable subsolvers of an SmtEngine
+ **/
+
+#include "smt/subsolver_pool.h"
+
+#include <sstream>
+
+#include "options/option_exception.h"
+#include "options/smt_options.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+#include "smt/smt_statistics_registry.h"
+
+namespace CVC4 {
+namespace smt {
+
+namespace {
+
+/** Convert a duration to seconds */
+double toSeconds(const timespec& t)
+{
+  return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_nsec) * 1e-9;
+}
+
+}  // namespace
+
+SubsolverPool::SubsolverPool(SmtEngine& parent) : d_parent(parent) {}
+
+SubsolverPool::~SubsolverPool() {}
+
+SmtEngine* SubsolverPool::acquire(const OptionMap& opts,
+                                  bool needsTimeout,
+                                  unsigned long timeout)
+{
+  if (options::subsolverPoolSize() == 0)
+  {
+    return nullptr;
+  }
+  std::string key = getKey(opts);
+  if (d_incompatible.find(key) != d_incompatible.end())
+  {
+    return nullptr;
+  }
+  Entry e;
+  std::list<Entry>::iterator it = d_idle.begin();
+  while (it != d_idle.end() && it->d_key != key)
+  {
+    ++it;
+  }
+  if (it != d_idle.end())
+  {
+    e = std::move(*it);
+    d_idle.erase(it);
+    ++d_statistics.d_numReused;
+    Trace("subsolver-pool") << "SubsolverPool: reuse subsolver for {" << key
+                            << "}" << std::endl;
+  }
+  else
+  {
+    e.d_key = key;
+    e.d_timeout = 0;
+    e.d_smte = construct(opts);
+    if (e.d_smte == nullptr)
+    {
+      d_incompatible.insert(key);
+      return nullptr;
+    }
+  }
+  unsigned long t = needsTimeout ? timeout : 0;
+  if (e.d_timeout != t)
+  {
+    e.d_smte->setTimeLimit(t);
+    e.d_timeout = t;
+  }
+  {
+    TimerStat::CodeTimer reuseTimer(d_statistics.d_reuseTime);
+    e.d_smte->push();
+  }
+  SmtEngine* smte = e.d_smte.get();
+  d_inUse[smte] = std::move(e);
+  return smte;
+}
+
+void SubsolverPool::release(SmtEngine* smte, bool discard)
+{
+  std::map<SmtEngine*, Entry>::iterator it = d_inUse.find(smte);
+  Assert(it != d_inUse.end());
+  Entry e = std::move(it->second);
+  d_inUse.erase(it);
+  if (discard || smte->getStatusOfLastCommand().isUnknown())
+  {
+    // the subsolver may have run out of resources, been interrupted, or be in
+    // the middle of a command that threw an exception
+    Trace("subsolver-pool") << "SubsolverPool: discard subsolver for {"
+                            << e.d_key << "}" << std::endl;
+    ++d_statistics.d_numDiscarded;
+    return;
+  }
+  {
+    TimerStat::CodeTimer reuseTimer(d_statistics.d_reuseTime);
+    smte->pop();
+  }
+  d_idle.push_front(std::move(e));
+  while (d_idle.size() > options::subsolverPoolSize())
+  {
+    d_idle.pop_back();
+    ++d_statistics.d_numEvicted;
+  }
+  updateTimeSaved();
+}
+
+void SubsolverPool::clear() { d_idle.clear(); }
+
+SubsolverPool::ReleaseGuard::ReleaseGuard(SubsolverPool* pool,
+                                          SmtEngine* smte)
+    : d_pool(pool), d_smte(smte), d_done(false)
+{
+}
+
+SubsolverPool::ReleaseGuard::~ReleaseGuard()
+{
+  if (d_smte != nullptr)
+  {
+    d_pool->release(d_smte, !d_done);
+  }
+}
+
+std::string SubsolverPool::getKey(const OptionMap& opts)
+{
+  std::stringstream ss;
+  for (const std::pair<const std::string, std::string>& o : opts)
+  {
+    ss << o.first << "=" << o.second << ";";
+  }
+  return ss.str();
+}
+
+std::unique_ptr<SmtEngine> SubsolverPool::construct(const OptionMap& opts)
+{
+  TimerStat::CodeTimer constructionTimer(d_statistics.d_constructionTime);
+  // A new SmtEngine puts itself in scope, restore the parent afterwards.
+  SmtScope scope(&d_parent);
+  std::unique_ptr<SmtEngine> smte(
+      new SmtEngine(d_parent.getNodeManager(), &d_parent.getOptions()));
+  SmtScope subsolverScope(smte.get());
+  smte->setIsInternalSubsolver();
+  smte->setLogic(d_parent.getLogicInfo());
+  for (const std::pair<const std::string, std::string>& o : opts)
+  {
+    smte->setOption(o.first, o.second);
+  }
+  smte->setOption("incremental", "true");
+  try
+  {
+    // initialize the subsolver, which fails if its options are incompatible
+    // with incremental mode
+    smte->finishInit();
+  }
+  catch (const OptionException& e)
+  {
+    Trace("subsolver-pool") << "SubsolverPool: cannot pool subsolver for {"
+                            << getKey(opts) << "}: " << e.getMessage()
+                            << std::endl;
+    return nullptr;
+  }
+  ++d_statistics.d_numConstructed;
+  Trace("subsolver-pool") << "SubsolverPool: construct subsolver for {"
+                          << getKey(opts) << "}" << std::endl;
+  return smte;
+}
+
+void SubsolverPool::updateTimeSaved()
+{
+  if (d_statistics.d_numConstructed.getData() == 0)
+  {
+    return;
+  }
+  double construction = toSeconds(d_statistics.d_constructionTime.getData())
+                        / d_statistics.d_numConstructed.getData();
+  d_statistics.d_timeSaved.setData(
+      construction * d_statistics.d_numReused.getData()
+      - toSeconds(d_statistics.d_reuseTime.getData()));
+}
+
+SubsolverPool::Statistics::Statistics()
+    : d_numConstructed("smt::SubsolverPool::constructed", 0),
+      d_numReused("smt::SubsolverPool::reused", 0),
+      d_numEvicted("smt::SubsolverPool::evicted", 0),
+      d_numDiscarded("smt::SubsolverPool::discarded", 0),
+      d_constructionTime("smt::SubsolverPool::constructionTime"),
+      d_reuseTime("smt::SubsolverPool::reuseTime"),
+      d_timeSaved("smt::SubsolverPool::estimatedTimeSaved", 0.0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numConstructed);
+  smtStatisticsRegistry()->registerStat(&d_numReused);
+  smtStatisticsRegistry()->registerStat(&d_numEvicted);
+  smtStatisticsRegistry()->registerStat(&d_numDiscarded);
+  smtStatisticsRegistry()->registerStat(&d_constructionTime);
+  smtStatisticsRegistry()->registerStat(&d_reuseTime);
+  smtStatisticsRegistry()->registerStat(&d_timeSaved);
+}
+
+SubsolverPool::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_numConstructed);
+  smtStatisticsRegistry()->unregisterStat(&d_numReused);
+  smtStatisticsRegistry()->unregisterStat(&d_numEvicted);
+  smtStatisticsRegistry()->unregisterStat(&d_numDiscarded);
+  smtStatisticsRegistry()->unregisterStat(&d_constructionTime);
+  smtStatisticsRegistry()->unregisterStat(&d_reuseTime);
+  smtStatisticsRegistry()->unregisterStat(&d_timeSaved);
+}
+
+}  // namespace smt
+}  // namespace CVC4
@@ -0,0 +1,160 @@
+/*********************                                                        */
+/*! \file subsolver_pool.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A pool of reusable subsolvers of an SmtEngine
+ **
+ ** Satisfiability checks of subsolvers, e.g. the verification queries of
+ ** sygus, are often so small that copying the options, setting the logic and
+ ** constructing the theory engine of a new SmtEngine dominates their cost. If
+ ** --subsolver-pool-size=N is given with N > 0, an SmtEngine keeps up to N
+ ** idle subsolvers, which are reused by later checks with the same options.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__SMT__SUBSOLVER_POOL_H
+#define CVC4__SMT__SUBSOLVER_POOL_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+
+class SmtEngine;
+
+namespace smt {
+
+/**
+ * A pool of subsolvers of an SmtEngine.
+ *
+ * The subsolvers are constructed in incremental mode, so that they can be
+ * reused: acquire() pushes a user context for the check, which release()
+ * pops before returning the subsolver to the pool. Resetting the assertions
+ * of a non-incremental subsolver is not sufficient, since several modules
+ * keep state that is not context-dependent in non-incremental mode.
+ *
+ * Subsolvers are keyed by the options that are set on them in addition to
+ * the options of the parent SmtEngine, whose logic they take. Options that
+ * cannot be used in incremental mode are remembered, and their checks use a
+ * subsolver of their own, as initializeSubsolver().
+ */
+class SubsolverPool
+{
+ public:
+  /** The options set on a subsolver in addition to those of its parent */
+  typedef std::map<std::string, std::string> OptionMap;
+
+  SubsolverPool(SmtEngine& parent);
+  ~SubsolverPool();
+
+  /**
+   * Get a subsolver of the parent, with the options of the parent and opts,
+   * in a new user context. If needsTimeout is true, each check is limited to
+   * timeout milliseconds.
+   *
+   * Returns nullptr if the pool is disabled or opts cannot be used in
+   * incremental mode. Otherwise, the subsolver must be given back by
+   * release(), until then it is owned by the pool.
+   */
+  SmtEngine* acquire(const OptionMap& opts,
+                     bool needsTimeout = false,
+                     unsigned long timeout = 0);
+  /**
+   * Give back a subsolver obtained from acquire(), which is kept for reuse
+   * unless discard is true or its last check was unknown, e.g. due to a
+   * timeout.
+   */
+  void release(SmtEngine* smte, bool discard = false);
+  /** Destroy all subsolvers that are not in use */
+  void clear();
+
+  /**
+   * Gives a subsolver obtained from acquire() back to its pool when it goes
+   * out of scope. The subsolver is discarded unless done() was called, e.g.
+   * if its check threw an exception. Does nothing if the subsolver is null.
+   */
+  class ReleaseGuard
+  {
+   public:
+    ReleaseGuard(SubsolverPool* pool, SmtEngine* smte);
+    ~ReleaseGuard();
+    /** Mark the use of the subsolver as completed */
+    void done() { d_done = true; }
+
+   private:
+    /** The pool */
+    SubsolverPool* d_pool;
+    /** The subsolver */
+    SmtEngine* d_smte;
+    /** Whether the use of the subsolver was completed */
+    bool d_done;
+  };
+
+ private:
+  /** A subsolver owned by the pool */
+  struct Entry
+  {
+    /** The key of its options */
+    std::string d_key;
+    /** Its time limit per check, or 0 if none */
+    unsigned long d_timeout;
+    /** The subsolver */
+    std::unique_ptr<SmtEngine> d_smte;
+  };
+  /** Get the key of opts */
+  static std::string getKey(const OptionMap& opts);
+  /** Construct a subsolver, returns nullptr if opts are incompatible */
+  std::unique_ptr<SmtEngine> construct(const OptionMap& opts);
+  /** Update the estimate of the saved time */
+  void updateTimeSaved();
+
+  /** The parent SmtEngine */
+  SmtEngine& d_parent;
+  /** The idle subsolvers, the most recently used first */
+  std::list<Entry> d_idle;
+  /** The subsolvers that were acquired and not yet released */
+  std::map<SmtEngine*, Entry> d_inUse;
+  /** The keys of options that cannot be used in incremental mode */
+  std::unordered_set<std::string> d_incompatible;
+
+  struct Statistics
+  {
+    /** Number of subsolvers constructed for the pool */
+    IntStat d_numConstructed;
+    /** Number of checks that reused a subsolver */
+    IntStat d_numReused;
+    /** Number of idle subsolvers destroyed since the pool was full */
+    IntStat d_numEvicted;
+    /** Number of subsolvers not reused since their check was unknown */
+    IntStat d_numDiscarded;
+    /** Time spent constructing and initializing subsolvers */
+    TimerStat d_constructionTime;
+    /** Time spent pushing and popping reused subsolvers */
+    TimerStat d_reuseTime;
+    /**
+     * Estimate of the time saved in seconds, i.e. the average construction
+     * time for each reuse, minus the time of reuses
+     */
+    BackedStat<double> d_timeSaved;
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+}; /* class SubsolverPool */
+
+}  // namespace smt
+}  // namespace CVC4
+
+#endif /* CVC4__SMT__SUBSOLVER_POOL_H */
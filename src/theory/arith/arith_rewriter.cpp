@@ -19,7 +19,9 @@
 #include <stack>
 #include <vector>
 
+#include "options/theory_options.h"
 #include "smt/logic_exception.h"
+#include "smt/smt_statistics_registry.h"
 #include "theory/arith/arith_msum.h"
 #include "theory/arith/arith_rewriter.h"
 #include "theory/arith/arith_utilities.h"
@@ -31,6 +33,24 @@ namespace CVC4 {
 namespace theory {
 namespace arith {
 
+ArithRewriter::ArithRewriter()
+{
+  if (options::rewriteProfile())
+  {
+    d_ruleProfile.reset(new RewriteProfileStat<Rewrite>(
+        "theory::arith::ArithRewriter::ruleProfile"));
+    smtStatisticsRegistry()->registerStat(d_ruleProfile.get());
+  }
+}
+
+ArithRewriter::~ArithRewriter()
+{
+  if (d_ruleProfile != nullptr)
+  {
+    smtStatisticsRegistry()->unregisterStat(d_ruleProfile.get());
+  }
+}
+
 bool ArithRewriter::isAtom(TNode n) {
   Kind k = n.getKind();
   return arith::isRelationOperator(k) || k == kind::IS_INTEGER
@@ -680,12 +700,17 @@ RewriteResponse ArithRewriter::preRewriteAtom(TNode atom){
 }
 
 RewriteResponse ArithRewriter::postRewrite(TNode t){
+  RewriteProfileStep<Rewrite> step(d_ruleProfile.get(), Rewrite::NONE);
   if(isTerm(t)){
     RewriteResponse response = postRewriteTerm(t);
     if (Debug.isOn("arith::rewriter") && response.d_status == REWRITE_DONE)
     {
       Polynomial::parsePolynomial(response.d_node);
     }
+    if (response.d_node != t)
+    {
+      step.setSuccess(true);
+    }
     return response;
   }else if(isAtom(t)){
     RewriteResponse response = postRewriteAtom(t);
@@ -693,6 +718,10 @@ RewriteResponse ArithRewriter::postRewrite(TNode t){
     {
       Comparison::parseNormalForm(response.d_node);
     }
+    if (response.d_node != t)
+    {
+      step.setSuccess(true);
+    }
     return response;
   }else{
     Unreachable();
@@ -700,13 +729,13 @@ RewriteResponse ArithRewriter::postRewrite(TNode t){
 }
 
 RewriteResponse ArithRewriter::preRewrite(TNode t){
-  if(isTerm(t)){
-    return preRewriteTerm(t);
-  }else if(isAtom(t)){
-    return preRewriteAtom(t);
-  }else{
-    Unreachable();
+  RewriteProfileStep<Rewrite> step(d_ruleProfile.get(), Rewrite::NONE);
+  RewriteResponse response = isTerm(t) ? preRewriteTerm(t) : preRewriteAtom(t);
+  if (response.d_node != t)
+  {
+    step.setSuccess(true);
   }
+  return response;
 }
 
 Node ArithRewriter::makeUnaryMinusNode(TNode n){
@@ -895,6 +924,7 @@ RewriteResponse ArithRewriter::returnRewrite(TNode t, Node ret, Rewrite r)
 {
   Trace("arith-rewrite") << "ArithRewriter : " << t << " == " << ret << " by "
                          << r << std::endl;
+  RewriteProfileStep<Rewrite>::setRule(r);
   return RewriteResponse(REWRITE_AGAIN_FULL, ret);
 }
 
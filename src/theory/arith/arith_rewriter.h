@@ -20,7 +20,10 @@
 #ifndef CVC4__THEORY__ARITH__ARITH_REWRITER_H
 #define CVC4__THEORY__ARITH__ARITH_REWRITER_H
 
+#include <memory>
+
 #include "theory/arith/rewrites.h"
+#include "theory/rewrite_profile.h"
 #include "theory/theory_rewriter.h"
 
 namespace CVC4 {
@@ -30,6 +33,9 @@ namespace arith {
 class ArithRewriter : public TheoryRewriter
 {
  public:
+  ArithRewriter();
+  ~ArithRewriter();
+
   RewriteResponse preRewrite(TNode n) override;
   RewriteResponse postRewrite(TNode n) override;
 
@@ -69,6 +75,13 @@ class ArithRewriter : public TheoryRewriter
   }
   /** return rewrite */
   static RewriteResponse returnRewrite(TNode t, Node ret, Rewrite r);
+
+  /**
+   * The profile of the rewrites of this rewriter, or nullptr if
+   * --rewrite-profile is disabled. Rewrite steps that do not end in one of the
+   * rewrites of Rewrite are recorded as Rewrite::NONE.
+   */
+  std::unique_ptr<RewriteProfileStat<Rewrite>> d_ruleProfile;
 }; /* class ArithRewriter */
 
 }/* CVC4::theory::arith namespace */
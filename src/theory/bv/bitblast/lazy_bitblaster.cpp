@@ -86,7 +86,7 @@ TLazyBitblaster::TLazyBitblaster(context::Context* c,
                                         nullptr,
                                         rm,
                                         prop::FormulaLitPolicy::INTERNAL,
-                                        "LazyBitblaster"));
+                                        name));
 
   d_satSolverNotify.reset(
       d_emptyNotify
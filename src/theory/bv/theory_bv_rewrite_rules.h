@@ -27,6 +27,7 @@
 #include "smt/smt_engine.h"
 #include "smt/smt_engine_scope.h"
 #include "theory/bv/theory_bv_utils.h"
+#include "theory/rewrite_profile.h"
 #include "theory/theory.h"
 #include "util/statistics_registry.h"
 
@@ -206,211 +207,193 @@ enum RewriteRuleId
   BitOfConst,
 };
 
-inline std::ostream& operator << (std::ostream& out, RewriteRuleId ruleId) {
+/**
+ * Converts a rewrite rule id to a string. Note: This function is also used in
+ * `safe_print()`.
+ */
+inline const char* toString(RewriteRuleId ruleId)
+{
   switch (ruleId) {
-  case EmptyRule:           out << "EmptyRule";           return out;
-  case ConcatFlatten:       out << "ConcatFlatten";       return out;
-  case ConcatExtractMerge:  out << "ConcatExtractMerge";  return out;
-  case ConcatConstantMerge: out << "ConcatConstantMerge"; return out;
-  case AndOrXorConcatPullUp:out << "AndOrXorConcatPullUp";return out;
-  case NegEliminate: out << "NegEliminate"; return out;
-  case OrEliminate: out << "OrEliminate"; return out;
-  case XorEliminate: out << "XorEliminate"; return out;
-  case ExtractExtract:      out << "ExtractExtract";      return out;
-  case ExtractWhole:        out << "ExtractWhole";        return out;
-  case ExtractConcat:       out << "ExtractConcat";       return out;
-  case ExtractConstant:     out << "ExtractConstant";     return out;
-  case FailEq:              out << "FailEq";              return out;
-  case SimplifyEq:          out << "SimplifyEq";          return out;
-  case ReflexivityEq:       out << "ReflexivityEq";       return out;
-  case UgtEliminate:        out << "UgtEliminate";        return out;
-  case SgtEliminate:        out << "SgtEliminate";        return out;
-  case UgeEliminate:        out << "UgeEliminate";        return out;
-  case SgeEliminate:        out << "SgeEliminate";        return out;
-  case RedorEliminate:      out << "RedorEliminate";      return out;
-  case RedandEliminate:     out << "RedandEliminate";     return out;
-  case RepeatEliminate:     out << "RepeatEliminate";     return out;
-  case RotateLeftEliminate: out << "RotateLeftEliminate"; return out;
-  case RotateRightEliminate:out << "RotateRightEliminate";return out;
-  case BVToNatEliminate:    out << "BVToNatEliminate";    return out;
-  case IntToBVEliminate:    out << "IntToBVEliminate";    return out;
-  case NandEliminate:       out << "NandEliminate";       return out;
-  case NorEliminate :       out << "NorEliminate";        return out;
-  case SdivEliminate :      out << "SdivEliminate";       return out;
+  case EmptyRule:           return "EmptyRule";
+  case ConcatFlatten:       return "ConcatFlatten";
+  case ConcatExtractMerge:  return "ConcatExtractMerge";
+  case ConcatConstantMerge: return "ConcatConstantMerge";
+  case AndOrXorConcatPullUp:return "AndOrXorConcatPullUp";
+  case NegEliminate: return "NegEliminate";
+  case OrEliminate: return "OrEliminate";
+  case XorEliminate: return "XorEliminate";
+  case ExtractExtract:      return "ExtractExtract";
+  case ExtractWhole:        return "ExtractWhole";
+  case ExtractConcat:       return "ExtractConcat";
+  case ExtractConstant:     return "ExtractConstant";
+  case FailEq:              return "FailEq";
+  case SimplifyEq:          return "SimplifyEq";
+  case ReflexivityEq:       return "ReflexivityEq";
+  case UgtEliminate:        return "UgtEliminate";
+  case SgtEliminate:        return "SgtEliminate";
+  case UgeEliminate:        return "UgeEliminate";
+  case SgeEliminate:        return "SgeEliminate";
+  case RedorEliminate:      return "RedorEliminate";
+  case RedandEliminate:     return "RedandEliminate";
+  case RepeatEliminate:     return "RepeatEliminate";
+  case RotateLeftEliminate: return "RotateLeftEliminate";
+  case RotateRightEliminate:return "RotateRightEliminate";
+  case BVToNatEliminate:    return "BVToNatEliminate";
+  case IntToBVEliminate:    return "IntToBVEliminate";
+  case NandEliminate:       return "NandEliminate";
+  case NorEliminate :       return "NorEliminate";
+  case SdivEliminate :      return "SdivEliminate";
   case SdivEliminateFewerBitwiseOps:
-    out << "SdivEliminateFewerBitwiseOps";
-    return out;
-  case SremEliminate :      out << "SremEliminate";       return out;
+    return "SdivEliminateFewerBitwiseOps";
+  case SremEliminate :      return "SremEliminate";
   case SremEliminateFewerBitwiseOps:
-    out << "SremEliminateFewerBitwiseOps";
-    return out;
-  case SmodEliminate :      out << "SmodEliminate";       return out;
+    return "SremEliminateFewerBitwiseOps";
+  case SmodEliminate :      return "SmodEliminate";
   case SmodEliminateFewerBitwiseOps:
-    out << "SmodEliminateFewerBitwiseOps";
-    return out;
-  case ZeroExtendEliminate :out << "ZeroExtendEliminate"; return out;
-  case EvalEquals :         out << "EvalEquals";          return out;
-  case EvalConcat :         out << "EvalConcat";          return out;
-  case EvalAnd :            out << "EvalAnd";             return out;
-  case EvalOr :             out << "EvalOr";              return out;
-  case EvalXor :            out << "EvalXor";             return out;
-  case EvalNot :            out << "EvalNot";             return out;
-  case EvalMult :           out << "EvalMult";            return out;
-  case EvalPlus :           out << "EvalPlus";            return out;
-  case EvalUdiv :           out << "EvalUdiv";            return out;
-  case EvalUrem :           out << "EvalUrem";            return out;
-  case EvalShl :            out << "EvalShl";             return out;
-  case EvalLshr :           out << "EvalLshr";            return out;
-  case EvalAshr :           out << "EvalAshr";            return out;
-  case EvalUlt :            out << "EvalUlt";             return out;
-  case EvalUle :            out << "EvalUle";             return out;
-  case EvalSlt :            out << "EvalSlt";             return out;
-  case EvalSle :            out << "EvalSle";             return out; 
-  case EvalSltBv:           out << "EvalSltBv";           return out;
-  case EvalITEBv:           out << "EvalITEBv";           return out;
-  case EvalComp:            out << "EvalComp";            return out;
-  case EvalExtract :        out << "EvalExtract";         return out;
-  case EvalSignExtend :     out << "EvalSignExtend";      return out;
-  case EvalRotateLeft :     out << "EvalRotateLeft";      return out;
-  case EvalRotateRight :    out << "EvalRotateRight";     return out;
-  case EvalNeg :            out << "EvalNeg";             return out;
-  case BvIteConstCond :     out << "BvIteConstCond";      return out;
-  case BvIteEqualChildren : out << "BvIteEqualChildren";  return out;
-  case BvIteConstChildren : out << "BvIteConstChildren";  return out;
-  case BvIteEqualCond :     out << "BvIteEqualCond";      return out;
-  case BvIteMergeThenIf :   out << "BvIteMergeThenIf";    return out;
-  case BvIteMergeElseIf :   out << "BvIteMergeElseIf";    return out;
-  case BvIteMergeThenElse : out << "BvIteMergeThenElse";  return out;
-  case BvIteMergeElseElse : out << "BvIteMergeElseElse";  return out;
-  case BvComp :             out << "BvComp";              return out;
-  case ShlByConst :         out << "ShlByConst";          return out;
-  case LshrByConst :        out << "LshrByConst";         return out;
-  case AshrByConst :        out << "AshrByConst";         return out;
-  case ExtractBitwise :     out << "ExtractBitwise";      return out;
-  case ExtractNot :         out << "ExtractNot";          return out;
-  case ExtractArith :       out << "ExtractArith";        return out;
-  case ExtractArith2 :      out << "ExtractArith2";       return out;
-  case DoubleNeg :          out << "DoubleNeg";           return out;
-  case NotConcat :          out << "NotConcat";           return out;
-  case NotAnd :             out << "NotAnd";              return out;
-  case NotOr :              out << "NotOr";               return out;
-  case NotXor :             out << "NotXor";              return out;
-  case BitwiseIdemp :       out << "BitwiseIdemp";        return out;
-  case XorDuplicate :       out << "XorDuplicate";        return out;
-  case BitwiseNotAnd :      out << "BitwiseNotAnd";       return out;
-  case BitwiseNotOr :       out << "BitwiseNotOr";        return out;
-  case XorNot :             out << "XorNot";              return out;
-  case LtSelf :             out << "LtSelf";              return out;
-  case LteSelf :            out << "LteSelf";             return out;
-  case UltZero :            out << "UltZero";             return out;
-  case UleZero :            out << "UleZero";             return out;
-  case ZeroUle :            out << "ZeroUle";             return out;
-  case NotUlt :             out << "NotUlt";              return out;
-  case NotUle :             out << "NotUle";              return out;
-  case UleMax :             out << "UleMax";              return out;
-  case SltEliminate :       out << "SltEliminate";        return out;
-  case SleEliminate :       out << "SleEliminate";        return out;
-  case AndZero :       out << "AndZero";        return out;
-  case AndOne :       out << "AndOne";        return out;
-  case OrZero :       out << "OrZero";        return out;
-  case OrOne :       out << "OrOne";        return out;
-  case XorOne :       out << "XorOne";        return out;
-  case XorZero :       out << "XorZero";        return out;
-  case MultPow2 :            out << "MultPow2";             return out;
-  case MultSlice :            out << "MultSlice";             return out;
-  case ExtractMultLeadingBit :            out << "ExtractMultLeadingBit";             return out;
-  case NegIdemp :            out << "NegIdemp";             return out;
-  case UdivPow2 :            out << "UdivPow2";             return out;
+    return "SmodEliminateFewerBitwiseOps";
+  case ZeroExtendEliminate :return "ZeroExtendEliminate";
+  case EvalEquals :         return "EvalEquals";
+  case EvalConcat :         return "EvalConcat";
+  case EvalAnd :            return "EvalAnd";
+  case EvalOr :             return "EvalOr";
+  case EvalXor :            return "EvalXor";
+  case EvalNot :            return "EvalNot";
+  case EvalMult :           return "EvalMult";
+  case EvalPlus :           return "EvalPlus";
+  case EvalUdiv :           return "EvalUdiv";
+  case EvalUrem :           return "EvalUrem";
+  case EvalShl :            return "EvalShl";
+  case EvalLshr :           return "EvalLshr";
+  case EvalAshr :           return "EvalAshr";
+  case EvalUlt :            return "EvalUlt";
+  case EvalUle :            return "EvalUle";
+  case EvalSlt :            return "EvalSlt";
+  case EvalSle :            return "EvalSle"; 
+  case EvalSltBv:           return "EvalSltBv";
+  case EvalITEBv:           return "EvalITEBv";
+  case EvalComp:            return "EvalComp";
+  case EvalExtract :        return "EvalExtract";
+  case EvalSignExtend :     return "EvalSignExtend";
+  case EvalRotateLeft :     return "EvalRotateLeft";
+  case EvalRotateRight :    return "EvalRotateRight";
+  case EvalNeg :            return "EvalNeg";
+  case BvIteConstCond :     return "BvIteConstCond";
+  case BvIteEqualChildren : return "BvIteEqualChildren";
+  case BvIteConstChildren : return "BvIteConstChildren";
+  case BvIteEqualCond :     return "BvIteEqualCond";
+  case BvIteMergeThenIf :   return "BvIteMergeThenIf";
+  case BvIteMergeElseIf :   return "BvIteMergeElseIf";
+  case BvIteMergeThenElse : return "BvIteMergeThenElse";
+  case BvIteMergeElseElse : return "BvIteMergeElseElse";
+  case BvComp :             return "BvComp";
+  case ShlByConst :         return "ShlByConst";
+  case LshrByConst :        return "LshrByConst";
+  case AshrByConst :        return "AshrByConst";
+  case ExtractBitwise :     return "ExtractBitwise";
+  case ExtractNot :         return "ExtractNot";
+  case ExtractArith :       return "ExtractArith";
+  case ExtractArith2 :      return "ExtractArith2";
+  case DoubleNeg :          return "DoubleNeg";
+  case NotConcat :          return "NotConcat";
+  case NotAnd :             return "NotAnd";
+  case NotOr :              return "NotOr";
+  case NotXor :             return "NotXor";
+  case BitwiseIdemp :       return "BitwiseIdemp";
+  case XorDuplicate :       return "XorDuplicate";
+  case BitwiseNotAnd :      return "BitwiseNotAnd";
+  case BitwiseNotOr :       return "BitwiseNotOr";
+  case XorNot :             return "XorNot";
+  case LtSelf :             return "LtSelf";
+  case LteSelf :            return "LteSelf";
+  case UltZero :            return "UltZero";
+  case UleZero :            return "UleZero";
+  case ZeroUle :            return "ZeroUle";
+  case NotUlt :             return "NotUlt";
+  case NotUle :             return "NotUle";
+  case UleMax :             return "UleMax";
+  case SltEliminate :       return "SltEliminate";
+  case SleEliminate :       return "SleEliminate";
+  case AndZero :       return "AndZero";
+  case AndOne :       return "AndOne";
+  case OrZero :       return "OrZero";
+  case OrOne :       return "OrOne";
+  case XorOne :       return "XorOne";
+  case XorZero :       return "XorZero";
+  case MultPow2 :            return "MultPow2";
+  case MultSlice :            return "MultSlice";
+  case ExtractMultLeadingBit :            return "ExtractMultLeadingBit";
+  case NegIdemp :            return "NegIdemp";
+  case UdivPow2 :            return "UdivPow2";
   case UdivZero:
-    out << "UdivZero";
-    return out;
-  case UdivOne :            out << "UdivOne";             return out;
-  case UremPow2 :            out << "UremPow2";             return out;
-  case UremOne :            out << "UremOne";             return out;
-  case UremSelf :            out << "UremSelf";             return out;
-  case ShiftZero :            out << "ShiftZero";             return out;
-  case UgtUrem: out << "UgtUrem"; return out;
-  case SubEliminate :            out << "SubEliminate";             return out;
-  case CompEliminate :            out << "CompEliminate";             return out;
-  case XnorEliminate :            out << "XnorEliminate";             return out;
-  case SignExtendEliminate :            out << "SignExtendEliminate";             return out;
-  case NotIdemp :                  out << "NotIdemp"; return out;
-  case UleSelf:                    out << "UleSelf"; return out; 
-  case FlattenAssocCommut:     out << "FlattenAssocCommut"; return out;
-  case FlattenAssocCommutNoDuplicates:     out << "FlattenAssocCommutNoDuplicates"; return out; 
-  case PlusCombineLikeTerms: out << "PlusCombineLikeTerms"; return out;
-  case MultSimplify: out << "MultSimplify"; return out;
-  case MultDistribConst: out << "MultDistribConst"; return out;
-  case SolveEq : out << "SolveEq"; return out;
-  case BitwiseEq : out << "BitwiseEq"; return out;
-  case NegMult : out << "NegMult"; return out;
-  case NegSub : out << "NegSub"; return out;
-  case AndSimplify : out << "AndSimplify"; return out;
-  case OrSimplify : out << "OrSimplify"; return out;
-  case XorSimplify : out << "XorSimplify"; return out;
-  case NegPlus : out << "NegPlus"; return out;
-  case BBPlusNeg : out << "BBPlusNeg"; return out;
-  case UltOne : out << "UltOne"; return out;
-  case SltZero : out << "SltZero"; return out;
-  case ZeroUlt : out << "ZeroUlt"; return out;
-  case MergeSignExtend : out << "MergeSignExtend"; return out;
-  case SignExtendEqConst: out << "SignExtendEqConst"; return out;
-  case ZeroExtendEqConst: out << "ZeroExtendEqConst"; return out;
-  case SignExtendUltConst: out << "SignExtendUltConst"; return out;
-  case ZeroExtendUltConst: out << "ZeroExtendUltConst"; return out;
+    return "UdivZero";
+  case UdivOne :            return "UdivOne";
+  case UremPow2 :            return "UremPow2";
+  case UremOne :            return "UremOne";
+  case UremSelf :            return "UremSelf";
+  case ShiftZero :            return "ShiftZero";
+  case UgtUrem: return "UgtUrem";
+  case SubEliminate :            return "SubEliminate";
+  case CompEliminate :            return "CompEliminate";
+  case XnorEliminate :            return "XnorEliminate";
+  case SignExtendEliminate :            return "SignExtendEliminate";
+  case NotIdemp :                  return "NotIdemp";
+  case UleSelf:                    return "UleSelf"; 
+  case FlattenAssocCommut:     return "FlattenAssocCommut";
+  case FlattenAssocCommutNoDuplicates:     return "FlattenAssocCommutNoDuplicates"; 
+  case PlusCombineLikeTerms: return "PlusCombineLikeTerms";
+  case MultSimplify: return "MultSimplify";
+  case MultDistribConst: return "MultDistribConst";
+  case SolveEq : return "SolveEq";
+  case BitwiseEq : return "BitwiseEq";
+  case NegMult : return "NegMult";
+  case NegSub : return "NegSub";
+  case AndSimplify : return "AndSimplify";
+  case OrSimplify : return "OrSimplify";
+  case XorSimplify : return "XorSimplify";
+  case NegPlus : return "NegPlus";
+  case BBPlusNeg : return "BBPlusNeg";
+  case UltOne : return "UltOne";
+  case SltZero : return "SltZero";
+  case ZeroUlt : return "ZeroUlt";
+  case MergeSignExtend : return "MergeSignExtend";
+  case SignExtendEqConst: return "SignExtendEqConst";
+  case ZeroExtendEqConst: return "ZeroExtendEqConst";
+  case SignExtendUltConst: return "SignExtendUltConst";
+  case ZeroExtendUltConst: return "ZeroExtendUltConst";
     
-  case UleEliminate : out << "UleEliminate"; return out;
-  case BitwiseSlicing : out << "BitwiseSlicing"; return out;
-  case ExtractSignExtend : out << "ExtractSignExtend"; return out;
-  case MultDistrib: out << "MultDistrib"; return out;
-  case UltPlusOne: out << "UltPlusOne"; return out;
-  case ConcatToMult: out << "ConcatToMult"; return out;
-  case IsPowerOfTwo: out << "IsPowerOfTwo"; return out;
-  case MultSltMult: out << "MultSltMult"; return out;
-  case NormalizeEqPlusNeg: out << "NormalizeEqPlusNeg"; return out;
-  case BitOfConst: out << "BitOfConst"; return out;
+  case UleEliminate : return "UleEliminate";
+  case BitwiseSlicing : return "BitwiseSlicing";
+  case ExtractSignExtend : return "ExtractSignExtend";
+  case MultDistrib: return "MultDistrib";
+  case UltPlusOne: return "UltPlusOne";
+  case ConcatToMult: return "ConcatToMult";
+  case IsPowerOfTwo: return "IsPowerOfTwo";
+  case MultSltMult: return "MultSltMult";
+  case NormalizeEqPlusNeg: return "NormalizeEqPlusNeg";
+  case BitOfConst: return "BitOfConst";
   default:
     Unreachable();
   }
+}
+
+inline std::ostream& operator<<(std::ostream& out, RewriteRuleId ruleId)
+{
+  return out << toString(ruleId);
+}
+
+/**
+ * The profile of the rewrite rules applied by a TheoryBVRewriter, see
+ * --rewrite-profile.
+ */
+class RewriteRuleProfile : public RewriteProfileStat<RewriteRuleId>
+{
+ public:
+  using RewriteProfileStat<RewriteRuleId>::RewriteProfileStat;
 };
 
 template <RewriteRuleId rule>
 class RewriteRule {
 
-  // class RuleStatistics {
-
-  //   /** The name of the rule prefixed with the prefix */
-  //   static std::string getStatName(const char* prefix) {
-  //     std::stringstream statName;
-  //     statName << prefix << rule;
-  //     return statName.str();
-  //   }
-
-  // public:
-
-  //   /** Number of applications of this rule */
-  //   IntStat d_ruleApplications;
-
-  //   /** Constructor */
-  //   RuleStatistics()
-  //   : d_ruleApplications(getStatName("theory::bv::RewriteRules::count"), 0) {
-  //     currentStatisticsRegistry()->registerStat(&d_ruleApplications);
-  //   }
-
-  //   /** Destructor */
-  //   ~RuleStatistics() {
-  //     StatisticsRegistry::unregisterStat(&d_ruleApplications);
-  //   }
-  // };
-
-  // /* Statistics about the rule */
-  // // NOTE: Cannot have static fields like this, or else you can't have
-  // // two SmtEngines in the process (the second-to-be-destroyed will
-  // // have a dangling pointer and segfault).  If this statistic is needed,
-  // // fix the rewriter by making it an instance per-SmtEngine (instead of
-  // // static).
-  // static RuleStatistics* s_statistics;
-
   /** Actually apply the rewrite rule */
   static inline Node apply(TNode node) {
     Unreachable();
@@ -419,21 +402,6 @@ class RewriteRule {
 
 public:
 
-  RewriteRule() {
-    
-    // if (s_statistics == NULL) {
-    //   s_statistics = new RuleStatistics();
-    // }
-    
-  }
-
-  ~RewriteRule() {
-    
-    // delete s_statistics;
-    // s_statistics = NULL;
-    
-  }
-
   static inline bool applies(TNode node)
   {
     Unreachable();
@@ -442,10 +410,37 @@ public:
 
   template<bool checkApplies>
   static inline Node run(TNode node) {
+    // recorded in the rule profile of the BV rewriter in scope, if any
+    return run<checkApplies>(node,
+                             RewriteProfileScope<RewriteRuleId>::active());
+  }
+
+  /**
+   * As above, recorded in the given rule profile. If profile is nullptr, the
+   * rule is applied without measuring it.
+   */
+  template<bool checkApplies>
+  static inline Node run(TNode node,
+                         RewriteProfileStat<RewriteRuleId>* profile)
+  {
+    if (profile == nullptr)
+    {
+      return runUnprofiled<checkApplies>(node);
+    }
+    RewriteProfileStep<RewriteRuleId> step(profile, rule);
+    Node result = runUnprofiled<checkApplies>(node);
+    step.setSuccess(result != node);
+    return result;
+  }
+
+private:
+
+  /** Apply the rewrite rule to node, if it applies */
+  template<bool checkApplies>
+  static inline Node runUnprofiled(TNode node) {
     if (!checkApplies || applies(node)) {
       Debug("theory::bv::rewrite") << "RewriteRule<" << rule << ">(" << node << ")" << std::endl;
       Assert(checkApplies || applies(node));
-      //++ s_statistics->d_ruleApplications;
       Node result = apply(node);
       if (result != node) {
         if(Dump.isOn("bv-rewrites")) {
@@ -472,9 +467,6 @@ public:
 };
 
 
- // template<RewriteRuleId rule>
- //   typename RewriteRule<rule>::RuleStatistics* RewriteRule<rule>::s_statistics = NULL;
-
 
 /** Have to list all the rewrite rules to get the statistics out */
 struct AllRewriteRules {
@@ -639,12 +631,16 @@ template<Kind kind, RewriteRuleId rule>
 struct ApplyRuleToChildren {
 
   static Node apply(TNode node) {
+    return apply(node, RewriteProfileScope<RewriteRuleId>::active());
+  }
+
+  static Node apply(TNode node, RewriteProfileStat<RewriteRuleId>* profile) {
     if (node.getKind() != kind) {
-      return RewriteRule<rule>::template run<true>(node);
+      return RewriteRule<rule>::template run<true>(node, profile);
     }
     NodeBuilder<> result(kind);
     for (unsigned i = 0, end = node.getNumChildren(); i < end; ++ i) {
-      result << RewriteRule<rule>::template run<true>(node[i]);
+      result << RewriteRule<rule>::template run<true>(node[i], profile);
     }
     return result;
   }
@@ -656,8 +652,14 @@ struct ApplyRuleToChildren {
 
   template <bool checkApplies>
   static Node run(TNode node) {
+    return run<checkApplies>(node,
+                             RewriteProfileScope<RewriteRuleId>::active());
+  }
+
+  template <bool checkApplies>
+  static Node run(TNode node, RewriteProfileStat<RewriteRuleId>* profile) {
     if (!checkApplies || applies(node)) {
-      return apply(node);
+      return apply(node, profile);
     } else {
       return node;
     }
@@ -688,27 +690,30 @@ template <
   >
 struct LinearRewriteStrategy {
   static Node apply(TNode node) {
+    // the rule profile of the BV rewriter in scope, if any
+    RewriteProfileStat<RewriteRuleId>* profile =
+        RewriteProfileScope<RewriteRuleId>::active();
     Node current = node;
-    if (R1::applies(current)) current  = R1::template run<false>(current);
-    if (R2::applies(current)) current  = R2::template run<false>(current);
-    if (R3::applies(current)) current  = R3::template run<false>(current);
-    if (R4::applies(current)) current  = R4::template run<false>(current);
-    if (R5::applies(current)) current  = R5::template run<false>(current);
-    if (R6::applies(current)) current  = R6::template run<false>(current);
-    if (R7::applies(current)) current  = R7::template run<false>(current);
-    if (R8::applies(current)) current  = R8::template run<false>(current);
-    if (R9::applies(current)) current  = R9::template run<false>(current);
-    if (R10::applies(current)) current = R10::template run<false>(current);
-    if (R11::applies(current)) current = R11::template run<false>(current);
-    if (R12::applies(current)) current = R12::template run<false>(current);
-    if (R13::applies(current)) current = R13::template run<false>(current);
-    if (R14::applies(current)) current = R14::template run<false>(current);
-    if (R15::applies(current)) current = R15::template run<false>(current);
-    if (R16::applies(current)) current = R16::template run<false>(current);
-    if (R17::applies(current)) current = R17::template run<false>(current);
-    if (R18::applies(current)) current = R18::template run<false>(current);
-    if (R19::applies(current)) current = R19::template run<false>(current);
-    if (R20::applies(current)) current = R20::template run<false>(current);
+    if (R1::applies(current)) current  = R1::template run<false>(current, profile);
+    if (R2::applies(current)) current  = R2::template run<false>(current, profile);
+    if (R3::applies(current)) current  = R3::template run<false>(current, profile);
+    if (R4::applies(current)) current  = R4::template run<false>(current, profile);
+    if (R5::applies(current)) current  = R5::template run<false>(current, profile);
+    if (R6::applies(current)) current  = R6::template run<false>(current, profile);
+    if (R7::applies(current)) current  = R7::template run<false>(current, profile);
+    if (R8::applies(current)) current  = R8::template run<false>(current, profile);
+    if (R9::applies(current)) current  = R9::template run<false>(current, profile);
+    if (R10::applies(current)) current = R10::template run<false>(current, profile);
+    if (R11::applies(current)) current = R11::template run<false>(current, profile);
+    if (R12::applies(current)) current = R12::template run<false>(current, profile);
+    if (R13::applies(current)) current = R13::template run<false>(current, profile);
+    if (R14::applies(current)) current = R14::template run<false>(current, profile);
+    if (R15::applies(current)) current = R15::template run<false>(current, profile);
+    if (R16::applies(current)) current = R16::template run<false>(current, profile);
+    if (R17::applies(current)) current = R17::template run<false>(current, profile);
+    if (R18::applies(current)) current = R18::template run<false>(current, profile);
+    if (R19::applies(current)) current = R19::template run<false>(current, profile);
+    if (R20::applies(current)) current = R20::template run<false>(current, profile);
     return current;
   }
 };
@@ -737,30 +742,33 @@ template <
   >
 struct FixpointRewriteStrategy {
   static Node apply(TNode node) {
+    // the rule profile of the BV rewriter in scope, if any
+    RewriteProfileStat<RewriteRuleId>* profile =
+        RewriteProfileScope<RewriteRuleId>::active();
     Node previous = node; 
     Node current = node;
     do {
       previous = current;
-      if (R1::applies(current)) current  = R1::template run<false>(current);
-      if (R2::applies(current)) current  = R2::template run<false>(current);
-      if (R3::applies(current)) current  = R3::template run<false>(current);
-      if (R4::applies(current)) current  = R4::template run<false>(current);
-      if (R5::applies(current)) current  = R5::template run<false>(current);
-      if (R6::applies(current)) current  = R6::template run<false>(current);
-      if (R7::applies(current)) current  = R7::template run<false>(current);
-      if (R8::applies(current)) current  = R8::template run<false>(current);
-      if (R9::applies(current)) current  = R9::template run<false>(current);
-      if (R10::applies(current)) current = R10::template run<false>(current);
-      if (R11::applies(current)) current = R11::template run<false>(current);
-      if (R12::applies(current)) current = R12::template run<false>(current);
-      if (R13::applies(current)) current = R13::template run<false>(current);
-      if (R14::applies(current)) current = R14::template run<false>(current);
-      if (R15::applies(current)) current = R15::template run<false>(current);
-      if (R16::applies(current)) current = R16::template run<false>(current);
-      if (R17::applies(current)) current = R17::template run<false>(current);
-      if (R18::applies(current)) current = R18::template run<false>(current);
-      if (R19::applies(current)) current = R19::template run<false>(current);
-      if (R20::applies(current)) current = R20::template run<false>(current);
+      if (R1::applies(current)) current  = R1::template run<false>(current, profile);
+      if (R2::applies(current)) current  = R2::template run<false>(current, profile);
+      if (R3::applies(current)) current  = R3::template run<false>(current, profile);
+      if (R4::applies(current)) current  = R4::template run<false>(current, profile);
+      if (R5::applies(current)) current  = R5::template run<false>(current, profile);
+      if (R6::applies(current)) current  = R6::template run<false>(current, profile);
+      if (R7::applies(current)) current  = R7::template run<false>(current, profile);
+      if (R8::applies(current)) current  = R8::template run<false>(current, profile);
+      if (R9::applies(current)) current  = R9::template run<false>(current, profile);
+      if (R10::applies(current)) current = R10::template run<false>(current, profile);
+      if (R11::applies(current)) current = R11::template run<false>(current, profile);
+      if (R12::applies(current)) current = R12::template run<false>(current, profile);
+      if (R13::applies(current)) current = R13::template run<false>(current, profile);
+      if (R14::applies(current)) current = R14::template run<false>(current, profile);
+      if (R15::applies(current)) current = R15::template run<false>(current, profile);
+      if (R16::applies(current)) current = R16::template run<false>(current, profile);
+      if (R17::applies(current)) current = R17::template run<false>(current, profile);
+      if (R18::applies(current)) current = R18::template run<false>(current, profile);
+      if (R19::applies(current)) current = R19::template run<false>(current, profile);
+      if (R20::applies(current)) current = R20::template run<false>(current, profile);
     } while (previous != current);
     
     return current;
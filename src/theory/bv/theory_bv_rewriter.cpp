@@ -16,6 +16,8 @@
  **/
 
 #include "options/bv_options.h"
+#include "options/theory_options.h"
+#include "smt/smt_statistics_registry.h"
 #include "theory/bv/theory_bv_rewrite_rules.h"
 #include "theory/bv/theory_bv_rewrite_rules_constant_evaluation.h"
 #include "theory/bv/theory_bv_rewrite_rules_core.h"
@@ -29,9 +31,27 @@ using namespace CVC4;
 using namespace CVC4::theory;
 using namespace CVC4::theory::bv;
 
-TheoryBVRewriter::TheoryBVRewriter() { initializeRewrites(); }
+TheoryBVRewriter::TheoryBVRewriter()
+{
+  initializeRewrites();
+  if (options::rewriteProfile())
+  {
+    d_ruleProfile.reset(
+        new RewriteRuleProfile("theory::bv::TheoryBVRewriter::ruleProfile"));
+    smtStatisticsRegistry()->registerStat(d_ruleProfile.get());
+  }
+}
+
+TheoryBVRewriter::~TheoryBVRewriter()
+{
+  if (d_ruleProfile != nullptr)
+  {
+    smtStatisticsRegistry()->unregisterStat(d_ruleProfile.get());
+  }
+}
 
 RewriteResponse TheoryBVRewriter::preRewrite(TNode node) {
+  RewriteProfileScope<RewriteRuleId> profile(d_ruleProfile.get());
   RewriteResponse res = d_rewriteTable[node.getKind()](node, true);
   if (res.d_node != node)
   {
@@ -43,6 +63,7 @@ RewriteResponse TheoryBVRewriter::preRewrite(TNode node) {
 }
 
 RewriteResponse TheoryBVRewriter::postRewrite(TNode node) {
+  RewriteProfileScope<RewriteRuleId> profile(d_ruleProfile.get());
   RewriteResponse res = d_rewriteTable[node.getKind()](node, false);
   if (res.d_node != node)
   {
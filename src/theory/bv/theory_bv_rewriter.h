@@ -20,6 +20,8 @@
 #ifndef CVC4__THEORY__BV__THEORY_BV_REWRITER_H
 #define CVC4__THEORY__BV__THEORY_BV_REWRITER_H
 
+#include <memory>
+
 #include "theory/theory_rewriter.h"
 #include "util/statistics_registry.h"
 
@@ -28,6 +30,7 @@ namespace theory {
 namespace bv {
 
 struct AllRewriteRules;
+class RewriteRuleProfile;
 typedef RewriteResponse (*RewriteFunction) (TNode, bool);
 
 class TheoryBVRewriter : public TheoryRewriter
@@ -44,6 +47,7 @@ class TheoryBVRewriter : public TheoryRewriter
   static Node eliminateBVSDiv(TNode node);
 
   TheoryBVRewriter();
+  ~TheoryBVRewriter();
 
   RewriteResponse postRewrite(TNode node) override;
   RewriteResponse preRewrite(TNode node) override;
@@ -103,6 +107,12 @@ class TheoryBVRewriter : public TheoryRewriter
   void initializeRewrites();
 
   RewriteFunction d_rewriteTable[kind::LAST_KIND];
+
+  /**
+   * The profile of the rewrite rules applied by this rewriter, or nullptr if
+   * --rewrite-profile is disabled.
+   */
+  std::unique_ptr<RewriteRuleProfile> d_ruleProfile;
 }; /* class TheoryBVRewriter */
 
 }/* CVC4::theory::bv namespace */
@@ -113,5 +113,18 @@ void EqEngineManagerDistributed::MasterNotifyClass::eqNotifyNewClass(TNode t)
   d_quantEngine->eqNotifyNewClass(t);
 }
 
+void EqEngineManagerDistributed::MasterNotifyClass::eqNotifyMerge(TNode t1,
+                                                                  TNode t2)
+{
+  // updates the term indices of the quantifiers term database
+  d_quantEngine->eqNotifyMerge(t1, t2);
+}
+
+void EqEngineManagerDistributed::MasterNotifyClass::eqNotifyDisequal(
+    TNode t1, TNode t2, TNode reason)
+{
+  d_quantEngine->eqNotifyDisequal(t1, t2);
+}
+
 }  // namespace theory
 }  // namespace CVC4
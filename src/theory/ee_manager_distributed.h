@@ -79,8 +79,13 @@ class EqEngineManagerDistributed : public EqEngineManager
       return true;
     }
     void eqNotifyConstantTermMerge(TNode t1, TNode t2) override {}
-    void eqNotifyMerge(TNode t1, TNode t2) override {}
-    void eqNotifyDisequal(TNode t1, TNode t2, TNode reason) override {}
+    /**
+     * Called when the class of t2 is merged into the class of t1 in the master
+     * equality engine.
+     */
+    void eqNotifyMerge(TNode t1, TNode t2) override;
+    /** Called when t1 and t2 are disequal in the master equality engine */
+    void eqNotifyDisequal(TNode t1, TNode t2, TNode reason) override;
 
    private:
     /** Pointer to quantifiers engine */
@@ -0,0 +1,606 @@
+/*********************                                                        */
+/*! \file code_tree.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the code tree for matching single triggers
+ **/
+
+#include "theory/quantifiers/ematching/code_tree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+#include "expr/node_manager.h"
+#include "options/options.h"
+#include "options/quantifiers_options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/quantifiers/quantifiers_state.h"
+#include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers/term_util.h"
+#include "theory/uf/equality_engine.h"
+
+using namespace CVC4::kind;
+
+namespace CVC4 {
+namespace theory {
+namespace inst {
+
+namespace {
+
+/** Is k a kind whose terms are matched through the term database? */
+bool isCompilableKind(Kind k)
+{
+  return k == APPLY_UF || k == SELECT || k == STORE || k == APPLY_TESTER
+         || k == UNION || k == INTERSECTION || k == SUBSET || k == SETMINUS
+         || k == MEMBER || k == SINGLETON || k == SEP_PTO
+         || k == BITVECTOR_TO_NAT || k == INT_TO_BITVECTOR
+         || k == STRING_LENGTH || k == SEQ_NTH;
+}
+
+/**
+ * Is application t compilable for quantified formula q? Adds the variables
+ * of q in t to vars.
+ */
+bool isCompilableApp(Node q,
+                     Node t,
+                     std::unordered_set<Node, NodeHashFunction>& vars)
+{
+  if (!isCompilableKind(t.getKind()))
+  {
+    return false;
+  }
+  for (const Node& tc : t)
+  {
+    if (tc.getKind() == INST_CONSTANT)
+    {
+      if (quantifiers::TermUtil::getInstConstAttr(tc) != q)
+      {
+        return false;
+      }
+      vars.insert(tc);
+    }
+    else if (quantifiers::TermUtil::hasInstConstAttr(tc)
+             && !isCompilableApp(q, tc, vars))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool CodeTree::Instr::operator==(const Instr& i) const
+{
+  return d_kind == i.d_kind && d_reg == i.d_reg && d_arg == i.d_arg
+         && d_node == i.d_node && d_arity == i.d_arity;
+}
+
+CodeTree::CodeTree(quantifiers::QuantifiersState& qs, quantifiers::TermDb* tdb)
+    : d_qstate(qs),
+      d_tdb(tdb),
+      d_incremental(options::ematchCodeTreeInc()),
+      d_numThreads(options::ematchThreads()),
+      d_cegqi(options::cegqi()),
+      d_round(0)
+{
+  Assert(d_numThreads <= 1 || !d_incremental);
+}
+
+CodeTree::~CodeTree() {}
+
+bool CodeTree::reset(Theory::Effort e)
+{
+  d_round++;
+  return true;
+}
+
+bool CodeTree::isCompilable(Node q, Node pat)
+{
+  std::unordered_set<Node, NodeHashFunction> vars;
+  if (!isCompilableApp(q, pat, vars))
+  {
+    return false;
+  }
+  return vars.size() == q[0].getNumChildren();
+}
+
+size_t CodeTree::registerPattern(Node q, Node pat)
+{
+  Assert(isCompilable(q, pat));
+  Node op = d_tdb->getMatchOperator(pat);
+  Assert(!op.isNull());
+  std::vector<Instr> code;
+  std::map<Node, size_t> slots;
+  std::unique_ptr<Pattern> p(new Pattern(d_qstate.getSatContext()));
+  size_t numRegs = pat.getNumChildren() + 1;
+  compileArgs(pat, 1, code, slots, p->d_varNum, numRegs);
+
+  Root& r = d_roots[op];
+  r.d_numRegs = std::max(r.d_numRegs, numRegs);
+  r.d_numSlots = std::max(r.d_numSlots, slots.size());
+  for (const Instr& in : code)
+  {
+    if (in.d_kind == InstrKind::MATCH
+        && std::find(r.d_matchOps.begin(), r.d_matchOps.end(), in.d_node)
+               == r.d_matchOps.end())
+    {
+      r.d_matchOps.push_back(in.d_node);
+    }
+  }
+  // insert the code into the tree, sharing the longest common prefix
+  CodeNode* n = &r.d_node;
+  size_t shared = 0;
+  for (const Instr& in : code)
+  {
+    CodeNode* next = nullptr;
+    for (const std::unique_ptr<CodeNode>& c : n->d_children)
+    {
+      if (c->d_instr == in)
+      {
+        next = c.get();
+        break;
+      }
+    }
+    if (next == nullptr)
+    {
+      n->d_children.emplace_back(new CodeNode);
+      next = n->d_children.back().get();
+      next->d_instr = in;
+      ++d_statistics.d_nodes;
+    }
+    else
+    {
+      shared++;
+    }
+    n = next;
+  }
+  size_t id = d_patterns.size();
+  n->d_yields.push_back(id);
+  r.d_patterns.push_back(id);
+  p->d_quant = q;
+  p->d_op = op;
+  p->d_leaf = n;
+  d_patterns.push_back(std::move(p));
+  ++d_statistics.d_patterns;
+  Trace("code-tree") << "CodeTree: register " << pat << " for " << q << ", "
+                     << code.size() << " instructions, " << shared
+                     << " shared" << std::endl;
+  return id;
+}
+
+void CodeTree::unregisterPattern(size_t id)
+{
+  Assert(id < d_patterns.size() && d_patterns[id] != nullptr);
+  Pattern& p = *d_patterns[id];
+  std::vector<size_t>& yields = p.d_leaf->d_yields;
+  yields.erase(std::find(yields.begin(), yields.end(), id));
+  std::vector<size_t>& pats = d_roots[p.d_op].d_patterns;
+  pats.erase(std::find(pats.begin(), pats.end(), id));
+  // the nodes of the code are kept, they are shared by most triggers
+  d_patterns[id].reset();
+}
+
+std::vector<std::vector<Node>>& CodeTree::getMatches(size_t id)
+{
+  Assert(id < d_patterns.size() && d_patterns[id] != nullptr);
+  Pattern& p = *d_patterns[id];
+  if (p.d_round != d_round)
+  {
+    if (d_numThreads > 1)
+    {
+      runParallel();
+    }
+    else
+    {
+      run(p.d_op, d_roots[p.d_op]);
+    }
+  }
+  return p.d_matches;
+}
+
+Node CodeTree::getOperator(size_t id) const
+{
+  Assert(id < d_patterns.size() && d_patterns[id] != nullptr);
+  return d_patterns[id]->d_op;
+}
+
+void CodeTree::compileArgs(Node t,
+                           size_t base,
+                           std::vector<Instr>& code,
+                           std::map<Node, size_t>& slots,
+                           std::vector<size_t>& varNum,
+                           size_t& numRegs)
+{
+  // first, the variables and ground arguments, which filter candidates
+  for (size_t i = 0, nchild = t.getNumChildren(); i < nchild; i++)
+  {
+    Node tc = t[i];
+    Instr in;
+    in.d_reg = base + i;
+    in.d_arg = 0;
+    in.d_arity = 0;
+    if (tc.getKind() == INST_CONSTANT)
+    {
+      std::map<Node, size_t>::iterator it = slots.find(tc);
+      if (it != slots.end())
+      {
+        in.d_kind = InstrKind::COMPARE;
+        in.d_arg = it->second;
+      }
+      else
+      {
+        in.d_kind = InstrKind::BIND;
+        in.d_arg = slots.size();
+        slots[tc] = in.d_arg;
+        varNum.push_back(tc.getAttribute(InstVarNumAttribute()));
+      }
+    }
+    else if (!quantifiers::TermUtil::hasInstConstAttr(tc))
+    {
+      in.d_kind = InstrKind::CHECK;
+      in.d_node = tc;
+    }
+    else
+    {
+      continue;
+    }
+    code.push_back(in);
+  }
+  // then, the nested applications
+  for (size_t i = 0, nchild = t.getNumChildren(); i < nchild; i++)
+  {
+    Node tc = t[i];
+    if (tc.getKind() == INST_CONSTANT
+        || !quantifiers::TermUtil::hasInstConstAttr(tc))
+    {
+      continue;
+    }
+    Instr in;
+    in.d_kind = InstrKind::MATCH;
+    in.d_reg = base + i;
+    in.d_arg = numRegs;
+    in.d_node = d_tdb->getMatchOperator(tc);
+    in.d_arity = tc.getNumChildren();
+    Assert(!in.d_node.isNull());
+    code.push_back(in);
+    numRegs += tc.getNumChildren();
+    compileArgs(tc, in.d_arg, code, slots, varNum, numRegs);
+  }
+}
+
+void CodeTree::run(Node op, Root& r)
+{
+  size_t start = preparePass(op, r);
+  Pass pass(false);
+  pass.d_root = &r;
+  executePass(op, start, pass);
+  finishPass(r, d_tdb->getNumGroundTerms(op), pass);
+}
+
+void CodeTree::runParallel()
+{
+  // prepare the passes of all trees with triggers that were not run
+  std::vector<Node> ops;
+  std::vector<size_t> starts;
+  for (std::pair<const Node, Root>& r : d_roots)
+  {
+    for (size_t id : r.second.d_patterns)
+    {
+      if (d_patterns[id]->d_round != d_round)
+      {
+        ops.push_back(r.first);
+        starts.push_back(preparePass(r.first, r.second));
+        break;
+      }
+    }
+  }
+  if (ops.empty())
+  {
+    return;
+  }
+  ++d_statistics.d_parallelRounds;
+  std::vector<std::unique_ptr<Pass>> passes;
+  for (const Node& op : ops)
+  {
+    passes.emplace_back(new Pass(true));
+    passes.back()->d_root = &d_roots[op];
+  }
+  // the passes are taken from a shared counter by the threads, the options
+  // and node manager are thread local, and must be set in each thread
+  std::atomic<size_t> next(0);
+  Options* opts = Options::current();
+  NodeManager* nm = NodeManager::currentNM();
+  auto work = [&]() {
+    Options::OptionsScope optionsScope(opts);
+    NodeManagerScope nms(nm);
+    for (size_t i = next++; i < ops.size(); i = next++)
+    {
+      executePass(ops[i], starts[i], *passes[i]);
+    }
+  };
+  size_t nthreads = std::min(d_numThreads, ops.size());
+  Trace("code-tree") << "CodeTree: run " << ops.size() << " passes in "
+                     << nthreads << " threads" << std::endl;
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < nthreads; i++)
+  {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& t : threads)
+  {
+    t.join();
+  }
+  for (size_t i = 0, nops = ops.size(); i < nops; i++)
+  {
+    finishPass(d_roots[ops[i]], d_tdb->getNumGroundTerms(ops[i]), *passes[i]);
+  }
+}
+
+size_t CodeTree::preparePass(Node op, Root& r)
+{
+  ++d_statistics.d_passes;
+  size_t nterms = d_tdb->getNumGroundTerms(op);
+  size_t start = nterms;
+  for (size_t id : r.d_patterns)
+  {
+    Pattern& p = *d_patterns[id];
+    if (p.d_round == d_round)
+    {
+      continue;
+    }
+    p.d_round = d_round;
+    p.d_collect = true;
+    p.d_matches.clear();
+    if (!d_incremental)
+    {
+      start = 0;
+      continue;
+    }
+    // the ground terms may have been removed by a pop of the user context
+    if (p.d_numMatched.get() > nterms)
+    {
+      p.d_numMatched = nterms;
+    }
+    start = std::min(start, p.d_numMatched.get());
+  }
+  // compute the term indices used by MATCH instructions, which are read only
+  // during the pass
+  r.d_eqcTries.clear();
+  for (const Node& mop : r.d_matchOps)
+  {
+    r.d_eqcTries[mop] = d_tdb->getTermArgTrie(Node::null(), mop);
+  }
+  // passes may run on other threads, so they are only traced here and in
+  // finishPass()
+  Trace("code-tree") << "CodeTree: run " << op << " on terms " << start
+                     << "..." << nterms << std::endl;
+  return start;
+}
+
+void CodeTree::executePass(Node op, size_t start, Pass& pass)
+{
+  Root& r = *pass.d_root;
+  size_t nterms = d_tdb->getNumGroundTerms(op);
+  pass.d_regs.resize(r.d_numRegs);
+  pass.d_slots.resize(r.d_numSlots);
+  for (size_t i = start; i < nterms; i++)
+  {
+    if (d_qstate.isInConflict())
+    {
+      break;
+    }
+    Node t = d_tdb->getGroundTerm(op, i);
+    if (t.getNumChildren() >= r.d_numRegs
+        || !isLegalCandidate(t, Node::null(), pass)
+        || !d_tdb->hasTermCurrent(t))
+    {
+      continue;
+    }
+    pass.d_matchesAttempted++;
+    pass.d_termIndex = i;
+    pass.d_regs[0] = t;
+    for (size_t j = 0, nchild = t.getNumChildren(); j < nchild; j++)
+    {
+      pass.d_regs[j + 1] = t[j];
+    }
+    execute(r.d_node, pass);
+  }
+}
+
+void CodeTree::finishPass(Root& r, size_t nterms, const Pass& pass)
+{
+  for (size_t id : r.d_patterns)
+  {
+    Pattern& p = *d_patterns[id];
+    if (p.d_collect && Trace.isOn("code-tree-debug"))
+    {
+      for (const std::vector<Node>& terms : p.d_matches)
+      {
+        Trace("code-tree-debug") << "CodeTree: match " << terms << " for "
+                                 << p.d_quant << std::endl;
+      }
+    }
+    if (p.d_collect && d_incremental)
+    {
+      p.d_numMatched = nterms;
+    }
+    p.d_collect = false;
+  }
+  d_statistics.d_instructions += pass.d_instructions;
+  d_statistics.d_matchesAttempted += pass.d_matchesAttempted;
+  d_statistics.d_matchesProduced += pass.d_matchesProduced;
+}
+
+void CodeTree::execute(CodeNode& n, Pass& pass)
+{
+  for (size_t id : n.d_yields)
+  {
+    Pattern& p = *d_patterns[id];
+    if (!p.d_collect
+        || (d_incremental && pass.d_termIndex < p.d_numMatched.get()))
+    {
+      continue;
+    }
+    std::vector<Node> terms(p.d_quant[0].getNumChildren());
+    for (size_t s = 0, nslots = p.d_varNum.size(); s < nslots; s++)
+    {
+      terms[p.d_varNum[s]] = pass.d_slots[s];
+    }
+    p.d_matches.push_back(terms);
+    pass.d_matchesProduced++;
+  }
+  for (const std::unique_ptr<CodeNode>& c : n.d_children)
+  {
+    const Instr& in = c->d_instr;
+    pass.d_instructions++;
+    switch (in.d_kind)
+    {
+      case InstrKind::BIND:
+        pass.d_slots[in.d_arg] = pass.d_regs[in.d_reg];
+        execute(*c, pass);
+        break;
+      case InstrKind::COMPARE:
+        if (d_qstate.areEqual(pass.d_slots[in.d_arg], pass.d_regs[in.d_reg]))
+        {
+          execute(*c, pass);
+        }
+        break;
+      case InstrKind::CHECK:
+        if (d_qstate.areEqual(in.d_node, pass.d_regs[in.d_reg]))
+        {
+          execute(*c, pass);
+        }
+        break;
+      case InstrKind::MATCH: executeMatch(*c, pass); break;
+    }
+  }
+}
+
+void CodeTree::executeMatch(CodeNode& n, Pass& pass)
+{
+  const Instr& in = n.d_instr;
+  TNode eqc = pass.d_regs[in.d_reg];
+  eq::EqualityEngine* ee = d_qstate.getEqualityEngine();
+  // as CandidateGeneratorQE, the candidates are the terms of the equivalence
+  // class of eqc, or eqc itself if it is not in the equality engine
+  if (!ee->hasTerm(eqc))
+  {
+    executeMatchCandidate(n, eqc, pass);
+    return;
+  }
+  // same as TermDb::getTermArgTrie(r, in.d_node) == nullptr, where the
+  // tries are indexed by representatives
+  TNode r = ee->getRepresentative(eqc);
+  std::map<Node, TNodeTrie*>::const_iterator itt =
+      pass.d_root->d_eqcTries.find(in.d_node);
+  Assert(itt != pass.d_root->d_eqcTries.end());
+  if (itt->second == nullptr
+      || itt->second->d_data.find(r) == itt->second->d_data.end())
+  {
+    return;
+  }
+  eq::EqClassIterator it(r, ee);
+  for (; !it.isFinished(); ++it)
+  {
+    executeMatchCandidate(n, *it, pass);
+  }
+}
+
+void CodeTree::executeMatchCandidate(CodeNode& n, Node c, Pass& pass)
+{
+  const Instr& in = n.d_instr;
+  if (c.getNumChildren() != in.d_arity || !isLegalCandidate(c, in.d_node, pass))
+  {
+    return;
+  }
+  pass.d_matchesAttempted++;
+  for (size_t j = 0; j < in.d_arity; j++)
+  {
+    pass.d_regs[in.d_arg + j] = c[j];
+  }
+  execute(n, pass);
+}
+
+bool CodeTree::isLegalCandidate(Node n, Node op, Pass& pass)
+{
+  if (!op.isNull())
+  {
+    if (!n.hasOperator())
+    {
+      return false;
+    }
+    Node nop;
+    if (pass.d_shared)
+    {
+      // computing the match operator of parametric kinds updates a cache
+      std::lock_guard<std::mutex> guard(d_tdbMutex);
+      nop = d_tdb->getMatchOperator(n);
+    }
+    else
+    {
+      nop = d_tdb->getMatchOperator(n);
+    }
+    if (nop != op)
+    {
+      return false;
+    }
+  }
+  if (!d_tdb->isTermActive(n))
+  {
+    return false;
+  }
+  if (d_cegqi)
+  {
+    if (pass.d_shared)
+    {
+      // computing whether n has instantiation constants caches the result
+      // in an attribute of n
+      std::lock_guard<std::mutex> guard(d_tdbMutex);
+      return !quantifiers::TermUtil::hasInstConstAttr(n);
+    }
+    return !quantifiers::TermUtil::hasInstConstAttr(n);
+  }
+  return true;
+}
+
+CodeTree::Statistics::Statistics()
+    : d_patterns("CodeTree::Patterns", 0),
+      d_nodes("CodeTree::Nodes", 0),
+      d_passes("CodeTree::Passes", 0),
+      d_instructions("CodeTree::Instructions", 0),
+      d_matchesAttempted("CodeTree::Matches_Attempted", 0),
+      d_matchesProduced("CodeTree::Matches_Produced", 0),
+      d_parallelRounds("CodeTree::Parallel_Rounds", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_patterns);
+  smtStatisticsRegistry()->registerStat(&d_nodes);
+  smtStatisticsRegistry()->registerStat(&d_passes);
+  smtStatisticsRegistry()->registerStat(&d_instructions);
+  smtStatisticsRegistry()->registerStat(&d_matchesAttempted);
+  smtStatisticsRegistry()->registerStat(&d_matchesProduced);
+  smtStatisticsRegistry()->registerStat(&d_parallelRounds);
+}
+
+CodeTree::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_patterns);
+  smtStatisticsRegistry()->unregisterStat(&d_nodes);
+  smtStatisticsRegistry()->unregisterStat(&d_passes);
+  smtStatisticsRegistry()->unregisterStat(&d_instructions);
+  smtStatisticsRegistry()->unregisterStat(&d_matchesAttempted);
+  smtStatisticsRegistry()->unregisterStat(&d_matchesProduced);
+  smtStatisticsRegistry()->unregisterStat(&d_parallelRounds);
+}
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
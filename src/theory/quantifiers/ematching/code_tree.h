@@ -0,0 +1,310 @@
+/*********************                                                        */
+/*! \file code_tree.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Code tree for matching all single triggers in one pass
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__QUANTIFIERS__CODE_TREE_H
+#define CVC4__THEORY__QUANTIFIERS__CODE_TREE_H
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "context/cdo.h"
+#include "expr/node.h"
+#include "expr/node_trie.h"
+#include "theory/quantifiers/quant_util.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+namespace quantifiers {
+class QuantifiersState;
+class TermDb;
+}  // namespace quantifiers
+
+namespace inst {
+
+/** CodeTree class
+ *
+ * This class compiles the single triggers of all quantified formulas into
+ * code trees, in the style of the code trees of "Efficient E-Matching for SMT
+ * Solvers" by de Moura and Bjorner, and matches them against the ground terms
+ * of the term database.
+ *
+ * Each trigger is compiled into a sequence of instructions over registers
+ * holding ground terms, where register 0 holds the candidate term and
+ * registers 1...n its arguments. The instructions are:
+ * - BIND(r, s): bind variable slot s to the term in register r,
+ * - COMPARE(r, s): check that the term in register r is equal to the term
+ *   bound to slot s,
+ * - CHECK(r, t): check that the term in register r is equal to ground term t,
+ * - MATCH(r, f, b): for each term f(t1, ..., tk) in the equivalence class of
+ *   the term in register r, load t1, ..., tk into registers b, ..., b+k-1.
+ * Variables are numbered by their first occurrence in the trigger, and the
+ * instructions are emitted in a fixed order (the checks of the arguments of
+ * an application before its nested applications). Hence, triggers that agree
+ * up to the renaming of their variables, e.g. f(g(x), a) for many quantified
+ * formulas, have identical instructions, and triggers with the same top
+ * symbol and a common prefix share the nodes of that prefix in the tree.
+ *
+ * The tree of a top symbol f is run once per instantiation round over the
+ * ground terms of f, and produces the matches of all its triggers in that
+ * pass, which are buffered until the match generator of each trigger asks for
+ * them (see InstMatchGeneratorCodeTree).
+ *
+ * If --ematch-code-tree-inc is enabled, a trigger is only matched against
+ * the ground terms that were added to the term database since its last pass
+ * in the current SAT context. This misses instances that are only due to new
+ * equalities between the subterms of old terms.
+ *
+ * If --ematch-threads=N is greater than one, the first request for matches
+ * in a round runs the passes of all trees in N threads. The passes only read
+ * the term database and the equality engine, whose term indices are computed
+ * beforehand, and each writes the matches of its own triggers. Since the
+ * matches of a trigger are buffered in the order of the ground terms, they do
+ * not depend on the scheduling of the passes, and are sent as instantiations
+ * in the same order as in a sequential run. This cannot be combined with
+ * --ematch-code-tree-inc, since the passes of triggers whose matches are not
+ * taken in the round would skip their terms in later rounds.
+ */
+class CodeTree : public QuantifiersUtil
+{
+ public:
+  CodeTree(quantifiers::QuantifiersState& qs, quantifiers::TermDb* tdb);
+  ~CodeTree();
+  /** Reset, which starts a new round */
+  bool reset(Theory::Effort e) override;
+  /** Register quantifier, does nothing */
+  void registerQuantifier(Node q) override {}
+  /** Identify this module */
+  std::string identify() const override { return "CodeTree"; }
+  /**
+   * Can single trigger pat of quantified formula q be compiled? This is the
+   * case if pat is an application whose nested subterms are applications,
+   * ground terms or variables of q, and that contains all variables of q.
+   * Triggers with kinds that require special candidate generators, e.g.
+   * selectors, constructors and higher-order applications, are not compiled.
+   */
+  static bool isCompilable(Node q, Node pat);
+  /** Register compilable trigger pat of quantified formula q, returns its id */
+  size_t registerPattern(Node q, Node pat);
+  /** Unregister the trigger with the given id */
+  void unregisterPattern(size_t id);
+  /**
+   * Get the matches of the trigger with the given id in this round. Each
+   * match is the vector of terms for the variables of its quantified formula.
+   * The caller takes the matches out of the returned vector, the trigger has
+   * no more matches until the next round.
+   */
+  std::vector<std::vector<Node>>& getMatches(size_t id);
+  /** Get the match operator of the trigger with the given id */
+  Node getOperator(size_t id) const;
+
+ private:
+  /** The kinds of instructions */
+  enum class InstrKind
+  {
+    BIND,
+    COMPARE,
+    CHECK,
+    MATCH
+  };
+  /** An instruction */
+  struct Instr
+  {
+    InstrKind d_kind;
+    /** The register read by the instruction */
+    size_t d_reg;
+    /**
+     * The variable slot for BIND and COMPARE, the first register loaded by
+     * MATCH
+     */
+    size_t d_arg;
+    /** The ground term for CHECK, the match operator for MATCH */
+    Node d_node;
+    /** The number of arguments for MATCH */
+    size_t d_arity;
+    bool operator==(const Instr& i) const;
+  };
+  /** A node of a code tree */
+  struct CodeNode
+  {
+    /** The instruction to execute when reaching this node */
+    Instr d_instr;
+    /** The continuations of the code */
+    std::vector<std::unique_ptr<CodeNode>> d_children;
+    /** The ids of the triggers whose code ends at this node */
+    std::vector<size_t> d_yields;
+  };
+  /** The code tree for a match operator */
+  struct Root
+  {
+    Root() : d_numRegs(0), d_numSlots(0) {}
+    /** The node below which the codes of the triggers start */
+    CodeNode d_node;
+    /** The number of registers needed by the codes of the tree */
+    size_t d_numRegs;
+    /** The number of variable slots needed by the codes of the tree */
+    size_t d_numSlots;
+    /** The ids of the triggers of this tree */
+    std::vector<size_t> d_patterns;
+    /** The match operators of the MATCH instructions of this tree */
+    std::vector<Node> d_matchOps;
+    /**
+     * The term indices per equivalence class of each operator in d_matchOps
+     * for the current pass, which are computed before the pass
+     */
+    std::map<Node, TNodeTrie*> d_eqcTries;
+  };
+  /** The state of a pass over the ground terms of a match operator */
+  struct Pass
+  {
+    Pass(bool shared)
+        : d_shared(shared),
+          d_root(nullptr),
+          d_termIndex(0),
+          d_instructions(0),
+          d_matchesAttempted(0),
+          d_matchesProduced(0)
+    {
+    }
+    /** Whether the pass runs in parallel with other passes */
+    bool d_shared;
+    /** The tree of the pass */
+    Root* d_root;
+    /** The registers */
+    std::vector<TNode> d_regs;
+    /** The variable slots */
+    std::vector<TNode> d_slots;
+    /** The index of the current candidate among the ground terms */
+    size_t d_termIndex;
+    /** Counters for the statistics below */
+    int64_t d_instructions;
+    int64_t d_matchesAttempted;
+    int64_t d_matchesProduced;
+  };
+  /** A registered trigger */
+  struct Pattern
+  {
+    Pattern(context::Context* c)
+        : d_leaf(nullptr),
+          d_round(std::numeric_limits<uint64_t>::max()),
+          d_collect(false),
+          d_numMatched(c, 0)
+    {
+    }
+    /** The quantified formula */
+    Node d_quant;
+    /** The match operator */
+    Node d_op;
+    /** The node at which its code ends */
+    CodeNode* d_leaf;
+    /** The variable number in d_quant of each variable slot */
+    std::vector<size_t> d_varNum;
+    /** The round of the last pass for this trigger */
+    uint64_t d_round;
+    /** Whether the current pass collects the matches of this trigger */
+    bool d_collect;
+    /**
+     * The number of ground terms of d_op matched in earlier passes, which is
+     * used if --ematch-code-tree-inc is enabled
+     */
+    context::CDO<size_t> d_numMatched;
+    /** The matches of the last pass that have not been taken */
+    std::vector<std::vector<Node>> d_matches;
+  };
+  /** Compile the arguments of t, whose first argument is in register base */
+  void compileArgs(Node t,
+                   size_t base,
+                   std::vector<Instr>& code,
+                   std::map<Node, size_t>& slots,
+                   std::vector<size_t>& varNum,
+                   size_t& numRegs);
+  /** Run the tree of op over its ground terms for triggers not yet run */
+  void run(Node op, Root& r);
+  /** Run the trees of all operators with triggers not yet run in parallel */
+  void runParallel();
+  /**
+   * Prepare the pass of the tree r of op for the triggers not yet run, which
+   * returns the index of the first ground term of op to match.
+   */
+  size_t preparePass(Node op, Root& r);
+  /** Match the ground terms of op from start against its tree */
+  void executePass(Node op, size_t start, Pass& pass);
+  /** Finish the pass of the tree r of op, which matched nterms terms */
+  void finishPass(Root& r, size_t nterms, const Pass& pass);
+  /** Execute the continuations of n */
+  void execute(CodeNode& n, Pass& pass);
+  /** Execute MATCH instruction n */
+  void executeMatch(CodeNode& n, Pass& pass);
+  /** Execute MATCH instruction n for candidate term c */
+  void executeMatchCandidate(CodeNode& n, Node c, Pass& pass);
+  /**
+   * Is n a legal candidate for matching, with match operator op if op is
+   * not null?
+   */
+  bool isLegalCandidate(Node n, Node op, Pass& pass);
+
+  /** Reference to the quantifiers state */
+  quantifiers::QuantifiersState& d_qstate;
+  /** Pointer to the term database */
+  quantifiers::TermDb* d_tdb;
+  /** The code trees for each match operator */
+  std::map<Node, Root> d_roots;
+  /** The registered triggers, null if unregistered */
+  std::vector<std::unique_ptr<Pattern>> d_patterns;
+  /** Whether only new ground terms are matched */
+  bool d_incremental;
+  /** The number of threads for the passes of a round */
+  size_t d_numThreads;
+  /** Whether terms with instantiation constants are excluded (for cegqi) */
+  bool d_cegqi;
+  /** The current round */
+  uint64_t d_round;
+  /**
+   * Protects the term database and the attributes cached by the legality
+   * checks of candidates from parallel passes
+   */
+  std::mutex d_tdbMutex;
+
+  /** Statistics */
+  struct Statistics
+  {
+    /** Number of compiled triggers */
+    IntStat d_patterns;
+    /** Number of nodes in the code trees */
+    IntStat d_nodes;
+    /** Number of passes over the ground terms of a match operator */
+    IntStat d_passes;
+    /** Number of executed instructions */
+    IntStat d_instructions;
+    /** Number of terms matched against a code tree or its subtrees */
+    IntStat d_matchesAttempted;
+    /** Number of matches produced */
+    IntStat d_matchesProduced;
+    /** Number of rounds whose passes were run in parallel */
+    IntStat d_parallelRounds;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+}; /* class CodeTree */
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__QUANTIFIERS__CODE_TREE_H */
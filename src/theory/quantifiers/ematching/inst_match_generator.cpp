@@ -523,6 +523,7 @@ int InstMatchGenerator::getNextMatch(Node f,
       if( d_curr_exclude_match.find( t )==d_curr_exclude_match.end() ){
         Assert(t.getType().isComparableTo(d_match_pattern_type));
         Trace("matching-summary") << "Try " << d_match_pattern << " : " << t << std::endl;
+        ++(qe->d_statistics.d_matches_attempted);
         success = getMatch(f, t, m, qe, tparent);
         if( d_independent_gen && success<0 ){
           Assert(d_eq_class.isNull() || !d_eq_class_rel.isNull());
@@ -558,6 +559,7 @@ uint64_t InstMatchGenerator::addInstantiations(Node f,
   InstMatch m( f );
   while (getNextMatch(f, m, qe, tparent) > 0)
   {
+    ++(qe->d_statistics.d_matches_produced);
     if( !d_active_add ){
       if (sendInstantiation(tparent, m))
       {
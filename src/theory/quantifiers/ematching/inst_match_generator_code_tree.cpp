@@ -0,0 +1,74 @@
+/*********************                                                        */
+/*! \file inst_match_generator_code_tree.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief inst match generator class for triggers compiled in a code tree
+ **/
+#include "theory/quantifiers/ematching/inst_match_generator_code_tree.h"
+
+#include "theory/quantifiers/ematching/code_tree.h"
+#include "theory/quantifiers/quantifiers_state.h"
+#include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers_engine.h"
+
+namespace CVC4 {
+namespace theory {
+namespace inst {
+
+InstMatchGeneratorCodeTree::InstMatchGeneratorCodeTree(
+    Node q,
+    Node pat,
+    quantifiers::QuantifiersState& qs,
+    quantifiers::QuantifiersInferenceManager& qim,
+    QuantifiersEngine* qe)
+    : IMGenerator(qs, qim), d_codeTree(qe->getCodeTree())
+{
+  Assert(d_codeTree != nullptr);
+  d_id = d_codeTree->registerPattern(q, pat);
+}
+
+InstMatchGeneratorCodeTree::~InstMatchGeneratorCodeTree()
+{
+  d_codeTree->unregisterPattern(d_id);
+}
+
+uint64_t InstMatchGeneratorCodeTree::addInstantiations(Node q,
+                                                       QuantifiersEngine* qe,
+                                                       Trigger* tparent)
+{
+  uint64_t addedLemmas = 0;
+  std::vector<std::vector<Node>>& matches = d_codeTree->getMatches(d_id);
+  InstMatch m(q);
+  for (std::vector<Node>& terms : matches)
+  {
+    if (d_qstate.isInConflict())
+    {
+      break;
+    }
+    m.d_vals.swap(terms);
+    if (sendInstantiation(tparent, m))
+    {
+      addedLemmas++;
+    }
+  }
+  matches.clear();
+  return addedLemmas;
+}
+
+int InstMatchGeneratorCodeTree::getActiveScore(QuantifiersEngine* qe)
+{
+  Node f = d_codeTree->getOperator(d_id);
+  size_t ngt = qe->getTermDatabase()->getNumGroundTerms(f);
+  Trace("trigger-active-sel-debug") << "Number of ground terms for (code tree) "
+                                    << f << " is " << ngt << std::endl;
+  return static_cast<int>(ngt);
+}
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
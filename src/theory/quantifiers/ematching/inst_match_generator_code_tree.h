@@ -0,0 +1,61 @@
+/*********************                                                        */
+/*! \file inst_match_generator_code_tree.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief inst match generator class for triggers compiled in a code tree
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__QUANTIFIERS__INST_MATCH_GENERATOR_CODE_TREE_H
+#define CVC4__THEORY__QUANTIFIERS__INST_MATCH_GENERATOR_CODE_TREE_H
+
+#include "theory/quantifiers/ematching/inst_match_generator.h"
+
+namespace CVC4 {
+namespace theory {
+namespace inst {
+
+class CodeTree;
+
+/** InstMatchGeneratorCodeTree class
+ *
+ * This is the generator class for single triggers if --ematch-engine=code-tree
+ * is enabled and the trigger can be compiled (see CodeTree::isCompilable).
+ * The trigger is registered in the code tree of the quantifiers engine, which
+ * matches the triggers with the same top symbol in one pass, and this class
+ * sends the matches of its trigger to the parent trigger.
+ */
+class InstMatchGeneratorCodeTree : public IMGenerator
+{
+ public:
+  InstMatchGeneratorCodeTree(Node q,
+                             Node pat,
+                             quantifiers::QuantifiersState& qs,
+                             quantifiers::QuantifiersInferenceManager& qim,
+                             QuantifiersEngine* qe);
+  ~InstMatchGeneratorCodeTree();
+  /** Add instantiations. */
+  uint64_t addInstantiations(Node q,
+                             QuantifiersEngine* qe,
+                             Trigger* tparent) override;
+  /** Get active score. */
+  int getActiveScore(QuantifiersEngine* qe) override;
+
+ private:
+  /** The code tree of the quantifiers engine */
+  CodeTree* d_codeTree;
+  /** The id of the trigger in d_codeTree */
+  size_t d_id;
+};
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
+
+#endif
@@ -133,6 +133,8 @@ void InstMatchGeneratorSimple::addInstantiations(InstMatch& m,
   if (argIndex == d_match_pattern.getNumChildren())
   {
     Assert(!tat->d_data.empty());
+    ++(qe->d_statistics.d_matches_attempted);
+    ++(qe->d_statistics.d_matches_produced);
     TNode t = tat->getData();
     Debug("simple-trigger") << "Actual term is " << t << std::endl;
     // convert to actual used terms
@@ -16,8 +16,10 @@
 
 #include "expr/skolem_manager.h"
 #include "theory/quantifiers/ematching/candidate_generator.h"
+#include "theory/quantifiers/ematching/code_tree.h"
 #include "theory/quantifiers/ematching/ho_trigger.h"
 #include "theory/quantifiers/ematching/inst_match_generator.h"
+#include "theory/quantifiers/ematching/inst_match_generator_code_tree.h"
 #include "theory/quantifiers/ematching/inst_match_generator_multi.h"
 #include "theory/quantifiers/ematching/inst_match_generator_multi_linear.h"
 #include "theory/quantifiers/ematching/inst_match_generator_simple.h"
@@ -64,7 +66,12 @@ Trigger::Trigger(QuantifiersEngine* qe,
     }
   }
   if( d_nodes.size()==1 ){
-    if (TriggerTermInfo::isSimpleTrigger(d_nodes[0]))
+    if (qe->getCodeTree() != nullptr && CodeTree::isCompilable(q, d_nodes[0]))
+    {
+      d_mg = new InstMatchGeneratorCodeTree(q, d_nodes[0], qs, qim, qe);
+      ++(qe->d_statistics.d_triggers);
+    }
+    else if (TriggerTermInfo::isSimpleTrigger(d_nodes[0]))
     {
       d_mg = new InstMatchGeneratorSimple(q, d_nodes[0], qs, qim, qe);
       ++(qe->d_statistics.d_triggers);
@@ -135,6 +142,9 @@ uint64_t Trigger::addInstantiations()
       }
     }
   }
+  // attribute the instantiations to this trigger when profiling
+  quantifiers::InstProfiler::TriggerScope ips(
+      d_quantEngine->getInstantiate()->getProfiler(), d_quant, d_nodes);
   uint64_t addedLemmas = d_mg->addInstantiations(d_quant, d_quantEngine, this);
   if (Debug.isOn("inst-trigger"))
   {
@@ -76,31 +76,32 @@ void ExprMiner::initializeChecker(std::unique_ptr<SmtEngine>& checker,
   Assert (!query.isNull());
   initializeSubsolver(checker);
   // also set the options
-  checker->setOption("sygus-rr-synth-input", "false");
-  checker->setOption("input-language", "smt2");
+  for (const std::pair<const std::string, std::string>& o :
+       getCheckerOptions())
+  {
+    checker->setOption(o.first, o.second);
+  }
   // Convert bound variables to skolems. This ensures the satisfiability
   // check is ground.
   Node squery = convertToSkolem(query);
   checker->assertFormula(squery);
 }
 
+std::map<std::string, std::string> ExprMiner::getCheckerOptions()
+{
+  std::map<std::string, std::string> opts;
+  opts["sygus-rr-synth-input"] = "false";
+  opts["input-language"] = "smt2";
+  return opts;
+}
+
 Result ExprMiner::doCheck(Node query)
 {
-  Node queryr = Rewriter::rewrite(query);
-  if (queryr.isConst())
-  {
-    if (!queryr.getConst<bool>())
-    {
-      return Result(Result::UNSAT);
-    }
-    else
-    {
-      return Result(Result::SAT);
-    }
-  }
-  std::unique_ptr<SmtEngine> smte;
-  initializeChecker(smte, query);
-  return smte->checkSat();
+  // as in initializeChecker, convert bound variables to skolems
+  Node squery = convertToSkolem(query);
+  std::vector<Node> vars;
+  std::vector<Node> modelVals;
+  return checkWithSubsolver(squery, vars, modelVals, getCheckerOptions());
 }
 
 }  // namespace quantifiers
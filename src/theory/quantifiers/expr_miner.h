@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "expr/node.h"
@@ -71,6 +72,8 @@ class ExprMiner
   std::map<Node, Node> d_fv_to_skolem;
   /** convert */
   Node convertToSkolem(Node n);
+  /** Get the options of checkers, in addition to those of the SMT engine */
+  static std::map<std::string, std::string> getCheckerOptions();
   /** initialize checker
    *
    * This function initializes the smt engine smte to check the satisfiability
@@ -83,7 +86,8 @@ class ExprMiner
    * (sat/unsat/unknown).
    *
    * In contrast to the above method, this call should be used for cases where
-   * the model for the query is not important.
+   * the model for the query is not important. The check may reuse a
+   * subsolver of the pool of the current SMT engine.
    */
   Result doCheck(Node query);
 };
@@ -0,0 +1,402 @@
+/*********************                                                        */
+/*! \file inst_match_index.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of hashed index of the instantiations of a quantified
+ ** formula
+ **/
+
+#include "theory/quantifiers/inst_match_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "theory/quantifiers/quantifiers_state.h"
+#include "theory/uf/equality_engine_iterator.h"
+#include "util/hash.h"
+
+namespace CVC4 {
+namespace theory {
+namespace inst {
+
+const uint32_t InstMatchIndex::NONE = std::numeric_limits<uint32_t>::max();
+const uint32_t InstMatchIndex::EMPTY = std::numeric_limits<uint32_t>::max();
+const uint32_t InstMatchIndex::TOMBSTONE =
+    std::numeric_limits<uint32_t>::max() - 1;
+
+InstMatchIndex::InstMatchIndex(size_t arity)
+    : d_arity(arity), d_numUsed(0), d_numLive(0), d_hasFirstIndex(false)
+{
+  Assert(arity > 0);
+}
+
+bool InstMatchIndex::existsInstMatch(quantifiers::QuantifiersState& qs,
+                                     const std::vector<Node>& m,
+                                     bool modEq)
+{
+  Assert(m.size() == d_arity);
+  if (findSlot(m, hash(m)) != NONE)
+  {
+    return true;
+  }
+  return modEq && existsModEq(qs, m);
+}
+
+bool InstMatchIndex::addInstMatch(quantifiers::QuantifiersState& qs,
+                                  const std::vector<Node>& m,
+                                  bool modEq)
+{
+  Assert(m.size() == d_arity);
+  uint64_t h = hash(m);
+  if (findSlot(m, h) != NONE || (modEq && existsModEq(qs, m)))
+  {
+    return false;
+  }
+  Assert(d_entries.size() < TOMBSTONE);
+  uint32_t i = static_cast<uint32_t>(d_entries.size());
+  d_terms.insert(d_terms.end(), m.begin(), m.end());
+  Entry e;
+  e.d_hash = h;
+  e.d_nextFirst = NONE;
+  e.d_removed = false;
+  if (d_hasFirstIndex)
+  {
+    uint32_t& head =
+        d_firstIndex.insert(std::pair<Node, uint32_t>(m[0], NONE))
+            .first->second;
+    e.d_nextFirst = head;
+    head = i;
+  }
+  d_entries.push_back(e);
+  d_numLive++;
+  insertSlot(i);
+  return true;
+}
+
+bool InstMatchIndex::removeInstMatch(const std::vector<Node>& m)
+{
+  Assert(m.size() == d_arity);
+  uint32_t slot = findSlot(m, hash(m));
+  if (slot == NONE)
+  {
+    return false;
+  }
+  removeEntry(d_table[slot]);
+  return true;
+}
+
+void InstMatchIndex::getInstantiations(
+    std::vector<std::vector<Node>>& insts) const
+{
+  size_t start = insts.size();
+  for (size_t i = 0, nentries = d_entries.size(); i < nentries; i++)
+  {
+    if (!d_entries[i].d_removed)
+    {
+      std::vector<Node>::const_iterator it = d_terms.begin() + i * d_arity;
+      insts.push_back(std::vector<Node>(it, it + d_arity));
+    }
+  }
+  // same order as the instantiations of InstMatchTrie
+  std::sort(insts.begin() + start, insts.end());
+}
+
+size_t InstMatchIndex::getMemoryUsage() const
+{
+  // the nodes of the hash map of first terms are approximated by an entry and
+  // a pointer
+  return d_terms.capacity() * sizeof(Node)
+         + d_entries.capacity() * sizeof(Entry)
+         + d_table.capacity() * sizeof(uint32_t)
+         + d_firstIndex.bucket_count() * sizeof(void*)
+         + d_firstIndex.size()
+               * (sizeof(std::pair<const Node, uint32_t>) + sizeof(void*));
+}
+
+void InstMatchIndex::print(std::ostream& out) const
+{
+  std::vector<std::vector<Node>> insts;
+  getInstantiations(insts);
+  for (const std::vector<Node>& terms : insts)
+  {
+    out << "  (";
+    for (size_t i = 0; i < d_arity; i++)
+    {
+      out << (i > 0 ? ", " : " ") << terms[i];
+    }
+    out << " )" << std::endl;
+  }
+}
+
+uint64_t InstMatchIndex::hash(const std::vector<Node>& m)
+{
+  uint64_t h = fnv1a::fnv1a_64(m.size());
+  for (const Node& n : m)
+  {
+    h = fnv1a::fnv1a_64(n.getId(), h);
+  }
+  // the table is indexed by the low bits, mix in the high bits
+  return h ^ (h >> 32);
+}
+
+bool InstMatchIndex::isEntry(uint32_t i, const std::vector<Node>& m) const
+{
+  return std::equal(
+      m.begin(), m.end(), d_terms.begin() + static_cast<size_t>(i) * d_arity);
+}
+
+uint32_t InstMatchIndex::findSlot(const std::vector<Node>& m, uint64_t h) const
+{
+  if (d_table.empty())
+  {
+    return NONE;
+  }
+  size_t mask = d_table.size() - 1;
+  for (size_t s = h & mask;; s = (s + 1) & mask)
+  {
+    uint32_t i = d_table[s];
+    if (i == EMPTY)
+    {
+      return NONE;
+    }
+    if (i != TOMBSTONE && d_entries[i].d_hash == h && isEntry(i, m))
+    {
+      return static_cast<uint32_t>(s);
+    }
+  }
+}
+
+uint32_t InstMatchIndex::findEntrySlot(uint32_t i) const
+{
+  size_t mask = d_table.size() - 1;
+  for (size_t s = d_entries[i].d_hash & mask;; s = (s + 1) & mask)
+  {
+    Assert(d_table[s] != EMPTY);
+    if (d_table[s] == i)
+    {
+      return static_cast<uint32_t>(s);
+    }
+  }
+}
+
+bool InstMatchIndex::existsModEq(quantifiers::QuantifiersState& qs,
+                                 const std::vector<Node>& m)
+{
+  if (!d_hasFirstIndex)
+  {
+    buildFirstIndex();
+  }
+  // the first terms to consider
+  std::vector<Node> firsts;
+  if (!m[0].isNull() && qs.hasTerm(m[0]))
+  {
+    eq::EqClassIterator eqc(qs.getRepresentative(m[0]),
+                            qs.getEqualityEngine());
+    while (!eqc.isFinished())
+    {
+      firsts.push_back(*eqc);
+      ++eqc;
+    }
+  }
+  else
+  {
+    firsts.push_back(m[0]);
+  }
+  for (const Node& f : firsts)
+  {
+    std::unordered_map<Node, uint32_t, NodeHashFunction>::const_iterator it =
+        d_firstIndex.find(f);
+    if (it == d_firstIndex.end())
+    {
+      continue;
+    }
+    for (uint32_t i = it->second; i != NONE; i = d_entries[i].d_nextFirst)
+    {
+      if (d_entries[i].d_removed)
+      {
+        continue;
+      }
+      const Node* terms = &d_terms[static_cast<size_t>(i) * d_arity];
+      bool eq = true;
+      for (size_t j = 1; j < d_arity && eq; j++)
+      {
+        eq = terms[j] == m[j]
+             || (!m[j].isNull() && !terms[j].isNull()
+                 && qs.areEqual(m[j], terms[j]));
+      }
+      if (eq)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void InstMatchIndex::buildFirstIndex()
+{
+  Assert(!d_hasFirstIndex);
+  d_hasFirstIndex = true;
+  for (size_t i = 0, nentries = d_entries.size(); i < nentries; i++)
+  {
+    uint32_t& head =
+        d_firstIndex.insert(std::pair<Node, uint32_t>(first(i), NONE))
+            .first->second;
+    d_entries[i].d_nextFirst = head;
+    head = static_cast<uint32_t>(i);
+  }
+}
+
+void InstMatchIndex::insertSlot(uint32_t i)
+{
+  // keep the load factor, including removed slots, at most 1/2
+  if (2 * (d_numUsed + 1) > d_table.size())
+  {
+    rehash(d_numLive);
+    // entry i is counted in d_numLive and was inserted by rehash if live
+    return;
+  }
+  size_t mask = d_table.size() - 1;
+  size_t s = d_entries[i].d_hash & mask;
+  while (d_table[s] != EMPTY && d_table[s] != TOMBSTONE)
+  {
+    s = (s + 1) & mask;
+  }
+  if (d_table[s] == EMPTY)
+  {
+    d_numUsed++;
+  }
+  d_table[s] = i;
+}
+
+void InstMatchIndex::rehash(size_t n)
+{
+  size_t size = 16;
+  while (size < 2 * n + 2)
+  {
+    size *= 2;
+  }
+  d_table.assign(size, EMPTY);
+  d_numUsed = 0;
+  size_t mask = size - 1;
+  for (size_t i = 0, nentries = d_entries.size(); i < nentries; i++)
+  {
+    if (d_entries[i].d_removed)
+    {
+      continue;
+    }
+    size_t s = d_entries[i].d_hash & mask;
+    while (d_table[s] != EMPTY)
+    {
+      s = (s + 1) & mask;
+    }
+    d_table[s] = static_cast<uint32_t>(i);
+    d_numUsed++;
+  }
+}
+
+void InstMatchIndex::removeEntry(uint32_t i)
+{
+  Assert(!d_entries[i].d_removed);
+  d_table[findEntrySlot(i)] = TOMBSTONE;
+  d_entries[i].d_removed = true;
+  d_numLive--;
+}
+
+void InstMatchIndex::restoreEntry(uint32_t i)
+{
+  Assert(d_entries[i].d_removed);
+  d_entries[i].d_removed = false;
+  d_numLive++;
+  insertSlot(i);
+}
+
+void InstMatchIndex::truncate(size_t n)
+{
+  for (size_t i = d_entries.size(); i > n; i--)
+  {
+    uint32_t ii = static_cast<uint32_t>(i - 1);
+    if (!d_entries[ii].d_removed)
+    {
+      removeEntry(ii);
+    }
+    if (d_hasFirstIndex)
+    {
+      // entries are popped in reverse order, hence ii is the last entry with
+      // its first term
+      std::unordered_map<Node, uint32_t, NodeHashFunction>::iterator it =
+          d_firstIndex.find(first(ii));
+      Assert(it != d_firstIndex.end() && it->second == ii);
+      if (d_entries[ii].d_nextFirst == NONE)
+      {
+        d_firstIndex.erase(it);
+      }
+      else
+      {
+        it->second = d_entries[ii].d_nextFirst;
+      }
+    }
+  }
+  d_terms.resize(n * d_arity);
+  d_entries.resize(n);
+}
+
+CDInstMatchIndex::CDInstMatchIndex(context::Context* c, size_t arity)
+    : InstMatchIndex(arity),
+      context::ContextNotifyObj(c),
+      d_numEntries(c, 0),
+      d_numRemoved(c, 0)
+{
+}
+
+bool CDInstMatchIndex::addInstMatch(quantifiers::QuantifiersState& qs,
+                                    const std::vector<Node>& m,
+                                    bool modEq)
+{
+  if (!InstMatchIndex::addInstMatch(qs, m, modEq))
+  {
+    return false;
+  }
+  d_numEntries = d_entries.size();
+  return true;
+}
+
+bool CDInstMatchIndex::removeInstMatch(const std::vector<Node>& m)
+{
+  uint32_t slot = findSlot(m, hash(m));
+  if (slot == NONE)
+  {
+    return false;
+  }
+  d_removedStack.push_back(d_table[slot]);
+  d_numRemoved = d_removedStack.size();
+  removeEntry(d_table[slot]);
+  return true;
+}
+
+void CDInstMatchIndex::contextNotifyPop()
+{
+  // undo the removals of the popped contexts, unless the entry is popped too
+  size_t nentries = d_numEntries.get();
+  for (size_t i = d_removedStack.size(), nrem = d_numRemoved.get(); i > nrem;
+       i--)
+  {
+    uint32_t e = d_removedStack[i - 1];
+    if (e < nentries)
+    {
+      restoreEntry(e);
+    }
+  }
+  d_removedStack.resize(d_numRemoved.get());
+  // undo the additions of the popped contexts
+  truncate(nentries);
+}
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
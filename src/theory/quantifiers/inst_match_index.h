@@ -0,0 +1,177 @@
+/*********************                                                        */
+/*! \file inst_match_index.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief hashed index of the instantiations of a quantified formula
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__QUANTIFIERS__INST_MATCH_INDEX_H
+#define CVC4__THEORY__QUANTIFIERS__INST_MATCH_INDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "context/cdo.h"
+#include "context/context.h"
+#include "expr/node.h"
+
+namespace CVC4 {
+namespace theory {
+
+namespace quantifiers {
+class QuantifiersState;
+}
+
+namespace inst {
+
+/** InstMatchIndex class
+ *
+ * This class stores the instantiations of a quantified formula q, i.e. term
+ * vectors whose length is the number of variables of q. It is a replacement
+ * for InstMatchTrie that does not allocate per term: the term vectors are
+ * stored contiguously in an arena, and are found by the hash of the whole
+ * vector in an open addressing table, where collisions are resolved by
+ * comparing the terms.
+ *
+ * Duplication modulo equality is checked on the entries whose first term is
+ * in the equivalence class of the first term of the vector. These entries are
+ * linked in a chain per first term, which is only built once the first check
+ * modulo equality is done.
+ */
+class InstMatchIndex
+{
+ public:
+  InstMatchIndex(size_t arity);
+  virtual ~InstMatchIndex() {}
+  /**
+   * Does m exist in this index? If modEq is true, we check for duplication
+   * modulo the current equalities in the equality engine of qs.
+   */
+  bool existsInstMatch(quantifiers::QuantifiersState& qs,
+                       const std::vector<Node>& m,
+                       bool modEq = false);
+  /**
+   * Add m to this index, returns true if and only if m did not already exist
+   * in this index (modulo equality if modEq is true).
+   */
+  virtual bool addInstMatch(quantifiers::QuantifiersState& qs,
+                            const std::vector<Node>& m,
+                            bool modEq = false);
+  /** Remove m from this index, returns true if m was in this index */
+  virtual bool removeInstMatch(const std::vector<Node>& m);
+  /**
+   * Get the instantiations of this index, in the lexicographic order of their
+   * terms.
+   */
+  void getInstantiations(std::vector<std::vector<Node>>& insts) const;
+  /** Get the number of instantiations in this index */
+  size_t size() const { return d_numLive; }
+  /** Get the number of bytes allocated by this index */
+  size_t getMemoryUsage() const;
+  /** print this class */
+  void print(std::ostream& out) const;
+
+ protected:
+  /** An entry of the index */
+  struct Entry
+  {
+    /** The hash of its terms */
+    uint64_t d_hash;
+    /** The previous entry with the same first term, or NONE */
+    uint32_t d_nextFirst;
+    /** Whether the entry was removed */
+    bool d_removed;
+  };
+  /** Marker for no entry */
+  static const uint32_t NONE;
+  /** Marker for an empty slot of the table */
+  static const uint32_t EMPTY;
+  /** Marker for a slot of the table whose entry was removed */
+  static const uint32_t TOMBSTONE;
+  /** Get the hash of m */
+  static uint64_t hash(const std::vector<Node>& m);
+  /** Get the first term of entry i */
+  const Node& first(uint32_t i) const { return d_terms[i * d_arity]; }
+  /** Does entry i have terms m? */
+  bool isEntry(uint32_t i, const std::vector<Node>& m) const;
+  /** Get the slot of the live entry with terms m and hash h, or NONE */
+  uint32_t findSlot(const std::vector<Node>& m, uint64_t h) const;
+  /** Get the slot of entry i */
+  uint32_t findEntrySlot(uint32_t i) const;
+  /** Does an entry equal to m modulo the equalities of qs exist? */
+  bool existsModEq(quantifiers::QuantifiersState& qs,
+                   const std::vector<Node>& m);
+  /** Build the chains of entries per first term */
+  void buildFirstIndex();
+  /** Insert entry i into the table, whose slots are known to be free */
+  void insertSlot(uint32_t i);
+  /** Resize the table to hold at least n entries */
+  void rehash(size_t n);
+  /** Mark entry i as removed */
+  void removeEntry(uint32_t i);
+  /** Reinsert removed entry i */
+  void restoreEntry(uint32_t i);
+  /** Remove all entries with index at least n */
+  void truncate(size_t n);
+
+  /** The number of terms of each entry */
+  size_t d_arity;
+  /** The terms of the entries, d_arity terms per entry */
+  std::vector<Node> d_terms;
+  /** The entries */
+  std::vector<Entry> d_entries;
+  /** The hash table of entry indices, whose size is a power of two */
+  std::vector<uint32_t> d_table;
+  /** The number of slots of d_table that are not empty */
+  size_t d_numUsed;
+  /** The number of entries that were not removed */
+  size_t d_numLive;
+  /** Whether d_firstIndex is built */
+  bool d_hasFirstIndex;
+  /** The last entry with each first term */
+  std::unordered_map<Node, uint32_t, NodeHashFunction> d_firstIndex;
+};
+
+/** CDInstMatchIndex class
+ *
+ * A context-dependent version of InstMatchIndex. The entries added and
+ * removed in a context are undone all at once when the context is popped.
+ */
+class CDInstMatchIndex : public InstMatchIndex, public context::ContextNotifyObj
+{
+ public:
+  CDInstMatchIndex(context::Context* c, size_t arity);
+  ~CDInstMatchIndex() {}
+  /** Add m, as in InstMatchIndex::addInstMatch */
+  bool addInstMatch(quantifiers::QuantifiersState& qs,
+                    const std::vector<Node>& m,
+                    bool modEq = false) override;
+  /** Remove m, as in InstMatchIndex::removeInstMatch */
+  bool removeInstMatch(const std::vector<Node>& m) override;
+
+ protected:
+  /** Undo the additions and removals of the popped contexts */
+  void contextNotifyPop() override;
+
+ private:
+  /** The number of entries in the current context */
+  context::CDO<size_t> d_numEntries;
+  /** The removed entries, in the order of their removal */
+  std::vector<uint32_t> d_removedStack;
+  /** The size of d_removedStack in the current context */
+  context::CDO<size_t> d_numRemoved;
+};
+
+}  // namespace inst
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__QUANTIFIERS__INST_MATCH_INDEX_H */
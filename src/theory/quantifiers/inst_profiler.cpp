@@ -0,0 +1,166 @@
+/*********************                                                        */
+/*! \file inst_profiler.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the profiler of the instantiations per quantified
+ ** formula and trigger
+ **/
+
+#include "theory/quantifiers/inst_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "theory/quantifiers/quantifiers_registry.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace quantifiers {
+
+InstProfiler::InstProfiler(QuantifiersRegistry& qr)
+    : d_qreg(qr), d_current(nullptr)
+{
+}
+
+void InstProfiler::Counts::add(const Counts& c)
+{
+  d_attempts += c.d_attempts;
+  d_instantiations += c.d_instantiations;
+  d_duplicates += c.d_duplicates;
+  d_conflicts += c.d_conflicts;
+  d_time += c.d_time;
+}
+
+void InstProfiler::Counts::toStreamJSON(std::ostream& out) const
+{
+  out << "\"attempts\": " << d_attempts
+      << ", \"instantiations\": " << d_instantiations
+      << ", \"duplicates\": " << d_duplicates
+      << ", \"conflicts\": " << d_conflicts << ", \"time\": " << std::fixed
+      << std::setprecision(6)
+      << std::chrono::duration<double>(d_time).count();
+}
+
+InstProfiler::TriggerScope::TriggerScope(InstProfiler* ip,
+                                         Node q,
+                                         const std::vector<Node>& nodes)
+    : d_profiler(ip), d_counts(nullptr), d_prev(nullptr)
+{
+  if (d_profiler == nullptr)
+  {
+    return;
+  }
+  Node pat = NodeManager::currentNM()->mkNode(kind::INST_PATTERN, nodes);
+  d_counts = &d_profiler->d_quants[q].d_triggers[pat];
+  d_prevQuant = d_profiler->d_currentQuant;
+  d_prev = d_profiler->d_current;
+  d_profiler->d_currentQuant = q;
+  d_profiler->d_current = d_counts;
+  d_start = std::chrono::steady_clock::now();
+}
+
+InstProfiler::TriggerScope::~TriggerScope()
+{
+  if (d_profiler == nullptr)
+  {
+    return;
+  }
+  d_counts->d_time += std::chrono::steady_clock::now() - d_start;
+  d_profiler->d_currentQuant = d_prevQuant;
+  d_profiler->d_current = d_prev;
+}
+
+InstProfiler::Counts& InstProfiler::getCounts(Node q, bool& timed)
+{
+  if (d_current != nullptr && d_currentQuant == q)
+  {
+    // the time is taken by the scope of the trigger
+    timed = false;
+    return *d_current;
+  }
+  timed = true;
+  return d_quants[q].d_other;
+}
+
+void InstProfiler::toStreamJSON(std::ostream& out) const
+{
+  // the totals of each quantified formula
+  std::vector<std::pair<Counts, Node>> totals;
+  for (const std::pair<const Node, QuantCounts>& qc : d_quants)
+  {
+    Counts total = qc.second.d_other;
+    for (const std::pair<const Node, Counts>& tc : qc.second.d_triggers)
+    {
+      total.add(tc.second);
+    }
+    totals.emplace_back(total, qc.first);
+  }
+  // the quantified formulas with the most instantiations first
+  std::stable_sort(totals.begin(),
+                   totals.end(),
+                   [](const std::pair<Counts, Node>& a,
+                      const std::pair<Counts, Node>& b) {
+                     return a.first.d_instantiations
+                            > b.first.d_instantiations;
+                   });
+  out << "{\"quantifiers\": [";
+  for (size_t i = 0, nquants = totals.size(); i < nquants; i++)
+  {
+    Node q = totals[i].second;
+    const QuantCounts& qc = d_quants.find(q)->second;
+    out << (i > 0 ? "," : "") << std::endl << "  {";
+    Node name;
+    if (d_qreg.getNameForQuant(q, name, true))
+    {
+      out << "\"name\": ";
+      std::stringstream ss;
+      ss << name;
+      stringToJSON(out, ss.str());
+      out << ", ";
+    }
+    out << "\"formula\": ";
+    std::stringstream ssq;
+    ssq << q;
+    stringToJSON(out, ssq.str());
+    out << ", ";
+    totals[i].first.toStreamJSON(out);
+    out << ", \"triggers\": [";
+    bool firstTrigger = true;
+    for (const std::pair<const Node, Counts>& tc : qc.d_triggers)
+    {
+      out << (firstTrigger ? "" : ",") << std::endl << "    {\"trigger\": ";
+      firstTrigger = false;
+      // print the terms of the trigger with the variables of q
+      Node pat = d_qreg.substituteInstConstantsToBoundVariables(tc.first, q);
+      std::stringstream ss;
+      for (size_t j = 0, nterms = pat.getNumChildren(); j < nterms; j++)
+      {
+        ss << (j > 0 ? " " : "") << pat[j];
+      }
+      stringToJSON(out, ss.str());
+      out << ", ";
+      tc.second.toStreamJSON(out);
+      out << "}";
+    }
+    out << "]";
+    if (qc.d_other.d_attempts > 0)
+    {
+      out << "," << std::endl << "   \"other\": {";
+      qc.d_other.toStreamJSON(out);
+      out << "}";
+    }
+    out << "}";
+  }
+  out << std::endl << "]}" << std::endl;
+}
+
+}  // namespace quantifiers
+}  // namespace theory
+}  // namespace CVC4
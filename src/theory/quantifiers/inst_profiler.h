@@ -0,0 +1,143 @@
+/*********************                                                        */
+/*! \file inst_profiler.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Profiler of the instantiations per quantified formula and trigger
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__QUANTIFIERS__INST_PROFILER_H
+#define CVC4__THEORY__QUANTIFIERS__INST_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+#include "expr/node.h"
+
+namespace CVC4 {
+namespace theory {
+namespace quantifiers {
+
+class QuantifiersRegistry;
+
+/** InstProfiler class
+ *
+ * This class records the cost of the instantiations of each quantified
+ * formula, attributed to the trigger that produced them, and prints it as a
+ * JSON object (see --inst-profile). For each quantified formula and trigger,
+ * it counts:
+ * - the matches sent to Instantiate::addInstantiation,
+ * - the instantiations that were added,
+ * - the matches that were rejected as duplicates, i.e. whose term vector, or
+ *   lemma, already exists, or whose body is already entailed,
+ * - the conflicting instantiations, i.e. those whose body is entailed to be
+ *   false by the current equalities, which hence cause a conflict as soon as
+ *   they are added,
+ * - the time spent generating and adding the instantiations.
+ * Instantiations that are not produced by a trigger, e.g. by enumerative or
+ * counterexample-guided instantiation, are attributed to the quantified
+ * formula only.
+ *
+ * The time is taken once per call to Trigger::addInstantiations, and once
+ * per instantiation that is not produced by a trigger, so that profiling is
+ * cheap enough to be enabled routinely. A quantified formula whose
+ * instantiations dominate the number of terms and whose triggers are rarely
+ * conflicting is a typical sign of a matching loop.
+ */
+class InstProfiler
+{
+ public:
+  InstProfiler(QuantifiersRegistry& qr);
+  /** The counts of a quantified formula or trigger */
+  struct Counts
+  {
+    Counts()
+        : d_attempts(0),
+          d_instantiations(0),
+          d_duplicates(0),
+          d_conflicts(0),
+          d_time(0)
+    {
+    }
+    /** Add the counts of c to this */
+    void add(const Counts& c);
+    /** Print this as the fields of a JSON object */
+    void toStreamJSON(std::ostream& out) const;
+    /** The number of matches sent to Instantiate::addInstantiation */
+    uint64_t d_attempts;
+    /** The number of instantiations that were added */
+    uint64_t d_instantiations;
+    /** The number of matches rejected as duplicates */
+    uint64_t d_duplicates;
+    /** The number of conflicting instantiations */
+    uint64_t d_conflicts;
+    /** The time spent */
+    std::chrono::steady_clock::duration d_time;
+  };
+  /**
+   * Attributes the instantiations of quantified formula q to the trigger
+   * with the given nodes for the lifetime of this object, and adds the time
+   * of its lifetime to that trigger. Does nothing if the profiler is null.
+   */
+  class TriggerScope
+  {
+   public:
+    TriggerScope(InstProfiler* ip, Node q, const std::vector<Node>& nodes);
+    ~TriggerScope();
+
+   private:
+    /** The profiler */
+    InstProfiler* d_profiler;
+    /** The counts of the trigger */
+    Counts* d_counts;
+    /** The previous quantified formula and counts attributed to */
+    Node d_prevQuant;
+    Counts* d_prev;
+    /** The start of the scope */
+    std::chrono::steady_clock::time_point d_start;
+  };
+  /**
+   * Get the counts to attribute the instantiations of q to, which are those
+   * of the current trigger of q if any, or of q otherwise. If timed is set to
+   * true, the caller should add the time of the instantiation to the counts.
+   */
+  Counts& getCounts(Node q, bool& timed);
+  /**
+   * Print the profile as a JSON object, where quantified formulas are sorted
+   * by their number of instantiations.
+   */
+  void toStreamJSON(std::ostream& out) const;
+
+ private:
+  /** The counts of a quantified formula */
+  struct QuantCounts
+  {
+    /** The counts of the instantiations not produced by a trigger */
+    Counts d_other;
+    /** The counts of each trigger, by its instantiation pattern */
+    std::map<Node, Counts> d_triggers;
+  };
+  /** Reference to the quantifiers registry */
+  QuantifiersRegistry& d_qreg;
+  /** The counts of each quantified formula */
+  std::map<Node, QuantCounts> d_quants;
+  /** The quantified formula of the current trigger, if any */
+  Node d_currentQuant;
+  /** The counts of the current trigger, if any */
+  Counts* d_current;
+};
+
+}  // namespace quantifiers
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__QUANTIFIERS__INST_PROFILER_H */
@@ -14,6 +14,8 @@
 
 #include "theory/quantifiers/instantiate.h"
 
+#include <fstream>
+
 #include "expr/node_algorithm.h"
 #include "expr/proof_node_manager.h"
 #include "options/printer_options.h"
@@ -42,7 +44,8 @@ Instantiate::Instantiate(QuantifiersEngine* qe,
                          QuantifiersInferenceManager& qim,
                          QuantifiersRegistry& qr,
                          ProofNodeManager* pnm)
-    : d_qe(qe),
+    : d_statistics(d_inst_match_index),
+      d_qe(qe),
       d_qstate(qs),
       d_qim(qim),
       d_qreg(qr),
@@ -50,19 +53,17 @@ Instantiate::Instantiate(QuantifiersEngine* qe,
       d_term_db(nullptr),
       d_total_inst_debug(qs.getUserContext()),
       d_c_inst_match_trie_dom(qs.getUserContext()),
-      d_pfInst(pnm ? new CDProof(pnm) : nullptr)
-{
-}
-
-Instantiate::~Instantiate()
+      d_pfInst(pnm ? new CDProof(pnm) : nullptr),
+      d_profileCounts(nullptr)
 {
-  for (std::pair<const Node, inst::CDInstMatchTrie*>& t : d_c_inst_match_trie)
+  if (!options::instProfile().empty())
   {
-    delete t.second;
+    d_profiler.reset(new InstProfiler(qr));
   }
-  d_c_inst_match_trie.clear();
 }
 
+Instantiate::~Instantiate() {}
+
 bool Instantiate::reset(Theory::Effort e)
 {
   if (!d_recorded_inst.empty())
@@ -99,6 +100,45 @@ void Instantiate::addRewriter(InstantiationRewriter* ir)
 
 bool Instantiate::addInstantiation(
     Node q, std::vector<Node>& terms, bool mkRep, bool modEq, bool doVts)
+{
+  if (d_profiler == nullptr)
+  {
+    return addInstantiationInternal(q, terms, mkRep, modEq, doVts);
+  }
+  bool timed;
+  InstProfiler::Counts& counts = d_profiler->getCounts(q, timed);
+  std::chrono::steady_clock::time_point start;
+  if (timed)
+  {
+    start = std::chrono::steady_clock::now();
+  }
+  counts.d_attempts++;
+  d_profileCounts = &counts;
+  bool ret = addInstantiationInternal(q, terms, mkRep, modEq, doVts);
+  d_profileCounts = nullptr;
+  if (ret)
+  {
+    counts.d_instantiations++;
+    // the instantiation is conflicting if its body is entailed to be false
+    std::map<TNode, TNode> subs;
+    for (size_t i = 0, size = terms.size(); i < size; i++)
+    {
+      subs[q[0][i]] = terms[i];
+    }
+    if (d_term_db->isEntailed(q[1], subs, false, false))
+    {
+      counts.d_conflicts++;
+    }
+  }
+  if (timed)
+  {
+    counts.d_time += std::chrono::steady_clock::now() - start;
+  }
+  return ret;
+}
+
+bool Instantiate::addInstantiationInternal(
+    Node q, std::vector<Node>& terms, bool mkRep, bool modEq, bool doVts)
 {
   // For resource-limiting (also does a time check).
   d_qim.safePoint(ResourceManager::Resource::QuantifierStep);
@@ -207,6 +247,7 @@ bool Instantiate::addInstantiation(
     {
       Trace("inst-add-debug") << " --> Currently entailed." << std::endl;
       ++(d_statistics.d_inst_duplicate_ent);
+      notifyDuplicate();
       return false;
     }
   }
@@ -229,6 +270,7 @@ bool Instantiate::addInstantiation(
   {
     Trace("inst-add-debug") << " --> Already exists (no record)." << std::endl;
     ++(d_statistics.d_inst_duplicate_eq);
+    notifyDuplicate();
     return false;
   }
 
@@ -327,6 +369,7 @@ bool Instantiate::addInstantiation(
   {
     Trace("inst-add-debug") << " --> Lemma already exists." << std::endl;
     ++(d_statistics.d_inst_duplicate);
+    notifyDuplicate();
     return false;
   }
 
@@ -380,6 +423,14 @@ bool Instantiate::addInstantiation(
   return true;
 }
 
+void Instantiate::notifyDuplicate()
+{
+  if (d_profileCounts != nullptr)
+  {
+    d_profileCounts->d_duplicates++;
+  }
+}
+
 bool Instantiate::addInstantiationExpFail(Node q,
                                           std::vector<Node>& terms,
                                           std::vector<bool>& failMask,
@@ -483,25 +534,8 @@ bool Instantiate::existsInstantiation(Node q,
                                       std::vector<Node>& terms,
                                       bool modEq)
 {
-  if (options::incrementalSolving())
-  {
-    std::map<Node, inst::CDInstMatchTrie*>::iterator it =
-        d_c_inst_match_trie.find(q);
-    if (it != d_c_inst_match_trie.end())
-    {
-      return it->second->existsInstMatch(d_qstate, q, terms, modEq);
-    }
-  }
-  else
-  {
-    std::map<Node, inst::InstMatchTrie>::iterator it =
-        d_inst_match_trie.find(q);
-    if (it != d_inst_match_trie.end())
-    {
-      return it->second.existsInstMatch(d_qstate, q, terms, modEq);
-    }
-  }
-  return false;
+  inst::InstMatchIndex* imi = getInstMatchIndex(q);
+  return imi != nullptr && imi->existsInstMatch(d_qstate, terms, modEq);
 }
 
 Node Instantiate::getInstantiation(Node q,
@@ -563,43 +597,39 @@ bool Instantiate::recordInstantiationInternal(Node q,
     // record the instantiation for deletion later
     d_recorded_inst.push_back(std::pair<Node, std::vector<Node> >(q, terms));
   }
-  if (options::incrementalSolving())
+  Trace("inst-add-debug") << "Adding into inst index, modEq = " << modEq
+                          << std::endl;
+  std::unique_ptr<inst::InstMatchIndex>& imi = d_inst_match_index[q];
+  if (imi == nullptr)
   {
-    Trace("inst-add-debug")
-        << "Adding into context-dependent inst trie, modEq = " << modEq
-        << std::endl;
-    inst::CDInstMatchTrie* imt;
-    std::map<Node, inst::CDInstMatchTrie*>::iterator it =
-        d_c_inst_match_trie.find(q);
-    if (it != d_c_inst_match_trie.end())
+    size_t nvars = q[0].getNumChildren();
+    if (options::incrementalSolving())
     {
-      imt = it->second;
+      imi.reset(new inst::CDInstMatchIndex(d_qstate.getUserContext(), nvars));
     }
     else
     {
-      imt = new inst::CDInstMatchTrie(d_qstate.getUserContext());
-      d_c_inst_match_trie[q] = imt;
+      imi.reset(new inst::InstMatchIndex(nvars));
     }
+  }
+  if (options::incrementalSolving())
+  {
     d_c_inst_match_trie_dom.insert(q);
-    return imt->addInstMatch(d_qstate, q, terms, modEq);
   }
-  Trace("inst-add-debug") << "Adding into inst trie" << std::endl;
-  return d_inst_match_trie[q].addInstMatch(d_qstate, q, terms, modEq);
+  return imi->addInstMatch(d_qstate, terms, modEq);
 }
 
 bool Instantiate::removeInstantiationInternal(Node q, std::vector<Node>& terms)
 {
-  if (options::incrementalSolving())
-  {
-    std::map<Node, inst::CDInstMatchTrie*>::iterator it =
-        d_c_inst_match_trie.find(q);
-    if (it != d_c_inst_match_trie.end())
-    {
-      return it->second->removeInstMatch(q, terms);
-    }
-    return false;
-  }
-  return d_inst_match_trie[q].removeInstMatch(q, terms);
+  inst::InstMatchIndex* imi = getInstMatchIndex(q);
+  return imi != nullptr && imi->removeInstMatch(terms);
+}
+
+inst::InstMatchIndex* Instantiate::getInstMatchIndex(Node q) const
+{
+  std::map<Node, std::unique_ptr<inst::InstMatchIndex>>::const_iterator it =
+      d_inst_match_index.find(q);
+  return it == d_inst_match_index.end() ? nullptr : it->second.get();
 }
 
 Node Instantiate::getTermForType(TypeNode tn)
@@ -625,7 +655,7 @@ void Instantiate::getInstantiatedQuantifiedFormulas(std::vector<Node>& qs)
   }
   else
   {
-    for (std::pair<const Node, inst::InstMatchTrie>& t : d_inst_match_trie)
+    for (const auto& t : d_inst_match_index)
     {
       qs.push_back(t.first);
     }
@@ -635,48 +665,40 @@ void Instantiate::getInstantiatedQuantifiedFormulas(std::vector<Node>& qs)
 void Instantiate::getInstantiationTermVectors(
     Node q, std::vector<std::vector<Node> >& tvecs)
 {
-
-  if (options::incrementalSolving())
+  inst::InstMatchIndex* imi = getInstMatchIndex(q);
+  if (imi != nullptr)
   {
-    std::map<Node, inst::CDInstMatchTrie*>::const_iterator it =
-        d_c_inst_match_trie.find(q);
-    if (it != d_c_inst_match_trie.end())
-    {
-      it->second->getInstantiations(q, tvecs);
-    }
-  }
-  else
-  {
-    std::map<Node, inst::InstMatchTrie>::const_iterator it =
-        d_inst_match_trie.find(q);
-    if (it != d_inst_match_trie.end())
-    {
-      it->second.getInstantiations(q, tvecs);
-    }
+    imi->getInstantiations(tvecs);
   }
 }
 
 void Instantiate::getInstantiationTermVectors(
     std::map<Node, std::vector<std::vector<Node> > >& insts)
 {
-  if (options::incrementalSolving())
+  for (const auto& t : d_inst_match_index)
   {
-    for (const auto& t : d_c_inst_match_trie)
-    {
-      getInstantiationTermVectors(t.first, insts[t.first]);
-    }
-  }
-  else
-  {
-    for (const auto& t : d_inst_match_trie)
-    {
-      getInstantiationTermVectors(t.first, insts[t.first]);
-    }
+    getInstantiationTermVectors(t.first, insts[t.first]);
   }
 }
 
 bool Instantiate::isProofEnabled() const { return d_pfInst != nullptr; }
 
+void Instantiate::writeProfile() const
+{
+  if (d_profiler == nullptr)
+  {
+    return;
+  }
+  std::ofstream out(options::instProfile());
+  if (!out)
+  {
+    Warning() << "Cannot write the instantiation profile to "
+              << options::instProfile() << std::endl;
+    return;
+  }
+  d_profiler->toStreamJSON(out);
+}
+
 void Instantiate::debugPrint(std::ostream& out)
 {
   // debug information
@@ -735,16 +757,44 @@ Node Instantiate::ensureType(Node n, TypeNode tn)
   return Node::null();
 }
 
-Instantiate::Statistics::Statistics()
+uint64_t Instantiate::IndexMemoryStat::getData() const
+{
+  uint64_t mem = 0;
+  for (const auto& t : d_indices)
+  {
+    mem += t.second->getMemoryUsage();
+  }
+  return mem;
+}
+
+void Instantiate::IndexMemoryStat::flushInformation(std::ostream& out) const
+{
+  out << getData();
+}
+
+void Instantiate::IndexMemoryStat::safeFlushInformation(int fd) const
+{
+  safe_print<uint64_t>(fd, getData());
+}
+
+SExpr Instantiate::IndexMemoryStat::getValue() const
+{
+  return SExpr(Integer(getData()));
+}
+
+Instantiate::Statistics::Statistics(
+    const std::map<Node, std::unique_ptr<inst::InstMatchIndex>>& indices)
     : d_instantiations("Instantiate::Instantiations_Total", 0),
       d_inst_duplicate("Instantiate::Duplicate_Inst", 0),
       d_inst_duplicate_eq("Instantiate::Duplicate_Inst_Eq", 0),
-      d_inst_duplicate_ent("Instantiate::Duplicate_Inst_Entailed", 0)
+      d_inst_duplicate_ent("Instantiate::Duplicate_Inst_Entailed", 0),
+      d_inst_index_memory("Instantiate::Inst_Index_Memory", indices)
 {
   smtStatisticsRegistry()->registerStat(&d_instantiations);
   smtStatisticsRegistry()->registerStat(&d_inst_duplicate);
   smtStatisticsRegistry()->registerStat(&d_inst_duplicate_eq);
   smtStatisticsRegistry()->registerStat(&d_inst_duplicate_ent);
+  smtStatisticsRegistry()->registerStat(&d_inst_index_memory);
 }
 
 Instantiate::Statistics::~Statistics()
@@ -753,6 +803,7 @@ Instantiate::Statistics::~Statistics()
   smtStatisticsRegistry()->unregisterStat(&d_inst_duplicate);
   smtStatisticsRegistry()->unregisterStat(&d_inst_duplicate_eq);
   smtStatisticsRegistry()->unregisterStat(&d_inst_duplicate_ent);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_index_memory);
 }
 
 } /* CVC4::theory::quantifiers namespace */
@@ -18,12 +18,14 @@
 #define CVC4__THEORY__QUANTIFIERS__INSTANTIATE_H
 
 #include <map>
+#include <memory>
 
 #include "context/cdhashset.h"
 #include "expr/lazy_proof.h"
 #include "expr/node.h"
 #include "expr/proof.h"
-#include "theory/quantifiers/inst_match_trie.h"
+#include "theory/quantifiers/inst_match_index.h"
+#include "theory/quantifiers/inst_profiler.h"
 #include "theory/quantifiers/quant_util.h"
 #include "util/statistics_registry.h"
 
@@ -71,9 +73,8 @@ class InstantiationRewriter
 /** Instantiate
  *
  * This class is used for generating instantiation lemmas.  It maintains an
- * instantiation trie, which is represented by a different data structure
- * depending on whether incremental solving is enabled (see d_inst_match_trie
- * and d_c_inst_match_trie).
+ * index of the instantiations of each quantified formula, which is context
+ * dependent if incremental solving is enabled (see d_inst_match_index).
  *
  * Below, we say an instantiation lemma for q = forall x. F under substitution
  * { x -> t } is the formula:
@@ -264,6 +265,38 @@ class Instantiate : public QuantifiersUtil
   /** Are proofs enabled for this object? */
   bool isProofEnabled() const;
 
+  /** Get the instantiation profiler, or null if --inst-profile is not set */
+  InstProfiler* getProfiler() const { return d_profiler.get(); }
+  /**
+   * Write the instantiation profile to the file of --inst-profile, if it is
+   * set.
+   */
+  void writeProfile() const;
+
+  /**
+   * The number of bytes allocated by the given instantiation indices. It is
+   * computed from the indices when it is read, since they also shrink on
+   * pops of the user context.
+   */
+  class IndexMemoryStat : public Stat
+  {
+   public:
+    IndexMemoryStat(
+        const std::string& name,
+        const std::map<Node, std::unique_ptr<inst::InstMatchIndex>>& indices)
+        : Stat(name), d_indices(indices)
+    {
+    }
+    /** Get the number of bytes allocated by the indices */
+    uint64_t getData() const;
+    void flushInformation(std::ostream& out) const override;
+    void safeFlushInformation(int fd) const override;
+    SExpr getValue() const override;
+
+   private:
+    const std::map<Node, std::unique_ptr<inst::InstMatchIndex>>& d_indices;
+  }; /* class Instantiate::IndexMemoryStat */
+
   /** statistics class
    *
    * This tracks statistics on the number of instantiations successfully
@@ -277,12 +310,23 @@ class Instantiate : public QuantifiersUtil
     IntStat d_inst_duplicate;
     IntStat d_inst_duplicate_eq;
     IntStat d_inst_duplicate_ent;
-    Statistics();
+    /** Number of bytes allocated by the instantiation indices */
+    IndexMemoryStat d_inst_index_memory;
+    Statistics(
+        const std::map<Node, std::unique_ptr<inst::InstMatchIndex>>& indices);
     ~Statistics();
   }; /* class Instantiate::Statistics */
   Statistics d_statistics;
 
  private:
+  /**
+   * Add instantiation, as addInstantiation, without updating the counts of
+   * the instantiation profiler
+   */
+  bool addInstantiationInternal(
+      Node q, std::vector<Node>& terms, bool mkRep, bool modEq, bool doVts);
+  /** Notify the instantiation profiler of a duplicate instantiation */
+  void notifyDuplicate();
   /** record instantiation, return true if it was not a duplicate
    *
    * addedLem : whether an instantiation lemma was added for the vector we are
@@ -322,16 +366,17 @@ class Instantiate : public QuantifiersUtil
   /** statistics for debugging total instantiations per quantifier per round */
   std::map<Node, uint32_t> d_temp_inst_debug;
 
-  /** list of all instantiations produced for each quantifier
+  /** Get the instantiation index of q, or null if it does not exist */
+  inst::InstMatchIndex* getInstMatchIndex(Node q) const;
+  /** index of all instantiations produced for each quantifier
    *
-   * We store context (dependent, independent) versions. If incremental solving
-   * is disabled, we use d_inst_match_trie for performance reasons.
+   * The indices are context dependent (in the user context) if incremental
+   * solving is enabled.
    */
-  std::map<Node, inst::InstMatchTrie> d_inst_match_trie;
-  std::map<Node, inst::CDInstMatchTrie*> d_c_inst_match_trie;
+  std::map<Node, std::unique_ptr<inst::InstMatchIndex>> d_inst_match_index;
   /**
-   * The list of quantified formulas for which the domain of d_c_inst_match_trie
-   * is valid.
+   * The list of quantified formulas for which the domain of d_inst_match_index
+   * is valid if incremental solving is enabled.
    */
   context::CDHashSet<Node, NodeHashFunction> d_c_inst_match_trie_dom;
 
@@ -346,6 +391,10 @@ class Instantiate : public QuantifiersUtil
    * A CDProof storing instantiation steps.
    */
   std::unique_ptr<CDProof> d_pfInst;
+  /** The instantiation profiler, if --inst-profile is set */
+  std::unique_ptr<InstProfiler> d_profiler;
+  /** The counts of the instantiation being added, if profiling */
+  InstProfiler::Counts* d_profileCounts;
 };
 
 } /* CVC4::theory::quantifiers namespace */
@@ -158,9 +158,7 @@ void QueryGenerator::checkQuery(Node qy, unsigned spIndex)
   {
     Trace("sygus-qgen-check") << "  query: check " << qy << "..." << std::endl;
     // make the satisfiability query
-    std::unique_ptr<SmtEngine> queryChecker;
-    initializeChecker(queryChecker, qy);
-    Result r = queryChecker->checkSat();
+    Result r = doCheck(qy);
     Trace("sygus-qgen-check") << "  query: ...got : " << r << std::endl;
     if (r.asSatisfiabilityResult().isSat() == Result::UNSAT)
     {
@@ -230,19 +230,25 @@ bool SygusRepairConst::repairSolution(Node sygusBody,
   }
 
   Trace("sygus-engine") << "Repairing previous solution..." << std::endl;
-  // make the satisfiability query
-  std::unique_ptr<SmtEngine> repcChecker;
-  // initialize the subsolver using the standard method
-  initializeSubsolver(repcChecker,
-                      options::sygusRepairConstTimeout.wasSetByUser(),
-                      options::sygusRepairConstTimeout());
+  std::vector<Node> fo_vars;
+  for (const Node& v : sk_vars)
+  {
+    Assert(d_sk_to_fo.find(v) != d_sk_to_fo.end());
+    fo_vars.push_back(d_sk_to_fo[v]);
+  }
   // renable options disabled by sygus
-  repcChecker->setOption("miniscope-quant", "true");
-  repcChecker->setOption("miniscope-quant-fv", "true");
-  repcChecker->setOption("quant-split", "true");
-  repcChecker->assertFormula(fo_body);
-  // check satisfiability
-  Result r = repcChecker->checkSat();
+  std::map<std::string, std::string> opts;
+  opts["miniscope-quant"] = "true";
+  opts["miniscope-quant-fv"] = "true";
+  opts["quant-split"] = "true";
+  // check satisfiability with a subsolver using the standard method
+  std::vector<Node> fo_vals;
+  Result r = checkWithSubsolver(fo_body,
+                                fo_vars,
+                                fo_vals,
+                                opts,
+                                options::sygusRepairConstTimeout.wasSetByUser(),
+                                options::sygusRepairConstTimeout());
   Trace("sygus-repair-const") << "...got : " << r << std::endl;
   if (r.asSatisfiabilityResult().isSat() == Result::UNSAT
       || r.asSatisfiabilityResult().isUnknown())
@@ -251,11 +257,11 @@ bool SygusRepairConst::repairSolution(Node sygusBody,
     return false;
   }
   std::vector<Node> sk_sygus_m;
-  for (const Node& v : sk_vars)
+  for (size_t i = 0, size = sk_vars.size(); i < size; i++)
   {
-    Assert(d_sk_to_fo.find(v) != d_sk_to_fo.end());
-    Node fov = d_sk_to_fo[v];
-    Node fov_m = repcChecker->getValue(fov);
+    Node v = sk_vars[i];
+    Node fov = fo_vars[i];
+    Node fov_m = fo_vals[i];
     Trace("sygus-repair-const") << "  " << fov << " = " << fov_m << std::endl;
     // convert to sygus
     Node fov_m_to_sygus = d_tds->getProxyVariable(v.getType(), fov_m);
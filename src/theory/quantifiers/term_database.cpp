@@ -19,6 +19,7 @@
 #include "options/smt_options.h"
 #include "options/theory_options.h"
 #include "options/uf_options.h"
+#include "smt/smt_statistics_registry.h"
 #include "theory/quantifiers/ematching/trigger_term_info.h"
 #include "theory/quantifiers/quantifiers_attributes.h"
 #include "theory/quantifiers/quantifiers_inference_manager.h"
@@ -26,6 +27,7 @@
 #include "theory/quantifiers/term_util.h"
 #include "theory/quantifiers_engine.h"
 #include "theory/theory_engine.h"
+#include "theory/uf/equality_engine_iterator.h"
 
 using namespace std;
 using namespace CVC4::kind;
@@ -49,7 +51,12 @@ TermDb::TermDb(QuantifiersState& qs,
       d_typeMap(d_termsContextUse),
       d_ops(d_termsContextUse),
       d_opMap(d_termsContextUse),
-      d_inactive_map(qs.getSatContext())
+      d_inactive_map(qs.getSatContext()),
+      d_incremental(options::termDbInc()
+                    && options::termDbMode() == options::TermDbMode::ALL
+                    && !options::ufHo()),
+      d_numChanges(qs.getSatContext(), 0),
+      d_undoNotify(qs.getSatContext(), *this)
 {
   d_consistent_ee = true;
   d_true = NodeManager::currentNM()->mkConst(true);
@@ -226,6 +233,11 @@ void TermDb::addTerm(Node n)
       Trace("term-db-debug") << "  match operator is : " << op << std::endl;
       DbList* dlo = getOrMkDbListForOp(op);
       dlo->d_list.push_back(n);
+      if (d_incremental)
+      {
+        markDirty(op);
+        addChange(op, TNode::null());
+      }
       // If we are higher-order, we may need to register more terms.
       if (options::ufHo())
       {
@@ -286,6 +298,10 @@ void TermDb::computeArgReps( TNode n ) {
 
 void TermDb::computeUfEqcTerms( TNode f ) {
   Assert(f == getOperatorRepresentative(f));
+  if (d_incremental)
+  {
+    refreshOp(f);
+  }
   if (d_func_map_eqc_trie.find(f) != d_func_map_eqc_trie.end())
   {
     return;
@@ -309,12 +325,24 @@ void TermDb::computeUfEqcTerms( TNode f ) {
         computeArgReps(n);
         TNode r = ee->hasTerm(n) ? ee->getRepresentative(n) : TNode(n);
         d_func_map_eqc_trie[f].d_data[r].addTerm(n, d_arg_reps[n]);
+        if (d_incremental)
+        {
+          addRepUser(r, f);
+          for (TNode ar : d_arg_reps[n])
+          {
+            addRepUser(ar, f);
+          }
+        }
       }
     }
   }
 }
 
 void TermDb::computeUfTerms( TNode f ) {
+  if (d_incremental)
+  {
+    refreshOp(f);
+  }
   if (d_op_nonred_count.find(f) != d_op_nonred_count.end())
   {
     // already computed
@@ -322,6 +350,7 @@ void TermDb::computeUfTerms( TNode f ) {
   }
   Assert(f == getOperatorRepresentative(f));
   d_op_nonred_count[f] = 0;
+  ++(d_statistics.d_opsComputed);
   // get the matchable operators in the equivalence class of f
   std::vector<TNode> ops;
   ops.push_back(f);
@@ -362,6 +391,15 @@ void TermDb::computeUfTerms( TNode f ) {
       }
 
       computeArgReps(n);
+      if (d_incremental)
+      {
+        // the index of f depends on the classes of n and its arguments
+        addRepUser(d_qstate.getRepresentative(n), f);
+        for (TNode ar : d_arg_reps[n])
+        {
+          addRepUser(ar, f);
+        }
+      }
       Trace("term-db-debug") << "Adding term " << n << " with arg reps : ";
       for (unsigned i = 0, size = d_arg_reps[n].size(); i < size; i++)
       {
@@ -383,7 +421,16 @@ void TermDb::computeUfTerms( TNode f ) {
       Trace("term-db-debug2") << "...add term returned " << at << std::endl;
       if (at != n && d_qstate.areEqual(at, n))
       {
-        setTermInactive(n);
+        if (d_incremental)
+        {
+          // n is congruent as long as the index of f is not out of date
+          d_op_congruent[f].push_back(n);
+          d_congruent.insert(n);
+        }
+        else
+        {
+          setTermInactive(n);
+        }
         Trace("term-db-debug") << n << " is redundant." << std::endl;
         congruentCount++;
         continue;
@@ -440,6 +487,11 @@ void TermDb::computeUfTerms( TNode f ) {
           d_qim.addPendingLemma(lem, InferenceId::UNKNOWN);
           d_qstate.notifyInConflict();
           d_consistent_ee = false;
+          if (d_incremental)
+          {
+            // the index of f is incomplete
+            d_dirtyOps.insert(f);
+          }
           return;
         }
       }
@@ -904,6 +956,10 @@ bool TermDb::isEntailed(TNode n,
 }
 
 bool TermDb::isTermActive( Node n ) {
+  if (d_incremental && d_congruent.find(n) != d_congruent.end())
+  {
+    return false;
+  }
   return d_inactive_map.find( n )==d_inactive_map.end(); 
   //return !n.getAttribute(NoMatchAttribute());
 }
@@ -999,15 +1055,167 @@ void TermDb::presolve() {
   {
     d_termsContext.pop();
     d_termsContext.push();
+    // the terms of all operators are cleared
+    if (d_incremental)
+    {
+      for (const std::pair<const Node, int>& op : d_op_nonred_count)
+      {
+        d_dirtyOps.insert(op.first);
+      }
+      for (const std::pair<const Node, TNodeTrie>& op : d_func_map_eqc_trie)
+      {
+        d_dirtyOps.insert(op.first);
+      }
+    }
+  }
+}
+
+void TermDb::eqNotifyNewClass(TNode t)
+{
+  if (!d_incremental || !inst::TriggerTermInfo::isAtomicTrigger(t))
+  {
+    return;
+  }
+  // t is now in the equality engine, and may be indexed
+  Node op = getMatchOperator(t);
+  if (!op.isNull())
+  {
+    markDirty(op);
+    addChange(op, TNode::null());
+  }
+}
+
+void TermDb::eqNotifyMerge(TNode t1, TNode t2)
+{
+  if (!d_incremental)
+  {
+    return;
+  }
+  // the terms of the class of t2 are now represented by t1
+  markDirtyUsers(t2);
+  d_repUsers.erase(t2);
+  addChange(t1, t2);
+}
+
+void TermDb::eqNotifyDisequal(TNode t1, TNode t2)
+{
+  if (!d_incremental)
+  {
+    return;
+  }
+  // congruent terms of t1 and t2 may now be in conflict
+  eq::EqualityEngine* ee = d_qstate.getEqualityEngine();
+  markDirtyUsers(ee->getRepresentative(t1));
+  markDirtyUsers(ee->getRepresentative(t2));
+}
+
+void TermDb::markDirty(TNode op)
+{
+  if (d_op_nonred_count.find(op) != d_op_nonred_count.end()
+      || d_func_map_eqc_trie.find(op) != d_func_map_eqc_trie.end())
+  {
+    d_dirtyOps.insert(op);
+  }
+}
+
+void TermDb::markDirtyUsers(TNode r)
+{
+  std::unordered_map<Node,
+                     std::unordered_set<Node, NodeHashFunction>,
+                     NodeHashFunction>::iterator it = d_repUsers.find(r);
+  if (it != d_repUsers.end())
+  {
+    for (const Node& op : it->second)
+    {
+      markDirty(op);
+    }
+  }
+}
+
+void TermDb::addRepUser(TNode r, TNode op) { d_repUsers[r].insert(op); }
+
+void TermDb::addChange(TNode a, TNode b)
+{
+  d_changes.resize(d_numChanges.get());
+  d_changes.push_back(std::pair<Node, Node>(a, b));
+  d_numChanges = d_changes.size();
+}
+
+void TermDb::undoChanges()
+{
+  size_t nchanges = d_numChanges.get();
+  for (size_t i = nchanges, size = d_changes.size(); i < size; i++)
+  {
+    std::pair<Node, Node>& c = d_changes[i];
+    if (c.second.isNull())
+    {
+      // the terms of operator c.first are restored
+      markDirty(c.first);
+    }
+    else
+    {
+      // the merge of c.second into c.first is undone
+      markDirtyUsers(c.first);
+      markDirtyUsers(c.second);
+    }
+  }
+  if (nchanges < d_changes.size())
+  {
+    d_changes.resize(nchanges);
+  }
+}
+
+void TermDb::refreshOp(TNode f)
+{
+  if (d_roundOps.insert(f).second)
+  {
+    if (d_dirtyOps.erase(f) > 0)
+    {
+      clearOp(f);
+    }
+    else if (d_op_nonred_count.find(f) != d_op_nonred_count.end())
+    {
+      ++(d_statistics.d_opsReused);
+    }
+  }
+}
+
+void TermDb::clearOp(TNode f)
+{
+  d_op_nonred_count.erase(f);
+  d_func_map_trie.erase(f);
+  d_func_map_eqc_trie.erase(f);
+  d_func_map_rel_dom.erase(f);
+  std::map<Node, std::vector<Node>>::iterator it = d_op_congruent.find(f);
+  if (it != d_op_congruent.end())
+  {
+    for (const Node& n : it->second)
+    {
+      d_congruent.erase(n);
+    }
+    d_op_congruent.erase(it);
   }
 }
 
 bool TermDb::reset( Theory::Effort effort ){
-  d_op_nonred_count.clear();
+  if (d_incremental)
+  {
+    // only remove the term indices that are out of date
+    for (const Node& f : d_dirtyOps)
+    {
+      clearOp(f);
+    }
+    d_dirtyOps.clear();
+    d_roundOps.clear();
+  }
+  else
+  {
+    d_op_nonred_count.clear();
+    d_func_map_trie.clear();
+    d_func_map_eqc_trie.clear();
+    d_func_map_rel_dom.clear();
+  }
   d_arg_reps.clear();
-  d_func_map_trie.clear();
-  d_func_map_eqc_trie.clear();
-  d_func_map_rel_dom.clear();
   d_consistent_ee = true;
 
   eq::EqualityEngine* ee = d_qstate.getEqualityEngine();
@@ -1217,6 +1425,20 @@ TNode TermDb::getCongruentTerm( Node f, std::vector< TNode >& args ) {
   return d_func_map_trie[f].existsTerm( args );
 }
 
+TermDb::Statistics::Statistics()
+    : d_opsComputed("TermDb::Ops_Computed", 0),
+      d_opsReused("TermDb::Ops_Reused", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_opsComputed);
+  smtStatisticsRegistry()->registerStat(&d_opsReused);
+}
+
+TermDb::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_opsComputed);
+  smtStatisticsRegistry()->unregisterStat(&d_opsReused);
+}
+
 Node TermDb::getHoTypeMatchPredicate(TypeNode tn)
 {
   std::map<TypeNode, Node>::iterator ithp = d_ho_type_match_pred.find(tn);
@@ -18,15 +18,18 @@
 #define CVC4__THEORY__QUANTIFIERS__TERM_DATABASE_H
 
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "context/cdhashmap.h"
 #include "context/cdhashset.h"
+#include "context/cdo.h"
 #include "expr/attribute.h"
 #include "expr/node_trie.h"
 #include "theory/quantifiers/quant_util.h"
 #include "theory/theory.h"
 #include "theory/type_enumerator.h"
+#include "util/statistics_registry.h"
 
 namespace CVC4 {
 namespace theory {
@@ -65,6 +68,14 @@ class DbList
  * This initializes the database for the round. However,
  * notice that TNodeTrie objects are computed
  * lazily for performance reasons.
+ *
+ * If --term-db-inc is enabled, the TNodeTrie objects of an operator are kept
+ * across rounds until they are invalidated by a change of the representatives
+ * they are indexed by, or of the terms of the operator. These changes are
+ * notified by the master equality engine (new classes, merges, disequalities)
+ * and by the registration of new terms, and are undone on backtracking. Each
+ * round then only rebuilds the indices of the operators that are affected by
+ * these changes.
  */
 class TermDb : public QuantifiersUtil {
   friend class ::CVC4::theory::QuantifiersEngine;
@@ -83,6 +94,12 @@ class TermDb : public QuantifiersUtil {
   ~TermDb();
   /** presolve (called once per user check-sat) */
   void presolve();
+  /** notification when the master equality engine creates class t */
+  void eqNotifyNewClass(TNode t);
+  /** notification when the master equality engine merges t2 into t1 */
+  void eqNotifyMerge(TNode t1, TNode t2);
+  /** notification when t1 and t2 are disequal in the master equality engine */
+  void eqNotifyDisequal(TNode t1, TNode t2);
   /** reset (calculate which terms are active) */
   bool reset(Theory::Effort effort) override;
   /** register quantified formula */
@@ -332,6 +349,76 @@ class TermDb : public QuantifiersUtil {
   std::map< Node, std::map< unsigned, std::vector< Node > > > d_func_map_rel_dom;
   /** has map */
   std::map< Node, bool > d_has_map;
+  //------------------------------incremental term indexing
+  /** Notifies the term database of popped SAT contexts */
+  class UndoNotify : public context::ContextNotifyObj
+  {
+   public:
+    UndoNotify(context::Context* c, TermDb& tdb)
+        : context::ContextNotifyObj(c), d_tdb(tdb)
+    {
+    }
+
+   protected:
+    void contextNotifyPop() override { d_tdb.undoChanges(); }
+
+   private:
+    TermDb& d_tdb;
+  };
+  /** Whether the term indices are kept across rounds (--term-db-inc) */
+  bool d_incremental;
+  /** The operators whose term indices are out of date */
+  std::unordered_set<Node, NodeHashFunction> d_dirtyOps;
+  /** The operators whose term indices were used in the current round */
+  std::unordered_set<Node, NodeHashFunction> d_roundOps;
+  /** Map from representatives to the operators whose indices use them */
+  std::unordered_map<Node,
+                     std::unordered_set<Node, NodeHashFunction>,
+                     NodeHashFunction>
+      d_repUsers;
+  /** The terms found congruent in the term index of each operator */
+  std::map<Node, std::vector<Node>> d_op_congruent;
+  /** The union of the terms in d_op_congruent, which are inactive */
+  std::unordered_set<Node, NodeHashFunction> d_congruent;
+  /**
+   * The changes of the current SAT context that invalidate term indices when
+   * they are undone: an operator whose terms changed, or a merge of two
+   * representatives.
+   */
+  std::vector<std::pair<Node, Node>> d_changes;
+  /** The number of changes in the current SAT context */
+  context::CDO<size_t> d_numChanges;
+  /** Notifies of popped SAT contexts */
+  UndoNotify d_undoNotify;
+  /** Mark the term indices of op as out of date */
+  void markDirty(TNode op);
+  /** Mark the term indices of the users of representative r as out of date */
+  void markDirtyUsers(TNode r);
+  /** Record that the term indices of op use representative r */
+  void addRepUser(TNode r, TNode op);
+  /** Record change (a, b) to be undone when the SAT context is popped */
+  void addChange(TNode a, TNode b);
+  /** Undo the changes of the popped SAT contexts */
+  void undoChanges();
+  /**
+   * Prepare for computing the term indices of f, which removes its term
+   * indices if they are out of date and were not used in this round.
+   */
+  void refreshOp(TNode f);
+  /** Remove the term indices of f */
+  void clearOp(TNode f);
+  /** Statistics */
+  struct Statistics
+  {
+    /** Number of term indices of operators that were computed */
+    IntStat d_opsComputed;
+    /** Number of term indices of operators reused from an earlier round */
+    IntStat d_opsReused;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+  //------------------------------end incremental term indexing
   /** map from reps to a term in eqc in d_has_map */
   std::map<Node, Node> d_term_elig_eqc;
   /**
@@ -20,6 +20,7 @@
 #include "options/uf_options.h"
 #include "smt/smt_engine_scope.h"
 #include "smt/smt_statistics_registry.h"
+#include "theory/quantifiers/ematching/code_tree.h"
 #include "theory/quantifiers/ematching/trigger_trie.h"
 #include "theory/quantifiers/equality_query.h"
 #include "theory/quantifiers/first_order_model.h"
@@ -56,6 +57,7 @@ QuantifiersEngine::QuantifiersEngine(
       d_pnm(pnm),
       d_qreg(),
       d_treg(qstate, qim, d_qreg),
+      d_code_tree(nullptr),
       d_tr_trie(new inst::TriggerTrie),
       d_model(nullptr),
       d_builder(nullptr),
@@ -73,6 +75,12 @@ QuantifiersEngine::QuantifiersEngine(
 
   d_util.push_back(d_instantiate.get());
 
+  if (options::ematchEngine() == options::EmatchEngineMode::CODE_TREE)
+  {
+    d_code_tree.reset(new inst::CodeTree(qstate, d_treg.getTermDatabase()));
+    d_util.push_back(d_code_tree.get());
+  }
+
   Trace("quant-engine-debug") << "Initialize quantifiers engine." << std::endl;
   Trace("quant-engine-debug") << "Initialize model, mbqi : " << options::mbqiMode() << std::endl;
 
@@ -174,6 +182,10 @@ inst::TriggerTrie* QuantifiersEngine::getTriggerDatabase() const
 {
   return d_tr_trie.get();
 }
+inst::CodeTree* QuantifiersEngine::getCodeTree() const
+{
+  return d_code_tree.get();
+}
 
 bool QuantifiersEngine::isFiniteBound(Node q, Node v) const
 {
@@ -726,7 +738,21 @@ void QuantifiersEngine::assertQuantifier( Node f, bool pol ){
   d_treg.addTerm(d_qreg.getInstConstantBody(f), true);
 }
 
-void QuantifiersEngine::eqNotifyNewClass(TNode t) { d_treg.addTerm(t); }
+void QuantifiersEngine::eqNotifyNewClass(TNode t)
+{
+  d_treg.addTerm(t);
+  d_treg.getTermDatabase()->eqNotifyNewClass(t);
+}
+
+void QuantifiersEngine::eqNotifyMerge(TNode t1, TNode t2)
+{
+  d_treg.getTermDatabase()->eqNotifyMerge(t1, t2);
+}
+
+void QuantifiersEngine::eqNotifyDisequal(TNode t1, TNode t2)
+{
+  d_treg.getTermDatabase()->eqNotifyDisequal(t1, t2);
+}
 
 void QuantifiersEngine::markRelevant( Node q ) {
   d_model->markRelevant( q );
@@ -760,6 +786,11 @@ void QuantifiersEngine::getSkolemTermVectors(
   d_skolemize->getSkolemTermVectors(sks);
 }
 
+void QuantifiersEngine::writeInstProfile() const
+{
+  d_instantiate->writeProfile();
+}
+
 QuantifiersEngine::Statistics::Statistics()
     : d_time("theory::QuantifiersEngine::time"),
       d_qcf_time("theory::QuantifiersEngine::time_qcf"),
@@ -771,6 +802,8 @@ QuantifiersEngine::Statistics::Statistics()
       d_simple_triggers("QuantifiersEngine::Triggers_Simple", 0),
       d_multi_triggers("QuantifiersEngine::Triggers_Multi", 0),
       d_multi_trigger_instantiations("QuantifiersEngine::Multi_Trigger_Instantiations", 0),
+      d_matches_attempted("QuantifiersEngine::Matches_Attempted", 0),
+      d_matches_produced("QuantifiersEngine::Matches_Produced", 0),
       d_red_alpha_equiv("QuantifiersEngine::Reductions_Alpha_Equivalence", 0),
       d_instantiations_user_patterns("QuantifiersEngine::Instantiations_User_Patterns", 0),
       d_instantiations_auto_gen("QuantifiersEngine::Instantiations_Auto_Gen", 0),
@@ -792,6 +825,8 @@ QuantifiersEngine::Statistics::Statistics()
   smtStatisticsRegistry()->registerStat(&d_simple_triggers);
   smtStatisticsRegistry()->registerStat(&d_multi_triggers);
   smtStatisticsRegistry()->registerStat(&d_multi_trigger_instantiations);
+  smtStatisticsRegistry()->registerStat(&d_matches_attempted);
+  smtStatisticsRegistry()->registerStat(&d_matches_produced);
   smtStatisticsRegistry()->registerStat(&d_red_alpha_equiv);
   smtStatisticsRegistry()->registerStat(&d_instantiations_user_patterns);
   smtStatisticsRegistry()->registerStat(&d_instantiations_auto_gen);
@@ -815,6 +850,8 @@ QuantifiersEngine::Statistics::~Statistics(){
   smtStatisticsRegistry()->unregisterStat(&d_simple_triggers);
   smtStatisticsRegistry()->unregisterStat(&d_multi_triggers);
   smtStatisticsRegistry()->unregisterStat(&d_multi_trigger_instantiations);
+  smtStatisticsRegistry()->unregisterStat(&d_matches_attempted);
+  smtStatisticsRegistry()->unregisterStat(&d_matches_produced);
   smtStatisticsRegistry()->unregisterStat(&d_red_alpha_equiv);
   smtStatisticsRegistry()->unregisterStat(&d_instantiations_user_patterns);
   smtStatisticsRegistry()->unregisterStat(&d_instantiations_auto_gen);
@@ -39,6 +39,7 @@ class QuantifiersModule;
 class RepSetIterator;
 
 namespace inst {
+class CodeTree;
 class TriggerTrie;
 }
 namespace quantifiers {
@@ -95,6 +96,8 @@ class QuantifiersEngine {
   quantifiers::Skolemize* getSkolemize() const;
   /** get trigger database */
   inst::TriggerTrie* getTriggerDatabase() const;
+  /** get the code tree, or null if --ematch-engine=code-tree is not set */
+  inst::CodeTree* getCodeTree() const;
   //---------------------- end utilities
  private:
   //---------------------- private initialization
@@ -173,6 +176,10 @@ private:
 public:
  /** notification when master equality engine is updated */
  void eqNotifyNewClass(TNode t);
+ /** notification when t2 is merged into t1 in the master equality engine */
+ void eqNotifyMerge(TNode t1, TNode t2);
+ /** notification when t1 and t2 are disequal in master equality engine */
+ void eqNotifyDisequal(TNode t1, TNode t2);
  /** mark relevant quantified formula, this will indicate it should be checked
   * before the others */
  void markRelevant(Node q);
@@ -215,6 +222,8 @@ public:
   * negation of that quantified formula.
   */
  void getSkolemTermVectors(std::map<Node, std::vector<Node> >& sks) const;
+ /** Write the instantiation profile, if --inst-profile is set */
+ void writeInstProfile() const;
 
  /** get synth solutions
   *
@@ -248,6 +257,8 @@ public:
     IntStat d_simple_triggers;
     IntStat d_multi_triggers;
     IntStat d_multi_trigger_instantiations;
+    IntStat d_matches_attempted;
+    IntStat d_matches_produced;
     IntStat d_red_alpha_equiv;
     IntStat d_instantiations_user_patterns;
     IntStat d_instantiations_auto_gen;
@@ -283,6 +294,11 @@ public:
   quantifiers::QuantifiersRegistry d_qreg;
   /** The term registry */
   quantifiers::TermRegistry d_treg;
+  /**
+   * The code tree for E-matching, which must outlive the triggers, whose
+   * match generators are registered in it
+   */
+  std::unique_ptr<inst::CodeTree> d_code_tree;
   /** all triggers will be stored in this trie */
   std::unique_ptr<inst::TriggerTrie> d_tr_trie;
   /** extended model object */
@@ -0,0 +1,103 @@
+/*********************                                                        */
+/*! \file rewrite_cache.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A bounded cache for rewrites
+ **/
+
+#include "theory/rewrite_cache.h"
+
+#include <algorithm>
+
+#include "smt/smt_statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+RewriteCacheStatistics::RewriteCacheStatistics()
+    : d_hits("theory::Rewriter::cacheHits"),
+      d_misses("theory::Rewriter::cacheMisses"),
+      d_evictions("theory::Rewriter::cacheEvictions"),
+      d_size("theory::Rewriter::cacheSize", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_hits);
+  smtStatisticsRegistry()->registerStat(&d_misses);
+  smtStatisticsRegistry()->registerStat(&d_evictions);
+  smtStatisticsRegistry()->registerStat(&d_size);
+}
+
+RewriteCacheStatistics::~RewriteCacheStatistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_hits);
+  smtStatisticsRegistry()->unregisterStat(&d_misses);
+  smtStatisticsRegistry()->unregisterStat(&d_evictions);
+  smtStatisticsRegistry()->unregisterStat(&d_size);
+}
+
+RewriteCache::RewriteCache(size_t budget, RewriteCacheStatistics& stats)
+    : d_capacity(std::max<size_t>(budget / entrySize(), 1)), d_stats(stats)
+{
+}
+
+size_t RewriteCache::entrySize()
+{
+  // a list node (entry and two links), a map node (key, iterator and a link)
+  // and a bucket of the map
+  return sizeof(Entry) + 2 * sizeof(void*) + sizeof(EntryMap::value_type)
+         + 2 * sizeof(void*);
+}
+
+Node RewriteCache::get(TheoryId theoryId, bool pre, TNode node)
+{
+  EntryMap::iterator it = d_map.find(Key{node, theoryId, pre});
+  if (it == d_map.end())
+  {
+    d_stats.d_misses << theoryId;
+    return Node::null();
+  }
+  d_stats.d_hits << theoryId;
+  // move the entry to the front
+  d_entries.splice(d_entries.begin(), d_entries, it->second);
+  return it->second->d_rewritten;
+}
+
+void RewriteCache::set(TheoryId theoryId,
+                       bool pre,
+                       TNode node,
+                       TNode rewritten)
+{
+  Key key{node, theoryId, pre};
+  EntryMap::iterator it = d_map.find(key);
+  if (it != d_map.end())
+  {
+    it->second->d_rewritten = rewritten;
+    d_entries.splice(d_entries.begin(), d_entries, it->second);
+    return;
+  }
+  if (d_map.size() >= d_capacity)
+  {
+    // evict the least recently used entry
+    Entry& last = d_entries.back();
+    d_stats.d_evictions << last.d_key.d_theoryId;
+    d_map.erase(last.d_key);
+    d_entries.pop_back();
+  }
+  d_entries.push_front(Entry{key, rewritten});
+  d_map.emplace(key, d_entries.begin());
+  d_stats.d_size.setData(d_map.size());
+}
+
+void RewriteCache::clear()
+{
+  d_map.clear();
+  d_entries.clear();
+  d_stats.d_size.setData(0);
+}
+
+}  // namespace theory
+}  // namespace CVC4
@@ -0,0 +1,126 @@
+/*********************                                                        */
+/*! \file rewrite_cache.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A bounded cache for rewrites
+ **
+ ** By default, the rewriter caches rewrites in node attributes, which live as
+ ** long as the rewritten nodes. The RewriteCache is used instead when a
+ ** memory budget is given (--rewrite-cache-budget). It evicts the least
+ ** recently used rewrites once the budget is exceeded.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__REWRITE_CACHE_H
+#define CVC4__THEORY__REWRITE_CACHE_H
+
+#include <list>
+#include <unordered_map>
+
+#include "expr/node.h"
+#include "theory/theory_id.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+/** Statistics of the RewriteCache, per theory. */
+class RewriteCacheStatistics
+{
+ public:
+  RewriteCacheStatistics();
+  ~RewriteCacheStatistics();
+  /** Number of lookups that found a cached rewrite */
+  IntegralHistogramStat<TheoryId> d_hits;
+  /** Number of lookups that did not find a cached rewrite */
+  IntegralHistogramStat<TheoryId> d_misses;
+  /** Number of rewrites evicted from the RewriteCache */
+  IntegralHistogramStat<TheoryId> d_evictions;
+  /** Number of rewrites in the RewriteCache */
+  IntStat d_size;
+};
+
+/**
+ * A cache for pre- and post-rewrites with a bounded number of entries and
+ * least recently used eviction.
+ *
+ * The cache holds references to the nodes in its entries, so that the memory
+ * of the nodes kept alive by the cache is bounded as well.
+ */
+class RewriteCache
+{
+ public:
+  /**
+   * @param budget The memory budget of the cache in bytes
+   * @param stats The statistics to update
+   */
+  RewriteCache(size_t budget, RewriteCacheStatistics& stats);
+
+  /**
+   * Get the cached pre- or post-rewrite of node for the given theory, or the
+   * null node if there is none.
+   */
+  Node get(TheoryId theoryId, bool pre, TNode node);
+
+  /** Set the pre- or post-rewrite of node for the given theory. */
+  void set(TheoryId theoryId, bool pre, TNode node, TNode rewritten);
+
+  /** Remove all rewrites. */
+  void clear();
+
+  /** The number of cached rewrites. */
+  size_t size() const { return d_map.size(); }
+
+  /** The maximal number of cached rewrites. */
+  size_t capacity() const { return d_capacity; }
+
+ private:
+  struct Key
+  {
+    Node d_node;
+    TheoryId d_theoryId;
+    bool d_pre;
+    bool operator==(const Key& k) const
+    {
+      return d_node == k.d_node && d_theoryId == k.d_theoryId
+             && d_pre == k.d_pre;
+    }
+  };
+  struct KeyHashFunction
+  {
+    size_t operator()(const Key& k) const
+    {
+      return (k.d_node.getId() << 6) ^ (k.d_theoryId << 1) ^ k.d_pre;
+    }
+  };
+  struct Entry
+  {
+    Key d_key;
+    Node d_rewritten;
+  };
+  using EntryList = std::list<Entry>;
+  using EntryMap = std::unordered_map<Key, EntryList::iterator, KeyHashFunction>;
+
+  /** The estimated size of an entry in bytes */
+  static size_t entrySize();
+
+  /** The entries, most recently used first */
+  EntryList d_entries;
+  /** Maps keys to their entries */
+  EntryMap d_map;
+  /** The maximal number of entries */
+  size_t d_capacity;
+  /** The statistics */
+  RewriteCacheStatistics& d_stats;
+};
+
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__REWRITE_CACHE_H */
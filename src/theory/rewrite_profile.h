@@ -0,0 +1,268 @@
+/*********************                                                        */
+/*! \file rewrite_profile.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Per-rule profiling of theory rewriters
+ **
+ ** If --rewrite-profile is enabled, the theory rewriters record how often
+ ** each of their rules is applied, how often it succeeds and how much time
+ ** it takes, in a RewriteProfileStat per rewriter. The profiles are printed
+ ** with the other statistics.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__REWRITE_PROFILE_H
+#define CVC4__THEORY__REWRITE_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "base/check.h"
+#include "util/safe_print.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+/**
+ * A statistic that maintains the number of applications, the number of
+ * successful applications and the cumulative time of the rules of a
+ * rewriter. The rules are identified by values of the enum type Id, which
+ * must be printable and are used as indices into a vector.
+ */
+template <typename Id>
+class RewriteProfileStat : public Stat
+{
+  static_assert(std::is_enum<Id>::value, "Rules must be identified by an enum");
+
+ public:
+  RewriteProfileStat(const std::string& name) : Stat(name) {}
+
+  /** Records an application of rule that took the given time */
+  void record(Id rule, bool success, std::chrono::nanoseconds time)
+  {
+    size_t i = static_cast<size_t>(rule);
+    if (i >= d_entries.size())
+    {
+      d_entries.resize(i + 1);
+    }
+    Entry& e = d_entries[i];
+    ++e.d_applications;
+    if (success)
+    {
+      ++e.d_successes;
+    }
+    e.d_nanos += time.count();
+  }
+
+  /** Get the number of applications of rule */
+  uint64_t getApplications(Id rule) const
+  {
+    size_t i = static_cast<size_t>(rule);
+    return i < d_entries.size() ? d_entries[i].d_applications : 0;
+  }
+
+  /** Get the number of successful applications of rule */
+  uint64_t getSuccesses(Id rule) const
+  {
+    size_t i = static_cast<size_t>(rule);
+    return i < d_entries.size() ? d_entries[i].d_successes : 0;
+  }
+
+  void flushInformation(std::ostream& out) const override
+  {
+    out << "[";
+    bool first = true;
+    for (size_t i = 0, n = d_entries.size(); i < n; ++i)
+    {
+      const Entry& e = d_entries[i];
+      if (e.d_applications == 0)
+      {
+        continue;
+      }
+      if (!first)
+      {
+        out << ", ";
+      }
+      first = false;
+      out << "(" << static_cast<Id>(i) << " : applications " << e.d_applications
+          << ", successes " << e.d_successes << ", time ";
+      // the operator for timespec is hidden by the ones of this namespace
+      CVC4::operator<<(out, toTimespec(e)) << ")";
+    }
+    out << "]";
+  }
+
+  void safeFlushInformation(int fd) const override
+  {
+    safe_print(fd, "[");
+    bool first = true;
+    for (size_t i = 0, n = d_entries.size(); i < n; ++i)
+    {
+      const Entry& e = d_entries[i];
+      if (e.d_applications == 0)
+      {
+        continue;
+      }
+      if (!first)
+      {
+        safe_print(fd, ", ");
+      }
+      first = false;
+      safe_print(fd, "(");
+      safe_print<Id>(fd, static_cast<Id>(i));
+      safe_print(fd, " : applications ");
+      safe_print<uint64_t>(fd, e.d_applications);
+      safe_print(fd, ", successes ");
+      safe_print<uint64_t>(fd, e.d_successes);
+      safe_print(fd, ", time ");
+      safe_print<timespec>(fd, toTimespec(e));
+      safe_print(fd, ")");
+    }
+    safe_print(fd, "]");
+  }
+
+ private:
+  struct Entry
+  {
+    uint64_t d_applications = 0;
+    uint64_t d_successes = 0;
+    uint64_t d_nanos = 0;
+  };
+
+  static timespec toTimespec(const Entry& e)
+  {
+    timespec t;
+    t.tv_sec = e.d_nanos / 1000000000;
+    t.tv_nsec = e.d_nanos % 1000000000;
+    return t;
+  }
+
+  /** The entries, indexed by rule */
+  std::vector<Entry> d_entries;
+}; /* class RewriteProfileStat */
+
+/**
+ * Makes a profile the active profile for rules of type Id in this thread for
+ * the lifetime of this object. This is used by rewriters whose rules are
+ * static code that cannot reach the rewriter instance that owns the profile.
+ * Scopes nest, the previously active profile is restored on destruction.
+ */
+template <typename Id>
+class RewriteProfileScope
+{
+ public:
+  RewriteProfileScope(RewriteProfileStat<Id>* profile) : d_prev(s_active)
+  {
+    s_active = profile;
+  }
+  ~RewriteProfileScope() { s_active = d_prev; }
+
+  /** Get the active profile, or nullptr if rules are not profiled */
+  static RewriteProfileStat<Id>* active() { return s_active; }
+
+ private:
+  /** The previously active profile */
+  RewriteProfileStat<Id>* d_prev;
+  /** The active profile of this thread */
+  static thread_local RewriteProfileStat<Id>* s_active;
+}; /* class RewriteProfileScope */
+
+template <typename Id>
+thread_local RewriteProfileStat<Id>* RewriteProfileScope<Id>::s_active =
+    nullptr;
+
+/**
+ * Measures a single rewrite step and records it in a profile on destruction.
+ * If the profile is nullptr, this does nothing.
+ *
+ * A step is started with the rule it applies. Rewriters whose rules are only
+ * known once they fire start the step with a placeholder rule, and the rule
+ * that fires replaces it via setRule(). Steps of the same type nest, the time
+ * of a step includes that of the steps nested in it.
+ */
+template <typename Id>
+class RewriteProfileStep
+{
+ public:
+  RewriteProfileStep(RewriteProfileStat<Id>* profile, Id rule)
+      : d_profile(profile), d_prev(nullptr), d_rule(rule), d_success(false)
+  {
+    if (d_profile != nullptr)
+    {
+      d_prev = s_current;
+      s_current = this;
+      d_start = std::chrono::steady_clock::now();
+    }
+  }
+  ~RewriteProfileStep()
+  {
+    if (d_profile != nullptr)
+    {
+      s_current = d_prev;
+      d_profile->record(
+          d_rule, d_success, std::chrono::steady_clock::now() - d_start);
+    }
+  }
+
+  /** Set whether this step succeeded */
+  void setSuccess(bool success) { d_success = success; }
+
+  /**
+   * Discards this step, which must be the innermost step. This is used when
+   * a rewriter delegates the step to another rewriter that profiles it.
+   */
+  void cancel()
+  {
+    if (d_profile != nullptr)
+    {
+      Assert(s_current == this);
+      s_current = d_prev;
+      d_profile = nullptr;
+    }
+  }
+
+  /**
+   * Marks the innermost step of this thread, if any, as a successful
+   * application of rule, unless it already succeeded with another rule.
+   */
+  static void setRule(Id rule)
+  {
+    RewriteProfileStep* step = s_current;
+    if (step != nullptr && !step->d_success)
+    {
+      step->d_rule = rule;
+      step->d_success = true;
+    }
+  }
+
+ private:
+  /** The profile to record this step in */
+  RewriteProfileStat<Id>* d_profile;
+  /** The enclosing step */
+  RewriteProfileStep* d_prev;
+  /** The rule of this step */
+  Id d_rule;
+  /** Whether the rule succeeded */
+  bool d_success;
+  /** When the step started */
+  std::chrono::steady_clock::time_point d_start;
+  /** The innermost step of this thread */
+  static thread_local RewriteProfileStep* s_current;
+}; /* class RewriteProfileStep */
+
+template <typename Id>
+thread_local RewriteProfileStep<Id>* RewriteProfileStep<Id>::s_current =
+    nullptr;
+
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__REWRITE_PROFILE_H */
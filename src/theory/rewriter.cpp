@@ -23,6 +23,7 @@
 #include "smt/smt_engine_scope.h"
 #include "smt/smt_statistics_registry.h"
 #include "theory/builtin/proof_checker.h"
+#include "theory/rewrite_cache.h"
 #include "theory/rewriter_tables.h"
 #include "theory/theory.h"
 #include "util/resource_manager.h"
@@ -97,6 +98,62 @@ RewriteResponse identityRewrite(RewriteEnvironment* re, TNode n)
   return RewriteResponse(REWRITE_DONE, n);
 }
 
+Rewriter::~Rewriter() {}
+
+void Rewriter::finishInit()
+{
+  if (d_cache == nullptr && options::rewriteCacheBudget() > 0)
+  {
+    // the statistics are only maintained by the bounded cache, so that
+    // lookups in the attribute-based caches do not pay for them
+    d_cacheStats.reset(new RewriteCacheStatistics());
+    size_t budget = static_cast<size_t>(options::rewriteCacheBudget()) << 20;
+    d_cache.reset(new RewriteCache(budget, *d_cacheStats));
+    Trace("rewriter") << "Rewriter::finishInit: bounded cache with capacity "
+                      << d_cache->capacity() << std::endl;
+  }
+}
+
+Node Rewriter::getPreRewriteCache(theory::TheoryId theoryId, TNode node)
+{
+  return d_cache != nullptr ? d_cache->get(theoryId, true, node)
+                            : getPreRewriteCacheAttribute(theoryId, node);
+}
+
+Node Rewriter::getPostRewriteCache(theory::TheoryId theoryId, TNode node)
+{
+  return d_cache != nullptr ? d_cache->get(theoryId, false, node)
+                            : getPostRewriteCacheAttribute(theoryId, node);
+}
+
+void Rewriter::setPreRewriteCache(theory::TheoryId theoryId,
+                                  TNode node,
+                                  TNode cache)
+{
+  if (d_cache != nullptr)
+  {
+    Trace("rewriter") << "setting pre-rewrite of " << node << " to " << cache
+                      << std::endl;
+    d_cache->set(theoryId, true, node, cache);
+    return;
+  }
+  setPreRewriteCacheAttribute(theoryId, node, cache);
+}
+
+void Rewriter::setPostRewriteCache(theory::TheoryId theoryId,
+                                   TNode node,
+                                   TNode cache)
+{
+  if (d_cache != nullptr)
+  {
+    Trace("rewriter") << "setting rewrite of " << node << " to " << cache
+                      << std::endl;
+    d_cache->set(theoryId, false, node, cache);
+    return;
+  }
+  setPostRewriteCacheAttribute(theoryId, node, cache);
+}
+
 Node Rewriter::rewrite(TNode node) {
   if (node.getNumChildren() == 0)
   {
@@ -509,6 +566,10 @@ void Rewriter::clearCaches() {
 #endif
 
   rewriter->clearCachesInternal();
+  if (rewriter->d_cache != nullptr)
+  {
+    rewriter->d_cache->clear();
+  }
 }
 
 }/* CVC4::theory namespace */
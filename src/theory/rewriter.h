@@ -28,6 +28,8 @@ class ProofNodeManager;
 
 namespace theory {
 
+class RewriteCache;
+class RewriteCacheStatistics;
 class TrustNode;
 
 namespace builtin {
@@ -59,6 +61,14 @@ class Rewriter {
 
  public:
   Rewriter();
+  ~Rewriter();
+
+  /**
+   * Finish initialization, to be called once the options are final. This
+   * sets up the cache statistics and, if a budget is given by
+   * --rewrite-cache-budget, the bounded rewrite cache.
+   */
+  void finishInit();
 
   /**
    * Rewrites the node using theoryOf() to determine which rewriter to
@@ -169,6 +179,22 @@ class Rewriter {
   /** Sets the appropriate cache for a node */
   void setPostRewriteCache(theory::TheoryId theoryId, TNode node, TNode cache);
 
+  /** Returns the attribute-based cache for a node */
+  Node getPreRewriteCacheAttribute(theory::TheoryId theoryId, TNode node);
+
+  /** Returns the attribute-based cache for a node */
+  Node getPostRewriteCacheAttribute(theory::TheoryId theoryId, TNode node);
+
+  /** Sets the attribute-based cache for a node */
+  void setPreRewriteCacheAttribute(theory::TheoryId theoryId,
+                                   TNode node,
+                                   TNode cache);
+
+  /** Sets the attribute-based cache for a node */
+  void setPostRewriteCacheAttribute(theory::TheoryId theoryId,
+                                    TNode node,
+                                    TNode cache);
+
   /**
    * Rewrites the node using the given theory rewriter.
    */
@@ -225,6 +251,17 @@ class Rewriter {
 
   /** The proof generator */
   std::unique_ptr<TConvProofGenerator> d_tpg;
+
+  /**
+   * The statistics of the bounded rewrite cache, or nullptr if rewrites are
+   * cached in node attributes. Set by finishInit().
+   */
+  std::unique_ptr<RewriteCacheStatistics> d_cacheStats;
+  /**
+   * The bounded rewrite cache, or nullptr if rewrites are cached in node
+   * attributes.
+   */
+  std::unique_ptr<RewriteCache> d_cache;
 #ifdef CVC4_ASSERTIONS
   std::unique_ptr<std::unordered_set<Node, NodeHashFunction>> d_rewriteStack =
       nullptr;
@@ -29,7 +29,7 @@ ${rewriter_includes}
 namespace CVC4 {
 namespace theory {
 
-Node Rewriter::getPreRewriteCache(theory::TheoryId theoryId, TNode node) {
+Node Rewriter::getPreRewriteCacheAttribute(theory::TheoryId theoryId, TNode node) {
   switch(theoryId) {
 ${pre_rewrite_get_cache}
   default:
@@ -37,7 +37,7 @@ ${pre_rewrite_get_cache}
   }
 }
 
-Node Rewriter::getPostRewriteCache(theory::TheoryId theoryId, TNode node) {
+Node Rewriter::getPostRewriteCacheAttribute(theory::TheoryId theoryId, TNode node) {
   switch(theoryId) {
 ${post_rewrite_get_cache}
     default:
@@ -45,7 +45,7 @@ ${post_rewrite_get_cache}
   }
 }
 
-void Rewriter::setPreRewriteCache(theory::TheoryId theoryId, TNode node, TNode cache) {
+void Rewriter::setPreRewriteCacheAttribute(theory::TheoryId theoryId, TNode node, TNode cache) {
   switch(theoryId) {
 ${pre_rewrite_set_cache}
   default:
@@ -53,7 +53,7 @@ ${pre_rewrite_set_cache}
   }
 }
 
-void Rewriter::setPostRewriteCache(theory::TheoryId theoryId, TNode node, TNode cache) {
+void Rewriter::setPostRewriteCacheAttribute(theory::TheoryId theoryId, TNode node, TNode cache) {
   switch(theoryId) {
 ${post_rewrite_set_cache}
   default:
@@ -18,6 +18,7 @@
 #include "api/cvc4cpp.h"
 #include "smt/smt_engine.h"
 #include "smt/smt_engine_scope.h"
+#include "smt/subsolver_pool.h"
 #include "theory/rewriter.h"
 
 namespace CVC4 {
@@ -86,6 +87,18 @@ Result checkWithSubsolver(Node query,
                           std::vector<Node>& modelVals,
                           bool needsTimeout,
                           unsigned long timeout)
+{
+  std::map<std::string, std::string> opts;
+  return checkWithSubsolver(
+      query, vars, modelVals, opts, needsTimeout, timeout);
+}
+
+Result checkWithSubsolver(Node query,
+                          const std::vector<Node>& vars,
+                          std::vector<Node>& modelVals,
+                          const std::map<std::string, std::string>& opts,
+                          bool needsTimeout,
+                          unsigned long timeout)
 {
   Assert(query.getType().isBoolean());
   Assert(modelVals.empty());
@@ -104,8 +117,20 @@ Result checkWithSubsolver(Node query,
     }
     return r;
   }
-  std::unique_ptr<SmtEngine> smte;
-  initializeSubsolver(smte, needsTimeout, timeout);
+  smt::SubsolverPool* pool = smt::currentSmtEngine()->getSubsolverPool();
+  SmtEngine* smte = pool->acquire(opts, needsTimeout, timeout);
+  // gives smte back to the pool on every exit, if it is from the pool
+  smt::SubsolverPool::ReleaseGuard release(pool, smte);
+  std::unique_ptr<SmtEngine> smteOwned;
+  if (smte == nullptr)
+  {
+    initializeSubsolver(smteOwned, needsTimeout, timeout);
+    for (const std::pair<const std::string, std::string>& o : opts)
+    {
+      smteOwned->setOption(o.first, o.second);
+    }
+    smte = smteOwned.get();
+  }
   smte->assertFormula(query);
   r = smte->checkSat();
   if (r.asSatisfiabilityResult().isSat() == Result::SAT)
@@ -116,6 +141,7 @@ Result checkWithSubsolver(Node query,
       modelVals.push_back(val);
     }
   }
+  release.done();
   return r;
 }
 
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "expr/node.h"
@@ -64,7 +65,9 @@ Result checkWithSubsolver(std::unique_ptr<SmtEngine>& smte,
  * This returns the result of checking the satisfiability of formula query.
  *
  * In contrast to above, this is used if the user of this method is not
- * concerned with the state of the SMT engine after the check.
+ * concerned with the state of the SMT engine after the check. This and the
+ * methods below use a subsolver of the pool of the current SMT engine if
+ * --subsolver-pool-size is positive.
  *
  * @param query The query to check
  * @param needsTimeout Whether we would like to set a timeout
@@ -91,6 +94,24 @@ Result checkWithSubsolver(Node query,
                           bool needsTimeout = false,
                           unsigned long timeout = 0);
 
+/**
+ * As above, where the options opts are set on the subsolver, in addition to
+ * the options of the current SMT engine.
+ *
+ * @param query The query to check
+ * @param vars The variables we are interesting in getting a model for.
+ * @param modelVals A vector storing the model values of variables in vars.
+ * @param opts The options to set on the subsolver, as (name, value) pairs
+ * @param needsTimeout Whether we would like to set a timeout
+ * @param timeout The timeout (in milliseconds)
+ */
+Result checkWithSubsolver(Node query,
+                          const std::vector<Node>& vars,
+                          std::vector<Node>& modelVals,
+                          const std::map<std::string, std::string>& opts,
+                          bool needsTimeout = false,
+                          unsigned long timeout = 0);
+
 }  // namespace theory
 }  // namespace CVC4
 
@@ -0,0 +1,675 @@
+/*********************                                                        */
+/*! \file regexp_automaton.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the compilation of constant regular expressions
+ ** to automata
+ **/
+
+#include "theory/strings/regexp_automaton.h"
+
+#include <algorithm>
+#include <map>
+
+#include "theory/strings/theory_strings_utils.h"
+
+using namespace CVC4::kind;
+
+namespace CVC4 {
+namespace theory {
+namespace strings {
+
+bool RegExpDfa::accepts(const String& s, size_t start) const
+{
+  const std::vector<unsigned>& vec = s.getVec();
+  size_t numClasses = d_bounds.size() + 1;
+  uint32_t q = 0;
+  for (size_t i = start, n = vec.size(); i < n; i++)
+  {
+    if (q == d_dead)
+    {
+      return false;
+    }
+    q = d_trans[q * numClasses + getClass(vec[i])];
+  }
+  return d_accept[q];
+}
+
+bool RegExpDfa::isEmpty() const
+{
+  // the automaton is minimal, so its language is empty iff it consists of
+  // a single rejecting state
+  return d_accept.size() == 1 && !d_accept[0];
+}
+
+bool RegExpDfa::isUniversal() const
+{
+  return d_accept.size() == 1 && d_accept[0];
+}
+
+size_t RegExpDfa::getClass(unsigned c) const
+{
+  return std::upper_bound(d_bounds.begin(), d_bounds.end(), c)
+         - d_bounds.begin();
+}
+
+RegExpCompiler::RegExpCompiler(size_t maxSize)
+    : d_maxSize(maxSize), d_numClasses(1), d_cacheSize(0)
+{
+}
+
+RegExpCompiler::~RegExpCompiler() {}
+
+std::shared_ptr<const RegExpDfa> RegExpCompiler::compile(Node r)
+{
+  auto it = d_cache.find(r);
+  if (it != d_cache.end())
+  {
+    return it->second;
+  }
+  std::shared_ptr<const RegExpDfa> ret;
+  std::unordered_set<TNode, TNodeHashFunction> visited;
+  d_bounds.clear();
+  if (collectBounds(r, visited, d_bounds))
+  {
+    std::sort(d_bounds.begin(), d_bounds.end());
+    d_bounds.erase(std::unique(d_bounds.begin(), d_bounds.end()),
+                   d_bounds.end());
+    // 0 and the number of code points are not bounds between two classes
+    if (!d_bounds.empty() && d_bounds.front() == 0)
+    {
+      d_bounds.erase(d_bounds.begin());
+    }
+    if (!d_bounds.empty() && d_bounds.back() >= String::num_codes())
+    {
+      d_bounds.pop_back();
+    }
+    d_numClasses = d_bounds.size() + 1;
+    Dfa d;
+    if (build(r, d))
+    {
+      std::shared_ptr<RegExpDfa> dfa(new RegExpDfa);
+      dfa->d_bounds = d_bounds;
+      dfa->d_dead = getDeadState(d);
+      dfa->d_trans = std::move(d.d_trans);
+      dfa->d_accept = std::move(d.d_accept);
+      ret = dfa;
+    }
+    d_built.clear();
+  }
+  Trace("re-automata") << "Compile " << r << " : "
+                       << (ret ? std::to_string(ret->getNumStates()) + " states"
+                               : std::string("failed"))
+                       << std::endl;
+  if (ret != nullptr)
+  {
+    // the size of each automaton is at most d_maxSize
+    if (d_cacheSize + ret->d_trans.size() > d_maxSize)
+    {
+      clear();
+    }
+    d_cache[r] = ret;
+    d_cacheSize += ret->d_trans.size();
+  }
+  return ret;
+}
+
+int RegExpCompiler::isIntersectionEmpty(Node r1, Node r2)
+{
+  Node inter = NodeManager::currentNM()->mkNode(REGEXP_INTER, r1, r2);
+  std::shared_ptr<const RegExpDfa> dfa = compile(inter);
+  if (dfa == nullptr)
+  {
+    return -1;
+  }
+  return dfa->isEmpty() ? 1 : 0;
+}
+
+int RegExpCompiler::includes(Node r1, Node r2)
+{
+  // r1 includes r2 iff the intersection of r2 and the complement of r1 is
+  // empty
+  NodeManager* nm = NodeManager::currentNM();
+  return isIntersectionEmpty(r2, nm->mkNode(REGEXP_COMPLEMENT, r1));
+}
+
+bool RegExpCompiler::collectBounds(
+    TNode r,
+    std::unordered_set<TNode, TNodeHashFunction>& visited,
+    std::vector<unsigned>& bounds)
+{
+  if (!visited.insert(r).second)
+  {
+    return true;
+  }
+  switch (r.getKind())
+  {
+    case STRING_TO_REGEXP:
+    {
+      if (!r[0].isConst())
+      {
+        return false;
+      }
+      for (unsigned c : r[0].getConst<String>().getVec())
+      {
+        bounds.push_back(c);
+        bounds.push_back(c + 1);
+      }
+      return true;
+    }
+    case REGEXP_RANGE:
+    {
+      for (const Node& b : r)
+      {
+        if (!b.isConst() || b.getConst<String>().size() != 1)
+        {
+          return false;
+        }
+      }
+      bounds.push_back(r[0].getConst<String>().front());
+      bounds.push_back(r[1].getConst<String>().front() + 1);
+      return true;
+    }
+    case REGEXP_SIGMA:
+    case REGEXP_EMPTY: return true;
+    case REGEXP_CONCAT:
+    case REGEXP_UNION:
+    case REGEXP_INTER:
+    case REGEXP_DIFF:
+    case REGEXP_STAR:
+    case REGEXP_PLUS:
+    case REGEXP_OPT:
+    case REGEXP_COMPLEMENT:
+    case REGEXP_LOOP:
+    case REGEXP_REPEAT:
+    {
+      for (const Node& rc : r)
+      {
+        if (!collectBounds(rc, visited, bounds))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    default: return false;
+  }
+}
+
+size_t RegExpCompiler::getClass(unsigned c) const
+{
+  return std::upper_bound(d_bounds.begin(), d_bounds.end(), c)
+         - d_bounds.begin();
+}
+
+bool RegExpCompiler::build(TNode r, Dfa& d)
+{
+  auto it = d_built.find(r);
+  if (it != d_built.end())
+  {
+    d = it->second;
+    return true;
+  }
+  Kind k = r.getKind();
+  switch (k)
+  {
+    case STRING_TO_REGEXP:
+    {
+      const std::vector<unsigned>& w = r[0].getConst<String>().getVec();
+      if (tooLarge(w.size() + 2))
+      {
+        return false;
+      }
+      mkWord(w, d);
+      break;
+    }
+    case REGEXP_RANGE:
+    {
+      unsigned a = r[0].getConst<String>().front();
+      unsigned b = r[1].getConst<String>().front();
+      if (a > b)
+      {
+        mkEmptyOrEpsilon(false, d);
+      }
+      else
+      {
+        mkClassRange(getClass(a), getClass(b), d);
+      }
+      break;
+    }
+    case REGEXP_SIGMA: mkClassRange(0, d_numClasses - 1, d); break;
+    case REGEXP_EMPTY: mkEmptyOrEpsilon(false, d); break;
+    case REGEXP_CONCAT:
+    case REGEXP_UNION:
+    case REGEXP_INTER:
+    {
+      if (!build(r[0], d))
+      {
+        return false;
+      }
+      for (size_t i = 1, nchild = r.getNumChildren(); i < nchild; i++)
+      {
+        Dfa b, res;
+        if (!build(r[i], b)
+            || !(k == REGEXP_CONCAT ? mkConcat(d, b, res)
+                                    : mkProduct(d, b, k == REGEXP_INTER, res)))
+        {
+          return false;
+        }
+        d = std::move(res);
+      }
+      break;
+    }
+    case REGEXP_DIFF:
+    {
+      Dfa a, b;
+      if (!build(r[0], a) || !build(r[1], b))
+      {
+        return false;
+      }
+      b.d_accept.flip();
+      if (!mkProduct(a, b, true, d))
+      {
+        return false;
+      }
+      break;
+    }
+    case REGEXP_COMPLEMENT:
+    {
+      if (!build(r[0], d))
+      {
+        return false;
+      }
+      // the automata are complete and minimal, hence so is the complement
+      d.d_accept.flip();
+      break;
+    }
+    case REGEXP_STAR:
+    case REGEXP_PLUS:
+    case REGEXP_OPT:
+    {
+      Dfa a;
+      if (!build(r[0], a))
+      {
+        return false;
+      }
+      if (k == REGEXP_OPT)
+      {
+        Dfa eps;
+        mkEmptyOrEpsilon(true, eps);
+        if (!mkProduct(a, eps, false, d))
+        {
+          return false;
+        }
+      }
+      else if (k == REGEXP_STAR)
+      {
+        if (!mkStar(a, d))
+        {
+          return false;
+        }
+      }
+      else
+      {
+        Dfa s;
+        if (!mkStar(a, s) || !mkConcat(a, s, d))
+        {
+          return false;
+        }
+      }
+      break;
+    }
+    case REGEXP_LOOP:
+    case REGEXP_REPEAT:
+    {
+      unsigned lo, hi;
+      if (k == REGEXP_LOOP)
+      {
+        lo = utils::getLoopMinOccurrences(r);
+        hi = utils::getLoopMaxOccurrences(r);
+      }
+      else
+      {
+        lo = utils::getRepeatAmount(r);
+        hi = lo;
+      }
+      if (hi > d_maxSize)
+      {
+        // too many copies to be worth unrolling
+        return false;
+      }
+      Dfa a, opt;
+      if (!build(r[0], a))
+      {
+        return false;
+      }
+      // r^lo (r | "")^(hi - lo)
+      mkEmptyOrEpsilon(true, d);
+      if (hi > lo)
+      {
+        Dfa eps;
+        mkEmptyOrEpsilon(true, eps);
+        if (!mkProduct(a, eps, false, opt))
+        {
+          return false;
+        }
+      }
+      for (unsigned i = 0; i < hi; i++)
+      {
+        Dfa res;
+        if (!mkConcat(d, i < lo ? a : opt, res))
+        {
+          return false;
+        }
+        d = std::move(res);
+      }
+      break;
+    }
+    default:
+      Unhandled() << "Unexpected regular expression " << r;
+      break;
+  }
+  d_built[r] = d;
+  return true;
+}
+
+void RegExpCompiler::mkWord(const std::vector<unsigned>& w, Dfa& d)
+{
+  // states 0 ... n read the word, n + 1 is the dead state
+  size_t n = w.size();
+  uint32_t dead = n + 1;
+  d.d_trans.assign((n + 2) * d_numClasses, dead);
+  d.d_accept.assign(n + 2, false);
+  d.d_accept[n] = true;
+  for (size_t i = 0; i < n; i++)
+  {
+    d.d_trans[i * d_numClasses + getClass(w[i])] = i + 1;
+  }
+}
+
+void RegExpCompiler::mkClassRange(size_t lo, size_t hi, Dfa& d)
+{
+  // state 0 is initial, 1 is accepting, 2 is dead
+  d.d_trans.assign(3 * d_numClasses, 2);
+  d.d_accept = {false, true, false};
+  for (size_t c = lo; c <= hi; c++)
+  {
+    d.d_trans[c] = 1;
+  }
+}
+
+void RegExpCompiler::mkEmptyOrEpsilon(bool accept, Dfa& d)
+{
+  if (accept)
+  {
+    d.d_trans.assign(2 * d_numClasses, 1);
+    d.d_accept = {true, false};
+  }
+  else
+  {
+    d.d_trans.assign(d_numClasses, 0);
+    d.d_accept = {false};
+  }
+}
+
+bool RegExpCompiler::mkProduct(const Dfa& a,
+                               const Dfa& b,
+                               bool isInter,
+                               Dfa& d)
+{
+  d.d_trans.clear();
+  d.d_accept.clear();
+  uint64_t nb = b.size();
+  std::unordered_map<uint64_t, uint32_t> ids;
+  std::vector<uint64_t> pairs;
+  ids[0] = 0;
+  pairs.push_back(0);
+  for (size_t i = 0; i < pairs.size(); i++)
+  {
+    uint32_t qa = pairs[i] / nb;
+    uint32_t qb = pairs[i] % nb;
+    d.d_accept.push_back(isInter ? a.d_accept[qa] && b.d_accept[qb]
+                                 : a.d_accept[qa] || b.d_accept[qb]);
+    for (size_t c = 0; c < d_numClasses; c++)
+    {
+      uint64_t p = a.d_trans[qa * d_numClasses + c] * nb
+                   + b.d_trans[qb * d_numClasses + c];
+      auto it = ids.find(p);
+      if (it == ids.end())
+      {
+        if (tooLarge(pairs.size() + 1))
+        {
+          return false;
+        }
+        it = ids.emplace(p, pairs.size()).first;
+        pairs.push_back(p);
+      }
+      d.d_trans.push_back(it->second);
+    }
+  }
+  minimize(d);
+  return true;
+}
+
+bool RegExpCompiler::mkConcat(const Dfa& a, const Dfa& b, Dfa& d)
+{
+  // A state is a state of a and the set of states of b reached after a
+  // prefix was accepted by a, without the dead state of b.
+  d.d_trans.clear();
+  d.d_accept.clear();
+  uint32_t deadB = getDeadState(b);
+  std::map<std::vector<uint32_t>, uint32_t> ids;
+  std::vector<std::vector<uint32_t>> sets;
+  auto mkState = [&](uint32_t qa, std::vector<uint32_t>& qbs) {
+    if (a.d_accept[qa])
+    {
+      qbs.push_back(0);
+    }
+    std::sort(qbs.begin(), qbs.end());
+    qbs.erase(std::unique(qbs.begin(), qbs.end()), qbs.end());
+    qbs.erase(std::remove(qbs.begin(), qbs.end(), deadB), qbs.end());
+    qbs.insert(qbs.begin(), qa);
+  };
+  std::vector<uint32_t> init;
+  mkState(0, init);
+  ids[init] = 0;
+  sets.push_back(init);
+  for (size_t i = 0; i < sets.size(); i++)
+  {
+    bool accept = false;
+    for (size_t j = 1, n = sets[i].size(); j < n; j++)
+    {
+      accept = accept || b.d_accept[sets[i][j]];
+    }
+    d.d_accept.push_back(accept);
+    for (size_t c = 0; c < d_numClasses; c++)
+    {
+      const std::vector<uint32_t>& s = sets[i];
+      std::vector<uint32_t> next;
+      for (size_t j = 1, n = s.size(); j < n; j++)
+      {
+        next.push_back(b.d_trans[s[j] * d_numClasses + c]);
+      }
+      mkState(a.d_trans[s[0] * d_numClasses + c], next);
+      auto it = ids.find(next);
+      if (it == ids.end())
+      {
+        if (tooLarge(sets.size() + 1))
+        {
+          return false;
+        }
+        it = ids.emplace(next, sets.size()).first;
+        sets.push_back(next);
+      }
+      d.d_trans.push_back(it->second);
+    }
+  }
+  minimize(d);
+  return true;
+}
+
+bool RegExpCompiler::mkStar(const Dfa& a, Dfa& d)
+{
+  // A state is a set of states of a, without the dead state of a, and a flag
+  // for the initial state, which accepts the empty string. When a state of
+  // the set is accepting, the initial state of a is added to it.
+  d.d_trans.clear();
+  d.d_accept.clear();
+  uint32_t deadA = getDeadState(a);
+  std::map<std::vector<uint32_t>, uint32_t> ids;
+  std::vector<std::vector<uint32_t>> sets;
+  std::vector<uint32_t> init = {1, 0};
+  ids[init] = 0;
+  sets.push_back(init);
+  for (size_t i = 0; i < sets.size(); i++)
+  {
+    bool accept = sets[i][0] == 1;
+    for (size_t j = 1, n = sets[i].size(); j < n; j++)
+    {
+      accept = accept || a.d_accept[sets[i][j]];
+    }
+    d.d_accept.push_back(accept);
+    for (size_t c = 0; c < d_numClasses; c++)
+    {
+      const std::vector<uint32_t>& s = sets[i];
+      std::vector<uint32_t> next;
+      bool hasAccept = false;
+      for (size_t j = 1, n = s.size(); j < n; j++)
+      {
+        uint32_t q = a.d_trans[s[j] * d_numClasses + c];
+        if (q != deadA)
+        {
+          next.push_back(q);
+          hasAccept = hasAccept || a.d_accept[q];
+        }
+      }
+      if (hasAccept)
+      {
+        next.push_back(0);
+      }
+      std::sort(next.begin(), next.end());
+      next.erase(std::unique(next.begin(), next.end()), next.end());
+      next.insert(next.begin(), 0);
+      auto it = ids.find(next);
+      if (it == ids.end())
+      {
+        if (tooLarge(sets.size() + 1))
+        {
+          return false;
+        }
+        it = ids.emplace(next, sets.size()).first;
+        sets.push_back(next);
+      }
+      d.d_trans.push_back(it->second);
+    }
+  }
+  minimize(d);
+  return true;
+}
+
+void RegExpCompiler::minimize(Dfa& d)
+{
+  // Moore's algorithm: refine the partition of the states by acceptance until
+  // the successors of all states of a block are in the same blocks. All states
+  // are reachable from the initial state by construction.
+  size_t n = d.size();
+  std::vector<uint32_t> part(n);
+  size_t numBlocks = 0;
+  bool hasBlock[2] = {false, false};
+  for (size_t q = 0; q < n; q++)
+  {
+    part[q] = d.d_accept[q] ? 1 : 0;
+    if (!hasBlock[part[q]])
+    {
+      hasBlock[part[q]] = true;
+      numBlocks++;
+    }
+  }
+  std::vector<uint32_t> next(n);
+  while (true)
+  {
+    // block ids are assigned in order of their first state, so that the
+    // block of the initial state is 0
+    std::map<std::vector<uint32_t>, uint32_t> ids;
+    std::vector<uint32_t> sig(d_numClasses + 1);
+    for (size_t q = 0; q < n; q++)
+    {
+      sig[0] = part[q];
+      for (size_t c = 0; c < d_numClasses; c++)
+      {
+        sig[c + 1] = part[d.d_trans[q * d_numClasses + c]];
+      }
+      next[q] = ids.emplace(sig, ids.size()).first->second;
+    }
+    part.swap(next);
+    if (ids.size() == numBlocks)
+    {
+      // the signatures refine the partition, so it is stable
+      break;
+    }
+    numBlocks = ids.size();
+  }
+  if (numBlocks == n && part[0] == 0)
+  {
+    bool identity = true;
+    for (size_t q = 0; q < n && identity; q++)
+    {
+      identity = part[q] == q;
+    }
+    if (identity)
+    {
+      return;
+    }
+  }
+  Dfa res;
+  res.d_trans.resize(numBlocks * d_numClasses);
+  res.d_accept.resize(numBlocks);
+  std::vector<bool> done(numBlocks, false);
+  for (size_t q = 0; q < n; q++)
+  {
+    uint32_t b = part[q];
+    if (done[b])
+    {
+      continue;
+    }
+    done[b] = true;
+    res.d_accept[b] = d.d_accept[q];
+    for (size_t c = 0; c < d_numClasses; c++)
+    {
+      res.d_trans[b * d_numClasses + c] = part[d.d_trans[q * d_numClasses + c]];
+    }
+  }
+  d = std::move(res);
+}
+
+uint32_t RegExpCompiler::getDeadState(const Dfa& d) const
+{
+  // in a minimal automaton, the dead state is the unique rejecting state
+  // whose successors are all itself
+  for (uint32_t q = 0, n = d.size(); q < n; q++)
+  {
+    if (d.d_accept[q])
+    {
+      continue;
+    }
+    bool dead = true;
+    for (size_t c = 0; c < d_numClasses && dead; c++)
+    {
+      dead = d.d_trans[q * d_numClasses + c] == q;
+    }
+    if (dead)
+    {
+      return q;
+    }
+  }
+  return RegExpDfa::NO_STATE;
+}
+
+}  // namespace strings
+}  // namespace theory
+}  // namespace CVC4
@@ -0,0 +1,173 @@
+/*********************                                                        */
+/*! \file regexp_automaton.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Compilation of constant regular expressions to automata
+ **
+ ** Constant regular expressions are compiled to minimal deterministic finite
+ ** automata, which decide membership of constant strings in linear time, and
+ ** emptiness (and hence intersection emptiness and inclusion) exactly. The
+ ** alphabet of an automaton is the partition of the code points into the
+ ** classes that no character or range of the regular expression distinguishes.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef CVC4__THEORY__STRINGS__REGEXP_AUTOMATON_H
+#define CVC4__THEORY__STRINGS__REGEXP_AUTOMATON_H
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "expr/node.h"
+#include "util/string.h"
+
+namespace CVC4 {
+namespace theory {
+namespace strings {
+
+/**
+ * A complete, minimal deterministic finite automaton over the character
+ * classes of a constant regular expression. The initial state is 0.
+ */
+class RegExpDfa
+{
+  friend class RegExpCompiler;
+
+ public:
+  /** Does this automaton accept the suffix of s that starts at index start? */
+  bool accepts(const String& s, size_t start = 0) const;
+  /** Is the language of this automaton empty? */
+  bool isEmpty() const;
+  /** Does the language of this automaton contain every string? */
+  bool isUniversal() const;
+  /** Get the number of states */
+  size_t getNumStates() const { return d_accept.size(); }
+
+ private:
+  RegExpDfa() : d_dead(NO_STATE) {}
+  /** Marker for the absence of a state */
+  static const uint32_t NO_STATE = static_cast<uint32_t>(-1);
+  /** Get the class of character c */
+  size_t getClass(unsigned c) const;
+  /**
+   * The lower bounds of the character classes but the first, in increasing
+   * order. Class i consists of the code points in [d_bounds[i-1],
+   * d_bounds[i]).
+   */
+  std::vector<unsigned> d_bounds;
+  /** The transitions, d_trans[q * numClasses + c] is the successor of q on c */
+  std::vector<uint32_t> d_trans;
+  /** Whether each state is accepting */
+  std::vector<bool> d_accept;
+  /** The state from which no state is accepting, or NO_STATE */
+  uint32_t d_dead;
+};
+
+/**
+ * Compiles constant regular expressions to RegExpDfa and caches the results.
+ * Compilation fails if the regular expression is not constant, or if the
+ * transition table of an intermediate automaton exceeds the given size, in
+ * which case callers fall back to reasoning on the regular expression itself.
+ * Failures are not cached, and the cache is cleared whenever the transition
+ * tables of the cached automata would exceed the given size in total.
+ */
+class RegExpCompiler
+{
+ public:
+  RegExpCompiler(size_t maxSize);
+  ~RegExpCompiler();
+
+  /**
+   * Get the automaton for constant regular expression r, or nullptr if r
+   * cannot be compiled.
+   */
+  std::shared_ptr<const RegExpDfa> compile(Node r);
+
+  /**
+   * Returns 1 if the intersection of the regular expressions r1 and r2 is
+   * empty, 0 if it is not, and -1 if this cannot be determined by
+   * compilation.
+   */
+  int isIntersectionEmpty(Node r1, Node r2);
+  /**
+   * Returns 1 if the language of r1 includes the language of r2, 0 if it
+   * does not, and -1 if this cannot be determined by compilation.
+   */
+  int includes(Node r1, Node r2);
+
+  /** Clear the cache of compiled automata */
+  void clear()
+  {
+    d_cache.clear();
+    d_cacheSize = 0;
+  }
+
+ private:
+  /** An automaton under construction, over d_numClasses classes */
+  struct Dfa
+  {
+    std::vector<uint32_t> d_trans;
+    std::vector<bool> d_accept;
+    size_t size() const { return d_accept.size(); }
+  };
+  /**
+   * Collects the bounds of the character classes of r in bounds. Returns
+   * false if r is not a constant regular expression.
+   */
+  static bool collectBounds(TNode r,
+                            std::unordered_set<TNode, TNodeHashFunction>& visited,
+                            std::vector<unsigned>& bounds);
+  /** Get the class of character c */
+  size_t getClass(unsigned c) const;
+  /** Builds the automaton for r, returns false if it is too large */
+  bool build(TNode r, Dfa& d);
+  /** Automaton for the given word */
+  void mkWord(const std::vector<unsigned>& w, Dfa& d);
+  /** Automaton for the single characters in the classes [lo, hi] */
+  void mkClassRange(size_t lo, size_t hi, Dfa& d);
+  /** Automaton for the empty language (accept = false) or epsilon */
+  void mkEmptyOrEpsilon(bool accept, Dfa& d);
+  /** Product automaton, for intersection if isInter, otherwise for union */
+  bool mkProduct(const Dfa& a, const Dfa& b, bool isInter, Dfa& d);
+  /** Automaton for the concatenation of a and b */
+  bool mkConcat(const Dfa& a, const Dfa& b, Dfa& d);
+  /** Automaton for the Kleene star of a */
+  bool mkStar(const Dfa& a, Dfa& d);
+  /** Minimizes d in place */
+  void minimize(Dfa& d);
+  /** Get the dead state of d, or RegExpDfa::NO_STATE */
+  uint32_t getDeadState(const Dfa& d) const;
+  /** Is the transition table of an automaton with numStates states too large? */
+  bool tooLarge(size_t numStates) const
+  {
+    return numStates * d_numClasses > d_maxSize;
+  }
+
+  /** The maximal number of transitions of an automaton */
+  size_t d_maxSize;
+  /** The class bounds of the regular expression being compiled */
+  std::vector<unsigned> d_bounds;
+  /** The number of classes of the regular expression being compiled */
+  size_t d_numClasses;
+  /** The automata of the subterms of the regular expression being compiled */
+  std::unordered_map<Node, Dfa, NodeHashFunction> d_built;
+  /** The compiled automata */
+  std::unordered_map<Node, std::shared_ptr<const RegExpDfa>, NodeHashFunction>
+      d_cache;
+  /** The number of transitions of the automata in d_cache */
+  size_t d_cacheSize;
+};
+
+}  // namespace strings
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* CVC4__THEORY__STRINGS__REGEXP_AUTOMATON_H */
@@ -40,6 +40,7 @@ RegExpOpr::RegExpOpr(SkolemCache* sc)
                                                std::vector<Node>{})),
       d_sigma_star(
           NodeManager::currentNM()->mkNode(kind::REGEXP_STAR, d_sigma)),
+      d_compiler(options::stringRegExpAutomataMaxSize()),
       d_sc(sc)
 {
   d_emptyString = Word::mkEmptyWord(NodeManager::currentNM()->stringType());
@@ -1563,10 +1564,23 @@ bool RegExpOpr::regExpIncludes(Node r1, Node r2)
     return (*it).second;
   }
   bool result = RegExpEntail::regExpIncludes(r1, r2);
+  if (!result && options::stringRegExpAutomata())
+  {
+    result = d_compiler.includes(r1, r2) == 1;
+  }
   d_inclusionCache[std::make_pair(r1, r2)] = result;
   return result;
 }
 
+bool RegExpOpr::isIntersectionEmpty(Node r1, Node r2)
+{
+  if (!options::stringRegExpAutomata())
+  {
+    return false;
+  }
+  return d_compiler.isIntersectionEmpty(r1, r2) == 1;
+}
+
 /**
  * Associating formulas with their "exists form", or an existentially
  * quantified formula that is equivalent to it. This is currently used
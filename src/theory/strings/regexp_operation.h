@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "expr/node.h"
+#include "theory/strings/regexp_automaton.h"
 #include "theory/strings/skolem_cache.h"
 #include "util/string.h"
 
@@ -84,6 +85,8 @@ class RegExpOpr {
   std::map<PairNodes, Node> d_inter_cache;
   std::map<Node, std::vector<PairNodes> > d_split_cache;
   std::map<PairNodes, bool> d_inclusionCache;
+  /** Compiles constant regular expressions to automata */
+  RegExpCompiler d_compiler;
   /**
    * Helper function for mkString, pretty prints constant or variable regular
    * expression r.
@@ -189,6 +192,12 @@ class RegExpOpr {
    * for performance reasons.
    */
   bool regExpIncludes(Node r1, Node r2);
+  /**
+   * Returns true if we can show that the intersection of the regular
+   * expressions `r1` and `r2` is empty, by compiling them to automata if they
+   * are constant.
+   */
+  bool isIntersectionEmpty(Node r1, Node r2);
 
  private:
   /**
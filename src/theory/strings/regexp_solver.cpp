@@ -471,7 +471,10 @@ bool RegExpSolver::checkEqcIntersect(const std::vector<Node>& mems)
       rcti = rct;
       continue;
     }
-    Node resR = d_regexp_opr.intersect(mi[1], m[1]);
+    // the automata decide emptiness without computing the intersection
+    Node resR = d_regexp_opr.isIntersectionEmpty(mi[1], m[1])
+                    ? d_emptyRegexp
+                    : d_regexp_opr.intersect(mi[1], m[1]);
     // intersection should be computable
     Assert(!resR.isNull());
     if (resR == d_emptyRegexp)
@@ -24,6 +24,7 @@ const char* toString(Rewrite r)
 {
   switch (r)
   {
+    case Rewrite::NONE: return "NONE";
     case Rewrite::CTN_COMPONENT: return "CTN_COMPONENT";
     case Rewrite::CTN_CONCAT_CHAR: return "CTN_CONCAT_CHAR";
     case Rewrite::CTN_CONST: return "CTN_CONST";
@@ -29,6 +29,7 @@ namespace strings {
  */
 enum class Rewrite : uint32_t
 {
+  NONE,
   CTN_COMPONENT,
   CTN_CONCAT_CHAR,
   CTN_CONST,
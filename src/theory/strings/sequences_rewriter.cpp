@@ -19,6 +19,7 @@
 #include "expr/attribute.h"
 #include "expr/node_builder.h"
 #include "expr/sequence.h"
+#include "options/strings_options.h"
 #include "theory/rewriter.h"
 #include "theory/strings/arith_entail.h"
 #include "theory/strings/regexp_entail.h"
@@ -33,8 +34,12 @@ namespace CVC4 {
 namespace theory {
 namespace strings {
 
-SequencesRewriter::SequencesRewriter(HistogramStat<Rewrite>* statistics)
-    : d_statistics(statistics), d_stringsEntail(*this)
+SequencesRewriter::SequencesRewriter(HistogramStat<Rewrite>* statistics,
+                                     RewriteProfileStat<Rewrite>* ruleProfile)
+    : d_statistics(statistics),
+      d_ruleProfile(ruleProfile),
+      d_reCompiler(options::stringRegExpAutomataMaxSize()),
+      d_stringsEntail(*this)
 {
 }
 
@@ -1142,7 +1147,14 @@ Node SequencesRewriter::rewriteMembership(TNode node)
   {
     // test whether x in node[1]
     CVC4::String s = x.getConst<String>();
-    bool test = RegExpEntail::testConstStringInRegExp(s, 0, r);
+    std::shared_ptr<const RegExpDfa> dfa;
+    if (options::stringRegExpAutomata())
+    {
+      dfa = d_reCompiler.compile(r);
+    }
+    bool test = dfa != nullptr
+                    ? dfa->accepts(s)
+                    : RegExpEntail::testConstStringInRegExp(s, 0, r);
     Node retNode = NodeManager::currentNM()->mkConst(test);
     return returnRewrite(node, retNode, Rewrite::RE_IN_EVAL);
   }
@@ -1387,6 +1399,7 @@ Node SequencesRewriter::rewriteMembership(TNode node)
 
 RewriteResponse SequencesRewriter::postRewrite(TNode node)
 {
+  RewriteProfileStep<Rewrite> step(d_ruleProfile, Rewrite::NONE);
   Trace("sequences-postrewrite")
       << "Strings::SequencesRewriter::postRewrite start " << node << std::endl;
   Node retNode = node;
@@ -1503,6 +1516,7 @@ RewriteResponse SequencesRewriter::postRewrite(TNode node)
   {
     Trace("strings-rewrite-debug") << "Strings::SequencesRewriter::postRewrite "
                                    << node << " to " << retNode << std::endl;
+    step.setSuccess(true);
     return RewriteResponse(REWRITE_AGAIN_FULL, retNode);
   }
   Trace("strings-rewrite-nf") << "No rewrites for : " << node << std::endl;
@@ -3352,6 +3366,7 @@ Node SequencesRewriter::returnRewrite(Node node, Node ret, Rewrite r)
   {
     (*d_statistics) << r;
   }
+  RewriteProfileStep<Rewrite>::setRule(r);
 
   // standard post-processing
   // We rewrite (string) equalities immediately here. This allows us to forego
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "expr/node.h"
+#include "theory/strings/regexp_automaton.h"
 #include "theory/strings/rewrites.h"
 #include "theory/strings/sequences_stats.h"
 #include "theory/strings/strings_entail.h"
@@ -33,7 +34,8 @@ namespace strings {
 class SequencesRewriter : public TheoryRewriter
 {
  public:
-  SequencesRewriter(HistogramStat<Rewrite>* statistics);
+  SequencesRewriter(HistogramStat<Rewrite>* statistics,
+                    RewriteProfileStat<Rewrite>* ruleProfile = nullptr);
 
  protected:
   /** rewrite regular expression concatenation
@@ -289,6 +291,10 @@ class SequencesRewriter : public TheoryRewriter
 
   /** Reference to the rewriter statistics. */
   HistogramStat<Rewrite>* d_statistics;
+  /** The profile of the rewrites, or nullptr if they are not profiled */
+  RewriteProfileStat<Rewrite>* d_ruleProfile;
+  /** Compiles the constant regular expressions of memberships */
+  RegExpCompiler d_reCompiler;
 
   /** Instance of the entailment checker for strings. */
   StringsEntail d_stringsEntail;
@@ -15,6 +15,7 @@
 
 #include "theory/strings/sequences_stats.h"
 
+#include "options/theory_options.h"
 #include "smt/smt_statistics_registry.h"
 
 namespace CVC4 {
@@ -30,6 +31,7 @@ SequencesStatistics::SequencesStatistics()
       d_regexpUnfoldingsPos("theory::strings::regexpUnfoldingsPos"),
       d_regexpUnfoldingsNeg("theory::strings::regexpUnfoldingsNeg"),
       d_rewrites("theory::strings::rewrites"),
+      d_ruleProfile("theory::strings::ruleProfile"),
       d_conflictsEqEngine("theory::strings::conflictsEqEngine", 0),
       d_conflictsEager("theory::strings::conflictsEager", 0),
       d_conflictsInfer("theory::strings::conflictsInfer", 0),
@@ -56,6 +58,10 @@ SequencesStatistics::SequencesStatistics()
   smtStatisticsRegistry()->registerStat(&d_lemmasRegisterTerm);
   smtStatisticsRegistry()->registerStat(&d_lemmasRegisterTermAtomic);
   smtStatisticsRegistry()->registerStat(&d_lemmasInfer);
+  if (options::rewriteProfile())
+  {
+    smtStatisticsRegistry()->registerStat(&d_ruleProfile);
+  }
 }
 
 SequencesStatistics::~SequencesStatistics()
@@ -76,6 +82,10 @@ SequencesStatistics::~SequencesStatistics()
   smtStatisticsRegistry()->unregisterStat(&d_lemmasRegisterTerm);
   smtStatisticsRegistry()->unregisterStat(&d_lemmasRegisterTermAtomic);
   smtStatisticsRegistry()->unregisterStat(&d_lemmasInfer);
+  if (options::rewriteProfile())
+  {
+    smtStatisticsRegistry()->unregisterStat(&d_ruleProfile);
+  }
 }
 
 }
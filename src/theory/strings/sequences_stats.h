@@ -19,6 +19,7 @@
 
 #include "expr/kind.h"
 #include "theory/strings/infer_info.h"
+#include "theory/rewrite_profile.h"
 #include "theory/strings/rewrites.h"
 #include "util/statistics_registry.h"
 
@@ -89,6 +90,12 @@ class SequencesStatistics
   //--------------- end of inferences
   /** Counts the number of applications of each type of rewrite rule */
   HistogramStat<Rewrite> d_rewrites;
+  /**
+   * The profile of the rewrites, which is registered and maintained only if
+   * --rewrite-profile is enabled. Rewrite steps that do not end in one of the
+   * rewrites of Rewrite are recorded as Rewrite::NONE.
+   */
+  RewriteProfileStat<Rewrite> d_ruleProfile;
   //--------------- conflicts, partition of calls to OutputChannel::conflict
   /** Number of equality engine conflicts */
   IntStat d_conflictsEqEngine;
@@ -25,13 +25,15 @@ namespace CVC4 {
 namespace theory {
 namespace strings {
 
-StringsRewriter::StringsRewriter(HistogramStat<Rewrite>* statistics)
-    : SequencesRewriter(statistics)
+StringsRewriter::StringsRewriter(HistogramStat<Rewrite>* statistics,
+                                 RewriteProfileStat<Rewrite>* ruleProfile)
+    : SequencesRewriter(statistics, ruleProfile)
 {
 }
 
 RewriteResponse StringsRewriter::postRewrite(TNode node)
 {
+  RewriteProfileStep<Rewrite> step(d_ruleProfile, Rewrite::NONE);
   Trace("strings-postrewrite")
       << "Strings::StringsRewriter::postRewrite start " << node << std::endl;
 
@@ -71,6 +73,8 @@ RewriteResponse StringsRewriter::postRewrite(TNode node)
   }
   else
   {
+    // profiled by SequencesRewriter
+    step.cancel();
     return SequencesRewriter::postRewrite(node);
   }
 
@@ -81,6 +85,7 @@ RewriteResponse StringsRewriter::postRewrite(TNode node)
   {
     Trace("strings-rewrite-debug") << "Strings::StringsRewriter::postRewrite "
                                    << node << " to " << retNode << std::endl;
+    step.setSuccess(true);
     return RewriteResponse(REWRITE_AGAIN_FULL, retNode);
   }
   return RewriteResponse(REWRITE_DONE, retNode);
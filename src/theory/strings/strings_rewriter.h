@@ -32,7 +32,8 @@ namespace strings {
 class StringsRewriter : public SequencesRewriter
 {
  public:
-  StringsRewriter(HistogramStat<Rewrite>* statistics);
+  StringsRewriter(HistogramStat<Rewrite>* statistics,
+                  RewriteProfileStat<Rewrite>* ruleProfile = nullptr);
 
   RewriteResponse postRewrite(TNode node) override;
 
@@ -51,7 +51,9 @@ TheoryStrings::TheoryStrings(context::Context* c,
       d_extTheoryCb(),
       d_extTheory(d_extTheoryCb, c, u, out),
       d_im(*this, d_state, d_termReg, d_extTheory, d_statistics, pnm),
-      d_rewriter(&d_statistics.d_rewrites),
+      d_rewriter(&d_statistics.d_rewrites,
+                 options::rewriteProfile() ? &d_statistics.d_ruleProfile
+                                           : nullptr),
       d_bsolver(d_state, d_im),
       d_csolver(d_state, d_im, d_termReg, d_bsolver),
       d_esolver(d_state,
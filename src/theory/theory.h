@@ -140,8 +140,11 @@ class Theory {
   std::string d_instanceName;
 
   // === STATISTICS ===
-  /** time spent in check calls */
-  TimerStat d_checkTime;
+  /**
+   * time spent in check calls, which are too frequent to read the clock for
+   * each of them
+   */
+  SampledTimerStat d_checkTime;
   /** time spent in theory combination */
   TimerStat d_computeCareGraphTime;
 
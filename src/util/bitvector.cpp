@@ -11,35 +11,136 @@
  **
  ** \brief A fixed-size bit-vector.
  **
- ** A fixed-size bit-vector, implemented as a wrapper around Integer.
+ ** A fixed-size bit-vector. Bit-vectors of size at most 64 are implemented as
+ ** a machine word, larger bit-vectors as a wrapper around Integer.
  **
  ** \todo document this file
  **/
 
 #include "util/bitvector.h"
 
+#include <functional>
+#include <limits>
+
 #include "base/exception.h"
 
 namespace CVC4 {
 
+namespace {
+
+/** Convert z to an Integer, independently of the size of long */
+Integer wordToInteger(uint64_t z)
+{
+  if (z <= std::numeric_limits<unsigned long>::max())
+  {
+    return Integer(static_cast<unsigned long>(z));
+  }
+  return Integer(static_cast<unsigned long>(z >> 32)).multiplyByPow2(32)
+         + Integer(static_cast<unsigned long>(z & 0xffffffff));
+}
+
+/** Convert val, which must be in [0, 2^64), to a word */
+uint64_t integerToWord(const Integer& val)
+{
+  if (val.fitsUnsignedLong())
+  {
+    return val.getUnsignedLong();
+  }
+  return (static_cast<uint64_t>(val.divByPow2(32).getUnsignedLong()) << 32)
+         | val.modByPow2(32).getUnsignedLong();
+}
+
+/** Shift z left by n, which may be the size of a word */
+uint64_t shiftLeft(uint64_t z, unsigned n)
+{
+  return n >= BitVector::WORD_SIZE ? 0 : z << n;
+}
+
+}  // namespace
+
+void BitVector::setWord(uint64_t z)
+{
+  if (isWord())
+  {
+    d_word = z & wordMask(d_size);
+    d_value.reset();
+  }
+  else
+  {
+    d_word = 0;
+    d_value.reset(new Integer(wordToInteger(z)));
+  }
+}
+
+void BitVector::setValue(const Integer& val)
+{
+  if (isWord())
+  {
+    d_word = integerToWord(val);
+    d_value.reset();
+  }
+  else
+  {
+    d_word = 0;
+    d_value.reset(new Integer(val));
+  }
+}
+
+int64_t BitVector::getSignedWord() const
+{
+  if (d_size == 0)
+  {
+    return 0;
+  }
+  // shift the sign bit to the most significant bit and back
+  unsigned n = WORD_SIZE - d_size;
+  return static_cast<int64_t>(d_word << n) >> n;
+}
+
 unsigned BitVector::getSize() const { return d_size; }
 
-const Integer& BitVector::getValue() const { return d_value; }
+Integer BitVector::getValue() const
+{
+  return isWord() ? wordToInteger(d_word) : *d_value;
+}
 
-Integer BitVector::toInteger() const { return d_value; }
+Integer BitVector::toInteger() const { return getValue(); }
 
 Integer BitVector::toSignedInteger() const
 {
+  if (isWord())
+  {
+    int64_t val = getSignedWord();
+    if (val >= 0)
+    {
+      return wordToInteger(val);
+    }
+    // -(-val) does not overflow as unsigned
+    return -wordToInteger(-static_cast<uint64_t>(val));
+  }
   unsigned size = d_size;
-  Integer sign_bit = d_value.extractBitRange(1, size - 1);
-  Integer val = d_value.extractBitRange(size - 1, 0);
+  Integer sign_bit = d_value->extractBitRange(1, size - 1);
+  Integer val = d_value->extractBitRange(size - 1, 0);
   Integer res = Integer(-1) * sign_bit.multiplyByPow2(size - 1) + val;
   return res;
 }
 
 std::string BitVector::toString(unsigned int base) const
 {
-  std::string str = d_value.toString(base);
+  if (isWord() && base == 2)
+  {
+    std::string str(d_size, '0');
+    for (unsigned i = 0; i < d_size; ++i)
+    {
+      if ((d_word >> i) & 1)
+      {
+        str[d_size - 1 - i] = '1';
+      }
+    }
+    // the value 0 of size 0 is printed as 0, as for larger sizes
+    return d_size == 0 ? "0" : str;
+  }
+  std::string str = getValue().toString(base);
   if (base == 2 && d_size > str.size())
   {
     std::string zeroes;
@@ -57,25 +158,51 @@ std::string BitVector::toString(unsigned int base) const
 
 size_t BitVector::hash() const
 {
-  return d_value.hash() + d_size;
+  if (isWord())
+  {
+    return std::hash<uint64_t>()(d_word) + d_size;
+  }
+  return d_value->hash() + d_size;
 }
 
 BitVector BitVector::setBit(uint32_t i, bool value) const
 {
   CheckArgument(i < d_size, i);
-  Integer res = d_value.setBit(i, value);
+  if (isWord())
+  {
+    uint64_t bit = static_cast<uint64_t>(1) << i;
+    return BitVector(d_size, value ? d_word | bit : d_word & ~bit);
+  }
+  Integer res = d_value->setBit(i, value);
   return BitVector(d_size, res);
 }
 
 bool BitVector::isBitSet(uint32_t i) const
 {
   CheckArgument(i < d_size, i);
-  return d_value.isBitSet(i);
+  if (isWord())
+  {
+    return (d_word >> i) & 1;
+  }
+  return d_value->isBitSet(i);
 }
 
 unsigned BitVector::isPow2() const
 {
-  return d_value.isPow2();
+  if (isWord())
+  {
+    if (d_word == 0 || (d_word & (d_word - 1)) != 0)
+    {
+      return 0;
+    }
+    unsigned k = 1;
+    for (uint64_t z = d_word; z > 1; z >>= 1)
+    {
+      ++k;
+    }
+    return k;
+  }
+  return d_value->isPow2();
 }
 
 /* -----------------------------------------------------------------------
@@ -86,16 +213,25 @@ unsigned BitVector::isPow2() const
 
 BitVector BitVector::concat(const BitVector& other) const
 {
-  return BitVector(d_size + other.d_size,
-                   (d_value.multiplyByPow2(other.d_size)) + other.d_value);
+  unsigned size = d_size + other.d_size;
+  if (size <= WORD_SIZE)
+  {
+    return BitVector(size, shiftLeft(d_word, other.d_size) | other.d_word);
+  }
+  return BitVector(
+      size, (getValue().multiplyByPow2(other.d_size)) + other.getValue());
 }
 
 BitVector BitVector::extract(unsigned high, unsigned low) const
 {
   CheckArgument(high < d_size, high);
   CheckArgument(low <= high, low);
+  if (isWord())
+  {
+    return BitVector(high - low + 1, d_word >> low);
+  }
   return BitVector(high - low + 1,
-                   d_value.extractBitRange(high - low + 1, low));
+                   d_value->extractBitRange(high - low + 1, low));
 }
 
 /* (Dis)Equality --------------------------------------------------------- */
@@ -103,51 +239,63 @@ BitVector BitVector::extract(unsigned high, unsigned low) const
 bool BitVector::operator==(const BitVector& y) const
 {
   if (d_size != y.d_size) return false;
-  return d_value == y.d_value;
+  return isWord() ? d_word == y.d_word : *d_value == *y.d_value;
 }
 
 bool BitVector::operator!=(const BitVector& y) const
 {
   if (d_size != y.d_size) return true;
-  return d_value != y.d_value;
+  return isWord() ? d_word != y.d_word : *d_value != *y.d_value;
 }
 
 /* Unsigned Inequality --------------------------------------------------- */
 
 bool BitVector::operator<(const BitVector& y) const
 {
-  return d_value < y.d_value;
+  if (isWord() && y.isWord())
+  {
+    return d_word < y.d_word;
+  }
+  return getValue() < y.getValue();
 }
 
 bool BitVector::operator<=(const BitVector& y) const
 {
-  return d_value <= y.d_value;
+  if (isWord() && y.isWord())
+  {
+    return d_word <= y.d_word;
+  }
+  return getValue() <= y.getValue();
 }
 
 bool BitVector::operator>(const BitVector& y) const
 {
-  return d_value > y.d_value;
+  if (isWord() && y.isWord())
+  {
+    return d_word > y.d_word;
+  }
+  return getValue() > y.getValue();
 }
 
 bool BitVector::operator>=(const BitVector& y) const
 {
-  return d_value >= y.d_value;
+  if (isWord() && y.isWord())
+  {
+    return d_word >= y.d_word;
+  }
+  return getValue() >= y.getValue();
 }
 
 bool BitVector::unsignedLessThan(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value >= 0, y);
-  return d_value < y.d_value;
+  return *this < y;
 }
 
 bool BitVector::unsignedLessThanEq(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, this);
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value >= 0, y);
-  return d_value <= y.d_value;
+  return *this <= y;
 }
 
 /* Signed Inequality ----------------------------------------------------- */
@@ -155,8 +303,10 @@ bool BitVector::unsignedLessThanEq(const BitVector& y) const
 bool BitVector::signedLessThan(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value >= 0, y);
+  if (isWord())
+  {
+    return getSignedWord() < y.getSignedWord();
+  }
   Integer a = (*this).toSignedInteger();
   Integer b = y.toSignedInteger();
 
@@ -166,8 +316,10 @@ bool BitVector::signedLessThan(const BitVector& y) const
 bool BitVector::signedLessThanEq(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value >= 0, y);
+  if (isWord())
+  {
+    return getSignedWord() <= y.getSignedWord();
+  }
   Integer a = (*this).toSignedInteger();
   Integer b = y.toSignedInteger();
 
@@ -179,24 +331,40 @@ bool BitVector::signedLessThanEq(const BitVector& y) const
 BitVector BitVector::operator^(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  return BitVector(d_size, d_value.bitwiseXor(y.d_value));
+  if (isWord())
+  {
+    return BitVector(d_size, d_word ^ y.d_word);
+  }
+  return BitVector(d_size, d_value->bitwiseXor(*y.d_value));
 }
 
 BitVector BitVector::operator|(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  return BitVector(d_size, d_value.bitwiseOr(y.d_value));
+  if (isWord())
+  {
+    return BitVector(d_size, d_word | y.d_word);
+  }
+  return BitVector(d_size, d_value->bitwiseOr(*y.d_value));
 }
 
 BitVector BitVector::operator&(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  return BitVector(d_size, d_value.bitwiseAnd(y.d_value));
+  if (isWord())
+  {
+    return BitVector(d_size, d_word & y.d_word);
+  }
+  return BitVector(d_size, d_value->bitwiseAnd(*y.d_value));
 }
 
 BitVector BitVector::operator~() const
 {
-  return BitVector(d_size, d_value.bitwiseNot());
+  if (isWord())
+  {
+    return BitVector(d_size, ~d_word);
+  }
+  return BitVector(d_size, d_value->bitwiseNot());
 }
 
 /* Arithmetic operations ------------------------------------------------- */
@@ -204,13 +372,21 @@ BitVector BitVector::operator~() const
 BitVector BitVector::operator+(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  Integer sum = d_value + y.d_value;
+  if (isWord())
+  {
+    return BitVector(d_size, d_word + y.d_word);
+  }
+  Integer sum = *d_value + *y.d_value;
   return BitVector(d_size, sum);
 }
 
 BitVector BitVector::operator-(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
+  if (isWord())
+  {
+    return BitVector(d_size, d_word - y.d_word);
+  }
   // to maintain the invariant that we are only adding BitVectors of the
   // same size
   BitVector one(d_size, Integer(1));
@@ -219,6 +395,10 @@ BitVector BitVector::operator-(const BitVector& y) const
 
 BitVector BitVector::operator-() const
 {
+  if (isWord())
+  {
+    return BitVector(d_size, -d_word);
+  }
   BitVector one(d_size, Integer(1));
   return ~(*this) + one;
 }
@@ -226,50 +406,74 @@ BitVector BitVector::operator-() const
 BitVector BitVector::operator*(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  Integer prod = d_value * y.d_value;
+  if (isWord())
+  {
+    return BitVector(d_size, d_word * y.d_word);
+  }
+  Integer prod = *d_value * *y.d_value;
   return BitVector(d_size, prod);
 }
 
 BitVector BitVector::unsignedDivTotal(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
+  if (isWord())
+  {
+    /* d_word / 0 = -1 = 2^d_size - 1 */
+    return BitVector(d_size,
+                     y.d_word == 0 ? ~static_cast<uint64_t>(0)
+                                   : d_word / y.d_word);
+  }
   /* d_value / 0 = -1 = 2^d_size - 1 */
-  if (y.d_value == 0)
+  if (*y.d_value == 0)
   {
     return BitVector(d_size, Integer(1).oneExtend(1, d_size - 1));
   }
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value > 0, y);
-  return BitVector(d_size, d_value.floorDivideQuotient(y.d_value));
+  CheckArgument(*d_value >= 0, this);
+  CheckArgument(*y.d_value > 0, y);
+  return BitVector(d_size, d_value->floorDivideQuotient(*y.d_value));
 }
 
 BitVector BitVector::unsignedRemTotal(const BitVector& y) const
 {
   CheckArgument(d_size == y.d_size, y);
-  if (y.d_value == 0)
+  if (isWord())
   {
-    return BitVector(d_size, d_value);
+    return BitVector(d_size, y.d_word == 0 ? d_word : d_word % y.d_word);
   }
-  CheckArgument(d_value >= 0, this);
-  CheckArgument(y.d_value > 0, y);
-  return BitVector(d_size, d_value.floorDivideRemainder(y.d_value));
+  if (*y.d_value == 0)
+  {
+    return *this;
+  }
+  CheckArgument(*d_value >= 0, this);
+  CheckArgument(*y.d_value > 0, y);
+  return BitVector(d_size, d_value->floorDivideRemainder(*y.d_value));
 }
 
 /* Extend operations ----------------------------------------------------- */
 
 BitVector BitVector::zeroExtend(unsigned n) const
 {
-  return BitVector(d_size + n, d_value);
+  if (d_size + n <= WORD_SIZE)
+  {
+    return BitVector(d_size + n, d_word);
+  }
+  return BitVector(d_size + n, getValue());
 }
 
 BitVector BitVector::signExtend(unsigned n) const
 {
-  Integer sign_bit = d_value.extractBitRange(1, d_size - 1);
+  if (d_size + n <= WORD_SIZE)
+  {
+    return BitVector(d_size + n, static_cast<uint64_t>(getSignedWord()));
+  }
+  Integer value = getValue();
+  Integer sign_bit = value.extractBitRange(1, d_size - 1);
   if (sign_bit == Integer(0))
   {
-    return BitVector(d_size + n, d_value);
+    return BitVector(d_size + n, value);
   }
-  Integer val = d_value.oneExtend(d_size, n);
+  Integer val = value.oneExtend(d_size, n);
   return BitVector(d_size + n, val);
 }
 
@@ -277,38 +481,60 @@ BitVector BitVector::signExtend(unsigned n) const
 
 BitVector BitVector::leftShift(const BitVector& y) const
 {
-  if (y.d_value > Integer(d_size))
+  if (isWord() && y.isWord())
+  {
+    return BitVector(d_size,
+                     y.d_word >= d_size ? 0 : shiftLeft(d_word, y.d_word));
+  }
+  Integer amountValue = y.getValue();
+  if (amountValue > Integer(d_size))
   {
     return BitVector(d_size, Integer(0));
   }
-  if (y.d_value == 0)
+  if (amountValue == 0)
   {
     return *this;
   }
   // making sure we don't lose information casting
-  CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
-  uint32_t amount = y.d_value.toUnsignedInt();
-  Integer res = d_value.multiplyByPow2(amount);
+  CheckArgument(amountValue < Integer(1).multiplyByPow2(32), y);
+  uint32_t amount = amountValue.toUnsignedInt();
+  Integer res = getValue().multiplyByPow2(amount);
   return BitVector(d_size, res);
 }
 
 BitVector BitVector::logicalRightShift(const BitVector& y) const
 {
-  if (y.d_value > Integer(d_size))
+  if (isWord() && y.isWord())
+  {
+    return BitVector(d_size, y.d_word >= d_size ? 0 : d_word >> y.d_word);
+  }
+  Integer amountValue = y.getValue();
+  if (amountValue > Integer(d_size))
   {
     return BitVector(d_size, Integer(0));
   }
   // making sure we don't lose information casting
-  CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
-  uint32_t amount = y.d_value.toUnsignedInt();
-  Integer res = d_value.divByPow2(amount);
+  CheckArgument(amountValue < Integer(1).multiplyByPow2(32), y);
+  uint32_t amount = amountValue.toUnsignedInt();
+  Integer res = getValue().divByPow2(amount);
   return BitVector(d_size, res);
 }
 
 BitVector BitVector::arithRightShift(const BitVector& y) const
 {
-  Integer sign_bit = d_value.extractBitRange(1, d_size - 1);
-  if (y.d_value > Integer(d_size))
+  if (isWord() && y.isWord())
+  {
+    int64_t val = getSignedWord();
+    if (y.d_word >= d_size)
+    {
+      return BitVector(d_size, val < 0 ? ~static_cast<uint64_t>(0) : 0);
+    }
+    return BitVector(d_size, static_cast<uint64_t>(val >> y.d_word));
+  }
+  Integer value = getValue();
+  Integer amountValue = y.getValue();
+  Integer sign_bit = value.extractBitRange(1, d_size - 1);
+  if (amountValue > Integer(d_size))
   {
     if (sign_bit == Integer(0))
     {
@@ -320,16 +546,16 @@ BitVector BitVector::arithRightShift(const BitVector& y) const
     }
   }
 
-  if (y.d_value == 0)
+  if (amountValue == 0)
   {
     return *this;
   }
 
   // making sure we don't lose information casting
-  CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
+  CheckArgument(amountValue < Integer(1).multiplyByPow2(32), y);
 
-  uint32_t amount = y.d_value.toUnsignedInt();
-  Integer rest = d_value.divByPow2(amount);
+  uint32_t amount = amountValue.toUnsignedInt();
+  Integer rest = value.divByPow2(amount);
 
   if (sign_bit == Integer(0))
   {
@@ -358,6 +584,10 @@ BitVector BitVector::mkOne(unsigned size)
 BitVector BitVector::mkOnes(unsigned size)
 {
   CheckArgument(size > 0, size);
+  if (size <= WORD_SIZE)
+  {
+    return BitVector(size, ~static_cast<uint64_t>(0));
+  }
   return BitVector(1, Integer(1)).signExtend(size - 1);
 }
 
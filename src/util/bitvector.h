@@ -11,7 +11,8 @@
  **
  ** \brief A fixed-size bit-vector.
  **
- ** A fixed-size bit-vector, implemented as a wrapper around Integer.
+ ** A fixed-size bit-vector. Bit-vectors of size at most 64 are implemented as
+ ** a machine word, larger bit-vectors as a wrapper around Integer.
  **/
 
 #include "cvc4_public.h"
@@ -19,7 +20,9 @@
 #ifndef CVC4__BITVECTOR_H
 #define CVC4__BITVECTOR_H
 
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 
 #include "util/integer.h"
 
@@ -28,12 +31,21 @@ namespace CVC4 {
 class CVC4_PUBLIC BitVector
 {
  public:
-  BitVector(unsigned size, const Integer& val)
-      : d_size(size), d_value(val.modByPow2(size))
+  /** The maximal size of bit-vectors whose value is stored in a word */
+  static const unsigned WORD_SIZE = 64;
+
+  BitVector(unsigned size, const Integer& val) : d_size(size), d_word(0)
   {
+    setValue(val.modByPow2(size));
   }
 
-  BitVector(unsigned size = 0) : d_size(size), d_value(0) {}
+  BitVector(unsigned size = 0) : d_size(size), d_word(0)
+  {
+    if (!isWord())
+    {
+      d_value.reset(new Integer(0));
+    }
+  }
 
   /**
    * BitVector constructor using a 32-bit unsigned integer for the value.
@@ -42,9 +54,9 @@ class CVC4_PUBLIC BitVector
    * platforms (long is 32-bit when compiling 64-bit binaries on
    * Windows but 64-bit on Linux) and to prevent ambiguous overloads.
    */
-  BitVector(unsigned size, uint32_t z) : d_size(size), d_value(z)
+  BitVector(unsigned size, uint32_t z) : d_size(size), d_word(0)
   {
-    d_value = d_value.modByPow2(size);
+    setWord(z);
   }
 
   /**
@@ -54,14 +66,21 @@ class CVC4_PUBLIC BitVector
    * platforms (long is 32-bit when compiling 64-bit binaries on
    * Windows but 64-bit on Linux) and to prevent ambiguous overloads.
    */
-  BitVector(unsigned size, uint64_t z) : d_size(size), d_value(z)
+  BitVector(unsigned size, uint64_t z) : d_size(size), d_word(0)
   {
-    d_value = d_value.modByPow2(size);
+    setWord(z);
   }
 
-  BitVector(unsigned size, const BitVector& q)
-      : d_size(size), d_value(q.d_value)
+  BitVector(unsigned size, const BitVector& q) : d_size(size), d_word(0)
   {
+    if (q.isWord())
+    {
+      setWord(q.d_word);
+    }
+    else
+    {
+      setValue(q.d_value->modByPow2(size));
+    }
   }
 
   /**
@@ -77,16 +96,33 @@ class CVC4_PUBLIC BitVector
    * @param num The value of the bit-vector in string representation.
    * @param base The base of the string representation.
    */
-  BitVector(const std::string& num, unsigned base = 2)
+  BitVector(const std::string& num, unsigned base = 2) : d_word(0)
   {
     CheckArgument(base == 2 || base == 10 || base == 16, base);
-    d_value = Integer(num, base);
+    Integer val(num, base);
     switch (base)
     {
-      case 10: d_size = d_value.length(); break;
+      case 10: d_size = val.length(); break;
       case 16: d_size = num.size() * 4; break;
       default: d_size = num.size();
     }
+    setValue(val);
+  }
+
+  BitVector(const BitVector& x) : d_size(x.d_size), d_word(x.d_word)
+  {
+    if (x.d_value)
+    {
+      d_value.reset(new Integer(*x.d_value));
+    }
+  }
+
+  BitVector(BitVector&& x)
+      : d_size(x.d_size), d_word(x.d_word), d_value(std::move(x.d_value))
+  {
+    // leave x as a valid bit-vector of size 0
+    x.d_size = 0;
+    x.d_word = 0;
   }
 
   ~BitVector() {}
@@ -95,14 +131,37 @@ class CVC4_PUBLIC BitVector
   {
     if (this == &x) return *this;
     d_size = x.d_size;
-    d_value = x.d_value;
+    d_word = x.d_word;
+    if (x.d_value == nullptr)
+    {
+      d_value.reset();
+    }
+    else if (d_value == nullptr)
+    {
+      d_value.reset(new Integer(*x.d_value));
+    }
+    else
+    {
+      *d_value = *x.d_value;
+    }
+    return *this;
+  }
+
+  BitVector& operator=(BitVector&& x)
+  {
+    if (this == &x) return *this;
+    d_size = x.d_size;
+    d_word = x.d_word;
+    d_value = std::move(x.d_value);
+    x.d_size = 0;
+    x.d_word = 0;
     return *this;
   }
 
   /* Get size (bit-width). */
   unsigned getSize() const;
   /* Get value. */
-  const Integer& getValue() const;
+  Integer getValue() const;
 
   /* Return value. */
   Integer toInteger() const;
@@ -262,12 +321,36 @@ class CVC4_PUBLIC BitVector
  private:
   /**
    * Class invariants:
-   *  - no overflows: 2^d_size < d_value
-   *  - no negative numbers: d_value >= 0
+   *  - bit-vectors of size at most WORD_SIZE store their value in d_word,
+   *    d_value is null
+   *  - larger bit-vectors store their value in d_value, d_word is 0
+   *  - no overflows: value < 2^d_size
+   *  - no negative numbers: value >= 0
    */
 
+  /** Is the value of this bit-vector stored in d_word? */
+  bool isWord() const { return d_size <= WORD_SIZE; }
+  /** Get the mask of the lower size bits of a word */
+  static uint64_t wordMask(unsigned size)
+  {
+    return size >= WORD_SIZE ? ~static_cast<uint64_t>(0)
+                             : (static_cast<uint64_t>(1) << size) - 1;
+  }
+  /** Get the value of this bit-vector of size at most WORD_SIZE, signed */
+  int64_t getSignedWord() const;
+  /** Set the value to z modulo 2^d_size */
+  void setWord(uint64_t z);
+  /** Set the value to val, which must be in [0, 2^d_size) */
+  void setValue(const Integer& val);
+
   unsigned d_size;
-  Integer d_value;
+  /** The value if d_size <= WORD_SIZE */
+  uint64_t d_word;
+  /**
+   * The value if d_size > WORD_SIZE. The value of small bit-vectors is
+   * stored inline, so that their operations do not allocate memory.
+   */
+  std::unique_ptr<Integer> d_value;
 
 }; /* class BitVector */
 
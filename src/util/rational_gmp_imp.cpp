@@ -16,6 +16,7 @@
 #include "util/rational.h"
 
 #include <cmath>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -26,6 +27,7 @@
 #endif /* CVC4_GMP_IMP */
 
 #include "base/check.h"
+#include "util/gmp_util.h"
 
 namespace CVC4 {
 
@@ -33,6 +35,199 @@ std::ostream& operator<<(std::ostream& os, const Rational& q){
   return os << q.toString();
 }
 
+namespace {
+
+/** Convert z to a GMP integer, independently of the size of long */
+mpz_class int64ToMpz(int64_t z)
+{
+  if (z >= std::numeric_limits<long>::min()
+      && z <= std::numeric_limits<long>::max())
+  {
+    return mpz_class(static_cast<long>(z));
+  }
+  uint64_t a = z < 0 ? -static_cast<uint64_t>(z) : z;
+  mpz_class res(static_cast<unsigned long>(a >> 32));
+  res <<= 32;
+  res += static_cast<unsigned long>(a & 0xffffffff);
+  return z < 0 ? mpz_class(-res) : res;
+}
+
+/** Same as above for unsigned integers */
+mpz_class uint64ToMpz(uint64_t z)
+{
+  if (z <= std::numeric_limits<unsigned long>::max())
+  {
+    return mpz_class(static_cast<unsigned long>(z));
+  }
+  mpz_class res(static_cast<unsigned long>(z >> 32));
+  res <<= 32;
+  res += static_cast<unsigned long>(z & 0xffffffff);
+  return res;
+}
+
+/**
+ * Returns true if z fits into the numerator or denominator of a small
+ * rational, and stores it in res.
+ */
+bool mpzToInt64(const mpz_class& z, int64_t& res)
+{
+  if (!mpz_fits_slong_p(z.get_mpz_t()))
+  {
+    return false;
+  }
+  long v = z.get_si();
+  if (v == std::numeric_limits<int64_t>::min())
+  {
+    return false;
+  }
+  res = v;
+  return true;
+}
+
+}  // namespace
+
+Rational::Rational(const Integer& n, const Integer& d) : d_num(0), d_den(1)
+{
+  int64_t nv, dv;
+  if (mpzToInt64(n.get_mpz(), nv) && mpzToInt64(d.get_mpz(), dv))
+  {
+    setFraction(nv, dv);
+    return;
+  }
+  mpq_class q(n.get_mpz(), d.get_mpz());
+  q.canonicalize();
+  setValue(q);
+}
+
+Rational::Rational(const Integer& n) : d_num(0), d_den(1)
+{
+  if (!mpzToInt64(n.get_mpz(), d_num))
+  {
+    d_num = 0;
+    d_big.reset(new mpq_class(n.get_mpz()));
+  }
+}
+
+void Rational::setFractionSlow(int64_t n, int64_t d)
+{
+  mpq_class q(int64ToMpz(n), int64ToMpz(d));
+  q.canonicalize();
+  setValue(q);
+}
+
+void Rational::setUnsignedFractionSlow(uint64_t n, uint64_t d)
+{
+  mpq_class q(uint64ToMpz(n), uint64ToMpz(d));
+  q.canonicalize();
+  setValue(q);
+}
+
+void Rational::setValue(const mpq_class& q)
+{
+  if (mpzToInt64(q.get_num(), d_num) && mpzToInt64(q.get_den(), d_den))
+  {
+    d_big.reset();
+    return;
+  }
+  d_num = 0;
+  d_den = 1;
+  if (d_big == nullptr)
+  {
+    d_big.reset(new mpq_class(q));
+  }
+  else
+  {
+    *d_big = q;
+  }
+}
+
+mpq_class Rational::toMpq() const
+{
+  Assert(isSmall());
+  return mpq_class(int64ToMpz(d_num), int64ToMpz(d_den));
+}
+
+int Rational::cmpSlow(const Rational& x) const
+{
+  // Don't use mpq_class's cmp() function.
+  // The name ends up conflicting with this function.
+  std::optional<mpq_class> tmp, xtmp;
+  const mpq_class& a = isSmall() ? tmp.emplace(toMpq()) : *d_big;
+  const mpq_class& b = x.isSmall() ? xtmp.emplace(x.toMpq()) : *x.d_big;
+  return mpq_cmp(a.get_mpq_t(), b.get_mpq_t());
+}
+
+Rational Rational::addSlow(const Rational& y) const
+{
+  std::optional<mpq_class> tmp, ytmp;
+  const mpq_class& a = isSmall() ? tmp.emplace(toMpq()) : *d_big;
+  const mpq_class& b = y.isSmall() ? ytmp.emplace(y.toMpq()) : *y.d_big;
+  return Rational(mpq_class(a + b));
+}
+
+Rational Rational::subSlow(const Rational& y) const
+{
+  std::optional<mpq_class> tmp, ytmp;
+  const mpq_class& a = isSmall() ? tmp.emplace(toMpq()) : *d_big;
+  const mpq_class& b = y.isSmall() ? ytmp.emplace(y.toMpq()) : *y.d_big;
+  return Rational(mpq_class(a - b));
+}
+
+Rational Rational::mulSlow(const Rational& y) const
+{
+  std::optional<mpq_class> tmp, ytmp;
+  const mpq_class& a = isSmall() ? tmp.emplace(toMpq()) : *d_big;
+  const mpq_class& b = y.isSmall() ? ytmp.emplace(y.toMpq()) : *y.d_big;
+  return Rational(mpq_class(a * b));
+}
+
+Rational Rational::divSlow(const Rational& y) const
+{
+  std::optional<mpq_class> tmp, ytmp;
+  const mpq_class& a = isSmall() ? tmp.emplace(toMpq()) : *d_big;
+  const mpq_class& b = y.isSmall() ? ytmp.emplace(y.toMpq()) : *y.d_big;
+  return Rational(mpq_class(a / b));
+}
+
+double Rational::getDouble() const
+{
+  // integers of at most 53 bits are represented exactly
+  if (isSmall() && d_den == 1 && d_num >= -(int64_t(1) << 53)
+      && d_num <= (int64_t(1) << 53))
+  {
+    return static_cast<double>(d_num);
+  }
+  return getValue().get_d();
+}
+
+std::string Rational::toString(int base) const
+{
+  if (isSmall() && base == 10)
+  {
+    std::string res = std::to_string(d_num);
+    if (d_den != 1)
+    {
+      res += "/" + std::to_string(d_den);
+    }
+    return res;
+  }
+  return getValue().get_str(base);
+}
+
+size_t Rational::hash() const
+{
+  if (isSmall())
+  {
+    // the same as gmpz_hash on the absolute values, which are single limbs
+    uint64_t num = d_num < 0 ? -static_cast<uint64_t>(d_num) : d_num;
+    return static_cast<size_t>(num) xor static_cast<size_t>(d_den);
+  }
+  size_t numeratorHash = gmpz_hash(d_big->get_num_mpz_t());
+  size_t denominatorHash = gmpz_hash(d_big->get_den_mpz_t());
+
+  return numeratorHash xor denominatorHash;
+}
+
 
 /* Computes a rational given a decimal string. The rational
  * version of <code>xxx.yyy</code> is <code>xxxyyy/(10^3)</code>.
@@ -91,9 +286,9 @@ Maybe<Rational> Rational::fromDouble(double d)
 {
   using namespace std;
   if(isfinite(d)){
-    Rational q;
-    mpq_set_d(q.d_value.get_mpq_t(), d);
-    return q;
+    mpq_class q;
+    mpq_set_d(q.get_mpq_t(), d);
+    return Rational(q);
   }
   return Maybe<Rational>();
 }
@@ -13,6 +13,8 @@
  ** rational.
  **
  ** Multiprecision rational constants; wraps a GMP multiprecision rational.
+ ** Rationals whose numerator and denominator fit into 64 bits are stored
+ ** inline and computed with machine arithmetic with overflow detection.
  **/
 
 #include "cvc4_public.h"
@@ -22,6 +24,10 @@
 
 #include <gmp.h>
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <string>
 
 #include "base/exception.h"
@@ -39,6 +45,13 @@ namespace CVC4 {
  ** literature.) A consequence is that that the numerator and denominator may be
  ** different than the values used to construct the Rational.
  **
+ ** Rationals whose numerator and denominator fit into a signed 64-bit integer
+ ** (excluding its minimum) are stored as a pair of machine integers instead.
+ ** Operations on them use machine arithmetic and fall back to GMP when the
+ ** result overflows, results that fit are demoted back to machine integers.
+ ** Almost all coefficients of the arithmetic tableau are small, so that
+ ** pivoting does not allocate.
+ **
  ** NOTE: The correct way to create a Rational from an int is to use one of the
  ** int numerator/int denominator constructors with the denominator 1.  Trying
  ** to construct a Rational with a single int, e.g., Rational(0), will put you
@@ -54,7 +67,7 @@ class CVC4_PUBLIC Rational
    * Assumes that the value is in canonical form, and thus does not
    * have to call canonicalize() on the value.
    */
-  Rational(const mpq_class& val) : d_value(val) {}
+  Rational(const mpq_class& val) : d_num(0), d_den(1) { setValue(val); }
 
   /**
    * Creates a rational from a decimal string (e.g., <code>"1.5"</code>).
@@ -65,7 +78,7 @@ class CVC4_PUBLIC Rational
   static Rational fromDecimal(const std::string& dec);
 
   /** Constructs a rational with the value 0/1. */
-  Rational() : d_value(0) { d_value.canonicalize(); }
+  Rational() : d_num(0), d_den(1) {}
 
   /**
    * Constructs a Rational from a C string in a given base (defaults to 10).
@@ -74,96 +87,108 @@ class CVC4_PUBLIC Rational
    * For more information about what is a valid rational string,
    * see GMP's documentation for mpq_set_str().
    */
-  explicit Rational(const char* s, unsigned base = 10) : d_value(s, base)
+  explicit Rational(const char* s, unsigned base = 10) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    mpq_class q(s, base);
+    q.canonicalize();
+    setValue(q);
   }
-  Rational(const std::string& s, unsigned base = 10) : d_value(s, base)
+  Rational(const std::string& s, unsigned base = 10) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    mpq_class q(s, base);
+    q.canonicalize();
+    setValue(q);
   }
 
   /**
    * Creates a Rational from another Rational, q, by performing a deep copy.
    */
-  Rational(const Rational& q) : d_value(q.d_value) { d_value.canonicalize(); }
+  Rational(const Rational& q)
+      : d_num(q.d_num),
+        d_den(q.d_den),
+        d_big(q.d_big ? new mpq_class(*q.d_big) : nullptr)
+  {
+  }
+
+  Rational(Rational&& q)
+      : d_num(q.d_num), d_den(q.d_den), d_big(std::move(q.d_big))
+  {
+    // leave q as a valid zero
+    q.d_num = 0;
+    q.d_den = 1;
+  }
 
   /**
    * Constructs a canonical Rational from a numerator.
    */
-  Rational(signed int n) : d_value(n, 1) { d_value.canonicalize(); }
-  Rational(unsigned int n) : d_value(n, 1) { d_value.canonicalize(); }
-  Rational(signed long int n) : d_value(n, 1) { d_value.canonicalize(); }
-  Rational(unsigned long int n) : d_value(n, 1) { d_value.canonicalize(); }
-
-#ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n) : d_value(static_cast<long>(n), 1)
-  {
-    d_value.canonicalize();
-  }
-  Rational(uint64_t n) : d_value(static_cast<unsigned long>(n), 1)
+  Rational(signed int n) : d_num(n), d_den(1) {}
+  Rational(unsigned int n) : d_num(n), d_den(1) {}
+  Rational(signed long int n) : d_num(0), d_den(1) { setFraction(n, 1); }
+  Rational(unsigned long int n) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setUnsignedFraction(n, 1);
   }
+
+#ifdef CVC4_NEED_INT64_T_OVERLOADS
+  Rational(int64_t n) : d_num(0), d_den(1) { setFraction(n, 1); }
+  Rational(uint64_t n) : d_num(0), d_den(1) { setUnsignedFraction(n, 1); }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   /**
    * Constructs a canonical Rational from a numerator and denominator.
    */
-  Rational(signed int n, signed int d) : d_value(n, d)
+  Rational(signed int n, signed int d) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setFraction(n, d);
   }
-  Rational(unsigned int n, unsigned int d) : d_value(n, d)
+  Rational(unsigned int n, unsigned int d) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setFraction(n, d);
   }
-  Rational(signed long int n, signed long int d) : d_value(n, d)
+  Rational(signed long int n, signed long int d) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setFraction(n, d);
   }
-  Rational(unsigned long int n, unsigned long int d) : d_value(n, d)
+  Rational(unsigned long int n, unsigned long int d) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setUnsignedFraction(n, d);
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n, int64_t d)
-      : d_value(static_cast<long>(n), static_cast<long>(d))
-  {
-    d_value.canonicalize();
-  }
-  Rational(uint64_t n, uint64_t d)
-      : d_value(static_cast<unsigned long>(n), static_cast<unsigned long>(d))
+  Rational(int64_t n, int64_t d) : d_num(0), d_den(1) { setFraction(n, d); }
+  Rational(uint64_t n, uint64_t d) : d_num(0), d_den(1)
   {
-    d_value.canonicalize();
+    setUnsignedFraction(n, d);
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
-  Rational(const Integer& n, const Integer& d)
-      : d_value(n.get_mpz(), d.get_mpz())
-  {
-    d_value.canonicalize();
-  }
-  Rational(const Integer& n) : d_value(n.get_mpz()) { d_value.canonicalize(); }
+  Rational(const Integer& n, const Integer& d);
+  Rational(const Integer& n);
   ~Rational() {}
 
   /**
-   * Returns a copy of d_value to enable public access of GMP data.
+   * Returns a copy of the value as a GMP rational to enable public access of
+   * GMP data.
    */
-  const mpq_class& getValue() const { return d_value; }
+  mpq_class getValue() const { return isSmall() ? toMpq() : *d_big; }
 
   /**
    * Returns the value of numerator of the Rational.
    * Note that this makes a deep copy of the numerator.
    */
-  Integer getNumerator() const { return Integer(d_value.get_num()); }
+  Integer getNumerator() const
+  {
+    return isSmall() ? Integer(d_num) : Integer(d_big->get_num());
+  }
 
   /**
    * Returns the value of denominator of the Rational.
    * Note that this makes a deep copy of the denominator.
    */
-  Integer getDenominator() const { return Integer(d_value.get_den()); }
+  Integer getDenominator() const
+  {
+    return isSmall() ? Integer(d_den) : Integer(d_big->get_den());
+  }
 
   static Maybe<Rational> fromDouble(double d);
 
@@ -172,30 +197,50 @@ class CVC4_PUBLIC Rational
    * approximate: truncation may occur, overflow may result in
    * infinity, and underflow may result in zero.
    */
-  double getDouble() const { return d_value.get_d(); }
+  double getDouble() const;
 
   Rational inverse() const
   {
+    if (isSmall() && d_num != 0)
+    {
+      return d_num < 0 ? mkSmall(-d_den, -d_num) : mkSmall(d_den, d_num);
+    }
     return Rational(getDenominator(), getNumerator());
   }
 
   int cmp(const Rational& x) const
   {
-    // Don't use mpq_class's cmp() function.
-    // The name ends up conflicting with this function.
-    return mpq_cmp(d_value.get_mpq_t(), x.d_value.get_mpq_t());
+    if (isSmall() && x.isSmall())
+    {
+      if (d_den == x.d_den)
+      {
+        return d_num < x.d_num ? -1 : (d_num > x.d_num ? 1 : 0);
+      }
+      int64_t a, b;
+      if (!__builtin_mul_overflow(d_num, x.d_den, &a)
+          && !__builtin_mul_overflow(x.d_num, d_den, &b))
+      {
+        return a < b ? -1 : (a > b ? 1 : 0);
+      }
+    }
+    return cmpSlow(x);
   }
 
-  int sgn() const { return mpq_sgn(d_value.get_mpq_t()); }
+  int sgn() const
+  {
+    if (isSmall())
+    {
+      return d_num < 0 ? -1 : (d_num > 0 ? 1 : 0);
+    }
+    return mpq_sgn(d_big->get_mpq_t());
+  }
 
   bool isZero() const { return sgn() == 0; }
 
-  bool isOne() const { return mpq_cmp_si(d_value.get_mpq_t(), 1, 1) == 0; }
+  /* Large rationals are never 1 or -1 since these fit into machine integers */
+  bool isOne() const { return isSmall() && d_num == 1 && d_den == 1; }
 
-  bool isNegativeOne() const
-  {
-    return mpq_cmp_si(d_value.get_mpq_t(), -1, 1) == 0;
-  }
+  bool isNegativeOne() const { return isSmall() && d_num == -1 && d_den == 1; }
 
   Rational abs() const
   {
@@ -211,15 +256,25 @@ class CVC4_PUBLIC Rational
 
   Integer floor() const
   {
+    if (isSmall())
+    {
+      int64_t q = d_num / d_den;
+      return Integer(d_num % d_den != 0 && d_num < 0 ? q - 1 : q);
+    }
     mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_fdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
   Integer ceiling() const
   {
+    if (isSmall())
+    {
+      int64_t q = d_num / d_den;
+      return Integer(d_num % d_den != 0 && d_num > 0 ? q + 1 : q);
+    }
     mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_cdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
@@ -228,84 +283,152 @@ class CVC4_PUBLIC Rational
   Rational& operator=(const Rational& x)
   {
     if (this == &x) return *this;
-    d_value = x.d_value;
+    d_num = x.d_num;
+    d_den = x.d_den;
+    if (x.d_big == nullptr)
+    {
+      d_big.reset();
+    }
+    else if (d_big == nullptr)
+    {
+      d_big.reset(new mpq_class(*x.d_big));
+    }
+    else
+    {
+      *d_big = *x.d_big;
+    }
+    return *this;
+  }
+
+  Rational& operator=(Rational&& x)
+  {
+    if (this == &x) return *this;
+    d_num = x.d_num;
+    d_den = x.d_den;
+    d_big = std::move(x.d_big);
+    x.d_num = 0;
+    x.d_den = 1;
     return *this;
   }
 
-  Rational operator-() const { return Rational(-(d_value)); }
+  Rational operator-() const
+  {
+    // the numerator of small rationals is not the minimal int64_t
+    return isSmall() ? mkSmall(-d_num, d_den) : Rational(-(*d_big));
+  }
 
-  bool operator==(const Rational& y) const { return d_value == y.d_value; }
+  bool operator==(const Rational& y) const
+  {
+    // the representation of a value is unique
+    if (isSmall() || y.isSmall())
+    {
+      return d_big == y.d_big && d_num == y.d_num && d_den == y.d_den;
+    }
+    return *d_big == *y.d_big;
+  }
 
-  bool operator!=(const Rational& y) const { return d_value != y.d_value; }
+  bool operator!=(const Rational& y) const { return !(*this == y); }
 
-  bool operator<(const Rational& y) const { return d_value < y.d_value; }
+  bool operator<(const Rational& y) const { return cmp(y) < 0; }
 
-  bool operator<=(const Rational& y) const { return d_value <= y.d_value; }
+  bool operator<=(const Rational& y) const { return cmp(y) <= 0; }
 
-  bool operator>(const Rational& y) const { return d_value > y.d_value; }
+  bool operator>(const Rational& y) const { return cmp(y) > 0; }
 
-  bool operator>=(const Rational& y) const { return d_value >= y.d_value; }
+  bool operator>=(const Rational& y) const { return cmp(y) >= 0; }
 
   Rational operator+(const Rational& y) const
   {
-    return Rational(d_value + y.d_value);
+    Rational res;
+    if (isSmall() && y.isSmall()
+        && addSmall(d_num, d_den, y.d_num, y.d_den, res))
+    {
+      return res;
+    }
+    return addSlow(y);
   }
   Rational operator-(const Rational& y) const
   {
-    return Rational(d_value - y.d_value);
+    Rational res;
+    if (isSmall() && y.isSmall()
+        && addSmall(d_num, d_den, -y.d_num, y.d_den, res))
+    {
+      return res;
+    }
+    return subSlow(y);
   }
 
   Rational operator*(const Rational& y) const
   {
-    return Rational(d_value * y.d_value);
+    Rational res;
+    if (isSmall() && y.isSmall()
+        && mulSmall(d_num, d_den, y.d_num, y.d_den, res))
+    {
+      return res;
+    }
+    return mulSlow(y);
   }
   Rational operator/(const Rational& y) const
   {
-    return Rational(d_value / y.d_value);
+    Rational res;
+    if (isSmall() && y.isSmall() && y.d_num != 0
+        && mulSmall(d_num,
+                    d_den,
+                    y.d_num < 0 ? -y.d_den : y.d_den,
+                    y.d_num < 0 ? -y.d_num : y.d_num,
+                    res))
+    {
+      return res;
+    }
+    return divSlow(y);
   }
 
   Rational& operator+=(const Rational& y)
   {
-    d_value += y.d_value;
+    *this = *this + y;
     return (*this);
   }
   Rational& operator-=(const Rational& y)
   {
-    d_value -= y.d_value;
+    *this = *this - y;
     return (*this);
   }
 
   Rational& operator*=(const Rational& y)
   {
-    d_value *= y.d_value;
+    *this = *this * y;
     return (*this);
   }
 
   Rational& operator/=(const Rational& y)
   {
-    d_value /= y.d_value;
+    *this = *this / y;
     return (*this);
   }
 
-  bool isIntegral() const { return getDenominator() == 1; }
+  bool isIntegral() const
+  {
+    return isSmall() ? d_den == 1 : mpz_cmp_ui(d_big->get_den_mpz_t(), 1) == 0;
+  }
 
   /** Returns a string representing the rational in the given base. */
-  std::string toString(int base = 10) const { return d_value.get_str(base); }
+  std::string toString(int base = 10) const;
 
   /**
    * Computes the hash of the rational from hashes of the numerator and the
    * denominator.
    */
-  size_t hash() const
-  {
-    size_t numeratorHash = gmpz_hash(d_value.get_num_mpz_t());
-    size_t denominatorHash = gmpz_hash(d_value.get_den_mpz_t());
-
-    return numeratorHash xor denominatorHash;
-  }
+  size_t hash() const;
 
   uint32_t complexity() const
   {
+    if (isSmall())
+    {
+      // the bit lengths, where the length of 0 is 1 as in Integer::length()
+      uint64_t num = d_num < 0 ? -static_cast<uint64_t>(d_num) : d_num;
+      uint32_t numLen = num == 0 ? 1 : 64 - __builtin_clzll(num);
+      return numLen + 64 - __builtin_clzll(d_den);
+    }
     uint32_t numLen = getNumerator().length();
     uint32_t denLen = getDenominator().length();
     return numLen + denLen;
@@ -315,11 +438,138 @@ class CVC4_PUBLIC Rational
   int absCmp(const Rational& q) const;
 
  private:
+  /** Is this rational stored as a pair of machine integers? */
+  bool isSmall() const { return d_big == nullptr; }
+  /** Make the rational n/d, which must be canonical and small */
+  static Rational mkSmall(int64_t n, int64_t d)
+  {
+    Rational res;
+    res.d_num = n;
+    res.d_den = d;
+    return res;
+  }
+  /**
+   * Set res to a/b + c/d if it is small, where a/b and c/d are canonical.
+   * Returns false if the computation overflows.
+   */
+  static bool addSmall(
+      int64_t a, int64_t b, int64_t c, int64_t d, Rational& res)
+  {
+    int64_t n;
+    if (b == d)
+    {
+      if (__builtin_add_overflow(a, c, &n) || n == INT64_MIN)
+      {
+        return false;
+      }
+      int64_t g = b == 1 ? 1 : std::gcd(n, b);
+      res.d_num = n / g;
+      res.d_den = b / g;
+      return true;
+    }
+    // Knuth, TAOCP 4.5.1: with g = gcd(b, d), the result is
+    //   t / (b/g * d/g2) where t = a * d/g + c * b/g and g2 = gcd(t, g)
+    int64_t g = std::gcd(b, d);
+    int64_t t1, t2, den;
+    if (__builtin_mul_overflow(a, d / g, &t1)
+        || __builtin_mul_overflow(c, b / g, &t2)
+        || __builtin_add_overflow(t1, t2, &n) || n == INT64_MIN)
+    {
+      return false;
+    }
+    int64_t g2 = std::gcd(n, g);
+    if (__builtin_mul_overflow(b / g, d / g2, &den))
+    {
+      return false;
+    }
+    res.d_num = n / g2;
+    res.d_den = den;
+    return true;
+  }
+  /**
+   * Set res to a/b * c/d if it is small, where a/b and c/d are canonical.
+   * Returns false if the computation overflows.
+   */
+  static bool mulSmall(
+      int64_t a, int64_t b, int64_t c, int64_t d, Rational& res)
+  {
+    if (a == 0 || c == 0)
+    {
+      res.d_num = 0;
+      res.d_den = 1;
+      return true;
+    }
+    int64_t g1 = std::gcd(a, d);
+    int64_t g2 = std::gcd(c, b);
+    int64_t n, den;
+    if (__builtin_mul_overflow(a / g1, c / g2, &n) || n == INT64_MIN
+        || __builtin_mul_overflow(b / g2, d / g1, &den))
+    {
+      return false;
+    }
+    res.d_num = n;
+    res.d_den = den;
+    return true;
+  }
+  /** Set the value to n/d */
+  void setFraction(int64_t n, int64_t d)
+  {
+    if (d == 0 || n == INT64_MIN || d == INT64_MIN)
+    {
+      // let GMP handle the division by zero
+      setFractionSlow(n, d);
+      return;
+    }
+    if (d < 0)
+    {
+      n = -n;
+      d = -d;
+    }
+    int64_t g = n == 0 ? d : std::gcd(n, d);
+    d_num = n / g;
+    d_den = d / g;
+    d_big.reset();
+  }
+  /** Set the value to n/d */
+  void setUnsignedFraction(uint64_t n, uint64_t d)
+  {
+    const uint64_t max = std::numeric_limits<int64_t>::max();
+    if (n <= max && d <= max)
+    {
+      setFraction(static_cast<int64_t>(n), static_cast<int64_t>(d));
+    }
+    else
+    {
+      setUnsignedFractionSlow(n, d);
+    }
+  }
+  /** Set the value to n/d */
+  void setFractionSlow(int64_t n, int64_t d);
+  /** Set the value to n/d */
+  void setUnsignedFractionSlow(uint64_t n, uint64_t d);
+  /** Set the value to canonical q, small if it fits */
+  void setValue(const mpq_class& q);
+  /** Get the value of this small rational as a GMP rational */
+  mpq_class toMpq() const;
+  /** cmp for the case that one of the rationals is large */
+  int cmpSlow(const Rational& x) const;
+  /** Arithmetic operations for the case that the result may not be small */
+  Rational addSlow(const Rational& y) const;
+  Rational subSlow(const Rational& y) const;
+  Rational mulSlow(const Rational& y) const;
+  Rational divSlow(const Rational& y) const;
+
+  /**
+   * The numerator and the denominator of small rationals. The denominator is
+   * positive and their gcd is 1.
+   */
+  int64_t d_num;
+  int64_t d_den;
   /**
-   * Stores the value of the rational is stored in a C++ GMP rational class.
-   * Using this instead of mpq_t allows for easier destruction.
+   * The value of rationals that are not small, or nullptr. Each value has a
+   * unique representation: large rationals do not fit into d_num and d_den.
    */
-  mpq_class d_value;
+  std::unique_ptr<mpq_class> d_big;
 
 }; /* class Rational */
 
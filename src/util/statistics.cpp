@@ -129,6 +129,28 @@ void StatisticsBase::safeFlushInformation(int fd) const {
 #endif /* CVC4_STATISTICS_ON */
 }
 
+void StatisticsBase::flushInformationJSON(std::ostream& out, bool& first) const
+{
+#ifdef CVC4_STATISTICS_ON
+  for (StatSet::iterator i = d_stats.begin(); i != d_stats.end(); ++i)
+  {
+    Stat* s = *i;
+    out << (first ? "\n  " : ",\n  ");
+    first = false;
+    if (d_prefix != "")
+    {
+      stringToJSON(out, d_prefix + s_regDelim + s->getName());
+    }
+    else
+    {
+      stringToJSON(out, s->getName());
+    }
+    out << ": ";
+    s->flushJSON(out);
+  }
+#endif /* CVC4_STATISTICS_ON */
+}
+
 SExpr StatisticsBase::getStatistic(std::string name) const {
   SExpr value;
   IntStat s(name, 0);
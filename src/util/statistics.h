@@ -90,6 +90,15 @@ public:
    */
   void safeFlushInformation(int fd) const;
 
+  /**
+   * Flush all statistics to the given output stream as members "name": value
+   * of a JSON object, one per line. The members are separated by commas, and
+   * preceded by one unless first is true, which is set to false once a member
+   * is written. This allows writing several sets of statistics into one
+   * object.
+   */
+  void flushInformationJSON(std::ostream& out, bool& first) const;
+
   /** Get the value of a named statistic. */
   SExpr getStatistic(std::string name) const;
 
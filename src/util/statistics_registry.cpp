@@ -17,8 +17,10 @@
 
 #include "util/statistics_registry.h"
 
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 
 #include "base/check.h"
 #include "lib/clock_gettime.h"
@@ -142,6 +144,61 @@ std::ostream& operator<<(std::ostream& os, const timespec& t) {
             << std::setfill('0') << std::setw(9) << std::right << t.tv_nsec;
 }
 
+void stringToJSON(std::ostream& out, const std::string& s)
+{
+  StreamFormatScope format_scope(out);
+  out << '"';
+  for (char c : s)
+  {
+    if (c == '"' || c == '\\')
+    {
+      out << '\\' << c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      out << "\\u" << std::hex << std::setfill('0') << std::setw(4)
+          << static_cast<int>(c) << std::dec;
+    }
+    else
+    {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+void sexprToJSON(std::ostream& out, const SExpr& e)
+{
+  if (e.isInteger())
+  {
+    out << e.getIntegerValue();
+  }
+  else if (e.isRational())
+  {
+    StreamFormatScope format_scope(out);
+    out << std::setprecision(std::numeric_limits<double>::digits10)
+        << e.getRationalValue().getDouble();
+  }
+  else if (e.isAtom())
+  {
+    // strings and keywords
+    stringToJSON(out, e.getValue());
+  }
+  else
+  {
+    out << "[";
+    const std::vector<SExpr>& children = e.getChildren();
+    for (size_t i = 0, size = children.size(); i < size; ++i)
+    {
+      if (i > 0)
+      {
+        out << ", ";
+      }
+      sexprToJSON(out, children[i]);
+    }
+    out << "]";
+  }
+}
 
 /** Construct a statistics registry */
 StatisticsRegistry::StatisticsRegistry(const std::string& name) : Stat(name)
@@ -239,6 +296,63 @@ SExpr TimerStat::getValue() const {
 }/* TimerStat::getValue() */
 
 
+size_t CounterStat::nextShard()
+{
+  static std::atomic<size_t> next(0);
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+timespec SampledTimerStat::getData() const
+{
+  if (d_samples == 0)
+  {
+    return {0, 0};
+  }
+  double sampled = static_cast<double>(d_sampled.tv_sec)
+                   + static_cast<double>(d_sampled.tv_nsec) * 1e-9;
+  double estimate = sampled * d_runs / d_samples;
+  ::timespec data;
+  data.tv_sec = static_cast<time_t>(std::floor(estimate));
+  data.tv_nsec = static_cast<long>((estimate - data.tv_sec) * 1e9);
+  if (data.tv_nsec >= 1000000000L)
+  {
+    data.tv_nsec = 999999999L;
+  }
+  return data;
+}
+
+void SampledTimerStat::flushInformation(std::ostream& out) const
+{
+  out << getData();
+}
+
+void SampledTimerStat::safeFlushInformation(int fd) const
+{
+  safe_print<timespec>(fd, getData());
+}
+
+SExpr SampledTimerStat::getValue() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(8) << getData();
+  return SExpr(Rational::fromDecimal(ss.str()));
+}
+
+void SampledTimerStat::startSample()
+{
+  clock_gettime(CLOCK_MONOTONIC, &d_start);
+  d_sampling = true;
+}
+
+void SampledTimerStat::stopSample()
+{
+  ::timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  d_sampled += end - d_start;
+  ++d_samples;
+  d_sampling = false;
+}
+
 RegisterStatistic::RegisterStatistic(StatisticsRegistry* reg, Stat* stat)
     : d_reg(reg),
       d_stat(stat) {
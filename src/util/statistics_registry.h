@@ -36,6 +36,9 @@
 #ifndef CVC4__STATISTICS_REGISTRY_H
 #define CVC4__STATISTICS_REGISTRY_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <ctime>
 #include <iomanip>
 #include <map>
@@ -56,6 +59,15 @@ namespace CVC4 {
  */
 std::ostream& operator<<(std::ostream& os, const timespec& t) CVC4_PUBLIC;
 
+/** Print s as a JSON string, with quotes and escapes. */
+void stringToJSON(std::ostream& out, const std::string& s) CVC4_PUBLIC;
+
+/**
+ * Print e as a JSON value: numerals and rationals as numbers, strings and
+ * keywords as strings, and lists as arrays.
+ */
+void sexprToJSON(std::ostream& out, const SExpr& e) CVC4_PUBLIC;
+
 #ifdef CVC4_STATISTICS_ON
 #  define CVC4_USE_STATISTICS true
 #else
@@ -151,6 +163,15 @@ public:
     return SExpr(ss.str());
   }
 
+  /**
+   * Flush the value of this statistic to an output stream as a JSON value.
+   * By default, this is the value of getValue().
+   */
+  virtual void flushJSON(std::ostream& out) const
+  {
+    sexprToJSON(out, getValue());
+  }
+
 };/* class Stat */
 
 // A generic way of making a SExpr from templated stats code.
@@ -476,6 +497,81 @@ public:
 
 };/* class IntStat */
 
+/**
+ * An integer-valued counter that is cheap to increment, also from several
+ * threads.
+ *
+ * Each thread increments one of a fixed number of shards, on its own cache
+ * line, which is chosen when the thread first increments a counter. The
+ * increment is a relaxed load and store rather than an atomic
+ * read-modify-write, and the value is aggregated over the shards when it is
+ * read. Threads only share a shard if there are more threads than shards, in
+ * which case concurrent increments of the shared shard may be lost.
+ */
+class CVC4_PUBLIC CounterStat : public Stat
+{
+ public:
+  /** Construct a counter with the given name and value 0 */
+  CounterStat(const std::string& name) : Stat(name) {}
+
+  /** Increment the counter. */
+  CounterStat& operator++() { return *this += 1; }
+
+  /** Increment the counter by the given amount. */
+  CounterStat& operator+=(int64_t val)
+  {
+    if (CVC4_USE_STATISTICS)
+    {
+      std::atomic<int64_t>& v = d_shards[getShard()].d_value;
+      v.store(v.load(std::memory_order_relaxed) + val,
+              std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  /** Get the value of the counter, i.e. the sum of its shards. */
+  int64_t getData() const
+  {
+    int64_t sum = 0;
+    for (const Shard& s : d_shards)
+    {
+      sum += s.d_value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  void flushInformation(std::ostream& out) const override
+  {
+    out << getData();
+  }
+
+  void safeFlushInformation(int fd) const override
+  {
+    safe_print<int64_t>(fd, getData());
+  }
+
+  SExpr getValue() const override { return SExpr(Integer(getData())); }
+
+ private:
+  /** The number of shards of a counter */
+  static constexpr size_t s_numShards = 8;
+  /** A shard of a counter, on its own cache line */
+  struct alignas(64) Shard
+  {
+    std::atomic<int64_t> d_value{0};
+  };
+  /** Get the shard of the calling thread */
+  static size_t getShard()
+  {
+    static thread_local size_t shard = nextShard() % s_numShards;
+    return shard;
+  }
+  /** Get the shard of a thread that did not increment a counter yet */
+  static size_t nextShard();
+
+  std::array<Shard, s_numShards> d_shards;
+}; /* class CounterStat */
+
 template <class T>
 class SizeStat : public Stat {
 private:
@@ -626,6 +722,26 @@ public:
     }
   }
 
+  void flushJSON(std::ostream& out) const override
+  {
+    out << "{";
+    for (typename Histogram::const_iterator i = d_hist.begin(),
+                                            end = d_hist.end();
+         i != end;
+         ++i)
+    {
+      std::stringstream key;
+      key << (*i).first;
+      if (i != d_hist.begin())
+      {
+        out << ", ";
+      }
+      stringToJSON(out, key.str());
+      out << ": " << (*i).second;
+    }
+    out << "}";
+  }
+
   HistogramStat& operator<<(const T& val){
     if(CVC4_USE_STATISTICS) {
       if(d_hist.find(val) == d_hist.end()){
@@ -718,6 +834,28 @@ class IntegralHistogramStat : public Stat
     }
   }
 
+  void flushJSON(std::ostream& out) const override
+  {
+    out << "{";
+    bool first = true;
+    for (std::size_t i = 0, n = d_hist.size(); i < n; ++i)
+    {
+      if (d_hist[i] > 0)
+      {
+        if (!first)
+        {
+          out << ", ";
+        }
+        first = false;
+        std::stringstream key;
+        key << static_cast<Integral>(i + d_offset);
+        stringToJSON(out, key.str());
+        out << ": " << d_hist[i];
+      }
+    }
+    out << "}";
+  }
+
   IntegralHistogramStat& operator<<(Integral val)
   {
     if (CVC4_USE_STATISTICS)
@@ -878,6 +1016,116 @@ public:
   }
 };/* class CodeTimer */
 
+class SampledCodeTimer;
+
+/**
+ * A timer statistic that only reads the clock for a sample of its runs.
+ *
+ * Reading the clock at each start() and stop() of a TimerStat is too costly
+ * for code that runs very often. A SampledTimerStat reads it for one run in
+ * every 2^k, and its value is the time of the sampled runs, scaled by the
+ * ratio of all runs to sampled runs. The number of runs is counted exactly.
+ * As a TimerStat, it is not thread-safe.
+ */
+class CVC4_PUBLIC SampledTimerStat : public Stat
+{
+ public:
+  typedef CVC4::SampledCodeTimer CodeTimer;
+
+  /**
+   * Construct a sampled timer with the given name, which samples one run in
+   * every 2^sampleLog.
+   */
+  SampledTimerStat(const std::string& name, uint32_t sampleLog = 6)
+      : Stat(name),
+        d_mask((uint64_t(1) << sampleLog) - 1),
+        d_runs(0),
+        d_samples(0),
+        d_sampling(false),
+        d_start{0, 0},
+        d_sampled{0, 0}
+  {
+  }
+
+  /** Start a run of the timer. */
+  void start()
+  {
+    if (CVC4_USE_STATISTICS)
+    {
+      if ((d_runs++ & d_mask) == 0)
+      {
+        startSample();
+      }
+    }
+  }
+
+  /** Stop the current run of the timer. */
+  void stop()
+  {
+    if (CVC4_USE_STATISTICS)
+    {
+      if (d_sampling)
+      {
+        stopSample();
+      }
+    }
+  }
+
+  /** Get the number of runs */
+  uint64_t getRuns() const { return d_runs; }
+
+  /** Get the number of sampled runs */
+  uint64_t getSamples() const { return d_samples; }
+
+  /** Get the estimated time of all runs */
+  timespec getData() const;
+
+  void flushInformation(std::ostream& out) const override;
+
+  void safeFlushInformation(int fd) const override;
+
+  SExpr getValue() const override;
+
+ private:
+  /** Start a sampled run */
+  void startSample();
+  /** Stop a sampled run */
+  void stopSample();
+
+  /** The runs whose number has these bits clear are sampled */
+  uint64_t d_mask;
+  /** The number of runs */
+  uint64_t d_runs;
+  /** The number of sampled runs that were stopped */
+  uint64_t d_samples;
+  /** Whether the current run is sampled */
+  bool d_sampling;
+  /** The start time of the current sampled run */
+  timespec d_start;
+  /** The accumulated time of the sampled runs */
+  timespec d_sampled;
+}; /* class SampledTimerStat */
+
+/**
+ * As CodeTimer, for a SampledTimerStat: starts a run of the timer when
+ * constructed, and stops it when destructed.
+ */
+class SampledCodeTimer
+{
+ public:
+  SampledCodeTimer(SampledTimerStat& timer) : d_timer(timer)
+  {
+    d_timer.start();
+  }
+  ~SampledCodeTimer() { d_timer.stop(); }
+
+  SampledCodeTimer(const SampledCodeTimer& timer) = delete;
+  SampledCodeTimer& operator=(const SampledCodeTimer& timer) = delete;
+
+ private:
+  SampledTimerStat& d_timer;
+}; /* class SampledCodeTimer */
+
 /**
  * Resource-acquisition-is-initialization idiom for statistics
  * registry.  Useful for stack-based statistics (like in the driver).
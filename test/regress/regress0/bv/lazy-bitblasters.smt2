@@ -0,0 +1,13 @@
+; COMMAND-LINE: --bv-quick-xplain
+; COMMAND-LINE: --bv-algebraic-solver
+; COMMAND-LINE: --bv-quick-xplain --bv-algebraic-solver
+; EXPECT: unsat
+; Each of these options adds a lazy bit-blaster to the BV solver, whose CNF
+; streams register their statistics under the name of their bit-blaster.
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (= (bvadd x y) #x05))
+(assert (= (bvsub x y) #x01))
+(assert (= (bvmul x #x02) #x07))
+(check-sat)
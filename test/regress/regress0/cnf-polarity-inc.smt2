@@ -0,0 +1,35 @@
+; COMMAND-LINE: --incremental --cnf-polarity --simplification=none
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; (and p q) is defined positively only, and used in the negative polarity in
+; user contexts that are popped, the completion clauses must survive the pops
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun f (U) U)
+(declare-fun q () Bool)
+(declare-fun r () Bool)
+(declare-fun s () Bool)
+(define-fun p () Bool (= (f a) b))
+(assert (or (and p q) r))
+(check-sat)
+(push 1)
+(assert (or (not (and p q)) s))
+(assert (not s))
+(assert p)
+(assert q)
+(check-sat)
+(pop 1)
+(check-sat)
+(push 1)
+(assert (not (or (and p q) s)))
+(assert (= (f a) b))
+(assert q)
+(check-sat)
+(pop 1)
+(assert (not r))
+(check-sat)
@@ -0,0 +1,19 @@
+; COMMAND-LINE: --cnf-polarity --simplification=none
+; EXPECT: unsat
+; (and p q) is first defined positively only, its use in the negative
+; polarity below needs the completion clause (or (not p) (not q) (and p q))
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun f (U) U)
+(declare-fun q () Bool)
+(declare-fun r () Bool)
+(declare-fun s () Bool)
+(define-fun p () Bool (= (f a) b))
+(assert (or (and p q) r))
+(assert (or (not (and p q)) s))
+(assert (not s))
+(assert p)
+(assert q)
+(check-sat)
@@ -0,0 +1,29 @@
+; COMMAND-LINE: --decision=justification-watched --incremental
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+(set-logic QF_UFLIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(declare-fun p () Bool)
+(declare-fun q () Bool)
+(declare-fun f (Int) Int)
+(assert (or (and p (> x 2)) (and (not p) (< x 0))))
+(assert (= (ite q (f x) (+ y 1)) z))
+(assert (xor p (= y (ite (> x y) x y))))
+(assert (=> (> z 10) (and q (= (f x) (- z 1)))))
+(check-sat)
+(push 1)
+(assert (> z 10))
+(assert (not q))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= p (> z 5)))
+(assert (distinct (f x) (f y)))
+(check-sat)
+(assert (= x y))
+(check-sat)
+(pop 1)
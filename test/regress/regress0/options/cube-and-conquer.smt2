@@ -0,0 +1,19 @@
+; COMMAND-LINE: --cube-workers=2 --cube-count=8
+; EXPECT: unsat
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(declare-fun c () Bool)
+(assert (and (>= x 0) (>= y 0) (>= z 0)))
+(assert (or a (> x 5)))
+(assert (or b (> y 5)))
+(assert (or c (> z 5)))
+(assert (=> a (< (+ x y) 3)))
+(assert (=> b (< (+ y z) 3)))
+(assert (=> c (< (+ x z) 3)))
+(assert (> (+ x y z) 7))
+(assert (< (+ x y z) 10))
+(check-sat)
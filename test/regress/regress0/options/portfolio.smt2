@@ -0,0 +1,11 @@
+; COMMAND-LINE: --portfolio=3
+; EXPECT: sat
+; EXPECT: unsat
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (> (f x) (f y)))
+(check-sat)
+(assert (= x y))
+(check-sat)
@@ -0,0 +1,47 @@
+; COMMAND-LINE: --incremental
+; COMMAND-LINE: --incremental --no-theory-explanation-cache
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+; EXPECT: sat
+; The same equalities and predicate literals are propagated by the theory of
+; equality in every scope, with different antecedents after backtracking, so
+; that cached explanations are reused or rejected as improper.
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(assert (or (= a b) (= a c)))
+(assert (or (= b d) (= c d)))
+(assert (P a))
+(push 1)
+(assert (not (P d)))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (not (P d)))
+(assert (= b c))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (not (P d)))
+(assert (not (= a c)))
+(assert (not (= b d)))
+(check-sat)
+(push 1)
+(assert (= b c))
+(check-sat)
+(pop 1)
+(pop 1)
+(push 1)
+(assert (not (P d)))
+(assert (= c b))
+(assert (not (= a b)))
+(check-sat)
+(pop 1)
+(check-sat)
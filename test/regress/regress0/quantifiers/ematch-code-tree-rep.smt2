@@ -0,0 +1,21 @@
+; COMMAND-LINE: --ematch-engine=code-tree --simplification=none
+; COMMAND-LINE: --ematch-engine=code-tree --ematch-code-tree-inc --simplification=none
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun g (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(declare-fun e () U)
+(assert (forall ((x U)) (! (P (f (g x) a)) :pattern ((f (g x) a)))))
+; c is merged into the larger class of g(b), hence the argument c of f(c, a)
+; is not the representative of its class when the nested g(x) is matched
+(assert (= (g b) d))
+(assert (= d e))
+(assert (= c (g b)))
+(assert (not (P (f c a))))
+(check-sat)
@@ -0,0 +1,20 @@
+; COMMAND-LINE: --ematch-engine=code-tree
+; COMMAND-LINE: --ematch-engine=code-tree --ematch-code-tree-inc
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun g (U) U)
+(declare-fun h (U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+; the triggers share the prefix f(g(x), _), and are matched modulo c = g(b)
+(assert (forall ((x U)) (! (P (f (g x) a)) :pattern ((f (g x) a)))))
+(assert (forall ((y U)) (! (Q (f (g y) a)) :pattern ((f (g y) a)))))
+(assert (forall ((x U) (y U)) (! (= (h (f (g x) y)) x) :pattern ((f (g x) y)))))
+(assert (= c (g b)))
+(assert (or (not (P (f c a))) (not (Q (f c a))) (not (= (h (f c a)) b))))
+(check-sat)
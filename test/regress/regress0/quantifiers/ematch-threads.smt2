@@ -0,0 +1,24 @@
+; REQUIRES: thread-safe-nodes
+; COMMAND-LINE: --ematch-engine=code-tree --ematch-threads=2
+; COMMAND-LINE: --ematch-engine=code-tree --ematch-threads=4
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun g (U) U)
+(declare-fun h (U) U)
+(declare-fun k (U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun R (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+; the trees of f, g and k are matched in parallel
+(assert (forall ((x U)) (! (P (f (g x) a)) :pattern ((f (g x) a)))))
+(assert (forall ((x U) (y U)) (! (= (h (f (g x) y)) x) :pattern ((f (g x) y)))))
+(assert (forall ((x U)) (! (Q (g x)) :pattern ((g x)))))
+(assert (forall ((x U)) (! (R (k (h x))) :pattern ((k (h x))))))
+(assert (= c (g b)))
+(assert (or (not (P (f c a))) (not (Q c)) (not (= (h (f c a)) b)) (not (R (k (h a))))))
+(check-sat)
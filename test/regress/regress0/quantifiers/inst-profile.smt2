@@ -0,0 +1,11 @@
+; COMMAND-LINE: --inst-profile=/dev/null
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-const a U)
+(assert (! (forall ((x U)) (! (=> (P x) (P (f x))) :pattern ((P x)))) :named ax))
+(assert (P a))
+(assert (not (P (f (f a)))))
+(check-sat)
@@ -0,0 +1,20 @@
+; COMMAND-LINE: --incremental --term-db-inc
+; EXPECT: unsat
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-const a U)
+(declare-const b U)
+(assert (forall ((x U)) (=> (P x) (P (f x)))))
+(assert (P a))
+(assert (= (f (f a)) b))
+(push 1)
+(assert (not (P b)))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (not (P (f b))))
+(check-sat)
+(pop 1)
@@ -0,0 +1,30 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --incremental --sat-solver=cadical
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (or (= (f x) 0) (= (f y) 1)))
+(assert (<= 0 x 3))
+(check-sat)
+(push 1)
+(assert (= x y))
+(assert (not (= (f x) 0)))
+(assert (not (= (f y) 1)))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (> x 1))
+(check-sat)
+(push 1)
+(assert (< x 2))
+(check-sat)
+(pop 1)
+(pop 1)
+(assert (= x 3))
+(check-sat)
@@ -0,0 +1,14 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --sat-solver=cadical
+; EXPECT: sat
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun p () Bool)
+(assert (or p (> x 3)))
+(assert (or (not p) (< y 0)))
+(assert (= (f x) (+ y 1)))
+(assert (not (= (f y) (f x))))
+(assert (<= (+ x y) 5))
+(check-sat)
@@ -0,0 +1,16 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --sat-solver=cadical
+; EXPECT: unsat
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (or (= x y) (= x z)))
+(assert (or (= y 1) (= y 2)))
+(assert (= z (+ y 2)))
+(assert (not (= (f x) (f 1))))
+(assert (not (= (f x) (f 2))))
+(assert (not (= (f x) (f 3))))
+(assert (not (= (f x) (f 4))))
+(check-sat)
@@ -2068,6 +2068,52 @@ TEST_F(TestApiBlackSolver, resetAssertions)
   d_solver.checkSatAssuming({slt, ule});
 }
 
+TEST_F(TestApiBlackSolver, clone)
+{
+  d_solver.setOption("incremental", "true");
+  d_solver.setOption("produce-models", "true");
+
+  Sort intSort = d_solver.getIntegerSort();
+  Term x = d_solver.mkConst(intSort, "x");
+  Term y = d_solver.mkConst(intSort, "y");
+  Term one = d_solver.mkInteger(1);
+  Term five = d_solver.mkInteger(5);
+  // x is eliminated by preprocessing
+  d_solver.assertFormula(
+      d_solver.mkTerm(EQUAL, x, d_solver.mkTerm(PLUS, y, one)));
+  d_solver.assertFormula(d_solver.mkTerm(GT, y, five));
+  ASSERT_TRUE(d_solver.checkSat().isSat());
+
+  std::unique_ptr<Solver> clone = d_solver.clone();
+  // terms of the solver can be used with the clone and vice versa
+  ASSERT_TRUE(clone->checkSat().isSat());
+  ASSERT_EQ(clone->getValue(x),
+            clone->getValue(clone->mkTerm(PLUS, y, clone->mkInteger(1))));
+  clone->push();
+  clone->assertFormula(clone->mkTerm(LT, x, five));
+  ASSERT_TRUE(clone->checkSat().isUnsat());
+  clone->pop();
+  Term z = clone->mkConst(intSort, "z");
+  clone->assertFormula(d_solver.mkTerm(EQUAL, z, x));
+  ASSERT_TRUE(clone->checkSat().isSat());
+
+  // the clone does not affect the solver
+  d_solver.assertFormula(d_solver.mkTerm(GT, x, d_solver.mkInteger(10)));
+  ASSERT_TRUE(d_solver.checkSat().isSat());
+  ASSERT_TRUE(clone->checkSatAssuming(clone->mkTerm(LT, z, five)).isUnsat());
+
+  // a solver with its own terms is not compatible
+  Solver other;
+  ASSERT_THROW(other.assertFormula(d_solver.mkTerm(GT, x, five)),
+               CVC4ApiException);
+}
+
+TEST_F(TestApiBlackSolver, cloneUnsatCores)
+{
+  d_solver.setOption("produce-unsat-cores", "true");
+  ASSERT_THROW(d_solver.clone(), CVC4ApiException);
+}
+
 TEST_F(TestApiBlackSolver, mkSygusVar)
 {
   Sort boolSort = d_solver.getBooleanSort();
@@ -0,0 +1,272 @@
+/*********************                                                        */
+/*! \file cdflat_benchmark_black.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Microbenchmarks of the flat context-dependent containers.
+ **
+ ** Compares CDFlatHashMap and CDFlatHashSet against CDHashMap, CDHashSet and
+ ** CDInsertHashMap on push/insert/lookup/pop workloads, and checks that the
+ ** containers agree. The default sizes are small so that the tests run
+ ** quickly; the DISABLED_ variants run with larger sizes, e.g. with
+ ** --gtest_also_run_disabled_tests, and trace their timings in builds with
+ ** tracing enabled.
+ **/
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/output.h"
+#include "context/cdflat_hashmap.h"
+#include "context/cdflat_hashset.h"
+#include "context/cdhashmap.h"
+#include "context/cdhashset.h"
+#include "context/cdinsert_hashmap.h"
+#include "test_context.h"
+
+namespace CVC4 {
+namespace test {
+
+using CVC4::context::CDFlatHashMap;
+using CVC4::context::CDFlatHashSet;
+using CVC4::context::CDHashMap;
+using CVC4::context::CDHashSet;
+using CVC4::context::CDInsertHashMap;
+using CVC4::context::Context;
+
+class TestContextCDFlatBenchmarkBlack : public TestContext
+{
+ protected:
+  /** Sizes of a workload */
+  struct Workload
+  {
+    /** Number of push/pop rounds */
+    size_t d_rounds;
+    /** Number of entries inserted at level 0 */
+    size_t d_base;
+    /** Number of insertions per round */
+    size_t d_inserts;
+    /** Number of lookups per round */
+    size_t d_lookups;
+  };
+
+  void SetUp() override
+  {
+    TestContext::SetUp();
+    d_small = Workload{100, 1000, 500, 1000};
+    d_large = Workload{2000, 100000, 5000, 20000};
+  }
+
+  /** Generate random keys, half of them are in the base of the workload */
+  static std::vector<int32_t> makeKeys(const Workload& w, size_t n)
+  {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int32_t> dist(0, 2 * w.d_base);
+    std::vector<int32_t> keys(n);
+    for (int32_t& k : keys)
+    {
+      k = dist(rng);
+    }
+    return keys;
+  }
+
+  /** Trace the time of f and return its result */
+  template <class F>
+  static uint64_t time(const std::string& name, F f)
+  {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t result = f();
+    auto end = std::chrono::steady_clock::now();
+    Trace("cdflat-benchmark")
+        << "  " << name << ": "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+               .count()
+        << " us" << std::endl;
+    return result;
+  }
+
+  /**
+   * Each round pushes the context, inserts or overwrites keys, looks up keys
+   * and pops the context. Returns a checksum of the lookups.
+   */
+  template <class Map>
+  static uint64_t mapRounds(Context* c, const Workload& w)
+  {
+    std::vector<int32_t> keys = makeKeys(w, w.d_inserts + w.d_lookups);
+    Map map(c);
+    for (size_t i = 0; i < w.d_base; ++i)
+    {
+      map.insert(static_cast<int32_t>(2 * i), static_cast<int32_t>(i));
+    }
+    uint64_t sum = 0;
+    for (size_t r = 0; r < w.d_rounds; ++r)
+    {
+      c->push();
+      size_t offset = r % w.d_lookups;
+      for (size_t i = 0; i < w.d_inserts; ++i)
+      {
+        map.insert(keys[(offset + i) % keys.size()], static_cast<int32_t>(r));
+      }
+      for (size_t i = 0; i < w.d_lookups; ++i)
+      {
+        auto it = map.find(keys[w.d_inserts + i]);
+        if (it != map.end())
+        {
+          sum += static_cast<uint64_t>((*it).second);
+        }
+      }
+      sum += map.size();
+      c->pop();
+    }
+    return sum + map.size();
+  }
+
+  /** As mapRounds, for sets */
+  template <class Set>
+  static uint64_t setRounds(Context* c, const Workload& w)
+  {
+    std::vector<int32_t> keys = makeKeys(w, w.d_inserts + w.d_lookups);
+    Set set(c);
+    for (size_t i = 0; i < w.d_base; ++i)
+    {
+      set.insert(static_cast<int32_t>(2 * i));
+    }
+    uint64_t sum = 0;
+    for (size_t r = 0; r < w.d_rounds; ++r)
+    {
+      c->push();
+      size_t offset = r % w.d_lookups;
+      for (size_t i = 0; i < w.d_inserts; ++i)
+      {
+        set.insert(keys[(offset + i) % keys.size()]);
+      }
+      for (size_t i = 0; i < w.d_lookups; ++i)
+      {
+        sum += set.contains(keys[w.d_inserts + i]) ? 1 : 0;
+      }
+      sum += set.size();
+      c->pop();
+    }
+    return sum + set.size();
+  }
+
+  /** As mapRounds, with insertions of absent keys only */
+  template <class Map, class Insert>
+  static uint64_t insertOnceRounds(Context* c, const Workload& w, Insert ins)
+  {
+    std::vector<int32_t> keys = makeKeys(w, w.d_inserts + w.d_lookups);
+    Map map(c);
+    for (size_t i = 0; i < w.d_base; ++i)
+    {
+      ins(map, static_cast<int32_t>(2 * i), static_cast<int32_t>(i));
+    }
+    uint64_t sum = 0;
+    for (size_t r = 0; r < w.d_rounds; ++r)
+    {
+      c->push();
+      size_t offset = r % w.d_lookups;
+      for (size_t i = 0; i < w.d_inserts; ++i)
+      {
+        ins(map, keys[(offset + i) % keys.size()], static_cast<int32_t>(r));
+      }
+      for (size_t i = 0; i < w.d_lookups; ++i)
+      {
+        int32_t k = keys[w.d_inserts + i];
+        if (map.contains(k))
+        {
+          sum += static_cast<uint64_t>(map.find(k)->second);
+        }
+      }
+      sum += map.size();
+      c->pop();
+    }
+    return sum + map.size();
+  }
+
+  void runMaps(const Workload& w)
+  {
+    Trace("cdflat-benchmark") << "map insert/overwrite:" << std::endl;
+    uint64_t ref = time("CDHashMap", [&]() {
+      return mapRounds<CDHashMap<int32_t, int32_t>>(d_context.get(), w);
+    });
+    uint64_t flat = time("CDFlatHashMap", [&]() {
+      return mapRounds<CDFlatHashMap<int32_t, int32_t>>(d_context.get(), w);
+    });
+    ASSERT_EQ(ref, flat);
+  }
+
+  void runSets(const Workload& w)
+  {
+    Trace("cdflat-benchmark") << "set insert:" << std::endl;
+    typedef CDHashSet<int32_t, std::hash<int32_t>> HashSet;
+    uint64_t ref = time("CDHashSet", [&]() {
+      return setRounds<HashSet>(d_context.get(), w);
+    });
+    uint64_t flat = time("CDFlatHashSet", [&]() {
+      return setRounds<CDFlatHashSet<int32_t>>(d_context.get(), w);
+    });
+    ASSERT_EQ(ref, flat);
+  }
+
+  void runInsertOnce(const Workload& w)
+  {
+    Trace("cdflat-benchmark") << "map insert once:" << std::endl;
+    typedef CDInsertHashMap<int32_t, int32_t> InsertMap;
+    typedef CDFlatHashMap<int32_t, int32_t> FlatMap;
+    uint64_t ref = time("CDInsertHashMap", [&]() {
+      return insertOnceRounds<InsertMap>(
+          d_context.get(), w, [](InsertMap& m, int32_t k, int32_t d) {
+            m.insert_safe(k, d);
+          });
+    });
+    uint64_t flat = time("CDFlatHashMap", [&]() {
+      return insertOnceRounds<FlatMap>(
+          d_context.get(), w, [](FlatMap& m, int32_t k, int32_t d) {
+            m.insertIfAbsent(k, d);
+          });
+    });
+    ASSERT_EQ(ref, flat);
+  }
+
+  Workload d_small;
+  Workload d_large;
+};
+
+TEST_F(TestContextCDFlatBenchmarkBlack, map) { runMaps(d_small); }
+
+TEST_F(TestContextCDFlatBenchmarkBlack, set) { runSets(d_small); }
+
+TEST_F(TestContextCDFlatBenchmarkBlack, insert_once)
+{
+  runInsertOnce(d_small);
+}
+
+TEST_F(TestContextCDFlatBenchmarkBlack, DISABLED_map_large)
+{
+  Trace.on("cdflat-benchmark");
+  runMaps(d_large);
+  Trace.off("cdflat-benchmark");
+}
+
+TEST_F(TestContextCDFlatBenchmarkBlack, DISABLED_set_large)
+{
+  Trace.on("cdflat-benchmark");
+  runSets(d_large);
+  Trace.off("cdflat-benchmark");
+}
+
+TEST_F(TestContextCDFlatBenchmarkBlack, DISABLED_insert_once_large)
+{
+  Trace.on("cdflat-benchmark");
+  runInsertOnce(d_large);
+  Trace.off("cdflat-benchmark");
+}
+
+}  // namespace test
+}  // namespace CVC4
@@ -0,0 +1,311 @@
+/*********************                                                        */
+/*! \file cdflat_hashmap_black.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Black box testing of CVC4::context::CDFlatHashMap<>.
+ **
+ ** Black box testing of CVC4::context::CDFlatHashMap<> and
+ ** CVC4::context::CDFlatHashSet<>.
+ **/
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+#include "context/cdflat_hashmap.h"
+#include "context/cdflat_hashset.h"
+#include "context/cdhashmap.h"
+#include "test_context.h"
+
+namespace CVC4 {
+namespace test {
+
+using CVC4::context::CDFlatHashMap;
+using CVC4::context::CDFlatHashSet;
+using CVC4::context::CDHashMap;
+
+class TestContextCDFlatHashMapBlack : public TestContext
+{
+ protected:
+  /** Returns the elements in a CDFlatHashMap. */
+  static std::map<int32_t, int32_t> get_elements(
+      const CDFlatHashMap<int32_t, int32_t>& map)
+  {
+    return std::map<int32_t, int32_t>{map.begin(), map.end()};
+  }
+
+  /** Returns true if the elements in map are the same as expected. */
+  static bool elements_are(const CDFlatHashMap<int32_t, int32_t>& map,
+                           const std::map<int32_t, int32_t>& expected)
+  {
+    return get_elements(map) == expected;
+  }
+
+  /** Returns true if the elements in set are the same as expected. */
+  static bool elements_are(const CDFlatHashSet<int32_t>& set,
+                           const std::set<int32_t>& expected)
+  {
+    return std::set<int32_t>{set.begin(), set.end()} == expected;
+  }
+};
+
+TEST_F(TestContextCDFlatHashMapBlack, simple_sequence)
+{
+  CDFlatHashMap<int32_t, int32_t> map(d_context.get());
+  ASSERT_TRUE(elements_are(map, {}));
+
+  map.insert(3, 4);
+  ASSERT_TRUE(elements_are(map, {{3, 4}}));
+
+  {
+    d_context->push();
+    ASSERT_TRUE(elements_are(map, {{3, 4}}));
+
+    map.insert(5, 6);
+    map.insert(9, 8);
+    ASSERT_TRUE(elements_are(map, {{3, 4}, {5, 6}, {9, 8}}));
+
+    {
+      d_context->push();
+      map.insert(1, 2);
+      map.insert(3, 7);
+      map.insert(3, 10);
+      ASSERT_TRUE(elements_are(map, {{1, 2}, {3, 10}, {5, 6}, {9, 8}}));
+      ASSERT_TRUE(map.contains(1));
+      ASSERT_EQ(map.find(3)->second, 10);
+      ASSERT_EQ(map.find(4), map.end());
+
+      {
+        d_context->push();
+        map.insert(5, 11);
+        ASSERT_FALSE(map.insertIfAbsent(1, 12));
+        ASSERT_TRUE(map.insertIfAbsent(13, 14));
+        ASSERT_TRUE(
+            elements_are(map, {{1, 2}, {3, 10}, {5, 11}, {9, 8}, {13, 14}}));
+        d_context->pop();
+      }
+
+      ASSERT_TRUE(elements_are(map, {{1, 2}, {3, 10}, {5, 6}, {9, 8}}));
+      d_context->pop();
+    }
+
+    ASSERT_TRUE(elements_are(map, {{3, 4}, {5, 6}, {9, 8}}));
+    d_context->pop();
+  }
+
+  ASSERT_TRUE(elements_are(map, {{3, 4}}));
+  ASSERT_FALSE(map.contains(5));
+  ASSERT_EQ(map.size(), 1);
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, insertion_order)
+{
+  CDFlatHashMap<int32_t, int32_t> map(d_context.get());
+  d_context->push();
+  for (int32_t i = 100; i > 0; --i)
+  {
+    map.insert(i, -i);
+  }
+  int32_t expected = 100;
+  for (const std::pair<int32_t, int32_t>& e : map)
+  {
+    ASSERT_EQ(e.first, expected);
+    ASSERT_EQ(e.second, -expected);
+    --expected;
+  }
+  d_context->pop();
+  ASSERT_TRUE(map.empty());
+  ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, grow_and_pop)
+{
+  CDFlatHashMap<int32_t, int32_t> map(d_context.get());
+  for (int32_t i = 0; i < 10; ++i)
+  {
+    map.insert(i, i);
+  }
+  d_context->push();
+  // the table grows several times above level 0
+  for (int32_t i = 10; i < 10000; ++i)
+  {
+    map.insert(i, i);
+  }
+  for (int32_t i = 0; i < 10000; i += 7)
+  {
+    map.insert(i, -1);
+  }
+  ASSERT_EQ(map.size(), 10000);
+  d_context->pop();
+
+  ASSERT_EQ(map.size(), 10);
+  for (int32_t i = 0; i < 10000; ++i)
+  {
+    ASSERT_EQ(map.contains(i), i < 10);
+  }
+  ASSERT_TRUE(
+      elements_are(map,
+                   {{0, 0},
+                    {1, 1},
+                    {2, 2},
+                    {3, 3},
+                    {4, 4},
+                    {5, 5},
+                    {6, 6},
+                    {7, 7},
+                    {8, 8},
+                    {9, 9}}));
+
+  d_context->push();
+  for (int32_t i = 5; i < 20; ++i)
+  {
+    map.insertIfAbsent(i, 2 * i);
+  }
+  ASSERT_EQ(map.size(), 20);
+  ASSERT_EQ(map.find(15)->second, 30);
+  ASSERT_EQ(map.find(5)->second, 5);
+  d_context->pop();
+  ASSERT_EQ(map.size(), 10);
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, shared_trail)
+{
+  CDFlatHashMap<int32_t, int32_t> map1(d_context.get());
+  CDFlatHashMap<int32_t, int32_t> map2(d_context.get());
+  CDFlatHashSet<int32_t> set(d_context.get());
+
+  d_context->push();
+  for (int32_t i = 0; i < 50; ++i)
+  {
+    map1.insert(i % 10, i);
+    map2.insert(i, i);
+    set.insert(i % 3);
+  }
+  {
+    d_context->push();
+    map2.insert(1, 100);
+    map1.insert(20, 20);
+    map2.insert(2, 200);
+    ASSERT_FALSE(set.insert(1));
+    ASSERT_TRUE(set.insert(3));
+    d_context->pop();
+  }
+  ASSERT_EQ(map1.size(), 10);
+  ASSERT_EQ(map1.find(3)->second, 43);
+  ASSERT_FALSE(map1.contains(20));
+  ASSERT_EQ(map2.size(), 50);
+  ASSERT_EQ(map2.find(1)->second, 1);
+  ASSERT_EQ(map2.find(2)->second, 2);
+  ASSERT_TRUE(elements_are(set, {0, 1, 2}));
+  d_context->pop();
+
+  ASSERT_TRUE(map1.empty());
+  ASSERT_TRUE(map2.empty());
+  ASSERT_TRUE(set.empty());
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, set)
+{
+  CDFlatHashSet<int32_t> set(d_context.get());
+  ASSERT_TRUE(set.insert(1));
+  ASSERT_FALSE(set.insert(1));
+  d_context->push();
+  ASSERT_TRUE(set.insert(2));
+  ASSERT_TRUE(set.insert(3));
+  ASSERT_EQ(set.count(2), 1);
+  ASSERT_EQ(*set.find(3), 3);
+  ASSERT_TRUE(elements_are(set, {1, 2, 3}));
+  d_context->pop();
+  ASSERT_TRUE(elements_are(set, {1}));
+  ASSERT_EQ(set.find(2), set.end());
+  ASSERT_EQ(set.count(2), 0);
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, destroy_above_level_zero)
+{
+  CDFlatHashMap<int32_t, int32_t> map(d_context.get());
+  d_context->push();
+  map.insert(1, 1);
+  {
+    std::unique_ptr<CDFlatHashMap<int32_t, int32_t>> tmp(
+        new CDFlatHashMap<int32_t, int32_t>(d_context.get()));
+    tmp->insert(2, 2);
+    map.insert(3, 3);
+    tmp->insert(4, 4);
+  }
+  map.insert(5, 5);
+  d_context->pop();
+  ASSERT_TRUE(map.empty());
+
+  // many short-lived maps, destroyed before or after some of their changes
+  // are undone
+  d_context->push();
+  for (int32_t i = 0; i < 100; ++i)
+  {
+    {
+      CDFlatHashMap<int32_t, int32_t> tmp(d_context.get());
+      tmp.insert(i, i);
+      d_context->push();
+      tmp.insert(i + 1, i);
+      map.insert(i, i);
+      if (i % 2 == 0)
+      {
+        d_context->pop();
+      }
+    }
+    if (i % 2 != 0)
+    {
+      d_context->pop();
+    }
+    map.insert(-i - 1, i);
+  }
+  ASSERT_EQ(map.size(), 100);
+  d_context->pop();
+  ASSERT_TRUE(map.empty());
+}
+
+TEST_F(TestContextCDFlatHashMapBlack, differential)
+{
+  // Compare against CDHashMap on a random sequence of operations.
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int32_t> key(0, 200);
+  std::uniform_int_distribution<int32_t> op(0, 19);
+  CDFlatHashMap<int32_t, int32_t> flat(d_context.get());
+  CDHashMap<int32_t, int32_t> ref(d_context.get());
+  for (int32_t i = 0; i < 20000; ++i)
+  {
+    int32_t o = op(rng);
+    if (o == 0 && d_context->getLevel() < 20)
+    {
+      d_context->push();
+    }
+    else if (o == 1 && d_context->getLevel() > 0)
+    {
+      d_context->pop();
+    }
+    else
+    {
+      int32_t k = key(rng);
+      ASSERT_EQ(flat.insert(k, i), ref.count(k) == 0);
+      ref.insert(k, i);
+    }
+    ASSERT_EQ(flat.size(), ref.size());
+    if (i % 100 == 0)
+    {
+      ASSERT_EQ(get_elements(flat),
+                (std::map<int32_t, int32_t>{ref.begin(), ref.end()}));
+    }
+  }
+  d_context->popto(0);
+  ASSERT_EQ(get_elements(flat),
+            (std::map<int32_t, int32_t>{ref.begin(), ref.end()}));
+}
+
+}  // namespace test
+}  // namespace CVC4
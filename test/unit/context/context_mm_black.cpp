@@ -103,5 +103,89 @@ TEST_F(TestContextMMBlack, push_pop)
 #endif
 }
 
+TEST_F(TestContextMMBlack, chunk_growth)
+{
+#ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
+  ContextMemoryConfig config;
+  config.d_maxChunkSizeBytes = 16 * 16384;
+  d_cmm->setConfig(config);
+  const ContextMemoryStatistics& stats = d_cmm->getStatistics();
+  ASSERT_EQ(stats.d_chunksAllocated, 1);
+
+  // The chunks grow with the memory used by the region
+  d_cmm->push();
+  for (uint32_t i = 0; i < 1024; ++i)
+  {
+    char* newMem = (char*)d_cmm->newData(1024);
+    memset(newMem, 'a', 1024);
+  }
+  ASSERT_EQ(d_cmm->getHighWaterMark(1), 1024 * 1024);
+  ASSERT_LT(stats.d_chunksAllocated, 1 + 1024 / 16);
+  uint64_t allocated = stats.d_chunksAllocated;
+  d_cmm->pop();
+  ASSERT_EQ(d_cmm->getHighWaterMark(1), 1024 * 1024);
+  ASSERT_EQ(d_cmm->getHighWaterMark(0), 0);
+
+  // The same workload reuses the free chunks
+  d_cmm->push();
+  for (uint32_t i = 0; i < 1024; ++i)
+  {
+    d_cmm->newData(1024);
+  }
+  d_cmm->pop();
+  ASSERT_EQ(stats.d_chunksAllocated, allocated);
+  ASSERT_EQ(stats.d_chunksRecycled, allocated - 1);
+  ASSERT_GE(stats.d_peakChunkBytes, 1024 * 1024);
+#endif
+}
+
+TEST_F(TestContextMMBlack, free_memory_bound)
+{
+#ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
+  ContextMemoryConfig config;
+  config.d_maxFreeBytes = 4 * 16384;
+  d_cmm->setConfig(config);
+  const ContextMemoryStatistics& stats = d_cmm->getStatistics();
+  d_cmm->push();
+  for (uint32_t i = 0; i < 10; ++i)
+  {
+    d_cmm->newData(16384);
+  }
+  d_cmm->pop();
+  ASSERT_EQ(stats.d_chunksAllocated, 10);
+  ASSERT_EQ(stats.d_chunksReleased, 5);
+  ASSERT_EQ(stats.d_chunkBytes, 5 * 16384);
+#endif
+}
+
+TEST_F(TestContextMMBlack, huge_pages)
+{
+  // Huge pages are only a hint, the memory must be usable either way
+  ContextMemoryConfig config;
+  config.d_maxChunkSizeBytes = 64 * 16384;
+  config.d_hugePages = true;
+  d_cmm->setConfig(config);
+  for (uint32_t p = 0; p < 3; ++p)
+  {
+    d_cmm->push();
+    std::vector<char*> allocs;
+    for (uint32_t i = 0; i < 4096; ++i)
+    {
+      char* newMem = (char*)d_cmm->newData(512);
+      memset(newMem, static_cast<char>(i), 512);
+      allocs.push_back(newMem);
+    }
+    for (uint32_t i = 0; i < 4096; ++i)
+    {
+      ASSERT_EQ(allocs[i][0], static_cast<char>(i));
+      ASSERT_EQ(allocs[i][511], static_cast<char>(i));
+    }
+  }
+  for (uint32_t p = 0; p < 3; ++p)
+  {
+    d_cmm->pop();
+  }
+}
+
 }  // namespace test
 }  // namespace CVC4
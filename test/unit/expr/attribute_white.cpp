@@ -15,6 +15,7 @@
  **/
 
 #include <string>
+#include <vector>
 
 #include "base/check.h"
 #include "expr/attribute.h"
@@ -444,5 +445,66 @@ TEST_F(TestExprWhiteAttribute, attributes)
 
   ASSERT_FALSE(unnamed.hasAttribute(VarNameAttr()));
 }
+
+TEST_F(TestExprWhiteAttribute, attribute_tables)
+{
+  AttributeManager* am = d_nodeManager->d_attrManager;
+  AttrHash<std::string>& strings = am->d_strings;
+  std::vector<Node> nodes;
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    nodes.push_back(d_nodeManager->mkVar(*d_booleanType));
+  }
+  size_t size = strings.size();
+#ifdef CVC4_STATISTICS_ON
+  int64_t hits = strings.d_hits.getData();
+  int64_t misses = strings.d_misses.getData();
+#endif
+
+  // grow the tables past their initial capacity
+  for (uint32_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i].setAttribute(TestStringAttr1(), std::to_string(i));
+    if (i % 2 == 0)
+    {
+      nodes[i].setAttribute(TestStringAttr2(), std::to_string(2 * i));
+    }
+  }
+  ASSERT_EQ(strings.size(), size + 1500);
+  for (uint32_t i = 0; i < nodes.size(); ++i)
+  {
+    ASSERT_EQ(nodes[i].getAttribute(TestStringAttr1()), std::to_string(i));
+    ASSERT_EQ(nodes[i].hasAttribute(TestStringAttr2()), i % 2 == 0);
+  }
+#ifdef CVC4_STATISTICS_ON
+  ASSERT_EQ(strings.d_hits.getData(), hits + 1500);
+  ASSERT_EQ(strings.d_misses.getData(), misses + 500);
+#endif
+
+  // delete the attributes of every third node
+  for (uint32_t i = 0; i < nodes.size(); i += 3)
+  {
+    am->deleteAllAttributes(nodes[i].d_nv);
+  }
+  for (uint32_t i = 0; i < nodes.size(); ++i)
+  {
+    ASSERT_EQ(nodes[i].hasAttribute(TestStringAttr1()), i % 3 != 0);
+    ASSERT_EQ(nodes[i].hasAttribute(TestStringAttr2()),
+              i % 2 == 0 && i % 3 != 0);
+    if (i % 3 != 0)
+    {
+      ASSERT_EQ(nodes[i].getAttribute(TestStringAttr1()), std::to_string(i));
+    }
+  }
+
+  // drop all entries of one attribute
+  AttributeUniqueId id = AttributeManager::getAttributeId(TestStringAttr1());
+  am->deleteAttributes({&id});
+  for (const Node& n : nodes)
+  {
+    ASSERT_FALSE(n.hasAttribute(TestStringAttr1()));
+  }
+  ASSERT_TRUE(nodes[2].hasAttribute(TestStringAttr2()));
+}
 }  // namespace test
 }  // namespace CVC4
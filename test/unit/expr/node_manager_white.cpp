@@ -15,7 +15,10 @@
  **/
 
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "expr/attribute.h"
 #include "expr/node_manager.h"
 #include "test_node.h"
 #include "util/integer.h"
@@ -80,5 +83,145 @@ TEST_F(TestNodeWhiteNodeManager, topological_sort)
     ASSERT_EQ(NodeManager::TopologicalSort(roots), result);
   }
 }
+
+TEST_F(TestNodeWhiteNodeManager, slab_allocation)
+{
+  NodeValueAllocator& alloc = d_nodeManager->d_nvAllocator;
+  Node x = d_nodeManager->mkSkolem("x", *d_boolTypeNode);
+  while (d_nodeManager->hasZombies())
+  {
+    d_nodeManager->reclaimZombies();
+  }
+  uint64_t slabNodes = alloc.d_stats.d_slabNodes;
+  uint64_t heapNodes = alloc.d_stats.d_heapNodes;
+  {
+    // 12 children exceed the inline capacity of NodeBuilder<>, so the node is
+    // moved from the builder's heap buffer to a slab
+    NodeBuilder<> nbSmall(kind::AND);
+    NodeBuilder<> nbLarge(kind::AND);
+    for (uint32_t i = 0; i < 12; ++i)
+    {
+      nbSmall << d_nodeManager->mkSkolem("y", *d_boolTypeNode);
+    }
+    for (uint32_t i = 0; i <= NodeValueAllocator::MAX_SLAB_CHILDREN; ++i)
+    {
+      nbLarge << x;
+    }
+    Node small = nbSmall;
+    Node large = nbLarge;
+    Node c = d_nodeManager->mkConst(Rational(12345));
+    ASSERT_EQ(small.getNumChildren(), 12);
+    ASSERT_EQ(large.getNumChildren(),
+              NodeValueAllocator::MAX_SLAB_CHILDREN + 1);
+    // 12 skolems and small
+    ASSERT_EQ(alloc.d_stats.d_slabNodes, slabNodes + 13);
+    // large and c
+    ASSERT_EQ(alloc.d_stats.d_heapNodes, heapNodes + 2);
+    ASSERT_GT(alloc.d_stats.d_slabBytes, 0);
+  }
+  // reclaiming small turns its children into zombies
+  while (d_nodeManager->hasZombies())
+  {
+    d_nodeManager->reclaimZombies();
+  }
+  ASSERT_EQ(alloc.d_stats.d_slabNodes, slabNodes);
+  ASSERT_EQ(alloc.d_stats.d_heapNodes, heapNodes);
+  ASSERT_GT(alloc.d_stats.d_batchFrees, 0);
+
+  // freed blocks are reused
+  uint64_t slabBytes = alloc.d_stats.d_slabBytes;
+  std::vector<Node> nodes;
+  for (uint32_t i = 0; i < 100; ++i)
+  {
+    nodes.push_back(d_nodeManager->mkSkolem("z", *d_boolTypeNode));
+  }
+  ASSERT_EQ(alloc.d_stats.d_slabBytes, slabBytes);
+}
+
+#ifdef CVC4_THREAD_SAFE_NODES
+TEST_F(TestNodeWhiteNodeManager, concurrent_hash_consing)
+{
+  const unsigned numThreads = 4;
+  const unsigned numConsts = 1000;
+  NodeManager* nm = d_nodeManager.get();
+  std::vector<std::vector<Node>> results(numThreads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numThreads; ++t)
+  {
+    threads.emplace_back([nm, t, numConsts, &results]() {
+      NodeManagerScope nms(nm);
+      for (unsigned round = 0; round < 10; ++round)
+      {
+        // all but the last round become zombies that are reclaimed while the
+        // other threads create the same constants
+        std::vector<Node> consts;
+        for (unsigned i = 0; i < numConsts; ++i)
+        {
+          consts.push_back(nm->mkConst(Rational(i)));
+        }
+        results[t] = consts;
+      }
+    });
+  }
+  for (std::thread& t : threads)
+  {
+    t.join();
+  }
+  for (unsigned t = 1; t < numThreads; ++t)
+  {
+    for (unsigned i = 0; i < numConsts; ++i)
+    {
+      ASSERT_EQ(results[t][i].getId(), results[0][i].getId());
+    }
+  }
+}
+
+struct TestConcurrentAttrTag
+{
+};
+using TestConcurrentAttr = expr::Attribute<TestConcurrentAttrTag, Node>;
+
+TEST_F(TestNodeWhiteNodeManager, concurrent_attributes)
+{
+  const unsigned numThreads = 4;
+  const unsigned numConsts = 1000;
+  NodeManager* nm = d_nodeManager.get();
+  std::vector<std::thread> threads;
+  // not std::vector<bool>, whose elements cannot be written concurrently
+  std::vector<char> ok(numThreads, true);
+  for (unsigned t = 0; t < numThreads; ++t)
+  {
+    threads.emplace_back([nm, t, numConsts, &ok]() {
+      NodeManagerScope nms(nm);
+      TestConcurrentAttr attr;
+      for (unsigned round = 0; round < 10; ++round)
+      {
+        // the attributes are set on shared constants, whose values become
+        // zombies that are reclaimed, with their attributes, while the other
+        // threads read and set attributes
+        for (unsigned i = 0; i < numConsts; ++i)
+        {
+          Node c = nm->mkConst(Rational(i));
+          Node v = nm->mkConst(Rational(i + numConsts * (round + 1)));
+          c.setAttribute(attr, v);
+          Node w = c.getAttribute(attr);
+          if (!w.isConst() || w.getConst<Rational>() < Rational(numConsts))
+          {
+            ok[t] = false;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& t : threads)
+  {
+    t.join();
+  }
+  for (unsigned t = 0; t < numThreads; ++t)
+  {
+    ASSERT_TRUE(ok[t]);
+  }
+}
+#endif /* CVC4_THREAD_SAFE_NODES */
 }  // namespace test
 }  // namespace CVC4
@@ -40,7 +40,7 @@ namespace test {
 class FakeSatSolver : public SatSolver
 {
  public:
-  FakeSatSolver() : d_nextVar(0), d_addClauseCalled(false) {}
+  FakeSatSolver() : d_nextVar(0), d_addClauseCalled(false), d_numClauses(0) {}
 
   SatVariable newVar(bool theoryAtom, bool preRegister, bool canErase) override
   {
@@ -54,6 +54,7 @@ class FakeSatSolver : public SatSolver
   ClauseId addClause(SatClause& c, bool lemma) override
   {
     d_addClauseCalled = true;
+    ++d_numClauses;
     return ClauseIdUndef;
   }
 
@@ -65,10 +66,16 @@ class FakeSatSolver : public SatSolver
 
   bool nativeXor() override { return false; }
 
-  void reset() { d_addClauseCalled = false; }
+  void reset()
+  {
+    d_addClauseCalled = false;
+    d_numClauses = 0;
+  }
 
   unsigned int addClauseCalled() { return d_addClauseCalled; }
 
+  unsigned numClauses() const { return d_numClauses; }
+
   unsigned getAssertionLevel() const override { return 0; }
 
   bool isDecision(Node) const { return false; }
@@ -99,6 +106,7 @@ class FakeSatSolver : public SatSolver
  private:
   SatVariable d_nextVar;
   bool d_addClauseCalled;
+  unsigned d_numClauses;
 };
 
 class TestPropWhiteCnfStream : public TestSmt
@@ -269,5 +277,47 @@ TEST_F(TestPropWhiteCnfStream, ensure_literal)
   ASSERT_TRUE(d_satSolver->addClauseCalled());
   ASSERT_TRUE(d_cnfStream->hasLiteral(a_and_b));
 }
+
+TEST_F(TestPropWhiteCnfStream, polarity)
+{
+  NodeManagerScope nms(d_nodeManager.get());
+  Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+  Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+  Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+  Node d = d_nodeManager->mkVar(d_nodeManager->booleanType());
+  Node e = d_nodeManager->mkVar(d_nodeManager->booleanType());
+  Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+  Node c_and_d = d_nodeManager->mkNode(kind::AND, c, d);
+  Node f = d_nodeManager->mkNode(kind::OR, a_and_b, c_and_d);
+
+  // the full definitions of the two conjunctions have 3 clauses each
+  d_cnfStream->convertAndAssert(f, false, false);
+  ASSERT_EQ(d_satSolver->numClauses(), 7u);
+
+  Context context;
+  CnfStream cnf(d_satSolver.get(),
+                d_cnfRegistrar.get(),
+                &context,
+                &d_smtEngine->getOutputManager(),
+                d_smtEngine->getResourceManager(),
+                FormulaLitPolicy::INTERNAL,
+                "",
+                true);
+  // only the positive directions are needed
+  d_satSolver->reset();
+  cnf.convertAndAssert(f, false, false);
+  ASSERT_EQ(d_satSolver->numClauses(), 5u);
+  // a lemma using a_and_b negatively completes its definition
+  d_satSolver->reset();
+  cnf.convertAndAssert(
+      d_nodeManager->mkNode(kind::OR, a_and_b.notNode(), e), true, false);
+  ASSERT_EQ(d_satSolver->numClauses(), 2u);
+  // literals are equal to their formula after ensureLiteral
+  d_satSolver->reset();
+  cnf.ensureLiteral(a_and_b);
+  ASSERT_EQ(d_satSolver->numClauses(), 0u);
+  cnf.ensureLiteral(c_and_d);
+  ASSERT_EQ(d_satSolver->numClauses(), 1u);
+}
 }  // namespace test
 }  // namespace CVC4
@@ -0,0 +1,173 @@
+/*********************                                                        */
+/*! \file regexp_automaton_black.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Unit tests for the compilation of regular expressions to automata
+ **
+ ** Unit tests for the compilation of regular expressions to automata.
+ **/
+
+#include <memory>
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "test_smt.h"
+#include "theory/strings/regexp_automaton.h"
+#include "util/rational.h"
+
+namespace CVC4 {
+
+using namespace kind;
+using namespace theory;
+using namespace theory::strings;
+
+namespace test {
+
+class TestTheoryBlackRegexpAutomaton : public TestSmt
+{
+ protected:
+  void SetUp() override
+  {
+    TestSmt::SetUp();
+    d_sigma = d_nodeManager->mkNode(REGEXP_SIGMA, std::vector<Node>{});
+    d_sigmaStar = d_nodeManager->mkNode(REGEXP_STAR, d_sigma);
+  }
+
+  Node mkStr(const std::string& s)
+  {
+    return d_nodeManager->mkNode(STRING_TO_REGEXP,
+                                 d_nodeManager->mkConst(String(s)));
+  }
+
+  Node mkRange(const std::string& a, const std::string& b)
+  {
+    return d_nodeManager->mkNode(REGEXP_RANGE,
+                                 d_nodeManager->mkConst(String(a)),
+                                 d_nodeManager->mkConst(String(b)));
+  }
+
+  Node d_sigma;
+  Node d_sigmaStar;
+};
+
+TEST_F(TestTheoryBlackRegexpAutomaton, membership)
+{
+  RegExpCompiler compiler(100000);
+  // (re.++ "a" (re.* (re.union "b" (re.range "0" "9"))) "c")
+  Node r = d_nodeManager->mkNode(
+      REGEXP_CONCAT,
+      mkStr("a"),
+      d_nodeManager->mkNode(
+          REGEXP_STAR,
+          d_nodeManager->mkNode(REGEXP_UNION, mkStr("b"), mkRange("0", "9"))),
+      mkStr("c"));
+  std::shared_ptr<const RegExpDfa> dfa = compiler.compile(r);
+  ASSERT_NE(dfa, nullptr);
+  ASSERT_TRUE(dfa->accepts(String("ac")));
+  ASSERT_TRUE(dfa->accepts(String("ab0b9c")));
+  ASSERT_TRUE(dfa->accepts(String("xab5c"), 1));
+  ASSERT_FALSE(dfa->accepts(String("abxc")));
+  ASSERT_FALSE(dfa->accepts(String("ab")));
+  ASSERT_FALSE(dfa->accepts(String("")));
+  ASSERT_FALSE(dfa->isEmpty());
+  ASSERT_FALSE(dfa->isUniversal());
+  // the result is cached
+  ASSERT_EQ(compiler.compile(r), dfa);
+
+  // ((_ re.loop 2 3) "ab")
+  Node loop = d_nodeManager->mkNode(
+      d_nodeManager->mkConst(RegExpLoop(2, 3)), mkStr("ab"));
+  dfa = compiler.compile(loop);
+  ASSERT_NE(dfa, nullptr);
+  ASSERT_FALSE(dfa->accepts(String("ab")));
+  ASSERT_TRUE(dfa->accepts(String("abab")));
+  ASSERT_TRUE(dfa->accepts(String("ababab")));
+  ASSERT_FALSE(dfa->accepts(String("abababab")));
+
+  // (re.comp (re.* re.allchar)) is empty, (re.comp re.none) is universal
+  dfa = compiler.compile(
+      d_nodeManager->mkNode(REGEXP_COMPLEMENT, d_sigmaStar));
+  ASSERT_NE(dfa, nullptr);
+  ASSERT_TRUE(dfa->isEmpty());
+  Node none = d_nodeManager->mkNode(REGEXP_EMPTY, std::vector<Node>{});
+  dfa = compiler.compile(d_nodeManager->mkNode(REGEXP_COMPLEMENT, none));
+  ASSERT_NE(dfa, nullptr);
+  ASSERT_TRUE(dfa->isUniversal());
+  ASSERT_EQ(dfa->getNumStates(), 1u);
+}
+
+TEST_F(TestTheoryBlackRegexpAutomaton, intersection_inclusion)
+{
+  RegExpCompiler compiler(100000);
+  Node digits = d_nodeManager->mkNode(REGEXP_STAR, mkRange("0", "9"));
+  Node letters = d_nodeManager->mkNode(REGEXP_PLUS, mkRange("a", "z"));
+  // digits and letters only share the empty string, which letters excludes
+  ASSERT_EQ(compiler.isIntersectionEmpty(digits, letters), 1);
+  ASSERT_EQ(compiler.isIntersectionEmpty(digits, d_sigmaStar), 0);
+
+  // (re.++ re.allchar re.allchar re.allchar) includes "abc" but not "ab"
+  Node sigma3 =
+      d_nodeManager->mkNode(REGEXP_CONCAT, d_sigma, d_sigma, d_sigma);
+  ASSERT_EQ(compiler.includes(sigma3, mkStr("abc")), 1);
+  ASSERT_EQ(compiler.includes(sigma3, mkStr("ab")), 0);
+  // (re.* (re.union "a" "b")) includes (re.* "ab")
+  Node abStar = d_nodeManager->mkNode(
+      REGEXP_STAR, d_nodeManager->mkNode(REGEXP_UNION, mkStr("a"), mkStr("b")));
+  Node abWordStar = d_nodeManager->mkNode(REGEXP_STAR, mkStr("ab"));
+  ASSERT_EQ(compiler.includes(abStar, abWordStar), 1);
+  ASSERT_EQ(compiler.includes(abWordStar, abStar), 0);
+}
+
+TEST_F(TestTheoryBlackRegexpAutomaton, failure)
+{
+  // regular expressions with variables are not compiled
+  Node x = d_nodeManager->mkSkolem("x", d_nodeManager->stringType());
+  Node rx = d_nodeManager->mkNode(STRING_TO_REGEXP, x);
+  RegExpCompiler compiler(100000);
+  ASSERT_EQ(compiler.compile(rx), nullptr);
+  ASSERT_EQ(compiler.isIntersectionEmpty(rx, d_sigmaStar), -1);
+
+  // (re.++ (re.* (re.union "a" "b")) "a" re.allchar^8) needs 2^9 states
+  std::vector<Node> children;
+  children.push_back(d_nodeManager->mkNode(
+      REGEXP_STAR,
+      d_nodeManager->mkNode(REGEXP_UNION, mkStr("a"), mkStr("b"))));
+  children.push_back(mkStr("a"));
+  for (size_t i = 0; i < 8; i++)
+  {
+    children.push_back(d_sigma);
+  }
+  Node r = d_nodeManager->mkNode(REGEXP_CONCAT, children);
+  RegExpCompiler small(100);
+  ASSERT_EQ(small.compile(r), nullptr);
+  ASSERT_NE(compiler.compile(r), nullptr);
+}
+
+TEST_F(TestTheoryBlackRegexpAutomaton, cache_bound)
+{
+  RegExpCompiler compiler(100);
+  Node r = d_nodeManager->mkNode(STRING_TO_REGEXP, mkStr("b"));
+  std::shared_ptr<const RegExpDfa> dfa = compiler.compile(r);
+  ASSERT_NE(dfa, nullptr);
+  ASSERT_EQ(compiler.compile(r), dfa);
+  // the cache is cleared once the cached automata exceed the size bound
+  bool cleared = false;
+  std::string w;
+  for (size_t i = 0; i < 100 && !cleared; i++)
+  {
+    w += "a";
+    Node rw = d_nodeManager->mkNode(STRING_TO_REGEXP, mkStr(w));
+    compiler.compile(rw);
+    cleared = compiler.compile(r) != dfa;
+  }
+  ASSERT_TRUE(cleared);
+}
+
+}  // namespace test
+}  // namespace CVC4
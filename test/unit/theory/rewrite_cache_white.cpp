@@ -0,0 +1,70 @@
+/*********************                                                        */
+/*! \file rewrite_cache_white.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::RewriteCache.
+ **/
+
+#include "smt/smt_engine_scope.h"
+#include "test_smt.h"
+#include "theory/rewrite_cache.h"
+
+namespace CVC4 {
+
+using namespace theory;
+
+namespace test {
+
+class TestTheoryWhiteRewriteCache : public TestSmt
+{
+};
+
+TEST_F(TestTheoryWhiteRewriteCache, lru_eviction)
+{
+  smt::SmtScope scope(d_smtEngine.get());
+  RewriteCacheStatistics stats;
+  RewriteCache cache(3 * RewriteCache::entrySize(), stats);
+  ASSERT_EQ(cache.capacity(), 3);
+
+  TypeNode intType = d_nodeManager->integerType();
+  Node x = d_nodeManager->mkVar("x", intType);
+  Node y = d_nodeManager->mkVar("y", intType);
+  Node z = d_nodeManager->mkVar("z", intType);
+  Node w = d_nodeManager->mkVar("w", intType);
+  Node zero = d_nodeManager->mkConst(Rational(0));
+
+  cache.set(THEORY_ARITH, true, x, zero);
+  cache.set(THEORY_ARITH, false, x, x);
+  cache.set(THEORY_UF, false, y, y);
+  ASSERT_EQ(cache.size(), 3);
+  ASSERT_EQ(cache.get(THEORY_ARITH, true, x), zero);
+  ASSERT_EQ(cache.get(THEORY_ARITH, false, x), x);
+  ASSERT_TRUE(cache.get(THEORY_ARITH, false, y).isNull());
+
+  // (UF, post, y) is the least recently used entry
+  cache.set(THEORY_ARITH, false, z, z);
+  ASSERT_EQ(cache.size(), 3);
+  ASSERT_TRUE(cache.get(THEORY_UF, false, y).isNull());
+  ASSERT_EQ(cache.get(THEORY_ARITH, false, z), z);
+
+  // updating an entry does not evict
+  cache.set(THEORY_ARITH, true, x, x);
+  ASSERT_EQ(cache.get(THEORY_ARITH, true, x), x);
+  ASSERT_EQ(cache.size(), 3);
+
+  // (ARITH, post, x) is now the least recently used entry
+  cache.set(THEORY_ARITH, false, w, w);
+  ASSERT_TRUE(cache.get(THEORY_ARITH, false, x).isNull());
+  ASSERT_EQ(cache.get(THEORY_ARITH, true, x), x);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_TRUE(cache.get(THEORY_ARITH, false, w).isNull());
+}
+}  // namespace test
+}  // namespace CVC4
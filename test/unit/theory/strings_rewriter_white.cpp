@@ -60,5 +60,24 @@ TEST_F(TestTheoryWhiteStringsRewriter, rewrite_leq)
   }
 }
 
+TEST_F(TestTheoryWhiteStringsRewriter, rule_profile)
+{
+  TypeNode strType = d_nodeManager->stringType();
+  Node abc = d_nodeManager->mkConst(::CVC4::String("ABC"));
+  Node x = d_nodeManager->mkVar("x", strType);
+
+  RewriteProfileStat<Rewrite> profile("test::ruleProfile");
+  StringsRewriter sr(nullptr, &profile);
+  sr.postRewrite(d_nodeManager->mkNode(STRING_LENGTH, abc));
+  sr.postRewrite(d_nodeManager->mkNode(STRING_LENGTH, x));
+  sr.postRewrite(d_nodeManager->mkNode(STRING_TOLOWER, abc));
+  ASSERT_EQ(profile.getApplications(Rewrite::LEN_EVAL), 1);
+  ASSERT_EQ(profile.getSuccesses(Rewrite::LEN_EVAL), 1);
+  ASSERT_EQ(profile.getApplications(Rewrite::STR_CONV_CONST), 1);
+  // (str.len x) does not rewrite
+  ASSERT_EQ(profile.getApplications(Rewrite::NONE), 1);
+  ASSERT_EQ(profile.getSuccesses(Rewrite::NONE), 0);
+}
+
 }  // namespace test
 }  // namespace CVC4
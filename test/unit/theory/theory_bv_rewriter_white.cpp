@@ -20,6 +20,7 @@
 
 #include "expr/node.h"
 #include "test_smt.h"
+#include "theory/bv/theory_bv_rewrite_rules_simplification.h"
 #include "theory/rewriter.h"
 #include "util/bitvector.h"
 
@@ -27,6 +28,7 @@ namespace CVC4 {
 
 using namespace kind;
 using namespace theory;
+using namespace theory::bv;
 
 namespace test {
 
@@ -80,5 +82,34 @@ TEST_F(TestTheoryWhiteBvRewriter, rewrite_bv_ite)
   Node nr = Rewriter::rewrite(n);
   ASSERT_EQ(nr, Rewriter::rewrite(nr));
 }
+
+TEST_F(TestTheoryWhiteBvRewriter, rule_profile)
+{
+  TypeNode bvType = d_nodeManager->mkBitVectorType(4);
+  Node one = d_nodeManager->mkConst(BitVector(1, 1u));
+  Node c = d_nodeManager->mkVar("c", d_nodeManager->mkBitVectorType(1));
+  Node x = d_nodeManager->mkVar("x", bvType);
+  Node y = d_nodeManager->mkVar("y", bvType);
+  Node constCond = d_nodeManager->mkNode(BITVECTOR_ITE, one, x, y);
+  Node varCond = d_nodeManager->mkNode(BITVECTOR_ITE, c, x, y);
+
+  RewriteRuleProfile profile("test::ruleProfile");
+  // not recorded without an active profile
+  ASSERT_EQ(RewriteRule<BvIteConstCond>::run<true>(constCond), x);
+  {
+    RewriteProfileScope<RewriteRuleId> scope(&profile);
+    ASSERT_EQ(RewriteRule<BvIteConstCond>::run<true>(constCond), x);
+    ASSERT_EQ(RewriteRule<BvIteConstCond>::run<true>(varCond), varCond);
+  }
+  ASSERT_EQ(RewriteProfileScope<RewriteRuleId>::active(), nullptr);
+  ASSERT_EQ(profile.getApplications(BvIteConstCond), 2);
+  ASSERT_EQ(profile.getSuccesses(BvIteConstCond), 1);
+  ASSERT_EQ(profile.getApplications(BvIteEqualChildren), 0);
+
+  std::stringstream ss;
+  profile.flushInformation(ss);
+  ASSERT_EQ(ss.str().find("(BvIteConstCond : applications 2, successes 1, "),
+            1);
+}
 }  // namespace test
 }  // namespace CVC4
@@ -0,0 +1,315 @@
+/*********************                                                        */
+/*! \file theory_quantifiers_inst_match_index_white.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::inst::InstMatchIndex.
+ **/
+
+#include <memory>
+#include <vector>
+
+#include "context/context.h"
+#include "smt/smt_engine_scope.h"
+#include "test_smt.h"
+#include "theory/quantifiers/inst_match_index.h"
+#include "theory/quantifiers/quantifiers_state.h"
+#include "theory/uf/equality_engine.h"
+#include "theory/valuation.h"
+
+namespace CVC4 {
+
+using namespace theory;
+using namespace theory::inst;
+using namespace theory::quantifiers;
+
+namespace test {
+
+class TestTheoryWhiteQuantifiersInstMatchIndex : public TestSmt
+{
+ protected:
+  void SetUp() override
+  {
+    TestSmt::SetUp();
+    d_scope.reset(new smt::SmtScope(d_smtEngine.get()));
+    d_context.reset(new context::Context());
+    d_userContext.reset(new context::UserContext());
+    d_logic.reset(new LogicInfo("ALL"));
+    d_ee.reset(new eq::EqualityEngine(d_context.get(), "test", false));
+    d_qs.reset(new QuantifiersState(
+        d_context.get(), d_userContext.get(), Valuation(nullptr), *d_logic));
+    d_qs->setEqualityEngine(d_ee.get());
+    TypeNode u = d_nodeManager->mkSort("U");
+    d_a = d_nodeManager->mkVar("a", u);
+    d_b = d_nodeManager->mkVar("b", u);
+    d_c = d_nodeManager->mkVar("c", u);
+    d_d = d_nodeManager->mkVar("d", u);
+  }
+
+  void TearDown() override
+  {
+    d_a = Node::null();
+    d_b = Node::null();
+    d_c = Node::null();
+    d_d = Node::null();
+    d_qs.reset();
+    d_ee.reset();
+    d_logic.reset();
+    d_userContext.reset();
+    d_context.reset();
+    d_scope.reset();
+  }
+
+  /** Assert a = b to the equality engine */
+  void assertEqual(Node a, Node b)
+  {
+    Node eq = a.eqNode(b);
+    d_ee->assertEquality(eq, true, eq);
+  }
+
+  /** Check the invariants of the hash table of idx */
+  void checkTable(const InstMatchIndex& idx)
+  {
+    size_t numUsed = 0;
+    size_t numTombstones = 0;
+    size_t numLive = 0;
+    for (uint32_t i : idx.d_table)
+    {
+      if (i == InstMatchIndex::EMPTY)
+      {
+        continue;
+      }
+      numUsed++;
+      if (i == InstMatchIndex::TOMBSTONE)
+      {
+        numTombstones++;
+        continue;
+      }
+      numLive++;
+      ASSERT_FALSE(idx.d_entries[i].d_removed);
+    }
+    // the size of the table is a power of two, at most half of it is used
+    ASSERT_EQ(idx.d_table.size() & (idx.d_table.size() - 1), 0);
+    ASSERT_LE(2 * numUsed, idx.d_table.size());
+    ASSERT_EQ(numUsed, idx.d_numUsed);
+    ASSERT_EQ(numLive, idx.size());
+    ASSERT_EQ(numLive + numTombstones, numUsed);
+  }
+
+  /** Get the entries in the chain of first term f of idx */
+  std::vector<uint32_t> getChain(const InstMatchIndex& idx, Node f)
+  {
+    std::vector<uint32_t> chain;
+    auto it = idx.d_firstIndex.find(f);
+    if (it != idx.d_firstIndex.end())
+    {
+      for (uint32_t i = it->second; i != InstMatchIndex::NONE;
+           i = idx.d_entries[i].d_nextFirst)
+      {
+        chain.push_back(i);
+      }
+    }
+    return chain;
+  }
+
+  std::unique_ptr<smt::SmtScope> d_scope;
+  std::unique_ptr<context::Context> d_context;
+  std::unique_ptr<context::UserContext> d_userContext;
+  std::unique_ptr<LogicInfo> d_logic;
+  std::unique_ptr<eq::EqualityEngine> d_ee;
+  std::unique_ptr<QuantifiersState> d_qs;
+  Node d_a;
+  Node d_b;
+  Node d_c;
+  Node d_d;
+};
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, add_remove_readd)
+{
+  InstMatchIndex idx(2);
+  std::vector<Node> ab = {d_a, d_b};
+  std::vector<Node> ba = {d_b, d_a};
+  ASSERT_EQ(idx.size(), 0);
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, ab));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, ab));
+  ASSERT_FALSE(idx.addInstMatch(*d_qs, ab));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, ba));
+  ASSERT_EQ(idx.size(), 2);
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, ab));
+
+  ASSERT_TRUE(idx.removeInstMatch(ab));
+  ASSERT_FALSE(idx.removeInstMatch(ab));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, ab));
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, ba));
+  ASSERT_EQ(idx.size(), 1);
+
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, ab));
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, ab));
+  ASSERT_EQ(idx.size(), 2);
+  checkTable(idx);
+}
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, mod_eq)
+{
+  InstMatchIndex idx(2);
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_c}));
+  ASSERT_FALSE(idx.d_hasFirstIndex);
+  // terms that are not in the equality engine are only equal to themselves
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_c}, true));
+  ASSERT_TRUE(idx.d_hasFirstIndex);
+
+  assertEqual(d_a, d_b);
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_c}));
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, {d_b, d_c}, true));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_d}, true));
+  assertEqual(d_c, d_d);
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, {d_b, d_d}, true));
+  ASSERT_FALSE(idx.addInstMatch(*d_qs, {d_b, d_d}, true));
+  ASSERT_EQ(idx.size(), 1);
+
+  // entries added once the chains are built are found modulo equality
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_d, d_a}));
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, {d_c, d_b}, true));
+
+  // removed entries are skipped
+  ASSERT_TRUE(idx.removeInstMatch({d_a, d_c}));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_d}, true));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_b, d_d}, true));
+  ASSERT_EQ(idx.size(), 2);
+}
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, cd_push_pop)
+{
+  CDInstMatchIndex idx(d_context.get(), 2);
+  std::vector<Node> ab = {d_a, d_b};
+  std::vector<Node> cd = {d_c, d_d};
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, ab));
+
+  d_context->push();
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, cd));
+  ASSERT_TRUE(idx.removeInstMatch(ab));
+  ASSERT_EQ(idx.size(), 1);
+  d_context->pop();
+  ASSERT_EQ(idx.size(), 1);
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, ab));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, cd));
+  checkTable(idx);
+
+  // an entry removed in one context and added again in a nested one
+  d_context->push();
+  ASSERT_TRUE(idx.removeInstMatch(ab));
+  d_context->push();
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, ab));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, cd));
+  ASSERT_TRUE(idx.removeInstMatch(cd));
+  ASSERT_EQ(idx.size(), 1);
+  d_context->pop();
+  ASSERT_EQ(idx.size(), 0);
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, ab));
+  d_context->pop();
+  ASSERT_EQ(idx.size(), 1);
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, ab));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, cd));
+  ASSERT_EQ(idx.d_entries.size(), 1);
+  checkTable(idx);
+}
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, get_instantiations)
+{
+  InstMatchIndex idx(2);
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_c, d_a}));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_b}));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_b, d_b}));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_a}));
+  ASSERT_TRUE(idx.removeInstMatch({d_b, d_b}));
+  // the instantiations are appended in the order of the ids of their terms
+  std::vector<std::vector<Node>> insts = {{d_d, d_d}};
+  idx.getInstantiations(insts);
+  std::vector<std::vector<Node>> expected = {
+      {d_d, d_d}, {d_a, d_a}, {d_a, d_b}, {d_c, d_a}};
+  ASSERT_EQ(insts, expected);
+}
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, tombstones_rehash)
+{
+  InstMatchIndex idx(2);
+  std::vector<Node> terms = {d_a, d_b, d_c, d_d};
+  for (unsigned i = 0; i < 32; i++)
+  {
+    terms.push_back(d_nodeManager->mkVar("t", d_a.getType()));
+  }
+  std::vector<std::vector<Node>> ms;
+  for (const Node& s : terms)
+  {
+    for (const Node& t : {d_a, d_b, d_c})
+    {
+      ms.push_back({s, t});
+      ASSERT_TRUE(idx.addInstMatch(*d_qs, ms.back()));
+    }
+  }
+  checkTable(idx);
+  size_t tableSize = idx.d_table.size();
+
+  // removed entries leave tombstones
+  for (size_t i = 0; i < ms.size(); i += 2)
+  {
+    ASSERT_TRUE(idx.removeInstMatch(ms[i]));
+  }
+  checkTable(idx);
+  ASSERT_EQ(idx.d_table.size(), tableSize);
+  ASSERT_EQ(idx.d_numUsed, ms.size());
+  for (size_t i = 0; i < ms.size(); i++)
+  {
+    ASSERT_EQ(idx.existsInstMatch(*d_qs, ms[i]), i % 2 == 1);
+  }
+
+  // adding again reuses the tombstones as new entries
+  for (size_t i = 0; i < ms.size(); i += 2)
+  {
+    ASSERT_TRUE(idx.addInstMatch(*d_qs, ms[i]));
+    checkTable(idx);
+  }
+  ASSERT_EQ(idx.size(), ms.size());
+  for (const std::vector<Node>& m : ms)
+  {
+    ASSERT_TRUE(idx.existsInstMatch(*d_qs, m));
+  }
+  // rehashing drops the tombstones
+  idx.rehash(idx.size());
+  checkTable(idx);
+  ASSERT_EQ(idx.d_numUsed, idx.size());
+}
+
+TEST_F(TestTheoryWhiteQuantifiersInstMatchIndex, truncate_first_index)
+{
+  CDInstMatchIndex idx(d_context.get(), 2);
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_a}));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_b}));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_a}, true));
+  ASSERT_EQ(getChain(idx, d_a), std::vector<uint32_t>({1, 0}));
+
+  d_context->push();
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_a, d_c}));
+  ASSERT_TRUE(idx.addInstMatch(*d_qs, {d_b, d_a}));
+  ASSERT_EQ(getChain(idx, d_a), std::vector<uint32_t>({2, 1, 0}));
+  ASSERT_EQ(getChain(idx, d_b), std::vector<uint32_t>({3}));
+  d_context->pop();
+
+  ASSERT_EQ(getChain(idx, d_a), std::vector<uint32_t>({1, 0}));
+  ASSERT_TRUE(getChain(idx, d_b).empty());
+  ASSERT_EQ(idx.d_firstIndex.count(d_b), 0);
+  ASSERT_EQ(idx.d_entries.size(), 2);
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_a, d_c}));
+  checkTable(idx);
+
+  // the truncated chains are still used modulo equality
+  assertEqual(d_b, d_a);
+  ASSERT_TRUE(idx.existsInstMatch(*d_qs, {d_b, d_b}, true));
+  ASSERT_FALSE(idx.existsInstMatch(*d_qs, {d_b, d_c}, true));
+}
+}  // namespace test
+}  // namespace CVC4
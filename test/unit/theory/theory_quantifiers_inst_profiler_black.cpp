@@ -0,0 +1,170 @@
+/*********************                                                        */
+/*! \file theory_quantifiers_inst_profiler_black.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2020 by the authors listed in the file AUTHORS
+ ** in the top-level source directory and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Black box testing of CVC4::theory::quantifiers::InstProfiler.
+ **/
+
+#include <regex>
+#include <sstream>
+#include <vector>
+
+#include "smt/smt_engine_scope.h"
+#include "test_smt.h"
+#include "theory/quantifiers/inst_profiler.h"
+#include "theory/quantifiers/quantifiers_registry.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+
+using namespace theory;
+using namespace theory::quantifiers;
+
+namespace test {
+
+class TestTheoryBlackQuantifiersInstProfiler : public TestSmt
+{
+ protected:
+  /** Get s as a JSON string */
+  std::string toJSON(const std::string& s)
+  {
+    std::stringstream ss;
+    stringToJSON(ss, s);
+    return ss.str();
+  }
+
+  /** Get n as a JSON string */
+  std::string toJSON(Node n)
+  {
+    std::stringstream ss;
+    ss << n;
+    return toJSON(ss.str());
+  }
+
+  /** Get the JSON fields of the given counts, with the time left out */
+  std::string toJSON(unsigned attempts,
+                     unsigned insts,
+                     unsigned dups,
+                     unsigned conflicts)
+  {
+    std::stringstream ss;
+    ss << "\"attempts\": " << attempts << ", \"instantiations\": " << insts
+       << ", \"duplicates\": " << dups << ", \"conflicts\": " << conflicts
+       << ", \"time\": T";
+    return ss.str();
+  }
+
+  /** Record the outcome of an instantiation of q, as Instantiate does */
+  void addInstantiation(InstProfiler& ip, Node q, bool added, bool conflict)
+  {
+    bool timed;
+    InstProfiler::Counts& counts = ip.getCounts(q, timed);
+    counts.d_attempts++;
+    if (!added)
+    {
+      counts.d_duplicates++;
+      return;
+    }
+    counts.d_instantiations++;
+    if (conflict)
+    {
+      counts.d_conflicts++;
+    }
+  }
+};
+
+TEST_F(TestTheoryBlackQuantifiersInstProfiler, to_stream_json)
+{
+  smt::SmtScope scope(d_smtEngine.get());
+  QuantifiersRegistry qreg;
+  InstProfiler ip(qreg);
+
+  TypeNode u = d_nodeManager->mkSort("U");
+  TypeNode predType =
+      d_nodeManager->mkFunctionType(u, d_nodeManager->booleanType());
+  Node p = d_nodeManager->mkSkolem("P", predType);
+  Node f = d_nodeManager->mkSkolem("f", d_nodeManager->mkFunctionType(u, u));
+  Node x = d_nodeManager->mkBoundVar("x", u);
+  Node y = d_nodeManager->mkBoundVar("y", u);
+  Node px = d_nodeManager->mkNode(kind::APPLY_UF, p, x);
+  Node fx = d_nodeManager->mkNode(kind::APPLY_UF, f, x);
+  Node q1 = d_nodeManager->mkNode(
+      kind::FORALL,
+      d_nodeManager->mkNode(kind::BOUND_VAR_LIST, x),
+      d_nodeManager->mkNode(
+          kind::OR, px, d_nodeManager->mkNode(kind::APPLY_UF, p, fx)));
+  Node q2 = d_nodeManager->mkNode(
+      kind::FORALL,
+      d_nodeManager->mkNode(kind::BOUND_VAR_LIST, y),
+      d_nodeManager->mkNode(kind::APPLY_UF, p, y));
+
+  // the triggers of q1, over its instantiation constant
+  qreg.registerQuantifier(q1);
+  Node ic = qreg.getInstantiationConstant(q1, 0);
+  Node pic = d_nodeManager->mkNode(kind::APPLY_UF, p, ic);
+  Node fic = d_nodeManager->mkNode(kind::APPLY_UF, f, ic);
+
+  bool timed = false;
+  {
+    InstProfiler::TriggerScope ts(&ip, q1, {pic});
+    ip.getCounts(q1, timed);
+    ASSERT_FALSE(timed);
+    // q2 is not instantiated by the trigger of q1
+    ip.getCounts(q2, timed);
+    ASSERT_TRUE(timed);
+    addInstantiation(ip, q1, true, false);
+    addInstantiation(ip, q1, true, true);
+    addInstantiation(ip, q1, false, false);
+    {
+      // a nested trigger of the same quantified formula
+      InstProfiler::TriggerScope tsn(&ip, q1, {fic, pic});
+      addInstantiation(ip, q1, true, false);
+    }
+    addInstantiation(ip, q1, false, false);
+  }
+  ip.getCounts(q1, timed);
+  ASSERT_TRUE(timed);
+  addInstantiation(ip, q1, true, false);
+  for (unsigned i = 0; i < 5; i++)
+  {
+    addInstantiation(ip, q2, true, i == 0);
+  }
+  // a trigger scope without a profiler does nothing
+  {
+    InstProfiler::TriggerScope ts(nullptr, q2, {pic});
+  }
+
+  std::stringstream ss;
+  ip.toStreamJSON(ss);
+  std::string json = std::regex_replace(
+      ss.str(), std::regex("\"time\": [0-9.]+"), "\"time\": T");
+
+  // q2 has the most instantiations and comes first, the triggers of q1 are
+  // printed over its bound variable, ordered by their instantiation pattern
+  Node pat1 = d_nodeManager->mkNode(kind::INST_PATTERN, pic);
+  Node pat2 = d_nodeManager->mkNode(kind::INST_PATTERN, fic, pic);
+  std::string trigger1 = "    {\"trigger\": " + toJSON(px) + ", "
+                         + toJSON(4, 2, 2, 1) + "}";
+  std::string trigger2 = "    {\"trigger\": "
+                         + toJSON(fx.toString() + " " + px.toString()) + ", "
+                         + toJSON(1, 1, 0, 0) + "}";
+  std::stringstream expected;
+  expected << "{\"quantifiers\": [" << std::endl
+           << "  {\"formula\": " << toJSON(q2) << ", " << toJSON(5, 5, 0, 1)
+           << ", \"triggers\": []," << std::endl
+           << "   \"other\": {" << toJSON(5, 5, 0, 1) << "}}," << std::endl
+           << "  {\"formula\": " << toJSON(q1) << ", " << toJSON(6, 4, 2, 1)
+           << ", \"triggers\": [" << std::endl
+           << (pat1 < pat2 ? trigger1 : trigger2) << "," << std::endl
+           << (pat1 < pat2 ? trigger2 : trigger1) << "]," << std::endl
+           << "   \"other\": {" << toJSON(1, 1, 0, 0) << "}}" << std::endl
+           << "]}" << std::endl;
+  ASSERT_EQ(json, expected.str());
+}
+}  // namespace test
+}  // namespace CVC4
@@ -195,5 +195,38 @@ TEST_F(TestUtilBlackBitVector, static_helpers)
   ASSERT_EQ(BitVector::mkMinSigned(4).toSignedInteger(), Integer(-8));
   ASSERT_EQ(BitVector::mkMaxSigned(4).toSignedInteger(), Integer(7));
 }
+
+TEST_F(TestUtilBlackBitVector, word_boundary)
+{
+  // bit-vectors of size up to 64 are stored in a word, larger ones as Integer
+  BitVector ones64 = BitVector::mkOnes(64);
+  BitVector one64 = BitVector::mkOne(64);
+  ASSERT_EQ(ones64.getValue(), Integer(1).multiplyByPow2(64) - 1);
+  ASSERT_EQ(ones64 + one64, BitVector::mkZero(64));
+  ASSERT_EQ(ones64.toSignedInteger(), Integer(-1));
+  ASSERT_EQ(BitVector::mkMinSigned(64).toSignedInteger(),
+            -Integer(1).multiplyByPow2(63));
+  ASSERT_TRUE(BitVector::mkMinSigned(64).signedLessThan(one64));
+  ASSERT_EQ(ones64.unsignedDivTotal(BitVector::mkZero(64)), ones64);
+  ASSERT_EQ(one64.leftShift(BitVector(64, 63u)).isPow2(), 64u);
+  ASSERT_EQ(ones64.arithRightShift(BitVector(64, 64u)), ones64);
+  ASSERT_EQ(ones64.logicalRightShift(BitVector(64, 64u)), BitVector::mkZero(64));
+
+  // operations that cross the boundary between the representations
+  BitVector ones65 = ones64.signExtend(1);
+  ASSERT_EQ(ones65, BitVector::mkOnes(65));
+  ASSERT_EQ(ones64.zeroExtend(1).getValue(), ones64.getValue());
+  ASSERT_EQ(ones64.concat(d_one).getValue(),
+            Integer(1).multiplyByPow2(68) - 15);
+  ASSERT_EQ(ones65.extract(64, 1), ones64);
+  ASSERT_EQ(ones65 + BitVector::mkOne(65), BitVector::mkZero(65));
+  ASSERT_EQ(BitVector(65, Integer(1).multiplyByPow2(64)).toString(16),
+            "10000000000000000");
+  BitVector copy(ones65);
+  copy = ones64;
+  ASSERT_EQ(copy, ones64);
+  copy = ones65;
+  ASSERT_EQ(copy, ones65);
+}
 }  // namespace test
 }  // namespace CVC4
@@ -14,6 +14,7 @@
  ** Black box testing of CVC4::Rational.
  **/
 
+#include <limits>
 #include <sstream>
 
 #include "test.h"
@@ -43,5 +44,40 @@ TEST_F(TestUtilBlackRational, fromDecimal)
   ASSERT_THROW(Rational::fromDecimal("1.2/3");, std::invalid_argument);
   ASSERT_THROW(Rational::fromDecimal("Hello, world!");, std::invalid_argument);
 }
+
+TEST_F(TestUtilBlackRational, overflow)
+{
+  // values around the bounds of 64-bit machine integers
+  Rational max(std::numeric_limits<int64_t>::max(), int64_t(1));
+  Rational one(1, 1);
+  Integer maxInt(std::numeric_limits<int64_t>::max());
+  Rational sum = max + one;
+  ASSERT_EQ(sum.getNumerator(), maxInt + 1);
+  ASSERT_EQ(sum - one, max);
+  ASSERT_TRUE((sum - one - max).isZero());
+  ASSERT_EQ(-sum + one, -max);
+  ASSERT_EQ((-sum).getNumerator(), -(maxInt + 1));
+  ASSERT_GT(sum, max);
+  ASSERT_LT(-sum, -max);
+  ASSERT_EQ((max * max) / max, max);
+  ASSERT_EQ((max * max).getNumerator(), maxInt * maxInt);
+
+  // denominators that overflow when added
+  Rational a(int64_t(1), std::numeric_limits<int64_t>::max());
+  Rational b(int64_t(1), std::numeric_limits<int64_t>::max() - 1);
+  Rational c = a + b;
+  ASSERT_EQ(c - b, a);
+  ASSERT_GT(c, a);
+  ASSERT_EQ(
+      c.getDenominator(),
+      (maxInt * (maxInt - 1)).floorDivideQuotient(maxInt.gcd(maxInt - 1)));
+  ASSERT_EQ((a * max).isOne(), true);
+  ASSERT_EQ(a.inverse(), max);
+  ASSERT_EQ(Rational(maxInt + 1, maxInt + 1), one);
+  ASSERT_EQ((sum / sum).hash(), one.hash());
+  ASSERT_EQ(sum.toString(), "9223372036854775808");
+  ASSERT_EQ(c.floor(), Integer(0));
+  ASSERT_EQ(c.ceiling(), Integer(1));
+}
 }  // namespace test
 }  // namespace CVC4
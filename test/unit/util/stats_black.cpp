@@ -19,6 +19,8 @@
 #include <ctime>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "expr/proof_rule.h"
 #include "lib/clock_gettime.h"
@@ -181,5 +183,99 @@ TEST_F(TestUtilBlackStats, stats)
   ASSERT_EQ(ret, 0);
 #endif
 }
+
+TEST_F(TestUtilBlackStats, counter)
+{
+#ifdef CVC4_STATISTICS_ON
+  CounterStat counter("counter");
+  ASSERT_EQ(counter.getData(), 0);
+  ++counter;
+  counter += 41;
+  ASSERT_EQ(counter.getData(), 42);
+
+  // increments of threads that do not share a shard are not lost
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&counter]() {
+      for (size_t j = 0; j < 100000; ++j)
+      {
+        ++counter;
+      }
+    });
+  }
+  for (std::thread& t : threads)
+  {
+    t.join();
+  }
+  ASSERT_EQ(counter.getData(), 400042);
+
+  std::stringstream sstr;
+  counter.flushInformation(sstr);
+  ASSERT_EQ(sstr.str(), "400042");
+  ASSERT_EQ(counter.getValue().getIntegerValue(), Integer(400042));
+#endif
+}
+
+TEST_F(TestUtilBlackStats, sampled_timer)
+{
+#ifdef CVC4_STATISTICS_ON
+  SampledTimerStat timer("timer", 2);
+  ASSERT_TRUE(timer.getData() == timespec());
+  for (size_t i = 0; i < 10; ++i)
+  {
+    SampledTimerStat::CodeTimer codeTimer(timer);
+    timespec sleep = {0, 1000000};
+    nanosleep(&sleep, nullptr);
+  }
+  // runs 0, 4 and 8 are sampled
+  ASSERT_EQ(timer.getRuns(), 10);
+  ASSERT_EQ(timer.getSamples(), 3);
+  // the estimate is the time of 10 runs of at least 1 ms each
+  timespec data = timer.getData();
+  ASSERT_TRUE(data.tv_sec > 0 || data.tv_nsec >= 10000000);
+#endif
+}
+
+TEST_F(TestUtilBlackStats, json)
+{
+#ifdef CVC4_STATISTICS_ON
+  StatisticsRegistry reg;
+  IntStat sInt("int", 10);
+  BackedStat<std::string> backedStr("str", "a \"quoted\"\tvalue");
+  BackedStat<double> backedDouble("double", 16.5);
+  HistogramStat<int64_t> histStat("hist");
+  histStat << 5 << 6 << 5;
+  IntegralHistogramStat<std::int64_t> histIntStat("hist-int");
+  histIntStat << 15 << 16 << 15;
+  CounterStat counter("counter");
+  counter += 3;
+  reg.registerStat(&sInt);
+  reg.registerStat(&backedStr);
+  reg.registerStat(&backedDouble);
+  reg.registerStat(&histStat);
+  reg.registerStat(&histIntStat);
+  reg.registerStat(&counter);
+
+  std::stringstream sstr;
+  bool first = true;
+  reg.flushInformationJSON(sstr, first);
+  ASSERT_FALSE(first);
+  ASSERT_EQ(sstr.str(),
+            "\n  \"counter\": 3"
+            ",\n  \"double\": 16.5"
+            ",\n  \"hist\": {\"5\": 2, \"6\": 1}"
+            ",\n  \"hist-int\": {\"15\": 2, \"16\": 1}"
+            ",\n  \"int\": 10"
+            ",\n  \"str\": \"a \\\"quoted\\\"\\u0009value\"");
+
+  reg.unregisterStat(&sInt);
+  reg.unregisterStat(&backedStr);
+  reg.unregisterStat(&backedDouble);
+  reg.unregisterStat(&histStat);
+  reg.unregisterStat(&histIntStat);
+  reg.unregisterStat(&counter);
+#endif
+}
 }  // namespace test
 }  // namespace CVC4